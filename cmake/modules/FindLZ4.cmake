@@ -0,0 +1,21 @@
+# Filename: FindLZ4.cmake
+#
+# Usage:
+#   find_package(LZ4 [REQUIRED] [QUIET])
+#
+# Once done this will define:
+#   LZ4_FOUND       - system has LZ4
+#   LZ4_INCLUDE_DIR - the include directory containing lz4frame.h
+#   LZ4_LIBRARY     - the path to the LZ4 library
+#
+
+find_path(LZ4_INCLUDE_DIR
+  NAMES "lz4frame.h")
+
+find_library(LZ4_LIBRARY
+  NAMES "lz4" "liblz4" "liblz4_static")
+
+mark_as_advanced(LZ4_INCLUDE_DIR LZ4_LIBRARY)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(LZ4 DEFAULT_MSG LZ4_INCLUDE_DIR LZ4_LIBRARY)
@@ -0,0 +1,21 @@
+# Filename: FindZstd.cmake
+#
+# Usage:
+#   find_package(Zstd [REQUIRED] [QUIET])
+#
+# Once done this will define:
+#   ZSTD_FOUND       - system has Zstandard
+#   ZSTD_INCLUDE_DIR - the include directory containing zstd.h and zdict.h
+#   ZSTD_LIBRARY     - the path to the Zstandard library
+#
+
+find_path(ZSTD_INCLUDE_DIR
+  NAMES "zstd.h" "zdict.h")
+
+find_library(ZSTD_LIBRARY
+  NAMES "zstd" "libzstd" "zstd_static")
+
+mark_as_advanced(ZSTD_INCLUDE_DIR ZSTD_LIBRARY)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(Zstd DEFAULT_MSG ZSTD_INCLUDE_DIR ZSTD_LIBRARY)
@@ -201,7 +201,8 @@ class TaskManager:
 
     def setupTaskChain(self, chainName, numThreads = None, tickClock = None,
                        threadPriority = None, frameBudget = None,
-                       frameSync = None, timeslicePriority = None):
+                       frameSync = None, timeslicePriority = None,
+                       workStealing = None):
         """Defines a new task chain.  Each task chain executes tasks
         potentially in parallel with all of the other task chains (if
         numThreads is more than zero).  When a new task is created, it
@@ -249,6 +250,13 @@ class TaskManager:
         meaning of priority so that certain tasks are run less often,
         in proportion to their time used and to their priority value.
         See AsyncTaskManager.setTimeslicePriority() for more.
+
+        workStealing is True to give each thread of a task chain with
+        more than one thread its own queue of tasks, and let idle
+        threads steal tasks from the other threads' queues.  This
+        reduces the contention between the threads when the chain
+        runs many small tasks.  See AsyncTaskChain.setWorkStealing()
+        for more.
         """
 
         chain = self.mgr.makeTaskChain(chainName)
@@ -264,6 +272,8 @@ class TaskManager:
             chain.setFrameSync(frameSync)
         if timeslicePriority is not None:
             chain.setTimeslicePriority(timeslicePriority)
+        if workStealing is not None:
+            chain.setWorkStealing(workStealing)
 
     def hasTaskNamed(self, taskName):
         """Returns true if there is at least one task, active or
@@ -72,6 +72,7 @@ if(THIRDPARTY_DIRECTORY)
     HarfBuzz
     JPEG
     LibSquish
+    LZ4
     ODE
     Ogg
     OpenAL
@@ -85,6 +86,7 @@ if(THIRDPARTY_DIRECTORY)
     VorbisFile
     VRPN
     ZLIB
+    Zstd
   )
 
     string(TOLOWER "${_Package}" _package)
@@ -340,6 +342,24 @@ package_option(ZLIB
 
 package_status(ZLIB "zlib")
 
+# LZ4
+find_package(LZ4 QUIET)
+
+package_option(LZ4
+  "Enables the LZ4 codec for compressed Multifile subfiles, which
+decompresses much faster than zlib.")
+
+package_status(LZ4 "LZ4")
+
+# Zstandard
+find_package(Zstd QUIET)
+
+package_option(Zstd
+  "Enables the Zstandard codec for compressed Multifile subfiles, including
+support for compression dictionaries.")
+
+package_status(Zstd "Zstandard")
+
 
 #
 # ------------ Image formats ------------
@@ -0,0 +1,114 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file collisionBroadphase.cxx
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#include "collisionBroadphase.h"
+#include "collisionLevelStateBase.h"
+#include "finiteBoundingVolume.h"
+
+#include <algorithm>
+
+/**
+ * Builds the grid from the bounding volumes of the colliders in the indicated
+ * level state, which should be the top-level state of a traversal pass, and
+ * associates the level state with the grid.
+ */
+void CollisionBroadphase::
+build(CollisionLevelStateBase &level_state) {
+  clear();
+  level_state._broadphase = this;
+
+  int num_colliders = level_state.get_num_colliders();
+
+  // First, choose a cell size that is on the order of the size of a typical
+  // collider, so that each collider overlaps only a few cells.
+  PN_stdfloat total_size = 0;
+  int num_finite = 0;
+  for (int c = 0; c < num_colliders; ++c) {
+    const GeometricBoundingVolume *gbv = level_state.get_local_bound(c);
+    const FiniteBoundingVolume *fbv = (gbv != nullptr) ? gbv->as_finite_bounding_volume() : nullptr;
+    if (fbv != nullptr && !fbv->is_empty() && !fbv->is_infinite()) {
+      LVector3 size = fbv->get_max() - fbv->get_min();
+      total_size += std::max(size[0], std::max(size[1], size[2]));
+      ++num_finite;
+    }
+  }
+
+  if (num_finite == 0) {
+    // Nothing to be gained.
+    return;
+  }
+
+  PN_stdfloat cell_size = std::max(total_size / num_finite, (PN_stdfloat)0.001);
+  _inv_cell_size = 1.0f / cell_size;
+
+  for (int c = 0; c < num_colliders; ++c) {
+    const GeometricBoundingVolume *gbv = level_state.get_local_bound(c);
+    const FiniteBoundingVolume *fbv = (gbv != nullptr) ? gbv->as_finite_bounding_volume() : nullptr;
+    LVecBase3i cell_min, cell_max;
+    if (fbv == nullptr || fbv->is_infinite() ||
+        (!fbv->is_empty() && !find_cells(fbv->get_min(), fbv->get_max(), 64, cell_min, cell_max))) {
+      _unbounded.push_back(c);
+
+    } else if (!fbv->is_empty()) {
+      Entry entry;
+      entry._collider = c;
+      for (int x = cell_min[0]; x <= cell_max[0]; ++x) {
+        for (int y = cell_min[1]; y <= cell_max[1]; ++y) {
+          for (int z = cell_min[2]; z <= cell_max[2]; ++z) {
+            entry._key = make_key(x, y, z);
+            _entries.push_back(entry);
+          }
+        }
+      }
+    }
+  }
+
+  std::sort(_entries.begin(), _entries.end());
+  _space = level_state._local_bounds.get_void_ptr();
+}
+
+/**
+ * Empties the grid.  It will reject no colliders until it is built again.
+ */
+void CollisionBroadphase::
+clear() {
+  _entries.clear();
+  _unbounded.clear();
+  _space = nullptr;
+}
+
+/**
+ * Computes the range of cells overlapped by the indicated box.  Returns false
+ * if the range would cover more than max_cells cells.
+ */
+bool CollisionBroadphase::
+find_cells(const LPoint3 &min, const LPoint3 &max, int max_cells,
+           LVecBase3i &cell_min, LVecBase3i &cell_max) const {
+  int num_cells = 1;
+  for (int i = 0; i < 3; ++i) {
+    PN_stdfloat lo = cfloor(min[i] * _inv_cell_size);
+    PN_stdfloat hi = cfloor(max[i] * _inv_cell_size);
+    if (!(hi - lo < (PN_stdfloat)max_cells) ||
+        cabs(lo) > 1.0e6f || cabs(hi) > 1.0e6f) {
+      // Too big, too far away, or NaN.
+      return false;
+    }
+    cell_min[i] = (int)lo;
+    cell_max[i] = (int)hi;
+    num_cells *= (cell_max[i] - cell_min[i] + 1);
+    if (num_cells > max_cells) {
+      return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,82 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file collisionBroadphase.h
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#ifndef COLLISIONBROADPHASE_H
+#define COLLISIONBROADPHASE_H
+
+#include "pandabase.h"
+
+#include "luse.h"
+#include "finiteBoundingVolume.h"
+#include "pvector.h"
+#include "vector_int.h"
+#include "numeric_types.h"
+
+#include <algorithm>
+
+class CollisionLevelStateBase;
+
+/**
+ * A uniform grid over the bounding volumes of the colliders in one pass of a
+ * CollisionTraverser.  It is built at the start of each traversal, and is
+ * consulted by the CollisionLevelState to reject, with a single lookup, all
+ * of the colliders that are nowhere near a node, rather than testing each
+ * collider's bounding volume against the node in turn.
+ *
+ * The grid is built in the coordinate space of the colliders' bounding
+ * volumes at the top of the traversal.  It can only be used as long as the
+ * traversal has not yet applied a transform to those volumes; this is
+ * detected by comparing the level state's array of bounding volumes with
+ * the one the grid was built from.
+ */
+class EXPCL_PANDA_COLLIDE CollisionBroadphase {
+public:
+  INLINE CollisionBroadphase();
+
+  void build(CollisionLevelStateBase &level_state);
+  void clear();
+
+  template<class MaskType>
+  INLINE bool get_candidates(MaskType &mask, const void *space,
+                             const GeometricBoundingVolume *volume) const;
+
+private:
+  bool find_cells(const LPoint3 &min, const LPoint3 &max, int max_cells,
+                  LVecBase3i &cell_min, LVecBase3i &cell_max) const;
+  INLINE static uint64_t make_key(int x, int y, int z);
+
+private:
+  class Entry {
+  public:
+    INLINE bool operator < (const Entry &other) const;
+
+    uint64_t _key;
+    int _collider;
+  };
+  typedef pvector<Entry> Entries;
+
+  // The entries, sorted by cell key.  A collider appears once for each cell
+  // that its bounding volume overlaps.
+  Entries _entries;
+
+  // The colliders that have no finite bounding volume, or that overlap too
+  // many cells to store; these are candidates for every node.
+  vector_int _unbounded;
+
+  const void *_space;
+  PN_stdfloat _inv_cell_size;
+};
+
+#include "collisionBroadphase.I"
+
+#endif
@@ -0,0 +1,457 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file collisionGeomTree.cxx
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#include "collisionGeomTree.h"
+#include "collisionPolygon.h"
+#include "config_collide.h"
+#include "geom.h"
+#include "geomTriangles.h"
+#include "geomVertexData.h"
+#include "geomVertexReader.h"
+#include "boundingBox.h"
+#include "boundingLine.h"
+#include "finiteBoundingVolume.h"
+#include "lightMutexHolder.h"
+#include "pStatTimer.h"
+
+#include <algorithm>
+#include <cfloat>
+
+LightMutex CollisionGeomTree::_cache_lock;
+CollisionGeomTree::Cache CollisionGeomTree::_cache;
+size_t CollisionGeomTree::_next_sweep_size = 64;
+
+PStatCollector CollisionGeomTree::_build_pcollector("App:Collisions:Build geom trees");
+
+// The maximum number of triangles stored in a leaf of the tree.
+static const int max_leaf_triangles = 4;
+
+// The maximum depth of the tree.  Since we always split at the median, the
+// depth is bounded by the log of the number of triangles; this is enough for
+// any number of triangles that can be indexed by an int.
+static const int max_tree_depth = 64;
+
+/**
+ * This comparison function is used to partition the triangle indices along
+ * one axis of their centroids while building the tree.
+ */
+class CompareCentroids {
+public:
+  CompareCentroids(const pvector<LPoint3> &centroids, int axis) :
+    _centroids(centroids), _axis(axis) {}
+
+  bool operator () (int a, int b) const {
+    return _centroids[a][_axis] < _centroids[b][_axis];
+  }
+
+  const pvector<LPoint3> &_centroids;
+  int _axis;
+};
+
+/**
+ * Returns true if the infinite line through origin in the indicated
+ * direction passes through the axis-aligned box defined by min and max.
+ */
+static inline bool
+line_intersects_box(const LPoint3 &origin, const LVector3 &direction,
+                    const LPoint3 &min, const LPoint3 &max) {
+  PN_stdfloat t0 = -FLT_MAX;
+  PN_stdfloat t1 = FLT_MAX;
+  for (int i = 0; i < 3; ++i) {
+    if (direction[i] == 0.0f) {
+      if (origin[i] < min[i] || origin[i] > max[i]) {
+        return false;
+      }
+    } else {
+      PN_stdfloat inv = 1.0f / direction[i];
+      PN_stdfloat ta = (min[i] - origin[i]) * inv;
+      PN_stdfloat tb = (max[i] - origin[i]) * inv;
+      if (ta > tb) {
+        std::swap(ta, tb);
+      }
+      t0 = std::max(t0, ta);
+      t1 = std::min(t1, tb);
+      if (t0 > t1) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/**
+ * Builds a new tree from the triangles of the indicated Geom, using the
+ * vertex positions of the indicated vertex data.  Normally you should not
+ * call this directly; use get_tree() instead, which returns a cached tree
+ * when one is available.
+ */
+CollisionGeomTree::
+CollisionGeomTree(const Geom *geom, const GeomVertexData *data,
+                  Thread *current_thread) {
+  PStatTimer timer(_build_pcollector, current_thread);
+
+  if (geom->get_primitive_type() != Geom::PT_polygons) {
+    return;
+  }
+
+  GeomVertexReader vertex(data, InternalName::get_vertex(), current_thread);
+  if (!vertex.has_column()) {
+    return;
+  }
+
+  int num_primitives = geom->get_num_primitives();
+  for (int i = 0; i < num_primitives; ++i) {
+    const GeomPrimitive *primitive = geom->get_primitive(i);
+    CPT(GeomPrimitive) tris = primitive->decompose();
+    nassertv(tris->is_of_type(GeomTriangles::get_class_type()));
+
+    if (tris->is_indexed()) {
+      // Indexed case.
+      GeomVertexReader index(tris->get_vertices(), 0, current_thread);
+      while (!index.is_at_end()) {
+        LPoint3 v[3];
+
+        vertex.set_row_unsafe(index.get_data1i());
+        v[0] = vertex.get_data3();
+        vertex.set_row_unsafe(index.get_data1i());
+        v[1] = vertex.get_data3();
+        vertex.set_row_unsafe(index.get_data1i());
+        v[2] = vertex.get_data3();
+
+        add_triangle(v[0], v[1], v[2]);
+      }
+    } else {
+      // Non-indexed case.
+      vertex.set_row_unsafe(tris->get_first_vertex());
+      int num_vertices = tris->get_num_vertices();
+      for (int j = 0; j + 2 < num_vertices; j += 3) {
+        LPoint3 v[3];
+
+        v[0] = vertex.get_data3();
+        v[1] = vertex.get_data3();
+        v[2] = vertex.get_data3();
+
+        add_triangle(v[0], v[1], v[2]);
+      }
+    }
+  }
+
+  int num_triangles = (int)_triangles.size();
+  if (num_triangles == 0) {
+    return;
+  }
+
+  _indices.reserve(num_triangles);
+  for (int i = 0; i < num_triangles; ++i) {
+    _indices.push_back(i);
+  }
+
+  _nodes.reserve((num_triangles / max_leaf_triangles + 1) * 2);
+  _nodes.push_back(Node());
+
+  pvector<LPoint3> centroids;
+  centroids.reserve(num_triangles);
+  for (const Triangle &tri : _triangles) {
+    centroids.push_back((tri._v[0] + tri._v[1] + tri._v[2]) / 3.0f);
+  }
+
+  r_build(0, &_indices[0], &_indices[0] + num_triangles, centroids);
+
+  if (collide_cat.is_debug()) {
+    collide_cat.debug()
+      << "Built collision tree with " << num_triangles << " triangles and "
+      << _nodes.size() << " nodes for " << *geom << "\n";
+  }
+}
+
+/**
+ * Appends to result the indices of all of the triangles that might intersect
+ * the indicated bounding volume, which should be in the coordinate space of
+ * the Geom.  The indices are returned in increasing order, which is the order
+ * in which the triangles appear in the Geom.  If volume is NULL, all
+ * triangles are returned.
+ *
+ * This is a conservative test; it may return triangles that do not actually
+ * intersect the volume, but it will never omit one that does.
+ */
+void CollisionGeomTree::
+find_triangles(vector_int &result,
+               const GeometricBoundingVolume *volume) const {
+  if (_nodes.empty()) {
+    return;
+  }
+
+  if (volume == nullptr || volume->is_infinite()) {
+    for (size_t i = 0; i < _triangles.size(); ++i) {
+      result.push_back((int)i);
+    }
+    return;
+  }
+
+  if (volume->is_empty()) {
+    return;
+  }
+
+  size_t first = result.size();
+
+  const FiniteBoundingVolume *fbv = volume->as_finite_bounding_volume();
+  const BoundingLine *line = volume->as_bounding_line();
+  if (fbv != nullptr) {
+    // This covers the spheres, capsules and short segments.
+    find_finite(result, fbv->get_min(), fbv->get_max());
+
+  } else if (line != nullptr) {
+    // This covers the rays and lines.
+    find_line(result, line->get_point_a(),
+              line->get_point_b() - line->get_point_a());
+
+  } else {
+    find_general(result, volume);
+  }
+
+  std::sort(result.begin() + first, result.end());
+}
+
+/**
+ * Returns the tree for the indicated Geom and vertex data, building it if
+ * necessary.  The tree is cached, and will be reused for subsequent calls
+ * until the Geom or its vertex data is modified.
+ */
+CPT(CollisionGeomTree) CollisionGeomTree::
+get_tree(const Geom *geom, const GeomVertexData *data,
+         Thread *current_thread) {
+  UpdateSeq geom_modified = geom->get_modified(current_thread);
+  UpdateSeq data_modified = data->get_modified(current_thread);
+
+  {
+    LightMutexHolder holder(_cache_lock);
+    Cache::const_iterator ci = _cache.find(geom);
+    if (ci != _cache.end()) {
+      const CacheEntry &entry = (*ci).second;
+      if (!entry._geom.was_deleted() &&
+          entry._geom_modified == geom_modified &&
+          entry._data == data &&
+          entry._data_modified == data_modified) {
+        return entry._tree;
+      }
+    }
+  }
+
+  // Build the tree outside of the lock, since it may take a while.  If two
+  // threads happen to build the same tree at once, the last one wins; this is
+  // harmless.
+  CPT(CollisionGeomTree) tree = new CollisionGeomTree(geom, data, current_thread);
+
+  LightMutexHolder holder(_cache_lock);
+  CacheEntry &entry = _cache[geom];
+  entry._geom = geom;
+  entry._geom_modified = geom_modified;
+  entry._data = data;
+  entry._data_modified = data_modified;
+  entry._tree = tree;
+
+  if (_cache.size() >= _next_sweep_size) {
+    sweep_cache();
+  }
+
+  return tree;
+}
+
+/**
+ * Empties the cache of trees.  They will be rebuilt as needed.
+ */
+void CollisionGeomTree::
+clear_cache() {
+  LightMutexHolder holder(_cache_lock);
+  _cache.clear();
+  _next_sweep_size = 64;
+}
+
+/**
+ * Adds a new triangle to the end of the list, if it is valid.
+ */
+void CollisionGeomTree::
+add_triangle(const LPoint3 &a, const LPoint3 &b, const LPoint3 &c) {
+  if (CollisionPolygon::verify_points(a, b, c)) {
+    Triangle tri;
+    tri._v[0] = a;
+    tri._v[1] = b;
+    tri._v[2] = c;
+    _triangles.push_back(tri);
+  }
+}
+
+/**
+ * Recursively fills in the indicated node, and its children, to reference
+ * the triangles in the indicated range of _indices.
+ */
+void CollisionGeomTree::
+r_build(int node_index, int *begin, int *end,
+        const pvector<LPoint3> &centroids) {
+  LPoint3 min = _triangles[*begin]._v[0];
+  LPoint3 max = min;
+  LPoint3 cmin = centroids[*begin];
+  LPoint3 cmax = cmin;
+  for (int *ti = begin; ti != end; ++ti) {
+    const Triangle &tri = _triangles[*ti];
+    for (int j = 0; j < 3; ++j) {
+      min.set(std::min(min[0], tri._v[j][0]),
+              std::min(min[1], tri._v[j][1]),
+              std::min(min[2], tri._v[j][2]));
+      max.set(std::max(max[0], tri._v[j][0]),
+              std::max(max[1], tri._v[j][1]),
+              std::max(max[2], tri._v[j][2]));
+    }
+    const LPoint3 &c = centroids[*ti];
+    cmin.set(std::min(cmin[0], c[0]), std::min(cmin[1], c[1]), std::min(cmin[2], c[2]));
+    cmax.set(std::max(cmax[0], c[0]), std::max(cmax[1], c[1]), std::max(cmax[2], c[2]));
+  }
+
+  // Pad the box slightly, so that a collider that grazes the edge of a
+  // triangle is not rejected due to roundoff error.
+  LVector3 pad = (max - min) * 0.001f + LVector3(0.001f);
+  _nodes[node_index]._min = min - pad;
+  _nodes[node_index]._max = max + pad;
+
+  int num_triangles = (int)(end - begin);
+  if (num_triangles <= max_leaf_triangles) {
+    _nodes[node_index]._index = (int)(begin - &_indices[0]);
+    _nodes[node_index]._num_triangles = num_triangles;
+    return;
+  }
+
+  // Split along the longest axis of the centroids, at the median.
+  LVector3 extent = cmax - cmin;
+  int axis = 0;
+  if (extent[1] > extent[axis]) {
+    axis = 1;
+  }
+  if (extent[2] > extent[axis]) {
+    axis = 2;
+  }
+
+  int *mid = begin + num_triangles / 2;
+  std::nth_element(begin, mid, end, CompareCentroids(centroids, axis));
+
+  int child_index = (int)_nodes.size();
+  _nodes.push_back(Node());
+  _nodes.push_back(Node());
+  _nodes[node_index]._index = child_index;
+  _nodes[node_index]._num_triangles = 0;
+
+  r_build(child_index, begin, mid, centroids);
+  r_build(child_index + 1, mid, end, centroids);
+}
+
+/**
+ * Collects the triangles whose nodes overlap the indicated axis-aligned box.
+ */
+void CollisionGeomTree::
+find_finite(vector_int &result, const LPoint3 &min, const LPoint3 &max) const {
+  int stack[max_tree_depth];
+  int sp = 0;
+  stack[sp++] = 0;
+
+  while (sp > 0) {
+    const Node &node = _nodes[stack[--sp]];
+    if (node._max[0] < min[0] || node._min[0] > max[0] ||
+        node._max[1] < min[1] || node._min[1] > max[1] ||
+        node._max[2] < min[2] || node._min[2] > max[2]) {
+      continue;
+    }
+
+    if (node._num_triangles != 0) {
+      const int *ti = &_indices[node._index];
+      result.insert(result.end(), ti, ti + node._num_triangles);
+    } else {
+      nassertv(sp + 2 <= max_tree_depth);
+      stack[sp++] = node._index + 1;
+      stack[sp++] = node._index;
+    }
+  }
+}
+
+/**
+ * Collects the triangles whose nodes are crossed by the indicated infinite
+ * line.
+ */
+void CollisionGeomTree::
+find_line(vector_int &result, const LPoint3 &origin,
+          const LVector3 &direction) const {
+  int stack[max_tree_depth];
+  int sp = 0;
+  stack[sp++] = 0;
+
+  while (sp > 0) {
+    const Node &node = _nodes[stack[--sp]];
+    if (!line_intersects_box(origin, direction, node._min, node._max)) {
+      continue;
+    }
+
+    if (node._num_triangles != 0) {
+      const int *ti = &_indices[node._index];
+      result.insert(result.end(), ti, ti + node._num_triangles);
+    } else {
+      nassertv(sp + 2 <= max_tree_depth);
+      stack[sp++] = node._index + 1;
+      stack[sp++] = node._index;
+    }
+  }
+}
+
+/**
+ * Collects the triangles whose nodes might intersect the indicated volume.
+ * This is the slow path, used for volumes that are neither finite nor lines.
+ */
+void CollisionGeomTree::
+find_general(vector_int &result,
+             const GeometricBoundingVolume *volume) const {
+  int stack[max_tree_depth];
+  int sp = 0;
+  stack[sp++] = 0;
+
+  while (sp > 0) {
+    const Node &node = _nodes[stack[--sp]];
+    BoundingBox box(node._min, node._max);
+    if (box.contains(volume) == BoundingVolume::IF_no_intersection) {
+      continue;
+    }
+
+    if (node._num_triangles != 0) {
+      const int *ti = &_indices[node._index];
+      result.insert(result.end(), ti, ti + node._num_triangles);
+    } else {
+      nassertv(sp + 2 <= max_tree_depth);
+      stack[sp++] = node._index + 1;
+      stack[sp++] = node._index;
+    }
+  }
+}
+
+/**
+ * Removes the cache entries for Geoms that have since been deleted.  Assumes
+ * the lock is already held.
+ */
+void CollisionGeomTree::
+sweep_cache() {
+  Cache::iterator ci = _cache.begin();
+  while (ci != _cache.end()) {
+    if ((*ci).second._geom.was_deleted()) {
+      ci = _cache.erase(ci);
+    } else {
+      ++ci;
+    }
+  }
+
+  _next_sweep_size = std::max((size_t)64, _cache.size() * 2);
+}
@@ -0,0 +1,119 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file collisionGeomTree.h
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#ifndef COLLISIONGEOMTREE_H
+#define COLLISIONGEOMTREE_H
+
+#include "pandabase.h"
+
+#include "referenceCount.h"
+#include "pointerTo.h"
+#include "weakPointerTo.h"
+#include "luse.h"
+#include "pvector.h"
+#include "pmap.h"
+#include "vector_int.h"
+#include "updateSeq.h"
+#include "lightMutex.h"
+#include "pStatCollector.h"
+
+class Geom;
+class GeomVertexData;
+class GeometricBoundingVolume;
+class Thread;
+
+/**
+ * A bounding volume hierarchy over the triangles of a visible Geom.  This is
+ * used by the CollisionTraverser to quickly find the handful of triangles
+ * that might intersect a collider, when the collider is tested against a
+ * GeomNode whose collide mask includes visible geometry.
+ *
+ * The tree is built lazily the first time a Geom is tested, and cached
+ * against the Geom until either the Geom or its vertex data is modified.
+ */
+class EXPCL_PANDA_COLLIDE CollisionGeomTree : public ReferenceCount {
+public:
+  CollisionGeomTree(const Geom *geom, const GeomVertexData *data,
+                    Thread *current_thread);
+
+  INLINE int get_num_triangles() const;
+  INLINE const LPoint3 *get_triangle(int n) const;
+
+  void find_triangles(vector_int &result,
+                      const GeometricBoundingVolume *volume) const;
+
+  static CPT(CollisionGeomTree) get_tree(const Geom *geom,
+                                         const GeomVertexData *data,
+                                         Thread *current_thread);
+  static void clear_cache();
+
+private:
+  void add_triangle(const LPoint3 &a, const LPoint3 &b, const LPoint3 &c);
+  void r_build(int node_index, int *begin, int *end,
+               const pvector<LPoint3> &centroids);
+
+  void find_finite(vector_int &result, const LPoint3 &min,
+                   const LPoint3 &max) const;
+  void find_line(vector_int &result, const LPoint3 &origin,
+                 const LVector3 &direction) const;
+  void find_general(vector_int &result,
+                    const GeometricBoundingVolume *volume) const;
+
+  static void sweep_cache();
+
+private:
+  // The triangles, in the order they were encountered in the Geom.  Only
+  // triangles that pass CollisionPolygon::verify_points() are stored.
+  class Triangle {
+  public:
+    LPoint3 _v[3];
+  };
+  typedef pvector<Triangle> Triangles;
+  Triangles _triangles;
+
+  // The triangle indices, reordered so that each leaf of the tree references
+  // a contiguous range.
+  vector_int _indices;
+
+  // If _num_triangles is 0, this is an interior node, and its children are
+  // at _index and _index + 1.  Otherwise it is a leaf, and it references
+  // _num_triangles triangles starting at _indices[_index].
+  class Node {
+  public:
+    LPoint3 _min;
+    LPoint3 _max;
+    int _index;
+    int _num_triangles;
+  };
+  typedef pvector<Node> Nodes;
+  Nodes _nodes;
+
+  class CacheEntry {
+  public:
+    WCPT(Geom) _geom;
+    UpdateSeq _geom_modified;
+    const GeomVertexData *_data;
+    UpdateSeq _data_modified;
+    CPT(CollisionGeomTree) _tree;
+  };
+  typedef pmap<const Geom *, CacheEntry> Cache;
+  static LightMutex _cache_lock;
+  static Cache _cache;
+  static size_t _next_sweep_size;
+
+  static PStatCollector _build_pcollector;
+};
+
+#include "collisionGeomTree.I"
+
+#endif
@@ -17,6 +17,7 @@
 #include "pandabase.h"
 
 #include "collisionLevelStateBase.h"
+#include "collisionBroadphase.h"
 #include "collisionNode.h"
 #include "bitMask.h"
 #include "doubleBitMask.h"
@@ -18,6 +18,7 @@
 #include "dcast.h"
 
 PStatCollector CollisionLevelStateBase::_node_volume_pcollector("Collision Volumes:PandaNode");
+PStatCollector CollisionLevelStateBase::_broadphase_reject_pcollector("Collision Volumes:Broadphase rejects");
 
 TypeHandle CollisionLevelStateBase::_type_handle;
 
@@ -29,6 +30,7 @@ clear() {
   _colliders.clear();
   _local_bounds.clear();
   _parent_bounds.clear();
+  _broadphase = nullptr;
 }
 
 /**
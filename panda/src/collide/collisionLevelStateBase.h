@@ -32,6 +32,7 @@
 
 class CollisionSolid;
 class CollisionNode;
+class CollisionBroadphase;
 
 /**
  * This is the state information the CollisionTraverser retains for each level
@@ -84,7 +85,10 @@ protected:
   BoundingVolumes _local_bounds;
   BoundingVolumes _parent_bounds;
 
+  const CollisionBroadphase *_broadphase;
+
   static PStatCollector _node_volume_pcollector;
+  static PStatCollector _broadphase_reject_pcollector;
 
 public:
   static TypeHandle get_class_type() {
@@ -98,6 +102,7 @@ private:
   static TypeHandle _type_handle;
 
   friend class CollisionTraverser;
+  friend class CollisionBroadphase;
 };
 
 #include "collisionLevelStateBase.I"
@@ -16,6 +16,7 @@
 #include "collisionEntry.h"
 #include "collisionPolygon.h"
 #include "collisionGeom.h"
+#include "collisionGeomTree.h"
 #include "collisionRecorder.h"
 #include "collisionVisualizer.h"
 #include "collisionSphere.h"
@@ -34,6 +35,7 @@
 #include "lodNode.h"
 #include "nodePath.h"
 #include "pStatTimer.h"
+#include "asyncTaskManager.h"
 #include "indent.h"
 
 #include <algorithm>
@@ -65,6 +67,24 @@ public:
   const CollisionTraverser &_trav;
 };
 
+/**
+ * Builds the broadphase grid for each of the indicated passes that has
+ * enough colliders to make it worthwhile.
+ */
+template<class LevelStates>
+static void
+build_broadphases(pvector<CollisionBroadphase> &broadphases,
+                  LevelStates &level_states) {
+  if (broadphases.size() < level_states.size()) {
+    broadphases.resize(level_states.size());
+  }
+  for (size_t pass = 0; pass < level_states.size(); ++pass) {
+    if (level_states[pass].get_num_colliders() >= collision_broadphase_min_colliders) {
+      broadphases[pass].build(level_states[pass]);
+    }
+  }
+}
+
 /**
  *
  */
@@ -74,6 +94,8 @@ CollisionTraverser(const std::string &name) :
   _this_pcollector(_collisions_pcollector, name)
 {
   _respect_prev_transform = respect_prev_transform;
+  _use_broadphase = collision_broadphase;
+  _num_threads = collision_traverser_threads;
   #ifdef DO_COLLISION_RECORDING
   _recorder = nullptr;
   #endif
@@ -269,8 +291,26 @@ traverse(const NodePath &root) {
   }
 
   bool traversal_done = false;
-  if ((int)_colliders.size() <= CollisionLevelStateSingle::get_max_colliders() ||
-      !allow_collider_multiple) {
+#ifdef DO_COLLISION_RECORDING
+  bool parallel = (_num_threads > 1 && Thread::is_true_threads() && !has_recorder());
+#else
+  bool parallel = (_num_threads > 1 && Thread::is_true_threads());
+#endif
+  if (parallel) {
+    // In parallel mode, we always use the single-word-at-a-time traverser,
+    // which gives us the most passes to distribute among the threads.
+    LevelStatesSingle level_states;
+    prepare_colliders_single(level_states, root);
+    if (_use_broadphase) {
+      build_broadphases(_broadphases, level_states);
+    }
+    traverse_parallel(level_states);
+    traversal_done = true;
+  }
+
+  if (!traversal_done &&
+      ((int)_colliders.size() <= CollisionLevelStateSingle::get_max_colliders() ||
+       !allow_collider_multiple)) {
     // Use the single-word-at-a-time traverser, which might need to make lots
     // of passes.
     LevelStatesSingle level_states;
@@ -278,6 +318,9 @@ traverse(const NodePath &root) {
 
     if (level_states.size() == 1 || !allow_collider_multiple) {
       traversal_done = true;
+      if (_use_broadphase) {
+        build_broadphases(_broadphases, level_states);
+      }
 
       // Make a number of passes, one for each group of 32 Colliders (or
       // whatever number of bits we have available in CurrentMask).
@@ -298,6 +341,9 @@ traverse(const NodePath &root) {
 
     if (level_states.size() == 1) {
       traversal_done = true;
+      if (_use_broadphase) {
+        build_broadphases(_broadphases, level_states);
+      }
 
       for (size_t pass = 0; pass < level_states.size(); ++pass) {
 #ifdef DO_PSTATS
@@ -314,6 +360,9 @@ traverse(const NodePath &root) {
     prepare_colliders_quad(level_states, root);
 
     traversal_done = true;
+    if (_use_broadphase) {
+      build_broadphases(_broadphases, level_states);
+    }
 
     for (size_t pass = 0; pass < level_states.size(); ++pass) {
 #ifdef DO_PSTATS
@@ -558,7 +607,8 @@ prepare_colliders_single(CollisionTraverser::LevelStatesSingle &level_states,
  *
  */
 void CollisionTraverser::
-r_traverse_single(CollisionLevelStateSingle &level_state, size_t pass) {
+r_traverse_single(CollisionLevelStateSingle &level_state, size_t pass,
+                  DeferredEntries *deferred) {
   if (!level_state.any_in_bounds()) {
     return;
   }
@@ -600,7 +650,7 @@ r_traverse_single(CollisionLevelStateSingle &level_state, size_t pass) {
               entry,
               level_state.get_parent_bound(c),
               level_state.get_local_bound(c),
-              node_gbv);
+              node_gbv, deferred);
         }
       }
     }
@@ -645,7 +695,7 @@ r_traverse_single(CollisionLevelStateSingle &level_state, size_t pass) {
               entry,
               level_state.get_parent_bound(c),
               level_state.get_local_bound(c),
-              node_gbv);
+              node_gbv, deferred);
         }
       }
     }
@@ -657,7 +707,7 @@ r_traverse_single(CollisionLevelStateSingle &level_state, size_t pass) {
     int index = node->get_visible_child();
     if (index >= 0 && index < node->get_num_children()) {
       CollisionLevelStateSingle next_state(level_state, node->get_child(index));
-      r_traverse_single(next_state, pass);
+      r_traverse_single(next_state, pass, deferred);
     }
 
   } else if (node->is_lod_node()) {
@@ -675,7 +725,7 @@ r_traverse_single(CollisionLevelStateSingle &level_state, size_t pass) {
         next_state.set_include_mask(next_state.get_include_mask() &
           ~GeomNode::get_default_collide_mask());
       }
-      r_traverse_single(next_state, pass);
+      r_traverse_single(next_state, pass, deferred);
     }
 
   } else {
@@ -684,11 +734,99 @@ r_traverse_single(CollisionLevelStateSingle &level_state, size_t pass) {
     int num_children = children.get_num_children();
     for (int i = 0; i < num_children; ++i) {
       CollisionLevelStateSingle next_state(level_state, children.get_child(i));
-      r_traverse_single(next_state, pass);
+      r_traverse_single(next_state, pass, deferred);
     }
   }
 }
 
+/**
+ * Performs the indicated passes of the traversal, distributing them among the
+ * calling thread and the threads of the "collision" task chain.  The detected
+ * collisions are passed to the handlers only after all passes are done, in
+ * the same order in which the serial traversal would have passed them.
+ */
+void CollisionTraverser::
+traverse_parallel(CollisionTraverser::LevelStatesSingle &level_states) {
+  size_t num_passes = level_states.size();
+  if (num_passes == 0) {
+    return;
+  }
+
+  // Make sure all of the pass collectors exist before any threads start, so
+  // that the threads don't need to modify the vector.
+  get_pass_collector((int)num_passes - 1);
+
+  ParallelPasses passes;
+  passes._trav = this;
+  passes._level_states = &level_states;
+  passes._entries.resize(num_passes);
+  passes._next_pass = 0;
+
+  int num_tasks = min(_num_threads, (int)num_passes) - 1;
+  pvector<PT(AsyncTask)> tasks;
+  if (num_tasks > 0) {
+    AsyncTaskManager *task_mgr = AsyncTaskManager::get_global_ptr();
+    AsyncTaskChain *chain = task_mgr->make_task_chain("collision");
+    if (chain->get_num_threads() < num_tasks) {
+      chain->set_num_threads(num_tasks);
+    }
+
+    tasks.reserve(num_tasks);
+    for (int i = 0; i < num_tasks; ++i) {
+      PT(GenericAsyncTask) task =
+        new GenericAsyncTask("collision_passes", &st_parallel_passes, &passes);
+      task->set_task_chain("collision");
+      task_mgr->add(task);
+      tasks.push_back(task);
+    }
+  }
+
+  // The calling thread takes its share of the passes, too.
+  do_parallel_passes(passes);
+
+  for (AsyncTask *task : tasks) {
+    task->wait();
+  }
+
+  // Now hand the results to the handlers, in pass order.
+  for (const DeferredEntries &entries : passes._entries) {
+    for (const DeferredEntry &def : entries) {
+      def._handler->add_entry(def._entry);
+    }
+  }
+}
+
+/**
+ * Repeatedly claims the next unclaimed pass and performs it, until there are
+ * no more passes.  This is called by each of the threads participating in
+ * traverse_parallel().
+ */
+void CollisionTraverser::
+do_parallel_passes(CollisionTraverser::ParallelPasses &passes) {
+  size_t num_passes = passes._entries.size();
+  while (true) {
+    size_t pass = (size_t)(AtomicAdjust::add(passes._next_pass, 1) - 1);
+    if (pass >= num_passes) {
+      return;
+    }
+#ifdef DO_PSTATS
+    PStatTimer pass_timer(_pass_collectors[pass]);
+#endif
+    r_traverse_single((*passes._level_states)[pass], pass,
+                      &passes._entries[pass]);
+  }
+}
+
+/**
+ * The task function for the threads participating in traverse_parallel().
+ */
+AsyncTask::DoneStatus CollisionTraverser::
+st_parallel_passes(GenericAsyncTask *task, void *data) {
+  ParallelPasses *passes = (ParallelPasses *)data;
+  passes->_trav->do_parallel_passes(*passes);
+  return AsyncTask::DS_done;
+}
+
 /**
  * Fills up the set of LevelStates corresponding to the active colliders in
  * use.
@@ -811,7 +949,7 @@ r_traverse_double(CollisionLevelStateDouble &level_state, size_t pass) {
               entry,
               level_state.get_parent_bound(c),
               level_state.get_local_bound(c),
-              node_gbv);
+              node_gbv, nullptr);
         }
       }
     }
@@ -856,7 +994,7 @@ r_traverse_double(CollisionLevelStateDouble &level_state, size_t pass) {
               entry,
               level_state.get_parent_bound(c),
               level_state.get_local_bound(c),
-              node_gbv);
+              node_gbv, nullptr);
         }
       }
     }
@@ -1022,7 +1160,7 @@ r_traverse_quad(CollisionLevelStateQuad &level_state, size_t pass) {
               entry,
               level_state.get_parent_bound(c),
               level_state.get_local_bound(c),
-              node_gbv);
+              node_gbv, nullptr);
         }
       }
     }
@@ -1067,7 +1205,7 @@ r_traverse_quad(CollisionLevelStateQuad &level_state, size_t pass) {
               entry,
               level_state.get_parent_bound(c),
               level_state.get_local_bound(c),
-              node_gbv);
+              node_gbv, nullptr);
         }
       }
     }
@@ -1118,7 +1256,8 @@ void CollisionTraverser::
 compare_collider_to_node(CollisionEntry &entry,
                          const GeometricBoundingVolume *from_parent_gbv,
                          const GeometricBoundingVolume *from_node_gbv,
-                         const GeometricBoundingVolume *into_node_gbv) {
+                         const GeometricBoundingVolume *into_node_gbv,
+                         DeferredEntries *deferred) {
   bool within_node_bounds = true;
   if (from_parent_gbv != nullptr &&
       into_node_gbv != nullptr) {
@@ -1148,7 +1287,7 @@ compare_collider_to_node(CollisionEntry &entry,
       Colliders::const_iterator ci;
       ci = _colliders.find(entry.get_from_node_path());
       nassertv(ci != _colliders.end());
-      entry.test_intersection((*ci).second, this);
+      test_intersection(entry, (*ci).second, deferred);
     } else {
       CollisionNode::Solids::const_iterator si;
       for (si = cnode->_solids.begin(); si != cnode->_solids.end(); ++si) {
@@ -1164,7 +1303,7 @@ compare_collider_to_node(CollisionEntry &entry,
           solid_gbv = (const GeometricBoundingVolume *)solid_bv.p();
         }
 
-        compare_collider_to_solid(entry, from_node_gbv, solid_gbv);
+        compare_collider_to_solid(entry, from_node_gbv, solid_gbv, deferred);
       }
     }
   }
@@ -1177,7 +1316,8 @@ void CollisionTraverser::
 compare_collider_to_geom_node(CollisionEntry &entry,
                               const GeometricBoundingVolume *from_parent_gbv,
                               const GeometricBoundingVolume *from_node_gbv,
-                              const GeometricBoundingVolume *into_node_gbv) {
+                              const GeometricBoundingVolume *into_node_gbv,
+                              DeferredEntries *deferred) {
   bool within_node_bounds = true;
   if (from_parent_gbv != nullptr &&
       into_node_gbv != nullptr) {
@@ -1205,7 +1345,7 @@ compare_collider_to_geom_node(CollisionEntry &entry,
           DCAST_INTO_V(geom_gbv, geom_bv);
         }
 
-        compare_collider_to_geom(entry, geom, from_node_gbv, geom_gbv);
+        compare_collider_to_geom(entry, geom, from_node_gbv, geom_gbv, deferred);
       }
     }
   }
@@ -1217,7 +1357,8 @@ compare_collider_to_geom_node(CollisionEntry &entry,
 void CollisionTraverser::
 compare_collider_to_solid(CollisionEntry &entry,
                           const GeometricBoundingVolume *from_node_gbv,
-                          const GeometricBoundingVolume *solid_gbv) {
+                          const GeometricBoundingVolume *solid_gbv,
+                          DeferredEntries *deferred) {
   bool within_solid_bounds = true;
   if (from_node_gbv != nullptr &&
       solid_gbv != nullptr) {
@@ -1238,7 +1379,7 @@ compare_collider_to_solid(CollisionEntry &entry,
     Colliders::const_iterator ci;
     ci = _colliders.find(entry.get_from_node_path());
     nassertv(ci != _colliders.end());
-    entry.test_intersection((*ci).second, this);
+    test_intersection(entry, (*ci).second, deferred);
   }
 }
 
@@ -1248,7 +1389,8 @@ compare_collider_to_solid(CollisionEntry &entry,
 void CollisionTraverser::
 compare_collider_to_geom(CollisionEntry &entry, const Geom *geom,
                          const GeometricBoundingVolume *from_node_gbv,
-                         const GeometricBoundingVolume *geom_gbv) {
+                         const GeometricBoundingVolume *geom_gbv,
+                         DeferredEntries *deferred) {
   bool within_geom_bounds = true;
   if (from_node_gbv != nullptr &&
       geom_gbv != nullptr) {
@@ -1263,6 +1405,31 @@ compare_collider_to_geom(CollisionEntry &entry, const Geom *geom,
     if (geom->get_primitive_type() == Geom::PT_polygons) {
       Thread *current_thread = Thread::get_current_thread();
       CPT(GeomVertexData) data = geom->get_animated_vertex_data(true, current_thread);
+
+      // If the Geom is big enough, and isn't animated (in which case the
+      // tree would have to be rebuilt every frame), use the cached triangle
+      // tree to find just the triangles near the collider.
+      if (collision_geom_tree &&
+          data == geom->get_vertex_data(current_thread) &&
+          geom->get_nested_vertices(current_thread) >= collision_geom_tree_min_triangles * 3) {
+        CPT(CollisionGeomTree) tree =
+          CollisionGeomTree::get_tree(geom, data, current_thread);
+
+        vector_int triangles;
+        tree->find_triangles(triangles, from_node_gbv);
+#ifdef DO_PSTATS
+        CollisionGeom::_volume_pcollector.add_level(triangles.size());
+#endif  // DO_PSTATS
+
+        for (int n : triangles) {
+          const LPoint3 *v = tree->get_triangle(n);
+          PT(CollisionGeom) cgeom = new CollisionGeom(v[0], v[1], v[2]);
+          entry._into = cgeom;
+          test_intersection(entry, (*ci).second, deferred);
+        }
+        return;
+      }
+
       GeomVertexReader vertex(data, InternalName::get_vertex());
 
       int num_primitives = geom->get_num_primitives();
@@ -1299,7 +1466,7 @@ compare_collider_to_geom(CollisionEntry &entry, const Geom *geom,
               if (within_solid_bounds) {
                 PT(CollisionGeom) cgeom = new CollisionGeom(v[0], v[1], v[2]);
                 entry._into = cgeom;
-                entry.test_intersection((*ci).second, this);
+                test_intersection(entry, (*ci).second, deferred);
               }
             }
           }
@@ -1329,7 +1496,7 @@ compare_collider_to_geom(CollisionEntry &entry, const Geom *geom,
               if (within_solid_bounds) {
                 PT(CollisionGeom) cgeom = new CollisionGeom(v[0], v[1], v[2]);
                 entry._into = cgeom;
-                entry.test_intersection((*ci).second, this);
+                test_intersection(entry, (*ci).second, deferred);
               }
             }
           }
@@ -1339,6 +1506,28 @@ compare_collider_to_geom(CollisionEntry &entry, const Geom *geom,
   }
 }
 
+/**
+ * Performs the intersection test stored in the indicated entry.  If deferred
+ * is NULL, the result is passed directly to the handler; otherwise, it is
+ * appended to deferred, to be passed to the handler later.
+ */
+void CollisionTraverser::
+test_intersection(const CollisionEntry &entry, CollisionHandler *handler,
+                  DeferredEntries *deferred) const {
+  if (deferred == nullptr) {
+    entry.test_intersection(handler, this);
+  } else {
+    PT(CollisionEntry) result = entry.compute_intersection(handler, this);
+    if (result != nullptr) {
+      DeferredEntry def;
+      def._handler = handler;
+      def._entry = std::move(result);
+      deferred->push_back(std::move(def));
+    }
+  }
+}
+
+
 /**
  * Removes the indicated CollisionHandler from the list of handlers to be
  * processed, and returns the iterator to the next handler in the list.  This
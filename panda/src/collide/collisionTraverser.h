@@ -18,9 +18,12 @@
 
 #include "collisionHandler.h"
 #include "collisionLevelState.h"
+#include "collisionBroadphase.h"
 
 #include "pointerTo.h"
 #include "pStatCollector.h"
+#include "genericAsyncTask.h"
+#include "atomicAdjust.h"
 
 #include "pset.h"
 #include "register_type.h"
@@ -52,6 +55,14 @@ PUBLISHED:
   MAKE_PROPERTY(respect_prev_transform, get_respect_prev_transform,
                                         set_respect_prev_transform);
 
+  INLINE void set_use_broadphase(bool flag);
+  INLINE bool get_use_broadphase() const;
+  MAKE_PROPERTY(use_broadphase, get_use_broadphase, set_use_broadphase);
+
+  INLINE void set_num_threads(int num_threads);
+  INLINE int get_num_threads() const;
+  MAKE_PROPERTY(num_threads, get_num_threads, set_num_threads);
+
   void add_collider(const NodePath &collider, CollisionHandler *handler);
   bool remove_collider(const NodePath &collider);
   bool has_collider(const NodePath &collider) const;
@@ -80,9 +91,31 @@ PUBLISHED:
   void write(std::ostream &out, int indent_level) const;
 
 private:
+  // In parallel mode, the entries detected during each pass are recorded
+  // here, and passed to the handlers only after all of the passes are done.
+  class DeferredEntry {
+  public:
+    CollisionHandler *_handler;
+    PT(CollisionEntry) _entry;
+  };
+  typedef pvector<DeferredEntry> DeferredEntries;
+
   typedef pvector<CollisionLevelStateSingle> LevelStatesSingle;
   void prepare_colliders_single(LevelStatesSingle &level_states, const NodePath &root);
-  void r_traverse_single(CollisionLevelStateSingle &level_state, size_t pass);
+  void r_traverse_single(CollisionLevelStateSingle &level_state, size_t pass,
+                         DeferredEntries *deferred = nullptr);
+
+  class ParallelPasses {
+  public:
+    CollisionTraverser *_trav;
+    LevelStatesSingle *_level_states;
+    pvector<DeferredEntries> _entries;
+    AtomicAdjust::Integer _next_pass;
+  };
+  void traverse_parallel(LevelStatesSingle &level_states);
+  void do_parallel_passes(ParallelPasses &passes);
+  static AsyncTask::DoneStatus st_parallel_passes(GenericAsyncTask *task,
+                                                  void *data);
 
   typedef pvector<CollisionLevelStateDouble> LevelStatesDouble;
   void prepare_colliders_double(LevelStatesDouble &level_states, const NodePath &root);
@@ -95,17 +128,24 @@ private:
   void compare_collider_to_node(CollisionEntry &entry,
                                 const GeometricBoundingVolume *from_parent_gbv,
                                 const GeometricBoundingVolume *from_node_gbv,
-                                const GeometricBoundingVolume *into_node_gbv);
+                                const GeometricBoundingVolume *into_node_gbv,
+                                DeferredEntries *deferred);
   void compare_collider_to_geom_node(CollisionEntry &entry,
                                      const GeometricBoundingVolume *from_parent_gbv,
                                      const GeometricBoundingVolume *from_node_gbv,
-                                     const GeometricBoundingVolume *into_node_gbv);
+                                     const GeometricBoundingVolume *into_node_gbv,
+                                     DeferredEntries *deferred);
   void compare_collider_to_solid(CollisionEntry &entry,
                                  const GeometricBoundingVolume *from_node_gbv,
-                                 const GeometricBoundingVolume *solid_gbv);
+                                 const GeometricBoundingVolume *solid_gbv,
+                                 DeferredEntries *deferred);
   void compare_collider_to_geom(CollisionEntry &entry, const Geom *geom,
                                 const GeometricBoundingVolume *from_node_gbv,
-                                const GeometricBoundingVolume *solid_gbv);
+                                const GeometricBoundingVolume *solid_gbv,
+                                DeferredEntries *deferred);
+  void test_intersection(const CollisionEntry &entry,
+                         CollisionHandler *handler,
+                         DeferredEntries *deferred) const;
 
   PStatCollector &get_pass_collector(int pass);
 
@@ -129,6 +169,11 @@ private:
   Handlers::iterator remove_handler(Handlers::iterator hi);
 
   bool _respect_prev_transform;
+  bool _use_broadphase;
+  int _num_threads;
+
+  typedef pvector<CollisionBroadphase> Broadphases;
+  Broadphases _broadphases;
 #ifdef DO_COLLISION_RECORDING
   CollisionRecorder *_recorder;
   NodePath _collision_visualizer_np;
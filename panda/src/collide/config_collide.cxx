@@ -111,6 +111,41 @@ ConfigVariableBool pushers_horizontal
           "set_horizontal() flag by default, false to let the move "
           "in three dimensions by default."));
 
+ConfigVariableInt collision_traverser_threads
+("collision-traverser-threads", 1,
+ PRC_DESC("The default number of threads used by each CollisionTraverser; "
+          "see CollisionTraverser::set_num_threads().  Set this greater "
+          "than 1 to distribute the traversal passes of traversers with "
+          "many colliders among multiple threads.  This only has an effect "
+          "if Panda was compiled with true threading support."));
+
+ConfigVariableBool collision_broadphase
+("collision-broadphase", true,
+ PRC_DESC("The default value of CollisionTraverser::set_use_broadphase().  "
+          "Set this true to sort the colliders of each traversal pass into "
+          "a uniform grid, which is used to quickly reject the colliders "
+          "that are nowhere near a given node."));
+
+ConfigVariableInt collision_broadphase_min_colliders
+("collision-broadphase-min-colliders", 8,
+ PRC_DESC("This is the minimum number of colliders a traversal pass must "
+          "have before collision-broadphase will build a grid for it."));
+
+ConfigVariableBool collision_geom_tree
+("collision-geom-tree", true,
+ PRC_DESC("Set this true to build a bounding volume hierarchy over the "
+          "triangles of each visible Geom that is tested for collisions, so "
+          "that colliders need only be tested against the triangles near "
+          "them.  The hierarchy is cached and rebuilt only when the Geom or "
+          "its vertex data is modified.  Set it false to test every "
+          "triangle every frame, which uses less memory."));
+
+ConfigVariableInt collision_geom_tree_min_triangles
+("collision-geom-tree-min-triangles", 16,
+ PRC_DESC("This is the minimum number of triangles a Geom must have before "
+          "collision-geom-tree will build a hierarchy for it.  Smaller "
+          "Geoms are simply tested triangle by triangle."));
+
 /**
  * Initializes the library.  This must be called at least once before any of
  * the functions or classes in this library can be used.  Normally it will be
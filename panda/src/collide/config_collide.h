@@ -30,6 +30,11 @@ extern EXPCL_PANDA_COLLIDE ConfigVariableDouble collision_parabola_bounds_thresh
 extern EXPCL_PANDA_COLLIDE ConfigVariableInt collision_parabola_bounds_sample;
 extern EXPCL_PANDA_COLLIDE ConfigVariableInt fluid_cap_amount;
 extern EXPCL_PANDA_COLLIDE ConfigVariableBool pushers_horizontal;
+extern EXPCL_PANDA_COLLIDE ConfigVariableInt collision_traverser_threads;
+extern EXPCL_PANDA_COLLIDE ConfigVariableBool collision_broadphase;
+extern EXPCL_PANDA_COLLIDE ConfigVariableInt collision_broadphase_min_colliders;
+extern EXPCL_PANDA_COLLIDE ConfigVariableBool collision_geom_tree;
+extern EXPCL_PANDA_COLLIDE ConfigVariableInt collision_geom_tree_min_triangles;
 
 extern EXPCL_PANDA_COLLIDE void init_libcollide();
 
@@ -1,8 +1,10 @@
 #include "config_collide.cxx"
 #include "collisionBox.cxx"
+#include "collisionBroadphase.cxx"
 #include "collisionCapsule.cxx"
 #include "collisionEntry.cxx"
 #include "collisionGeom.cxx"
+#include "collisionGeomTree.cxx"
 #include "collisionHandler.cxx"
 #include "collisionHandlerEvent.cxx"
 #include "collisionHandlerHighestEvent.cxx"
@@ -33,6 +33,20 @@ ConfigureFn(config_cull) {
   init_libcull();
 }
 
+ConfigVariableBool cull_bin_key_sort
+("cull-bin-key-sort", true,
+ PRC_DESC("Set this true to sort the objects in the state-sorted and "
+          "depth-sorted cull bins by computing an integer key for each "
+          "object and radix sorting the keys, rather than by calling a "
+          "comparison function.  The resulting order is the same either "
+          "way, except possibly among objects that compare equal."));
+
+ConfigVariableInt cull_bin_key_sort_min_objects
+("cull-bin-key-sort-min-objects", 256,
+ PRC_DESC("The minimum number of objects a cull bin must have before "
+          "cull-bin-key-sort applies to it.  Smaller bins are sorted with a "
+          "comparison function, which is faster for few objects."));
+
 /**
  * Initializes the library.  This must be called at least once before any of
  * the functions or classes in this library can be used.  Normally it will be
@@ -26,6 +26,9 @@ class DSearchPath;
 ConfigureDecl(config_cull, EXPCL_PANDA_CULL, EXPTP_PANDA_CULL);
 NotifyCategoryDecl(cull, EXPCL_PANDA_CULL, EXPTP_PANDA_CULL);
 
+extern ConfigVariableBool cull_bin_key_sort;
+extern ConfigVariableInt cull_bin_key_sort_min_objects;
+
 extern EXPCL_PANDA_CULL void init_libcull();
 
 #endif
@@ -12,6 +12,7 @@
  */
 
 #include "cullBinFrontToBack.h"
+#include "cullSortKeys.h"
 #include "graphicsStateGuardianBase.h"
 #include "geometricBoundingVolume.h"
 #include "cullableObject.h"
@@ -75,7 +76,19 @@ add_object(CullableObject *object, Thread *current_thread) {
 void CullBinFrontToBack::
 finish_cull(SceneSetup *, Thread *current_thread) {
   PStatTimer timer(_cull_this_pcollector, current_thread);
-  sort(_objects.begin(), _objects.end());
+  if (CullSortKeys::should_sort_by_key(_objects.size())) {
+    // Sort on the bit patterns of the distances.
+    size_t num_objects = _objects.size();
+    CullSortKeys keys;
+    keys.reserve(num_objects);
+    for (size_t i = 0; i < num_objects; ++i) {
+      keys.add_entry(CullSortKeys::get_distance_key(_objects[i]._dist), i);
+    }
+    keys.sort(sizeof(PN_stdfloat) * 8);
+    keys.reorder(_objects);
+  } else {
+    sort(_objects.begin(), _objects.end());
+  }
 }
 
 /**
@@ -12,6 +12,7 @@
  */
 
 #include "cullBinStateSorted.h"
+#include "cullSortKeys.h"
 #include "graphicsStateGuardianBase.h"
 #include "cullableObject.h"
 #include "cullHandler.h"
@@ -59,10 +60,106 @@ add_object(CullableObject *object, Thread *current_thread) {
 void CullBinStateSorted::
 finish_cull(SceneSetup *, Thread *current_thread) {
   PStatTimer timer(_cull_this_pcollector, current_thread);
-  sort(_objects.begin(), _objects.end());
+  if (!CullSortKeys::should_sort_by_key(_objects.size()) || !sort_by_key()) {
+    sort(_objects.begin(), _objects.end());
+  }
 }
 
 
+/**
+ * Sorts the objects into the order defined by ObjectData::operator <, without
+ * calling it.  Each of the four values compared by operator < is replaced by
+ * its rank among the distinct values of that kind in the bin, and the four
+ * ranks are packed into a single key, which is radix sorted.
+ *
+ * Returns false, leaving the objects unsorted, if there are too many distinct
+ * values for the ranks to fit into a 64-bit key.
+ */
+bool CullBinStateSorted::
+sort_by_key() {
+  size_t num_objects = _objects.size();
+  CullSortKeys keys;
+  keys.reserve(num_objects);
+
+  // The states are ordered by compare_sort(), which is too expensive to call
+  // for every comparison.  Instead, we only use it to order the distinct
+  // states, of which there are usually far fewer than there are objects.
+  pvector<uint32_t> state_ranks(num_objects);
+  for (size_t i = 0; i < num_objects; ++i) {
+    keys.add_entry(CullSortKeys::get_pointer_key(_objects[i]._object->_state), i);
+  }
+  size_t num_states = keys.rank_keys(state_ranks);
+
+  pvector<const RenderState *> states(num_states);
+  for (size_t n = 0; n < num_objects; ++n) {
+    const CullSortKeys::Entry &entry = keys.get_entry(n);
+    states[entry._key] = _objects[entry._index]._object->_state;
+  }
+
+  pvector<uint32_t> state_order(num_states);
+  for (size_t s = 0; s < num_states; ++s) {
+    state_order[s] = (uint32_t)s;
+  }
+  sort(state_order.begin(), state_order.end(),
+       [&states](uint32_t a, uint32_t b) {
+    return states[a]->compare_sort(*states[b]) < 0;
+  });
+
+  // Distinct states that compare_sort() considers equal get the same rank.
+  pvector<uint32_t> state_sort_ranks(num_states);
+  uint32_t num_state_ranks = 0;
+  for (size_t s = 0; s < num_states; ++s) {
+    if (s == 0 ||
+        states[state_order[s - 1]]->compare_sort(*states[state_order[s]]) != 0) {
+      ++num_state_ranks;
+    }
+    state_sort_ranks[state_order[s]] = num_state_ranks - 1;
+  }
+
+  // The other values are simply ordered by pointer.
+  pvector<uint32_t> format_ranks(num_objects);
+  keys.clear();
+  for (size_t i = 0; i < num_objects; ++i) {
+    keys.add_entry(CullSortKeys::get_pointer_key(_objects[i]._format), i);
+  }
+  size_t num_formats = keys.rank_keys(format_ranks);
+
+  pvector<uint32_t> data_ranks(num_objects);
+  keys.clear();
+  for (size_t i = 0; i < num_objects; ++i) {
+    keys.add_entry(CullSortKeys::get_pointer_key(_objects[i]._object->_munged_data), i);
+  }
+  size_t num_datas = keys.rank_keys(data_ranks);
+
+  pvector<uint32_t> transform_ranks(num_objects);
+  keys.clear();
+  for (size_t i = 0; i < num_objects; ++i) {
+    keys.add_entry(CullSortKeys::get_pointer_key(_objects[i]._object->_internal_transform), i);
+  }
+  size_t num_transforms = keys.rank_keys(transform_ranks);
+
+  int state_bits = CullSortKeys::get_num_bits(num_state_ranks);
+  int format_bits = CullSortKeys::get_num_bits(num_formats);
+  int data_bits = CullSortKeys::get_num_bits(num_datas);
+  int transform_bits = CullSortKeys::get_num_bits(num_transforms);
+  int num_key_bits = state_bits + format_bits + data_bits + transform_bits;
+  if (num_key_bits > 64) {
+    return false;
+  }
+
+  keys.clear();
+  for (size_t i = 0; i < num_objects; ++i) {
+    uint64_t key = state_sort_ranks[state_ranks[i]];
+    key = (format_bits != 0) ? ((key << format_bits) | format_ranks[i]) : key;
+    key = (data_bits != 0) ? ((key << data_bits) | data_ranks[i]) : key;
+    key = (transform_bits != 0) ? ((key << transform_bits) | transform_ranks[i]) : key;
+    keys.add_entry(key, i);
+  }
+  keys.sort(num_key_bits);
+  keys.reorder(_objects);
+  return true;
+}
+
 /**
  * Draws all the geoms in the bin, in the appropriate order.
  */
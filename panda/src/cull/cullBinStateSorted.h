@@ -51,6 +51,8 @@ protected:
   virtual void fill_result_graph(ResultGraphBuilder &builder);
 
 private:
+  bool sort_by_key();
+
   class ObjectData {
   public:
     INLINE ObjectData(CullableObject *object);
@@ -0,0 +1,83 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file cullSortKeys.cxx
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#include "cullSortKeys.h"
+
+/**
+ * Sorts the entries in increasing order of key, using a least-significant-
+ * digit radix sort.  Only the lowest num_key_bits bits of each key are
+ * considered.
+ */
+void CullSortKeys::
+sort(int num_key_bits) {
+  size_t num_entries = _entries.size();
+  if (num_entries < 2) {
+    return;
+  }
+
+  _scratch.resize(num_entries);
+  Entry *src = &_entries[0];
+  Entry *dest = &_scratch[0];
+
+  for (int shift = 0; shift < num_key_bits; shift += 8) {
+    size_t counts[256];
+    memset(counts, 0, sizeof(counts));
+    for (size_t i = 0; i < num_entries; ++i) {
+      ++counts[(src[i]._key >> shift) & 0xff];
+    }
+
+    if (counts[(src[0]._key >> shift) & 0xff] == num_entries) {
+      // All of the keys have the same value in this digit.
+      continue;
+    }
+
+    size_t offset = 0;
+    for (int d = 0; d < 256; ++d) {
+      size_t count = counts[d];
+      counts[d] = offset;
+      offset += count;
+    }
+
+    for (size_t i = 0; i < num_entries; ++i) {
+      dest[counts[(src[i]._key >> shift) & 0xff]++] = src[i];
+    }
+    std::swap(src, dest);
+  }
+
+  if (src != &_entries[0]) {
+    _entries.swap(_scratch);
+  }
+}
+
+/**
+ * Sorts the entries, then replaces each key with its rank among the distinct
+ * keys: the smallest key becomes 0, the next smallest 1, and so on.  The rank
+ * of each entry is also stored in ranks, indexed by the entry's object index,
+ * which must be less than ranks.size().  Returns the number of distinct keys.
+ */
+size_t CullSortKeys::
+rank_keys(pvector<uint32_t> &ranks) {
+  sort();
+
+  size_t num_ranks = 0;
+  uint64_t last_key = 0;
+  for (Entry &entry : _entries) {
+    if (num_ranks == 0 || entry._key != last_key) {
+      last_key = entry._key;
+      ++num_ranks;
+    }
+    entry._key = num_ranks - 1;
+    ranks[entry._index] = (uint32_t)(num_ranks - 1);
+  }
+  return num_ranks;
+}
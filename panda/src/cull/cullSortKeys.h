@@ -0,0 +1,67 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file cullSortKeys.h
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#ifndef CULLSORTKEYS_H
+#define CULLSORTKEYS_H
+
+#include "pandabase.h"
+#include "pvector.h"
+#include "numeric_types.h"
+#include "config_cull.h"
+
+/**
+ * An array of integer sort keys, each associated with the index of an object
+ * in a CullBin, which can be sorted with a radix sort.  This is used by the
+ * sorting CullBins to order their objects without calling a comparison
+ * function O(n log n) times.
+ *
+ * The sort is stable: entries with equal keys remain in the order in which
+ * they were added.
+ */
+class EXPCL_PANDA_CULL CullSortKeys {
+public:
+  class Entry {
+  public:
+    uint64_t _key;
+    size_t _index;
+  };
+  typedef pvector<Entry> Entries;
+
+  INLINE void clear();
+  INLINE void reserve(size_t num_entries);
+  INLINE void add_entry(uint64_t key, size_t index);
+
+  INLINE size_t get_num_entries() const;
+  INLINE const Entry &get_entry(size_t n) const;
+
+  void sort(int num_key_bits = 64);
+  size_t rank_keys(pvector<uint32_t> &ranks);
+
+  template<class Vector>
+  INLINE void reorder(Vector &objects) const;
+
+  INLINE static bool should_sort_by_key(size_t num_objects);
+
+  INLINE static uint64_t get_pointer_key(const void *ptr);
+  INLINE static uint64_t get_distance_key(float distance);
+  INLINE static uint64_t get_distance_key(double distance);
+  INLINE static int get_num_bits(size_t num_values);
+
+private:
+  Entries _entries;
+  Entries _scratch;
+};
+
+#include "cullSortKeys.I"
+
+#endif
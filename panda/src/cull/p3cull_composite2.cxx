@@ -1,4 +1,5 @@
 #include "cullBinFrontToBack.cxx"
 #include "cullBinStateSorted.cxx"
 #include "cullBinUnsorted.cxx"
+#include "cullSortKeys.cxx"
 #include "drawCullHandler.cxx"
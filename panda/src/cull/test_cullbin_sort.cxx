@@ -0,0 +1,169 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_cullbin_sort.cxx
+ * @author agent
+ * @date 2026-10-16
+ */
+
+/**
+ * A microbenchmark comparing the time CullBinStateSorted::finish_cull() takes
+ * with cull-bin-key-sort enabled and disabled, and likewise the radix sort of
+ * CullSortKeys against std::sort for the distances in the depth-sorted bins.
+ *
+ * Usage: test_cullbin_sort [num_objects [num_states [num_iterations]]]
+ */
+
+#include "config_cull.h"
+#include "cullBinStateSorted.h"
+#include "cullSortKeys.h"
+#include "cullableObject.h"
+#include "colorAttrib.h"
+#include "renderState.h"
+#include "transformState.h"
+#include "geomVertexData.h"
+#include "geomVertexFormat.h"
+#include "geomTriangles.h"
+#include "geom.h"
+#include "trueClock.h"
+#include "randomizer.h"
+#include "pStatCollector.h"
+
+#include <algorithm>
+
+using std::cerr;
+
+static PStatCollector bench_pcollector("Bench");
+
+/**
+ * Fills a CullBinStateSorted with copies of the indicated objects, and returns
+ * the time taken by finish_cull().  The resulting order of the objects is
+ * stored in order.
+ */
+static double
+time_state_sorted(const pvector<CullableObject> &objects,
+                  pvector<const TransformState *> &order) {
+  PT(CullBinStateSorted) bin =
+    new CullBinStateSorted("bench", nullptr, bench_pcollector);
+  for (const CullableObject &object : objects) {
+    bin->add_object(new CullableObject(object), Thread::get_current_thread());
+  }
+
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+  bin->finish_cull(nullptr, Thread::get_current_thread());
+  double elapsed = clock->get_short_time() - start;
+
+  // Each object has a unique transform, so the result graph has one child
+  // per object, in the order the bin will draw them.
+  PT(PandaNode) result = bin->make_result_graph();
+  order.clear();
+  for (int i = 0; i < result->get_num_children(); ++i) {
+    order.push_back(result->get_child(i)->get_transform());
+  }
+
+  return elapsed;
+}
+
+int
+main(int argc, char *argv[]) {
+  int num_objects = (argc > 1) ? atoi(argv[1]) : 20000;
+  int num_states = (argc > 2) ? atoi(argv[2]) : 500;
+  int num_iterations = (argc > 3) ? atoi(argv[3]) : 10;
+
+  Randomizer random(1);
+
+  pvector<CPT(RenderState)> states;
+  for (int i = 0; i < num_states; ++i) {
+    states.push_back(RenderState::make(ColorAttrib::make_flat(
+      LColor(random.random_real(1), random.random_real(1), random.random_real(1), 1))));
+  }
+
+  CPT(Geom) geom;
+  pvector<CPT(GeomVertexData)> datas;
+  for (int i = 0; i < 16; ++i) {
+    PT(GeomVertexData) data = new GeomVertexData
+      ("data", GeomVertexFormat::get_v3(), Geom::UH_static);
+    data->unclean_set_num_rows(3);
+    PT(Geom) new_geom = new Geom(data);
+    PT(GeomTriangles) tris = new GeomTriangles(Geom::UH_static);
+    tris->add_next_vertices(3);
+    new_geom->add_primitive(tris);
+    geom = new_geom;
+    datas.push_back(data);
+  }
+
+  pvector<CullableObject> objects;
+  objects.reserve(num_objects);
+  for (int i = 0; i < num_objects; ++i) {
+    CullableObject object(geom, states[random.random_int(num_states)],
+                          TransformState::make_pos(LVecBase3(i, 0, 0)));
+    object._munged_data = datas[random.random_int((int)datas.size())];
+    objects.push_back(object);
+  }
+
+  cerr << num_objects << " objects, " << num_states << " states, "
+       << num_iterations << " iterations\n";
+
+  // First, the state-sorted bin.
+  pvector<const TransformState *> comparator_order, key_order;
+  double comparator_time = 0.0, key_time = 0.0;
+  cull_bin_key_sort_min_objects.set_value(2);
+  for (int n = 0; n < num_iterations; ++n) {
+    cull_bin_key_sort.set_value(false);
+    comparator_time += time_state_sorted(objects, comparator_order);
+    cull_bin_key_sort.set_value(true);
+    key_time += time_state_sorted(objects, key_order);
+  }
+
+  cerr << "CullBinStateSorted::finish_cull():\n"
+       << "  comparator sort: " << comparator_time * 1000.0 / num_iterations << " ms\n"
+       << "  key sort:        " << key_time * 1000.0 / num_iterations << " ms\n";
+  if (comparator_order != key_order) {
+    cerr << "  ERROR: the two sorts produced different orders!\n";
+    return 1;
+  }
+
+  // Now the distances used by the depth-sorted bins.
+  pvector<PN_stdfloat> distances;
+  distances.reserve(num_objects);
+  for (int i = 0; i < num_objects; ++i) {
+    distances.push_back((PN_stdfloat)random.random_real(1000.0) - 10.0f);
+  }
+
+  TrueClock *clock = TrueClock::get_global_ptr();
+  comparator_time = 0.0;
+  key_time = 0.0;
+  for (int n = 0; n < num_iterations; ++n) {
+    pvector<PN_stdfloat> sorted(distances);
+    double start = clock->get_short_time();
+    std::sort(sorted.begin(), sorted.end());
+    comparator_time += clock->get_short_time() - start;
+
+    pvector<PN_stdfloat> reordered(distances);
+    start = clock->get_short_time();
+    CullSortKeys keys;
+    keys.reserve(num_objects);
+    for (int i = 0; i < num_objects; ++i) {
+      keys.add_entry(CullSortKeys::get_distance_key(distances[i]), i);
+    }
+    keys.sort(sizeof(PN_stdfloat) * 8);
+    keys.reorder(reordered);
+    key_time += clock->get_short_time() - start;
+
+    if (sorted != reordered) {
+      cerr << "  ERROR: the two distance sorts produced different orders!\n";
+      return 1;
+    }
+  }
+
+  cerr << "Depth sort:\n"
+       << "  comparator sort: " << comparator_time * 1000.0 / num_iterations << " ms\n"
+       << "  key sort:        " << key_time * 1000.0 / num_iterations << " ms\n";
+  return 0;
+}
@@ -49,6 +49,7 @@
 #include "callbackGraphicsWindow.h"
 #include "depthTestAttrib.h"
 #include "unionBoundingVolume.h"
+#include "jobGroup.h"
 
 #if defined(_WIN32) && defined(HAVE_THREADS) && defined(SIMPLE_THREADS)
 #include "winInputDeviceManager.h"
@@ -159,6 +160,11 @@ GraphicsEngine(Pipeline *pipeline) :
     _pipeline = Pipeline::get_render_pipeline();
   }
 
+#ifdef THREADED_PIPELINE
+  // Let a large pipeline cycle be split across the job pool.
+  _pipeline->set_run_jobs_func(&run_pipeline_jobs);
+#endif
+
   _windows_sorted = true;
   _window_sort_index = 0;
 
@@ -2413,6 +2419,20 @@ pstats_count_dirty_cycler_type(TypeHandle type, int count, void *data) {
 }
 #endif // DO_PSTATS
 
+#ifdef THREADED_PIPELINE
+/**
+ * A callback function for Pipeline::cycle() to run the jobs of a large cycle
+ * on the shared JobGroup pool.
+ */
+void GraphicsEngine::
+run_pipeline_jobs(size_t num_jobs, void (*function)(size_t, void *),
+                  void *data) {
+  JobGroup jobs(num_jobs, function, data);
+  jobs.start();
+  jobs.wait();
+}
+#endif  // THREADED_PIPELINE
+
 /**
  * Returns a RenderState for inverting the sense of polygon vertex ordering:
  * if the scene graph specifies a clockwise ordering, this changes it to
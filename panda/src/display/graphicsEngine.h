@@ -185,6 +185,12 @@ private:
   static void pstats_count_dirty_cycler_type(TypeHandle type, int count, void *data);
 #endif  // DO_PSTATS
 
+#ifdef THREADED_PIPELINE
+  static void run_pipeline_jobs(size_t num_jobs,
+                                void (*function)(size_t, void *),
+                                void *data);
+#endif  // THREADED_PIPELINE
+
   static const RenderState *get_invert_polygon_state();
 
   // The WindowRenderer class records the stages of the pipeline that each
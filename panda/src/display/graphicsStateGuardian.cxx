@@ -301,11 +301,15 @@ GraphicsStateGuardian::
   // Note that if uniquify-states is false, we can't iterate over all the
   // states, and some GSGs will linger.  Let's hope this isn't a problem.
   LightReMutexHolder holder(*RenderState::_states_lock);
-  size_t size = RenderState::_states.get_num_entries();
-  for (size_t si = 0; si < size; ++si) {
-    const RenderState *state = RenderState::_states.get_key(si);
-    state->_mungers.remove(_id);
-    state->_munged_states.remove(_id);
+  RenderState::States::Holder shards_holder(*RenderState::_states);
+  for (size_t n = 0; n < RenderState::States::num_shards; ++n) {
+    const RenderState::StateTable &states = (*RenderState::_states)[n]._table;
+    size_t size = states.get_num_entries();
+    for (size_t si = 0; si < size; ++si) {
+      const RenderState *state = states.get_key(si);
+      state->_mungers.remove(_id);
+      state->_munged_states.remove(_id);
+    }
   }
 }
 
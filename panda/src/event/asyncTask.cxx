@@ -73,12 +73,16 @@ bool AsyncTask::
 remove() {
   AsyncTaskManager *manager = _manager;
   if (manager != nullptr) {
+    MutexHolder holder(manager->_lock);
+    if (_chain == nullptr) {
+      // It finished on another thread while we were waiting for the lock.
+      return false;
+    }
     nassertr(_chain->_manager == manager, false);
     if (task_cat.is_debug()) {
       task_cat.debug()
         << "Removing " << *this << "\n";
     }
-    MutexHolder holder(manager->_lock);
     if (_chain->do_remove(this, true)) {
       return true;
     } else {
@@ -399,6 +403,29 @@ unlock_and_do_task() {
   nassertr(_manager != nullptr, DS_done);
   PT(ClockObject) clock = _manager->get_clock();
 
+  // It's important to release the lock while the task is being serviced.
+  _manager->_lock.unlock();
+
+  double dt;
+  DoneStatus status = do_task_timed(clock, dt);
+
+  // Now reacquire the lock (so we can return with the lock held).
+  _manager->_lock.lock();
+
+  record_dt(dt);
+  return status;
+}
+
+/**
+ * Runs the task, as the current task of the running thread, and stores the
+ * time it took in dt.  This is the part of unlock_and_do_task() that is done
+ * without the lock held; it is also called directly by an AsyncTaskChain in
+ * work-stealing mode, which passes the time to record_dt() later.
+ */
+AsyncTask::DoneStatus AsyncTask::
+do_task_timed(ClockObject *clock, double &dt) {
+  dt = 0.0;
+
   // Indicate that this task is now the current task running on the thread.
   Thread *current_thread = Thread::get_current_thread();
   nassertr(current_thread->_current_task == nullptr, DS_interrupt);
@@ -419,23 +446,11 @@ unlock_and_do_task() {
   nassertr(current_thread->_current_task == this, DS_interrupt);
 #endif  // __GNUC__
 
-  // It's important to release the lock while the task is being serviced.
-  _manager->_lock.unlock();
-
   double start = clock->get_real_time();
   _task_pcollector.start();
   DoneStatus status = do_task();
   _task_pcollector.stop();
-  double end = clock->get_real_time();
-
-  // Now reacquire the lock (so we can return with the lock held).
-  _manager->_lock.lock();
-
-  _dt = end - start;
-  _max_dt = std::max(_dt, _max_dt);
-  _total_dt += _dt;
-
-  _chain->_time_in_frame += _dt;
+  dt = clock->get_real_time() - start;
 
   // Now indicate that this is no longer the current task.
   nassertr(current_thread->_current_task == this, status);
@@ -456,6 +471,19 @@ unlock_and_do_task() {
   return status;
 }
 
+/**
+ * Records the time taken by one run of the task, as measured by
+ * do_task_timed().  Assumes the lock is held.
+ */
+void AsyncTask::
+record_dt(double dt) {
+  _dt = dt;
+  _max_dt = std::max(_dt, _max_dt);
+  _total_dt += _dt;
+
+  _chain->_time_in_frame += _dt;
+}
+
 /**
  * Cancels this task.  This is equivalent to remove().
  */
@@ -23,6 +23,7 @@
 
 class AsyncTaskManager;
 class AsyncTaskChain;
+class ClockObject;
 
 /**
  * This class represents a concrete task performed by an AsyncManager.
@@ -123,6 +124,8 @@ PUBLISHED:
 protected:
   void jump_to_task_chain(AsyncTaskManager *manager);
   DoneStatus unlock_and_do_task();
+  DoneStatus do_task_timed(ClockObject *clock, double &dt);
+  void record_dt(double dt);
 
   virtual bool cancel() final;
   virtual bool is_task() const final {return true;}
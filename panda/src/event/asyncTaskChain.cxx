@@ -15,6 +15,7 @@
 #include "asyncTaskManager.h"
 #include "event.h"
 #include "mutexHolder.h"
+#include "lightMutexHolder.h"
 #include "indent.h"
 #include "pStatClient.h"
 #include "pStatTimer.h"
@@ -33,6 +34,10 @@ TypeHandle AsyncTaskChain::_type_handle;
 PStatCollector AsyncTaskChain::_task_pcollector("Task");
 PStatCollector AsyncTaskChain::_wait_pcollector("Wait");
 
+// In work-stealing mode, this is the maximum number of tasks that a thread
+// will run before it reacquires the lock to record their results.
+static const size_t work_stealing_batch_size = 16;
+
 /**
  *
  */
@@ -43,6 +48,7 @@ AsyncTaskChain(AsyncTaskManager *manager, const string &name) :
   _cvar(manager->_lock),
   _tick_clock(false),
   _timeslice_priority(false),
+  _work_stealing(false),
   _num_threads(0),
   _thread_priority(TP_normal),
   _frame_budget(-1.0),
@@ -57,7 +63,8 @@ AsyncTaskChain(AsyncTaskManager *manager, const string &name) :
   _current_frame(0),
   _time_in_frame(0.0),
   _block_till_next_frame(false),
-  _next_implicit_sort(0)
+  _next_implicit_sort(0),
+  _num_queued(0)
 {
 }
 
@@ -257,6 +264,48 @@ get_timeslice_priority() const {
   return _timeslice_priority;
 }
 
+/**
+ * Sets the work_stealing flag.  When this is true, and the chain has more
+ * than one thread, the tasks of each sort value are divided among queues
+ * owned by the individual threads.  Each thread runs the tasks on its own
+ * queue, and steals tasks from the other threads' queues when its own runs
+ * out.  The threads only acquire the task manager's lock once per batch of
+ * tasks, rather than for each task, which greatly reduces the contention
+ * between the threads when the chain runs many small tasks.
+ *
+ * Tasks with a lower sort value are still all completed before any task with
+ * a higher sort value is started.  However, tasks of the same sort value are
+ * only run in approximately their priority order, and a task that finishes
+ * may not be reported done until the thread has finished its current batch.
+ * The frame budget is only checked between batches.
+ *
+ * This has no effect on a chain with no threads, whose tasks are run by
+ * poll().
+ */
+void AsyncTaskChain::
+set_work_stealing(bool work_stealing) {
+  MutexHolder holder(_manager->_lock);
+  if (_work_stealing != work_stealing) {
+    // The threads must be stopped first, so that any tasks still on their
+    // queues are returned to the active list.
+    do_stop_threads();
+    _work_stealing = work_stealing;
+
+    if (_num_tasks != 0) {
+      do_start_threads();
+    }
+  }
+}
+
+/**
+ * Returns the work_stealing flag.  See set_work_stealing().
+ */
+bool AsyncTaskChain::
+get_work_stealing() const {
+  MutexHolder holder(_manager->_lock);
+  return _work_stealing;
+}
+
 /**
  * Stops any threads that are currently running.  If any tasks are still
  * pending and have not yet been picked up by a thread, they will not be
@@ -471,6 +520,13 @@ bool AsyncTaskChain::
 do_remove(AsyncTask *task, bool upon_death) {
   nassertr(task->_chain == this, false);
 
+  if (remove_queued_task(task)) {
+    // It was waiting on one of the threads' queues.
+    PT(AsyncTask) hold_task = task;
+    cleanup_task(task, upon_death, false);
+    return true;
+  }
+
   switch (task->_state) {
   case AsyncTask::S_servicing:
     // This task is being serviced.  upon_death will be called afterwards.
@@ -621,10 +677,22 @@ do_cleanup() {
  */
 bool AsyncTaskChain::
 do_has_task(AsyncTask *task) const {
-  return (find_task_on_heap(_active, task) != -1 ||
-          find_task_on_heap(_next_active, task) != -1 ||
-          find_task_on_heap(_sleeping, task) != -1 ||
-          find_task_on_heap(_this_active, task) != -1);
+  if (find_task_on_heap(_active, task) != -1 ||
+      find_task_on_heap(_next_active, task) != -1 ||
+      find_task_on_heap(_sleeping, task) != -1 ||
+      find_task_on_heap(_this_active, task) != -1) {
+    return true;
+  }
+
+  if (AtomicAdjust::get(_num_queued) != 0) {
+    for (AsyncTaskChainThread *thread : _threads) {
+      LightMutexHolder holder(thread->_queue_lock);
+      if (std::find(thread->_queue.begin(), thread->_queue.end(), task) != thread->_queue.end()) {
+        return true;
+      }
+    }
+  }
+  return false;
 }
 
 /**
@@ -679,79 +747,191 @@ service_one_task(AsyncTaskChain::AsyncTaskChainThread *thread) {
     }
     task->_servicing_thread = nullptr;
 
-    if (task->_chain == this) {
-      if (task->_state == AsyncTask::S_servicing_removed) {
-        // This task wants to kill itself.
-        cleanup_task(task, true, false);
+    finish_task(task, ds);
 
-      } else if (task->_chain_name != get_name()) {
-        // The task wants to jump to a different chain.
-        PT(AsyncTask) hold_task = task;
-        cleanup_task(task, false, false);
-        task->jump_to_task_chain(_manager);
+    if (task_cat.is_spam()) {
+      task_cat.spam()
+        << "Done servicing " << *task << " in "
+        << *Thread::get_current_thread() << "\n";
+    }
+  }
+  thread_consider_yield();
+}
 
-      } else {
-        switch (ds) {
-        case AsyncTask::DS_cont:
-          // The task is still alive; put it on the next frame's active queue.
-          task->_state = AsyncTask::S_active;
-          _next_active.push_back(task);
-          _cvar.notify_all();
-          break;
-
-        case AsyncTask::DS_again:
-          // The task wants to sleep again.
-          {
-            double now = _manager->_clock->get_frame_time();
-            task->_wake_time = now + task->get_delay();
-            task->_start_time = task->_wake_time;
-            task->_state = AsyncTask::S_sleeping;
-            _sleeping.push_back(task);
-            push_heap(_sleeping.begin(), _sleeping.end(), AsyncTaskSortWakeTime());
-            if (task_cat.is_spam()) {
-              task_cat.spam()
-                << "Sleeping " << *task << ", wake time at "
-                << task->_wake_time - now << "\n";
-            }
-            _cvar.notify_all();
-          }
-          break;
+/**
+ * Called after a task has been serviced, to put it back on the appropriate
+ * queue according to the status it returned, or to clean it up if it is
+ * done.  Assumes the lock is held.
+ *
+ * Note that the lock may be temporarily released by this method.
+ */
+void AsyncTaskChain::
+finish_task(AsyncTask *task, AsyncTask::DoneStatus ds) {
+  if (task->_chain == this) {
+    if (task->_state == AsyncTask::S_servicing_removed) {
+      // This task wants to kill itself.
+      cleanup_task(task, true, false);
+
+    } else if (task->_chain_name != get_name()) {
+      // The task wants to jump to a different chain.
+      PT(AsyncTask) hold_task = task;
+      cleanup_task(task, false, false);
+      task->jump_to_task_chain(_manager);
 
-        case AsyncTask::DS_pickup:
-          // The task wants to run again this frame if possible.
-          task->_state = AsyncTask::S_active;
-          _this_active.push_back(task);
-          _cvar.notify_all();
-          break;
-
-        case AsyncTask::DS_interrupt:
-          // The task had an exception and wants to raise a big flag.
-          task->_state = AsyncTask::S_active;
-          _next_active.push_back(task);
-          if (_state == S_started) {
-            _state = S_interrupted;
-            _cvar.notify_all();
+    } else {
+      switch (ds) {
+      case AsyncTask::DS_cont:
+        // The task is still alive; put it on the next frame's active queue.
+        task->_state = AsyncTask::S_active;
+        _next_active.push_back(task);
+        _cvar.notify_all();
+        break;
+
+      case AsyncTask::DS_again:
+        // The task wants to sleep again.
+        {
+          double now = _manager->_clock->get_frame_time();
+          task->_wake_time = now + task->get_delay();
+          task->_start_time = task->_wake_time;
+          task->_state = AsyncTask::S_sleeping;
+          _sleeping.push_back(task);
+          push_heap(_sleeping.begin(), _sleeping.end(), AsyncTaskSortWakeTime());
+          if (task_cat.is_spam()) {
+            task_cat.spam()
+              << "Sleeping " << *task << ", wake time at "
+              << task->_wake_time - now << "\n";
           }
-          break;
-
-        case AsyncTask::DS_await:
-          // The task wants to wait for another one to finish.
-          task->_state = AsyncTask::S_awaiting;
           _cvar.notify_all();
-          ++_num_awaiting_tasks;
-          break;
-
-        default:
-          // The task has finished.
-          cleanup_task(task, true, true);
         }
+        break;
+
+      case AsyncTask::DS_pickup:
+        // The task wants to run again this frame if possible.
+        task->_state = AsyncTask::S_active;
+        _this_active.push_back(task);
+        _cvar.notify_all();
+        break;
+
+      case AsyncTask::DS_interrupt:
+        // The task had an exception and wants to raise a big flag.
+        task->_state = AsyncTask::S_active;
+        _next_active.push_back(task);
+        if (_state == S_started) {
+          _state = S_interrupted;
+          _cvar.notify_all();
+        }
+        break;
+
+      case AsyncTask::DS_await:
+        // The task wants to wait for another one to finish.
+        task->_state = AsyncTask::S_awaiting;
+        _cvar.notify_all();
+        ++_num_awaiting_tasks;
+        break;
+
+      default:
+        // The task has finished.
+        cleanup_task(task, true, true);
       }
-    } else {
-      task_cat.error()
-        << "Task is no longer on chain " << get_name()
-        << ": " << *task << "\n";
+    }
+  } else {
+    task_cat.error()
+      << "Task is no longer on chain " << get_name()
+      << ": " << *task << "\n";
+  }
+}
+
+/**
+ * Moves all of the tasks of the current sort value from the active queue to
+ * the threads' own queues, in work-stealing mode.  The tasks are dealt out in
+ * priority order, so that each thread's queue is in priority order as well.
+ * Assumes the lock is held.
+ */
+void AsyncTaskChain::
+distribute_sort_group() {
+  size_t num_threads = _threads.size();
+  nassertv(num_threads != 0);
+
+  size_t ti = 0;
+  while (!_active.empty() && _active.front()->get_sort() == _current_sort) {
+    PT(AsyncTask) task = _active.front();
+    pop_heap(_active.begin(), _active.end(), AsyncTaskSortPriority());
+    _active.pop_back();
+
+    AsyncTaskChainThread *thread = _threads[ti];
+    ti = (ti + 1) % num_threads;
+    {
+      LightMutexHolder holder(thread->_queue_lock);
+      thread->_queue.push_back(std::move(task));
+    }
+    AtomicAdjust::inc(_num_queued);
+  }
+
+  _cvar.notify_all();
+}
+
+/**
+ * Runs a batch of the tasks on the indicated thread's queue, or stolen from
+ * the other threads' queues, in work-stealing mode.  This is the
+ * work-stealing equivalent of service_one_task().  Assumes the lock is
+ * already held.
+ *
+ * The lock is released while the tasks are run, and reacquired only once
+ * the whole batch has run, to put the tasks back on the appropriate queues.
+ */
+void AsyncTaskChain::
+service_queued_tasks(AsyncTaskChain::AsyncTaskChainThread *thread) {
+  if (!_active.empty() && _active.front()->get_sort() == _current_sort) {
+    distribute_sort_group();
+  }
+
+  // Make a list of the other threads, to steal from once our own queue is
+  // empty.  Each thread starts with a different neighbor, so that they don't
+  // all try to steal from the same thread.
+  pvector<AsyncTaskChainThread *> &victims = thread->_victims;
+  victims.clear();
+  size_t num_threads = _threads.size();
+  size_t self = std::find(_threads.begin(), _threads.end(), thread) - _threads.begin();
+  for (size_t i = 1; i < num_threads; ++i) {
+    victims.push_back(_threads[(self + i) % num_threads]);
+  }
+
+  PT(ClockObject) clock = _manager->get_clock();
+
+  struct Serviced {
+    PT(AsyncTask) _task;
+    AsyncTask::DoneStatus _ds;
+    double _dt;
+  };
+  Serviced batch[work_stealing_batch_size];
+  size_t num_serviced = 0;
+
+  _manager->_lock.unlock();
+  while (num_serviced < work_stealing_batch_size) {
+    PT(AsyncTask) task = claim_queued_task(thread);
+    if (task == nullptr) {
+      break;
     }
 
+    if (task_cat.is_spam()) {
+      task_cat.spam()
+        << "Servicing " << *task << " in "
+        << *Thread::get_current_thread() << "\n";
+    }
+
+    Serviced &serviced = batch[num_serviced++];
+    serviced._task = task;
+    serviced._ds = task->do_task_timed(clock, serviced._dt);
+  }
+  _manager->_lock.lock();
+
+  thread->_servicing = nullptr;
+  for (size_t i = 0; i < num_serviced; ++i) {
+    AsyncTask *task = batch[i]._task;
+    task->_servicing_thread = nullptr;
+    task->record_dt(batch[i]._dt);
+    finish_task(task, batch[i]._ds);
+
     if (task_cat.is_spam()) {
       task_cat.spam()
         << "Done servicing " << *task << " in "
@@ -761,6 +941,93 @@ service_one_task(AsyncTaskChain::AsyncTaskChainThread *thread) {
   thread_consider_yield();
 }
 
+/**
+ * Takes the next task off the indicated thread's queue, or, if that is
+ * empty, off the end of another thread's queue, and marks it as being
+ * serviced by the thread.  Returns nullptr if all of the queues are empty.
+ *
+ * This is called without the lock held.
+ */
+PT(AsyncTask) AsyncTaskChain::
+claim_queued_task(AsyncTaskChain::AsyncTaskChainThread *thread) {
+  PT(AsyncTask) task;
+  {
+    LightMutexHolder holder(thread->_queue_lock);
+    if (!thread->_queue.empty()) {
+      task = std::move(thread->_queue.front());
+      thread->_queue.pop_front();
+    }
+  }
+
+  if (task == nullptr) {
+    // Our own queue is empty.  Steal the lowest-priority task from another
+    // thread, which will be the last one it would have gotten around to.
+    for (AsyncTaskChainThread *victim : thread->_victims) {
+      if (AtomicAdjust::get(_num_queued) == 0) {
+        return nullptr;
+      }
+      LightMutexHolder holder(victim->_queue_lock);
+      if (!victim->_queue.empty()) {
+        task = std::move(victim->_queue.back());
+        victim->_queue.pop_back();
+        break;
+      }
+    }
+    if (task == nullptr) {
+      return nullptr;
+    }
+  }
+
+  AtomicAdjust::dec(_num_queued);
+
+  nassertr(task->_state == AsyncTask::S_active, task);
+  task->_state = AsyncTask::S_servicing;
+  task->_servicing_thread = thread;
+  thread->_servicing = task;
+  return task;
+}
+
+/**
+ * If the indicated task is waiting on one of the threads' queues in
+ * work-stealing mode, removes it from the queue and returns true.  Returns
+ * false if the task is not on any queue.  Assumes the lock is held.
+ */
+bool AsyncTaskChain::
+remove_queued_task(AsyncTask *task) {
+  if (AtomicAdjust::get(_num_queued) == 0 ||
+      task->_state != AsyncTask::S_active) {
+    return false;
+  }
+
+  for (AsyncTaskChainThread *thread : _threads) {
+    LightMutexHolder holder(thread->_queue_lock);
+    auto it = std::find(thread->_queue.begin(), thread->_queue.end(), task);
+    if (it != thread->_queue.end()) {
+      thread->_queue.erase(it);
+      AtomicAdjust::dec(_num_queued);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * Moves any tasks left on the queues of the indicated threads, which must no
+ * longer be running, back onto the active queue.  Assumes the lock is held.
+ */
+void AsyncTaskChain::
+return_queued_tasks(const AsyncTaskChain::Threads &threads) {
+  for (AsyncTaskChainThread *thread : threads) {
+    for (AsyncTask *task : thread->_queue) {
+      _active.push_back(task);
+      AtomicAdjust::dec(_num_queued);
+    }
+    thread->_queue.clear();
+  }
+  make_heap(_active.begin(), _active.end(), AsyncTaskSortPriority());
+}
+
 /**
  * Called internally when a task has completed (or been interrupted) and is
  * about to be removed from the active queue.  Assumes the lock is held.
@@ -812,6 +1079,7 @@ cleanup_task(AsyncTask *task, bool upon_death, bool clean_exit) {
 bool AsyncTaskChain::
 finish_sort_group() {
   nassertr(_num_busy_threads == 0, true);
+  nassertr(AtomicAdjust::get(_num_queued) == 0, true);
 
   if (!_threads.empty()) {
     PStatClient::thread_tick(get_name());
@@ -1052,6 +1320,10 @@ do_stop_threads() {
     }
     _manager->_lock.lock();
 
+    // Any tasks that the threads didn't get to in work-stealing mode go back
+    // on the active queue.
+    return_queued_tasks(wait_threads);
+
     _state = S_initial;
 
     // There might be one busy "thread" still: the main thread.
@@ -1106,6 +1378,10 @@ do_get_active_tasks() const {
     if (task != nullptr) {
       result.add_task(task);
     }
+    LightMutexHolder holder((*thi)->_queue_lock);
+    for (AsyncTask *queued : (*thi)->_queue) {
+      result.add_task(queued);
+    }
   }
   TaskHeap::const_iterator ti;
   for (ti = _active.begin(); ti != _active.end(); ++ti) {
@@ -1265,6 +1541,10 @@ do_write(ostream &out, int indent_level) const {
     indent(out, indent_level + 2)
       << "tick clock\n";
   }
+  if (_work_stealing) {
+    indent(out, indent_level + 2)
+      << "work stealing\n";
+  }
 
   static const size_t buffer_size = 1024;
   char buffer[buffer_size];
@@ -1295,6 +1575,8 @@ do_write(ostream &out, int indent_level) const {
     if (task != nullptr) {
       tasks.push_back(task);
     }
+    LightMutexHolder holder((*thi)->_queue_lock);
+    tasks.insert(tasks.end(), (*thi)->_queue.begin(), (*thi)->_queue.end());
   }
 
   double now = _manager->_clock->get_frame_time();
@@ -1395,8 +1677,9 @@ thread_main() {
   MutexHolder holder(_chain->_manager->_lock);
   while (_chain->_state != S_shutdown && _chain->_state != S_interrupted) {
     thread_consider_yield();
-    if (!_chain->_active.empty() &&
-        _chain->_active.front()->get_sort() == _chain->_current_sort) {
+    if ((!_chain->_active.empty() &&
+         _chain->_active.front()->get_sort() == _chain->_current_sort) ||
+        AtomicAdjust::get(_chain->_num_queued) != 0) {
 
       int frame = _chain->_manager->_clock->get_frame_count();
       if (_chain->_current_frame != frame) {
@@ -1426,7 +1709,11 @@ thread_main() {
 
       PStatTimer timer(_task_pcollector);
       _chain->_num_busy_threads++;
-      _chain->service_one_task(this);
+      if (_chain->_work_stealing) {
+        _chain->service_queued_tasks(this);
+      } else {
+        _chain->service_one_task(this);
+      }
       _chain->_num_busy_threads--;
       _chain->_cvar.notify_all();
 
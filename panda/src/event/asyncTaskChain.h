@@ -25,6 +25,8 @@
 #include "pdeque.h"
 #include "pStatCollector.h"
 #include "clockObject.h"
+#include "lightMutex.h"
+#include "atomicAdjust.h"
 
 class AsyncTaskManager;
 
@@ -46,6 +48,12 @@ class AsyncTaskManager;
  * parallelism.  Tasks with different sort values are never run in parallel
  * together, but tasks with different priority values might be (if there is
  * more than one thread).
+ *
+ * In work-stealing mode, each thread of the chain keeps its own queue of the
+ * tasks of the current sort value.  The threads run the tasks on their own
+ * queues, and those they steal from the other threads' queues once their own
+ * are empty, in batches, without contending for the task manager's lock for
+ * each task.  Sort values are still honored as in the normal mode.
  */
 class EXPCL_PANDA_EVENT AsyncTaskChain : public TypedReferenceCount, public Namable {
 public:
@@ -72,6 +80,9 @@ PUBLISHED:
   void set_timeslice_priority(bool timeslice_priority);
   bool get_timeslice_priority() const;
 
+  BLOCKING void set_work_stealing(bool work_stealing);
+  bool get_work_stealing() const;
+
   BLOCKING void stop_threads();
   void start_threads();
   INLINE bool is_started() const;
@@ -104,6 +115,12 @@ protected:
   int find_task_on_heap(const TaskHeap &heap, AsyncTask *task) const;
 
   void service_one_task(AsyncTaskChainThread *thread);
+  void finish_task(AsyncTask *task, AsyncTask::DoneStatus ds);
+  void distribute_sort_group();
+  void service_queued_tasks(AsyncTaskChainThread *thread);
+  PT(AsyncTask) claim_queued_task(AsyncTaskChainThread *thread);
+  bool remove_queued_task(AsyncTask *task);
+  void return_queued_tasks(const pvector< PT(AsyncTaskChainThread) > &threads);
   void cleanup_task(AsyncTask *task, bool upon_death, bool clean_exit);
   bool finish_sort_group();
   void filter_timeslice_priority();
@@ -128,6 +145,11 @@ protected:
 
     AsyncTaskChain *_chain;
     AsyncTask *_servicing;
+
+    // These are used only in work-stealing mode.
+    LightMutex _queue_lock;
+    pdeque< PT(AsyncTask) > _queue;
+    pvector<AsyncTaskChainThread *> _victims;
   };
 
   class AsyncTaskSortWakeTime {
@@ -170,6 +192,7 @@ protected:
 
   bool _tick_clock;
   bool _timeslice_priority;
+  bool _work_stealing;
   int _num_threads;
   ThreadPriority _thread_priority;
   Threads _threads;
@@ -193,6 +216,9 @@ protected:
 
   unsigned int _next_implicit_sort;
 
+  // The number of tasks on the threads' queues in work-stealing mode.
+  AtomicAdjust::Integer _num_queued;
+
   static PStatCollector _task_pcollector;
   static PStatCollector _wait_pcollector;
 
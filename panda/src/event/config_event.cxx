@@ -23,6 +23,8 @@
 #include "eventHandler.h"
 #include "eventParameter.h"
 #include "genericAsyncTask.h"
+#include "jobGroup.h"
+#include "bamReader.h"
 #include "pointerEventList.h"
 
 #include "dconfig.h"
@@ -35,6 +37,27 @@ Configure(config_event);
 NotifyCategoryDef(event, "");
 NotifyCategoryDef(task, "");
 
+ConfigVariableInt job_pool_threads
+("job-pool-threads", -1,
+ PRC_DESC("The number of threads in the pool that runs the jobs of the "
+          "engine's internal parallel loops, such as those started with "
+          "parallel_for().  The thread that waits on the jobs also runs "
+          "them, so the default of -1 creates one fewer thread than there "
+          "are CPUs.  Set this to 0 to run all of the jobs serially in the "
+          "waiting thread.  This is read only once, when the pool is first "
+          "needed."));
+
+/**
+ * Runs a batch of the BamReader's deferred decoding jobs on the job pool.
+ */
+static void
+run_bam_decode_jobs(size_t num_jobs, BamReader::DecodeIndexFunc *function,
+                    void *data) {
+  JobGroup group(num_jobs, function, data);
+  group.start();
+  group.wait();
+}
+
 ConfigureFn(config_event) {
   AsyncFuture::init_type();
   AsyncGatheringFuture::init_type();
@@ -54,4 +77,6 @@ ConfigureFn(config_event) {
   ButtonEventList::register_with_read_factory();
   EventStoreInt::register_with_read_factory();
   EventStoreDouble::register_with_read_factory();
+
+  BamReader::set_decode_runner(&run_bam_decode_jobs);
 }
@@ -0,0 +1,209 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file jobGroup.cxx
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#include "jobGroup.h"
+#include "config_event.h"
+#include "genericAsyncTask.h"
+#include "asyncTaskChain.h"
+#include "mutexHolder.h"
+#include "pStatTimer.h"
+
+#include <thread>
+
+Mutex JobGroup::_manager_lock("JobGroup::_manager_lock");
+AsyncTaskManager *JobGroup::_manager = nullptr;
+AtomicAdjust::Integer JobGroup::_num_threads = -1;
+
+PStatCollector JobGroup::_jobs_pcollector("Jobs");
+PStatCollector JobGroup::_wait_pcollector("Wait:Jobs");
+
+/**
+ * Creates an empty group.  Use add_job() to fill it.
+ */
+JobGroup::
+JobGroup() :
+  _num_jobs(0),
+  _index_function(nullptr),
+  _index_data(nullptr),
+  _next_job(0),
+  _started(false)
+{
+}
+
+/**
+ * Creates a group of num_jobs jobs, each of which calls the indicated
+ * function with its index and the data pointer.
+ */
+JobGroup::
+JobGroup(size_t num_jobs, IndexFunc *function, void *data) :
+  _num_jobs(num_jobs),
+  _index_function(function),
+  _index_data(data),
+  _next_job(0),
+  _started(false)
+{
+}
+
+/**
+ * Waits for any jobs that are still running.
+ */
+JobGroup::
+~JobGroup() {
+  if (_started) {
+    wait();
+  }
+}
+
+/**
+ * Adds a job to the group, which will call the indicated function with the
+ * data pointer.  It is not legal to add jobs once the group has been
+ * started, or to a group that was constructed with an index function.
+ */
+void JobGroup::
+add_job(JobFunc *function, void *data) {
+  nassertv(!_started && _index_function == nullptr);
+  Job job;
+  job._function = function;
+  job._data = data;
+  _jobs.push_back(job);
+  _num_jobs = _jobs.size();
+}
+
+/**
+ * Hands the group's jobs to the pool's threads, which begin running them
+ * immediately.  The calling thread may then do other work before it calls
+ * wait().  It is not necessary to call this explicitly; wait() does it if
+ * needed.
+ */
+void JobGroup::
+start(Thread *current_thread) {
+  if (_started) {
+    return;
+  }
+  _started = true;
+
+  // The calling thread will run jobs too, so one fewer helper is needed than
+  // there are jobs.
+  size_t num_tasks = std::min((size_t)get_num_threads(), _num_jobs);
+  if (num_tasks > 0) {
+    --num_tasks;
+  }
+  if (num_tasks == 0) {
+    return;
+  }
+
+  AsyncTaskManager *manager = get_manager();
+  _tasks.reserve(num_tasks);
+  for (size_t i = 0; i < num_tasks; ++i) {
+    PT(GenericAsyncTask) task = new GenericAsyncTask("job", &st_run_jobs, this);
+    task->set_task_chain("jobs");
+    manager->add(task);
+    _tasks.push_back(task);
+  }
+}
+
+/**
+ * Runs the jobs that have not yet been claimed by the pool in the calling
+ * thread, then waits for all of the jobs to finish.  Starts the group first
+ * if it has not already been started.
+ */
+void JobGroup::
+wait(Thread *current_thread) {
+  start(current_thread);
+  run_jobs();
+
+  if (!_tasks.empty()) {
+    PStatTimer timer(_wait_pcollector, current_thread);
+
+    // There is no more work left to claim.  Any helper that hasn't started
+    // yet would have nothing to do, so take it off the queue rather than
+    // waiting for a pool thread to come around to it; this also keeps a
+    // JobGroup waited on from within a job from deadlocking the pool.
+    for (AsyncTask *task : _tasks) {
+      task->remove();
+    }
+    for (AsyncTask *task : _tasks) {
+      task->wait();
+    }
+    _tasks.clear();
+  }
+}
+
+/**
+ * Returns the number of threads in the pool that runs the jobs of all
+ * JobGroups, according to job-pool-threads.  This is 0 if the jobs are all
+ * run in the thread that waits on them.
+ */
+int JobGroup::
+get_num_threads() {
+  int num_threads = (int)AtomicAdjust::get(_num_threads);
+  if (num_threads < 0) {
+    num_threads = job_pool_threads;
+    if (num_threads < 0) {
+      // Use all of the CPUs, counting the thread that calls wait().
+      num_threads = (int)std::thread::hardware_concurrency() - 1;
+    }
+    if (!Thread::is_true_threads()) {
+      num_threads = 0;
+    }
+    num_threads = std::max(num_threads, 0);
+    AtomicAdjust::set(_num_threads, num_threads);
+  }
+  return num_threads;
+}
+
+/**
+ * Repeatedly claims the next unclaimed job and runs it, until there are no
+ * more jobs.  This is called by each of the threads working on the group.
+ */
+void JobGroup::
+run_jobs() {
+  while (true) {
+    size_t index = (size_t)(AtomicAdjust::add(_next_job, 1) - 1);
+    if (index >= _num_jobs) {
+      break;
+    }
+    if (_index_function != nullptr) {
+      (*_index_function)(index, _index_data);
+    } else {
+      const Job &job = _jobs[index];
+      (*job._function)(job._data);
+    }
+  }
+}
+
+/**
+ * The task function for the pool threads.
+ */
+AsyncTask::DoneStatus JobGroup::
+st_run_jobs(GenericAsyncTask *task, void *data) {
+  PStatTimer timer(_jobs_pcollector);
+  ((JobGroup *)data)->run_jobs();
+  return AsyncTask::DS_done;
+}
+
+/**
+ * Returns the task manager that owns the pool's threads, creating it on first
+ * use.
+ */
+AsyncTaskManager *JobGroup::
+get_manager() {
+  MutexHolder holder(_manager_lock);
+  if (_manager == nullptr) {
+    _manager = new AsyncTaskManager("JobGroup");
+    _manager->ref();
+    AsyncTaskChain *chain = _manager->make_task_chain("jobs");
+    chain->set_num_threads(get_num_threads());
+  }
+  return _manager;
+}
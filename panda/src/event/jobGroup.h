@@ -0,0 +1,93 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file jobGroup.h
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#ifndef JOBGROUP_H
+#define JOBGROUP_H
+
+#include "pandabase.h"
+
+#include "asyncTask.h"
+#include "asyncTaskManager.h"
+#include "atomicAdjust.h"
+#include "pStatCollector.h"
+#include "pmutex.h"
+
+class GenericAsyncTask;
+
+/**
+ * A set of short jobs that may be run in parallel on a shared pool of
+ * threads, for data parallelism within the engine.  The jobs are added to
+ * the group, then start() hands them to the pool, and wait() runs whichever
+ * jobs the pool has not yet gotten to in the calling thread, then waits for
+ * the rest to finish.  The jobs may be run in any order.
+ *
+ * The pool's threads belong to a private AsyncTaskManager, whose size is
+ * controlled by job-pool-threads.  If there are no pool threads, or the
+ * threading model does not provide true threads, all of the jobs are simply
+ * run in the thread that calls wait().
+ *
+ * Also see parallel_for(), which is built on this class.
+ */
+class EXPCL_PANDA_EVENT JobGroup {
+public:
+  typedef void JobFunc(void *data);
+  typedef void IndexFunc(size_t index, void *data);
+
+  JobGroup();
+  JobGroup(size_t num_jobs, IndexFunc *function, void *data);
+  JobGroup(const JobGroup &copy) = delete;
+  ~JobGroup();
+
+  JobGroup &operator = (const JobGroup &copy) = delete;
+
+  void add_job(JobFunc *function, void *data);
+  INLINE size_t get_num_jobs() const;
+
+  void start(Thread *current_thread = Thread::get_current_thread());
+  void wait(Thread *current_thread = Thread::get_current_thread());
+
+  static int get_num_threads();
+
+private:
+  void run_jobs();
+  static AsyncTask::DoneStatus st_run_jobs(GenericAsyncTask *task, void *data);
+  static AsyncTaskManager *get_manager();
+
+private:
+  class Job {
+  public:
+    JobFunc *_function;
+    void *_data;
+  };
+  typedef pvector<Job> Jobs;
+  Jobs _jobs;
+
+  size_t _num_jobs;
+  IndexFunc *_index_function;
+  void *_index_data;
+
+  AtomicAdjust::Integer _next_job;
+  pvector<PT(AsyncTask)> _tasks;
+  bool _started;
+
+  static Mutex _manager_lock;
+  static AsyncTaskManager *_manager;
+  static AtomicAdjust::Integer _num_threads;
+
+  static PStatCollector _jobs_pcollector;
+  static PStatCollector _wait_pcollector;
+};
+
+#include "jobGroup.I"
+
+#endif
@@ -8,5 +8,6 @@
 #include "buttonEvent.cxx"
 #include "buttonEventList.cxx"
 #include "genericAsyncTask.cxx"
+#include "jobGroup.cxx"
 #include "pointerEvent.cxx"
 #include "pointerEventList.cxx"
@@ -0,0 +1,58 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file parallelFor.h
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#ifndef PARALLELFOR_H
+#define PARALLELFOR_H
+
+#include "pandabase.h"
+
+#include "jobGroup.h"
+
+// parallel_for() divides the range [begin, end) into chunks of grain
+// elements, and calls func(chunk_begin, chunk_end) once for each chunk,
+// spreading the calls across the threads of the JobGroup pool and the calling
+// thread.  It returns when all of the chunks are done.  The chunks may be
+// processed in any order, and func must be safe to call from several threads
+// at once.
+//
+// If the range fits in a single chunk, or there are no pool threads, func is
+// simply called once for the whole range in the calling thread.
+
+template<class Func>
+INLINE void
+parallel_for(size_t begin, size_t end, size_t grain, const Func &func,
+             Thread *current_thread = Thread::get_current_thread());
+
+/**
+ * The per-call state of parallel_for(), which maps each job of a JobGroup to
+ * a chunk of the range.
+ */
+template<class Func>
+class ParallelForRange {
+public:
+  INLINE ParallelForRange(size_t begin, size_t end, size_t grain,
+                          const Func &func);
+
+  INLINE size_t get_num_chunks() const;
+  static void st_run_chunk(size_t index, void *data);
+
+private:
+  size_t _begin;
+  size_t _end;
+  size_t _grain;
+  const Func &_func;
+};
+
+#include "parallelFor.T"
+
+#endif
@@ -0,0 +1,106 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_task_throughput.cxx
+ * @author agent
+ * @date 2026-10-16
+ */
+
+/**
+ * A microbenchmark measuring the number of small tasks per second that a
+ * threaded AsyncTaskChain can run, for a range of thread counts, with and
+ * without work stealing.
+ *
+ * Usage: test_task_throughput [num_tasks [task_length_us [max_threads]]]
+ */
+
+#include "pandabase.h"
+#include "asyncTask.h"
+#include "asyncTaskManager.h"
+#include "trueClock.h"
+#include "atomicAdjust.h"
+
+using std::cerr;
+
+class SpinTask : public AsyncTask {
+public:
+  SpinTask(const std::string &name, double length, AtomicAdjust::Integer *count) :
+    AsyncTask(name),
+    _length(length),
+    _count(count)
+  {
+  }
+  ALLOC_DELETED_CHAIN(SpinTask);
+
+  virtual DoneStatus do_task() {
+    // Spin rather than sleep, to simulate a task that does real work.
+    TrueClock *clock = TrueClock::get_global_ptr();
+    double end = clock->get_short_time() + _length;
+    while (clock->get_short_time() < end) {
+    }
+    AtomicAdjust::inc(*_count);
+    return DS_done;
+  }
+
+  double _length;
+  AtomicAdjust::Integer *_count;
+};
+
+/**
+ * Runs the indicated number of tasks on a fresh chain with the given number
+ * of threads, and returns the number of tasks completed per second.
+ */
+static double
+run_tasks(AsyncTaskManager *task_mgr, int num_tasks, double length,
+          int num_threads, bool work_stealing) {
+  std::ostringstream strm;
+  strm << "bench_" << num_threads << "_" << work_stealing;
+  PT(AsyncTaskChain) chain = task_mgr->make_task_chain(strm.str());
+  chain->set_num_threads(num_threads);
+  chain->set_work_stealing(work_stealing);
+
+  AtomicAdjust::Integer count = 0;
+  for (int i = 0; i < num_tasks; ++i) {
+    PT(SpinTask) task = new SpinTask("spin", length, &count);
+    task->set_task_chain(chain->get_name());
+    task_mgr->add(task);
+  }
+
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+  chain->start_threads();
+  chain->wait_for_tasks();
+  double elapsed = clock->get_short_time() - start;
+  chain->stop_threads();
+  task_mgr->remove_task_chain(chain->get_name());
+
+  if (AtomicAdjust::get(count) != num_tasks) {
+    cerr << "ERROR: only " << AtomicAdjust::get(count) << " of "
+         << num_tasks << " tasks ran!\n";
+  }
+  return num_tasks / elapsed;
+}
+
+int
+main(int argc, char *argv[]) {
+  int num_tasks = (argc > 1) ? atoi(argv[1]) : 100000;
+  double length = ((argc > 2) ? atof(argv[2]) : 5.0) * 0.000001;
+  int max_threads = (argc > 3) ? atoi(argv[3]) : 8;
+
+  PT(AsyncTaskManager) task_mgr = new AsyncTaskManager("task_mgr");
+
+  cerr << num_tasks << " tasks of " << length * 1000000.0 << " us each\n"
+       << "threads      shared queue   work stealing   (tasks/s)\n";
+  for (int num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+    double shared = run_tasks(task_mgr, num_tasks, length, num_threads, false);
+    double stealing = run_tasks(task_mgr, num_tasks, length, num_threads, true);
+    fprintf(stderr, "%7d %16.0f %15.0f\n", num_threads, shared, stealing);
+  }
+
+  return 0;
+}
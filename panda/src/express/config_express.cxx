@@ -76,6 +76,16 @@ ConfigVariableBool multifile_always_binary
           "or extracted in either binary or text mode, according to the "
           "set_binary() or set_text() flag on the Filename."));
 
+ConfigVariableBool multifile_memory_map
+("multifile-memory-map", false,
+ PRC_DESC("Set this true to map each Multifile that is opened for reading "
+          "from a file on disk into memory.  Subfiles that are stored "
+          "neither compressed nor encrypted are then read straight from the "
+          "mapped pages, without going through a buffered stream, and their "
+          "data may be accessed in place with "
+          "Multifile::get_subfile_view().  This uses address space "
+          "equal to the size of each mapped Multifile."));
+
 ConfigVariableBool collect_tcp
 ("collect-tcp", false,
  PRC_DESC("Set this true to enable accumulation of several small consecutive "
@@ -50,6 +50,7 @@ extern ConfigVariableInt patchfile_zone_size;
 
 extern EXPCL_PANDA_EXPRESS ConfigVariableBool keep_temporary_files;
 extern ConfigVariableBool multifile_always_binary;
+extern ConfigVariableBool multifile_memory_map;
 
 extern EXPCL_PANDA_EXPRESS ConfigVariableBool collect_tcp;
 extern EXPCL_PANDA_EXPRESS ConfigVariableDouble collect_tcp_interval;
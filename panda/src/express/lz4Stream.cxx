@@ -0,0 +1,14 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file lz4Stream.cxx
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#include "lz4Stream.h"
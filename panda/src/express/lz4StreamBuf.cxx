@@ -0,0 +1,376 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file lz4StreamBuf.cxx
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#include "lz4StreamBuf.h"
+
+#ifdef HAVE_LZ4
+
+#include "pnotify.h"
+#include "config_express.h"
+
+using std::ios;
+using std::streamoff;
+using std::streampos;
+
+/**
+ *
+ */
+Lz4StreamBuf::
+Lz4StreamBuf() {
+  _source = nullptr;
+  _owns_source = false;
+  _dest = nullptr;
+  _owns_dest = false;
+  _dctx = nullptr;
+  _cctx = nullptr;
+  _total_out = 0;
+  _in_pos = 0;
+  _in_end = 0;
+
+#ifdef PHAVE_IOSTREAM
+  _buffer = (char *)PANDA_MALLOC_ARRAY(4096);
+  char *ebuf = _buffer + 4096;
+  setg(_buffer, ebuf, ebuf);
+  setp(_buffer, ebuf);
+
+#else
+  allocate();
+  setg(base(), ebuf(), ebuf());
+  setp(base(), ebuf());
+#endif
+}
+
+/**
+ *
+ */
+Lz4StreamBuf::
+~Lz4StreamBuf() {
+  close_read();
+  close_write();
+#ifdef PHAVE_IOSTREAM
+  PANDA_FREE_ARRAY(_buffer);
+#endif
+}
+
+/**
+ *
+ */
+void Lz4StreamBuf::
+open_read(std::istream *source, bool owns_source) {
+  _source = source;
+  _owns_source = owns_source;
+  _total_out = 0;
+  _in_pos = 0;
+  _in_end = 0;
+
+  size_t result = LZ4F_createDecompressionContext(&_dctx, LZ4F_VERSION);
+  if (LZ4F_isError(result)) {
+    show_lz4_error("LZ4F_createDecompressionContext", result);
+    _dctx = nullptr;
+    close_read();
+  }
+}
+
+/**
+ *
+ */
+void Lz4StreamBuf::
+close_read() {
+  if (_source != nullptr) {
+    if (_dctx != nullptr) {
+      LZ4F_freeDecompressionContext(_dctx);
+      _dctx = nullptr;
+    }
+
+    if (_owns_source) {
+      delete _source;
+      _owns_source = false;
+    }
+    _source = nullptr;
+  }
+}
+
+/**
+ *
+ */
+void Lz4StreamBuf::
+open_write(std::ostream *dest, bool owns_dest, int compression_level) {
+  _dest = dest;
+  _owns_dest = owns_dest;
+
+  memset(&_prefs, 0, sizeof(_prefs));
+  _prefs.compressionLevel = compression_level;
+  _prefs.frameInfo.blockMode = LZ4F_blockLinked;
+  _prefs.frameInfo.contentChecksumFlag = LZ4F_contentChecksumEnabled;
+
+  size_t result = LZ4F_createCompressionContext(&_cctx, LZ4F_VERSION);
+  if (LZ4F_isError(result)) {
+    show_lz4_error("LZ4F_createCompressionContext", result);
+    _cctx = nullptr;
+    close_write();
+    return;
+  }
+
+  // Write the frame header.
+  _compress_buffer.resize(LZ4F_HEADER_SIZE_MAX);
+  result = LZ4F_compressBegin(_cctx, &_compress_buffer[0],
+                              _compress_buffer.size(), &_prefs);
+  write_output(result, "LZ4F_compressBegin");
+}
+
+/**
+ *
+ */
+void Lz4StreamBuf::
+close_write() {
+  if (_dest != nullptr) {
+    if (_cctx != nullptr) {
+      size_t n = pptr() - pbase();
+      write_chars(pbase(), n);
+      pbump(-(int)n);
+
+      // Write the end of the frame.
+      _compress_buffer.resize(LZ4F_compressBound(0, &_prefs));
+      size_t result = LZ4F_compressEnd(_cctx, &_compress_buffer[0],
+                                       _compress_buffer.size(), nullptr);
+      write_output(result, "LZ4F_compressEnd");
+
+      LZ4F_freeCompressionContext(_cctx);
+      _cctx = nullptr;
+    }
+
+    if (_owns_dest) {
+      delete _dest;
+      _owns_dest = false;
+    }
+    _dest = nullptr;
+  }
+}
+
+/**
+ * Implements seeking within the stream.  Lz4StreamBuf only allows seeking
+ * back to the beginning of the stream.
+ */
+streampos Lz4StreamBuf::
+seekoff(streamoff off, ios_seekdir dir, ios_openmode which) {
+  if (which != ios::in || _dctx == nullptr) {
+    // We can only do this with the input stream.
+    return -1;
+  }
+
+  // Determine the current position.
+  size_t n = egptr() - gptr();
+  streampos gpos = _total_out - n;
+
+  // Implement tellg() and seeks to current position.
+  if ((dir == ios::cur && off == 0) ||
+      (dir == ios::beg && off == gpos)) {
+    return gpos;
+  }
+
+  if (off != 0 || dir != ios::beg) {
+    // We only know how to reposition to the beginning.
+    return -1;
+  }
+
+  gbump(n);
+
+  if (_source->rdbuf()->pubseekpos(0, ios::in) == (streampos)0) {
+    _source->clear();
+    _in_pos = 0;
+    _in_end = 0;
+    _total_out = 0;
+    LZ4F_resetDecompressionContext(_dctx);
+    return 0;
+  }
+
+  return -1;
+}
+
+/**
+ * Implements seeking within the stream.  Lz4StreamBuf only allows seeking
+ * back to the beginning of the stream.
+ */
+streampos Lz4StreamBuf::
+seekpos(streampos pos, ios_openmode which) {
+  return seekoff(pos, ios::beg, which);
+}
+
+/**
+ * Called by the system ostream implementation when its internal buffer is
+ * filled, plus one character.
+ */
+int Lz4StreamBuf::
+overflow(int ch) {
+  size_t n = pptr() - pbase();
+  if (n != 0) {
+    write_chars(pbase(), n);
+    pbump(-(int)n);
+  }
+
+  if (ch != EOF) {
+    // Write one more character.
+    char c = ch;
+    write_chars(&c, 1);
+  }
+
+  return 0;
+}
+
+/**
+ * Called by the system iostream implementation to implement a flush
+ * operation.
+ */
+int Lz4StreamBuf::
+sync() {
+  if (_source != nullptr) {
+    size_t n = egptr() - gptr();
+    gbump(n);
+  }
+
+  if (_dest != nullptr && _cctx != nullptr) {
+    size_t n = pptr() - pbase();
+    write_chars(pbase(), n);
+    pbump(-(int)n);
+
+    _compress_buffer.resize(LZ4F_compressBound(0, &_prefs));
+    size_t result = LZ4F_flush(_cctx, &_compress_buffer[0],
+                               _compress_buffer.size(), nullptr);
+    write_output(result, "LZ4F_flush");
+    _dest->flush();
+  }
+
+  return 0;
+}
+
+/**
+ * Called by the system istream implementation when its internal buffer needs
+ * more characters.
+ */
+int Lz4StreamBuf::
+underflow() {
+  // Sometimes underflow() is called even if the buffer is not empty.
+  if (gptr() >= egptr()) {
+    size_t buffer_size = egptr() - eback();
+    gbump(-(int)buffer_size);
+
+    size_t num_bytes = buffer_size;
+    size_t read_count = read_chars(gptr(), buffer_size);
+
+    if (read_count != num_bytes) {
+      // Oops, we didn't read what we thought we would.
+      if (read_count == 0) {
+        gbump(num_bytes);
+        return EOF;
+      }
+
+      // Slide what we did read to the top of the buffer.
+      nassertr(read_count < num_bytes, EOF);
+      size_t delta = num_bytes - read_count;
+      memmove(gptr() + delta, gptr(), read_count);
+      gbump(delta);
+    }
+  }
+
+  return (unsigned char)*gptr();
+}
+
+
+/**
+ * Gets some characters from the source stream.
+ */
+size_t Lz4StreamBuf::
+read_chars(char *start, size_t length) {
+  if (_dctx == nullptr) {
+    return 0;
+  }
+
+  bool eof = (_source->eof() || _source->fail());
+  size_t bytes_read = 0;
+
+  while (bytes_read < length) {
+    if (_in_pos == _in_end) {
+      if (eof) {
+        // The input is exhausted, possibly truncated.
+        break;
+      }
+      _source->read(_decompress_buffer, decompress_buffer_size);
+      _in_pos = 0;
+      _in_end = _source->gcount();
+      eof = (_in_end == 0 || _source->eof() || _source->fail());
+    }
+
+    size_t dst_size = length - bytes_read;
+    size_t src_size = _in_end - _in_pos;
+    size_t result = LZ4F_decompress(_dctx, start + bytes_read, &dst_size,
+                                    _decompress_buffer + _in_pos, &src_size,
+                                    nullptr);
+    thread_consider_yield();
+    _in_pos += src_size;
+    bytes_read += dst_size;
+
+    if (LZ4F_isError(result)) {
+      show_lz4_error("LZ4F_decompress", result);
+      break;
+    }
+    if (result == 0) {
+      // Here's the end of the frame.
+      break;
+    }
+  }
+
+  _total_out += bytes_read;
+  return bytes_read;
+}
+
+/**
+ * Sends some characters to the dest stream.
+ */
+void Lz4StreamBuf::
+write_chars(const char *start, size_t length) {
+  if (_cctx == nullptr || length == 0) {
+    return;
+  }
+
+  _compress_buffer.resize(LZ4F_compressBound(length, &_prefs));
+  size_t result = LZ4F_compressUpdate(_cctx, &_compress_buffer[0],
+                                      _compress_buffer.size(),
+                                      start, length, nullptr);
+  write_output(result, "LZ4F_compressUpdate");
+}
+
+/**
+ * Writes the first result bytes of _compress_buffer to the dest stream, or
+ * reports an error if result is an LZ4 error code.
+ */
+void Lz4StreamBuf::
+write_output(size_t result, const char *function) {
+  if (LZ4F_isError(result)) {
+    show_lz4_error(function, result);
+  } else if (result != 0) {
+    _dest->write(&_compress_buffer[0], result);
+  }
+  thread_consider_yield();
+}
+
+/**
+ * Reports a recent error code returned by LZ4.
+ */
+void Lz4StreamBuf::
+show_lz4_error(const char *function, size_t error_code) {
+  express_cat.warning()
+    << "LZ4 error in " << function << ": "
+    << LZ4F_getErrorName(error_code) << "\n";
+}
+
+#endif  // HAVE_LZ4
@@ -0,0 +1,85 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file lz4StreamBuf.h
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#ifndef LZ4STREAMBUF_H
+#define LZ4STREAMBUF_H
+
+#include "pandabase.h"
+
+// This module is not compiled if LZ4 is not available.
+#ifdef HAVE_LZ4
+
+#include "pvector.h"
+
+#include <lz4frame.h>
+
+/**
+ * The streambuf object that implements ILz4DecompressStream and
+ * OLz4CompressStream.
+ */
+class EXPCL_PANDA_EXPRESS Lz4StreamBuf : public std::streambuf {
+public:
+  Lz4StreamBuf();
+  virtual ~Lz4StreamBuf();
+
+  void open_read(std::istream *source, bool owns_source);
+  void close_read();
+
+  void open_write(std::ostream *dest, bool owns_dest, int compression_level);
+  void close_write();
+
+  virtual std::streampos seekoff(std::streamoff off, ios_seekdir dir, ios_openmode which);
+  virtual std::streampos seekpos(std::streampos pos, ios_openmode which);
+
+protected:
+  virtual int overflow(int c);
+  virtual int sync();
+  virtual int underflow();
+
+private:
+  size_t read_chars(char *start, size_t length);
+  void write_chars(const char *start, size_t length);
+  void write_output(size_t result, const char *function);
+  void show_lz4_error(const char *function, size_t error_code);
+
+private:
+  std::istream *_source;
+  bool _owns_source;
+
+  std::ostream *_dest;
+  bool _owns_dest;
+
+  LZ4F_dctx *_dctx;
+  LZ4F_cctx *_cctx;
+  LZ4F_preferences_t _prefs;
+  size_t _total_out;
+
+  char *_buffer;
+
+  // The LZ4 frame decoder might not consume all of the input characters at
+  // each call, so we keep the unconsumed remainder here.
+  enum {
+    decompress_buffer_size = 4096
+  };
+  char _decompress_buffer[decompress_buffer_size];
+  size_t _in_pos;
+  size_t _in_end;
+
+  // Holds the compressed output of each call to the frame encoder, which is
+  // sized according to LZ4F_compressBound().
+  pvector<char> _compress_buffer;
+};
+
+#endif  // HAVE_LZ4
+
+#endif
@@ -0,0 +1,246 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file memoryMappedFile.cxx
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#include "memoryMappedFile.h"
+#include "config_express.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN 1
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using std::ios;
+using std::streamoff;
+using std::streampos;
+using std::streamsize;
+
+/**
+ *
+ */
+MemoryMappedFile::
+MemoryMappedFile() :
+  _data(nullptr),
+  _size(0)
+{
+}
+
+/**
+ *
+ */
+MemoryMappedFile::
+~MemoryMappedFile() {
+  close();
+}
+
+/**
+ * Maps the indicated file on disk into memory.  The filename is understood
+ * as a physical file, not a file within the vfs.  Returns true on success,
+ * false on failure; an empty file cannot be mapped.
+ */
+bool MemoryMappedFile::
+open(const Filename &filename) {
+  close();
+
+#ifdef _WIN32
+  std::wstring os_specific = filename.to_os_specific_w();
+  HANDLE file = CreateFileW(os_specific.c_str(), GENERIC_READ,
+                            FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0 ||
+      (unsigned long long)size.QuadPart > (unsigned long long)SIZE_MAX) {
+    CloseHandle(file);
+    return false;
+  }
+
+  size_t data_size = (size_t)size.QuadPart;
+
+  HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY,
+                                      0, 0, nullptr);
+  CloseHandle(file);
+  if (mapping == nullptr) {
+    return false;
+  }
+
+  // The view keeps the mapping object alive.
+  void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  CloseHandle(mapping);
+  if (data == nullptr) {
+    return false;
+  }
+
+#else  // _WIN32
+  std::string os_specific = filename.to_os_specific();
+  int fd = ::open(os_specific.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return false;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size <= 0 ||
+      (unsigned long long)st.st_size > (unsigned long long)SIZE_MAX) {
+    ::close(fd);
+    return false;
+  }
+
+  size_t data_size = (size_t)st.st_size;
+
+  // The mapping keeps the file open.
+  void *data = mmap(nullptr, data_size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED) {
+    return false;
+  }
+#endif  // _WIN32
+
+  _filename = filename;
+  _data = (unsigned char *)data;
+  _size = data_size;
+
+  if (express_cat.is_debug()) {
+    express_cat.debug()
+      << "Mapped " << _size << " bytes of " << _filename << "\n";
+  }
+  return true;
+}
+
+/**
+ * Releases the mapping.  It is an error to call this while any pointers into
+ * the mapped data, or streams returned by open_read_stream(), are still in
+ * use; normally the mapping is simply released by the destructor.
+ */
+void MemoryMappedFile::
+close() {
+  if (_data != nullptr) {
+#ifdef _WIN32
+    UnmapViewOfFile(_data);
+#else
+    munmap(_data, _size);
+#endif
+    _data = nullptr;
+  }
+  _size = 0;
+  _filename = Filename();
+}
+
+/**
+ * Returns a newly-allocated istream that reads the indicated range of bytes
+ * directly from the mapped memory.  The stream holds a reference to this
+ * object, so the mapping remains valid for as long as the stream exists.
+ *
+ * Returns NULL if the range does not lie within the mapped file.
+ */
+std::istream *MemoryMappedFile::
+open_read_stream(size_t start, size_t length) {
+  if (_data == nullptr || start > _size || length > _size - start) {
+    return nullptr;
+  }
+  return new MappedStream(this, start, length);
+}
+
+/**
+ *
+ */
+MemoryMappedFile::MappedStreamBuf::
+MappedStreamBuf(const unsigned char *data, size_t length) {
+  // The whole range is the get area, so there is never anything to read in.
+  // The streambuf interface wants a non-const pointer, but nothing is ever
+  // written through it.
+  char *begin = (char *)data;
+  setg(begin, begin, begin + length);
+}
+
+/**
+ * Implements seeking within the stream.  Seeking only moves the get pointer
+ * within the mapped range.
+ */
+streampos MemoryMappedFile::MappedStreamBuf::
+seekoff(streamoff off, ios_seekdir dir, ios_openmode which) {
+  if ((which & ios::in) == 0) {
+    return streampos(-1);
+  }
+
+  streamoff pos;
+  switch (dir) {
+  case ios::beg:
+    pos = off;
+    break;
+  case ios::cur:
+    pos = (gptr() - eback()) + off;
+    break;
+  case ios::end:
+    pos = (egptr() - eback()) + off;
+    break;
+  default:
+    return streampos(-1);
+  }
+
+  if (pos < 0 || pos > (streamoff)(egptr() - eback())) {
+    return streampos(-1);
+  }
+
+  setg(eback(), eback() + pos, egptr());
+  return pos;
+}
+
+/**
+ * Implements seeking within the stream.
+ */
+streampos MemoryMappedFile::MappedStreamBuf::
+seekpos(streampos pos, ios_openmode which) {
+  return seekoff(pos, ios::beg, which);
+}
+
+/**
+ * Returns the number of bytes remaining in the range.
+ */
+streamsize MemoryMappedFile::MappedStreamBuf::
+showmanyc() {
+  streamsize avail = egptr() - gptr();
+  return (avail > 0) ? avail : -1;
+}
+
+/**
+ * Called by the system istream implementation when its internal buffer needs
+ * more characters.  Since the entire range is always available, this only
+ * happens at the end of the range.
+ */
+int MemoryMappedFile::MappedStreamBuf::
+underflow() {
+  if (gptr() < egptr()) {
+    return (unsigned char)*gptr();
+  }
+  return EOF;
+}
+
+/**
+ *
+ */
+MemoryMappedFile::MappedStream::
+MappedStream(MemoryMappedFile *mapping, size_t start, size_t length) :
+  std::istream(&_buf),
+  _buf(mapping->get_data() + start, length),
+  _mapping(mapping)
+{
+}
@@ -0,0 +1,80 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file memoryMappedFile.h
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#ifndef MEMORYMAPPEDFILE_H
+#define MEMORYMAPPEDFILE_H
+
+#include "pandabase.h"
+
+#include "referenceCount.h"
+#include "pointerTo.h"
+#include "filename.h"
+
+/**
+ * A read-only mapping of an entire file on disk into the address space of
+ * the process.  The bytes of the file may be accessed directly through
+ * get_data(), without any further system calls or copies; the operating
+ * system pages them in on demand.
+ *
+ * The mapping is released when the last reference to this object goes away,
+ * so anyone holding a pointer into the mapped data should also hold a
+ * reference to the MemoryMappedFile.
+ */
+class EXPCL_PANDA_EXPRESS MemoryMappedFile : public ReferenceCount {
+public:
+  MemoryMappedFile();
+  MemoryMappedFile(const MemoryMappedFile &copy) = delete;
+  virtual ~MemoryMappedFile();
+
+  MemoryMappedFile &operator = (const MemoryMappedFile &copy) = delete;
+
+  bool open(const Filename &filename);
+  void close();
+
+  INLINE bool is_valid() const;
+  INLINE const Filename &get_filename() const;
+  INLINE const unsigned char *get_data() const;
+  INLINE size_t get_size() const;
+
+  std::istream *open_read_stream(size_t start, size_t length);
+
+private:
+  Filename _filename;
+  unsigned char *_data;
+  size_t _size;
+
+  class MappedStreamBuf : public std::streambuf {
+  public:
+    MappedStreamBuf(const unsigned char *data, size_t length);
+
+    virtual std::streampos seekoff(std::streamoff off, ios_seekdir dir, ios_openmode which);
+    virtual std::streampos seekpos(std::streampos pos, ios_openmode which);
+
+  protected:
+    virtual std::streamsize showmanyc();
+    virtual int underflow();
+  };
+
+  class MappedStream : public std::istream {
+  public:
+    MappedStream(MemoryMappedFile *mapping, size_t start, size_t length);
+
+  private:
+    MappedStreamBuf _buf;
+    PT(MemoryMappedFile) _mapping;
+  };
+};
+
+#include "memoryMappedFile.I"
+
+#endif
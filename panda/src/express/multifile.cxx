@@ -18,6 +18,8 @@
 #include "streamReader.h"
 #include "datagram.h"
 #include "zStream.h"
+#include "lz4Stream.h"
+#include "zstdStream.h"
 #include "encryptStream.h"
 #include "virtualFileSystem.h"
 #include "virtualFile.h"
@@ -26,6 +28,10 @@
 #include <iterator>
 #include <time.h>
 
+#if defined(HAVE_THREADS) && !defined(SIMPLE_THREADS)
+#include <thread>
+#endif
+
 #include "openSSLWrapper.h"
 
 using std::ios;
@@ -62,6 +68,11 @@ const int Multifile::_current_minor_ver = 1;
 const char Multifile::_encrypt_header[] = "crypty";
 const size_t Multifile::_encrypt_header_size = 6;
 
+// The Zstandard dictionary set by set_compression_dictionary() is stored in a
+// subfile of this name, which is flagged with SF_dictionary.  Subfiles that
+// were compressed against it are flagged with SF_zstd_dict.
+const char Multifile::_dictionary_name[] = ".zstd_dictionary";
+
 
 
 /*
@@ -86,7 +97,9 @@ const size_t Multifile::_encrypt_header_size = 6;
  * (although they will after the file has been "packed"). uint32     The
  * address of the next entry.  0 to mark the end.  uint32     The address of
  * this subfile's data record.  uint32     The length in bytes of this
- * subfile's data record.  uint16     The Subfile::_flags member.  [uint32]
+ * subfile's data record.  uint16     The Subfile::_flags member; for a
+ * compressed subfile, the SF_codec_mask bits name the compression codec.
+ * [uint32]
  * The original, uncompressed and unencrypted length of the subfile, if it is
  * compressed or encrypted.  This field is only present if one or both of the
  * SF_compressed or SF_encrypted bits are set in _flags.  uint32     A
@@ -115,10 +128,18 @@ Multifile() :
               "be loaded quickly, without paying the cost of an expensive hash on "
               "each subfile in order to decrypt it."));
 
+  ConfigVariableInt multifile_compression_threads
+    ("multifile-compression-threads", 1,
+     PRC_DESC("This is the default number of threads a Multifile uses to compress "
+              "and encrypt new subfiles when it is flushed or repacked; see "
+              "Multifile::set_num_compression_threads().  Set this to 0 to use "
+              "one thread per CPU."));
+
   _read = nullptr;
   _write = nullptr;
   _offset = 0;
   _owns_stream = false;
+  _mapping_start = 0;
   _next_index = 0;
   _last_index = 0;
   _last_data_byte = 0;
@@ -130,6 +151,8 @@ Multifile() :
   _new_scale_factor = 1;
   _encryption_flag = false;
   _encryption_iteration_count = multifile_encryption_iteration_count;
+  _compression_codec = CC_zlib;
+  _num_compression_threads = multifile_compression_threads;
   _file_major_ver = 0;
   _file_minor_ver = 0;
 
@@ -179,6 +202,20 @@ open_read(const Filename &multifile_name, const streampos &offset) {
   _owns_stream = true;
   _multifile_name = multifile_name;
   _offset = offset;
+
+  if (multifile_memory_map) {
+    // If the Multifile is a plain file on disk, map it into memory, so that
+    // its subfiles can be read straight from the mapped pages.
+    SubfileInfo info;
+    if (vfile->get_system_info(info)) {
+      PT(MemoryMappedFile) mapping = new MemoryMappedFile;
+      if (mapping->open(info.get_filename())) {
+        _mapping = mapping;
+        _mapping_start = info.get_start();
+      }
+    }
+  }
+
   return read_index();
 }
 
@@ -346,6 +383,11 @@ close() {
   _write = nullptr;
   _offset = 0;
   _owns_stream = false;
+
+  // Any streams still open on the mapping keep it alive.
+  _mapping.clear();
+  _mapping_start = 0;
+
   _next_index = 0;
   _last_index = 0;
   _needs_repack = false;
@@ -354,8 +396,12 @@ close() {
   _scale_factor = 1;
   _new_scale_factor = 1;
   _encryption_flag = false;
+  _compression_codec = CC_zlib;
   _file_major_ver = 0;
   _file_minor_ver = 0;
+#ifdef HAVE_ZSTD
+  _zstd_dictionary.clear();
+#endif
 
   _read_file.close();
   _write_file.close();
@@ -1200,9 +1246,25 @@ flush() {
     nassertr(_next_index == _write->tellp(), false);
     _next_index = pad_to_streampos(_next_index);
 
-    // All right, now write out each subfile's data.
-    for (pi = _new_subfiles.begin(); pi != _new_subfiles.end(); ++pi) {
-      Subfile *subfile = (*pi);
+    // All right, now write out each subfile's data.  If we have several
+    // threads, they compress the subfiles a batch at a time, ahead of the
+    // loop that writes them out in order.
+    int num_threads = _num_compression_threads;
+#if defined(HAVE_THREADS) && !defined(SIMPLE_THREADS)
+    if (num_threads <= 0) {
+      num_threads = max((int)std::thread::hardware_concurrency(), 1);
+    }
+#else
+    num_threads = 1;
+#endif
+    size_t batch_size = (num_threads > 1) ? (size_t)num_threads * 4 : 0;
+
+    for (size_t si = 0; si < _new_subfiles.size(); ++si) {
+      Subfile *subfile = _new_subfiles[si];
+      if (batch_size != 0 && (si % batch_size) == 0) {
+        encode_subfiles(si, min(si + batch_size, _new_subfiles.size()),
+                        num_threads);
+      }
 
       if (_read != nullptr) {
         _read->acquire();
@@ -1519,6 +1581,16 @@ is_subfile_compressed(int index) const {
   return (_subfiles[index]->_flags & SF_compressed) != 0;
 }
 
+/**
+ * Returns the codec the indicated subfile has been compressed with.  This is
+ * only meaningful if is_subfile_compressed() returns true.
+ */
+Multifile::CompressionCodec Multifile::
+get_subfile_compression_codec(int index) const {
+  nassertr(index >= 0 && index < (int)_subfiles.size(), CC_zlib);
+  return _subfiles[index]->get_codec();
+}
+
 /**
  * Returns true if the indicated subfile has been encrypted when stored within
  * the archive, false otherwise.
@@ -1928,6 +2000,10 @@ read_subfile(int index, vector_uchar &result) {
     success = VirtualFile::simple_read_file(in, result);
     close_read_subfile(in);
 
+  } else if (const unsigned char *data = get_mapped_data(subfile)) {
+    // If the Multifile is memory-mapped, the data is already in memory.
+    result.assign(data, data + subfile->_data_length);
+
   } else {
     // But if the subfile is just a plain file, we can just read the data
     // directly from the Multifile, without paying the cost of an ISubStream.
@@ -1966,6 +2042,126 @@ read_subfile(int index, vector_uchar &result) {
   return true;
 }
 
+/**
+ * Returns true if the indicated compression codec was compiled into this
+ * build of Panda, and may therefore be passed to set_compression_codec() and
+ * used to read subfiles compressed with it.
+ */
+bool Multifile::
+has_compression_codec(CompressionCodec codec) {
+  switch (codec) {
+  case CC_zlib:
+#ifdef HAVE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+
+  case CC_lz4:
+#ifdef HAVE_LZ4
+    return true;
+#else
+    return false;
+#endif
+
+  case CC_zstd:
+#ifdef HAVE_ZSTD
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  return false;
+}
+
+/**
+ * Stores the indicated Zstandard dictionary in the Multifile.  Subfiles that
+ * are subsequently added with the CC_zstd codec are compressed against it,
+ * which compresses many small, similar files (such as bam files) much better
+ * than compressing each one on its own.  A suitable dictionary may be
+ * produced from a sample of the files with ZstdDictionary::train().
+ *
+ * The dictionary is stored uncompressed in a subfile of its own, and is
+ * loaded automatically when the Multifile is opened for reading.  A Multifile
+ * can have only one dictionary, since the subfiles compressed against it
+ * cannot be read with any other; returns false if it already has one, or if
+ * Panda was built without Zstandard support.
+ */
+bool Multifile::
+set_compression_dictionary(const vector_uchar &dictionary) {
+  nassertr(is_write_valid(), false);
+
+#ifdef HAVE_ZSTD
+  if (has_compression_dictionary()) {
+    express_cat.error()
+      << "Multifile " << _multifile_name
+      << " already has a compression dictionary.\n";
+    return false;
+  }
+  if (dictionary.empty()) {
+    return false;
+  }
+
+  _zstd_dictionary = new ZstdDictionary(dictionary);
+
+  _dictionary_source.str(string(dictionary.begin(), dictionary.end()));
+  _dictionary_source.clear();
+
+  Subfile *subfile = new Subfile;
+  subfile->_name = _dictionary_name;
+  subfile->_source = &_dictionary_source;
+  subfile->_flags |= SF_dictionary;
+  add_new_subfile(subfile, 0);
+  return true;
+
+#else  // HAVE_ZSTD
+  express_cat.warning()
+    << "Zstandard not compiled in; cannot store a compression dictionary.\n";
+  return false;
+#endif  // HAVE_ZSTD
+}
+
+/**
+ * Returns true if the Multifile has a Zstandard compression dictionary,
+ * either one read from the file or one set by set_compression_dictionary().
+ */
+bool Multifile::
+has_compression_dictionary() const {
+#ifdef HAVE_ZSTD
+  return _zstd_dictionary != nullptr;
+#else
+  return false;
+#endif
+}
+
+/**
+ * Returns a pointer to the data of the indicated subfile within the
+ * memory-mapped Multifile, which may be parsed in place without copying it.
+ * The pointer remains valid until the Multifile is closed, or for as long as
+ * a reference to get_memory_map() is held.  The number of bytes is
+ * get_subfile_length().
+ *
+ * Returns NULL if the Multifile is not memory-mapped, or if the subfile is
+ * compressed or encrypted (or has not yet been written to the Multifile);
+ * such a subfile must be read with read_subfile() or open_read_subfile()
+ * instead.
+ */
+const unsigned char *Multifile::
+get_subfile_view(int index) const {
+  nassertr(is_read_valid(), nullptr);
+  nassertr(index >= 0 && index < (int)_subfiles.size(), nullptr);
+  const Subfile *subfile = _subfiles[index];
+
+  if ((subfile->_flags & (SF_encrypted | SF_compressed)) != 0 ||
+      subfile->_source != nullptr ||
+      !subfile->_source_filename.empty()) {
+    return nullptr;
+  }
+
+  return get_mapped_data(subfile);
+}
+
 /**
  * Assumes the _write pointer is at the indicated fpos, rounds the fpos up to
  * the next legitimate address (using normalize_streampos()), and writes
@@ -1995,13 +2191,27 @@ add_new_subfile(Subfile *subfile, int compression_level) {
       << "zlib not compiled in; cannot generated compressed multifiles.\n";
     compression_level = 0;
 #else  // HAVE_ZLIB
-    subfile->_flags |= SF_compressed;
+    CompressionCodec codec = _compression_codec;
+    if (!has_compression_codec(codec)) {
+      express_cat.warning()
+        << "Compression codec " << (int)codec
+        << " not compiled in; compressing " << subfile->_name
+        << " with zlib instead.\n";
+      codec = CC_zlib;
+    }
+    subfile->_flags |= SF_compressed | (codec << SF_codec_shift);
     subfile->_compression_level = compression_level;
+
+#ifdef HAVE_ZSTD
+    if (codec == CC_zstd && _zstd_dictionary != nullptr) {
+      subfile->_flags |= SF_zstd_dict;
+    }
+#endif  // HAVE_ZSTD
 #endif  // HAVE_ZLIB
   }
 
 #ifdef HAVE_OPENSSL
-  if (_encryption_flag) {
+  if (_encryption_flag && (subfile->_flags & SF_dictionary) == 0) {
     subfile->_flags |= SF_encrypted;
   }
 #endif  // HAVE_OPENSSL
@@ -2037,6 +2247,63 @@ add_new_subfile(Subfile *subfile, int compression_level) {
   _new_subfiles.push_back(subfile);
 }
 
+/**
+ * Compresses and/or encrypts the source data of the subfiles in the indicated
+ * range of _new_subfiles, using up to num_threads threads (including this
+ * one), so that write_data() can then write each of them out without further
+ * work.  Only subfiles that are to be compressed or encrypted, and whose data
+ * is not already in the Multifile, are encoded this way.
+ */
+void Multifile::
+encode_subfiles(size_t begin, size_t end, int num_threads) {
+#if defined(HAVE_THREADS) && !defined(SIMPLE_THREADS)
+  pvector<Subfile *> subfiles;
+  for (size_t si = begin; si < end; ++si) {
+    Subfile *subfile = _new_subfiles[si];
+    if ((subfile->_flags & (SF_compressed | SF_encrypted)) != 0 &&
+        (subfile->_flags & SF_signature) == 0 &&
+        (subfile->_source != nullptr || !subfile->_source_filename.empty())) {
+      subfiles.push_back(subfile);
+    }
+  }
+  if (subfiles.size() < 2) {
+    // Not worth starting any threads for.
+    return;
+  }
+
+  AtomicAdjust::Integer next_subfile = 0;
+  size_t num_helpers = min((size_t)num_threads, subfiles.size()) - 1;
+  pvector<std::thread> helpers;
+  helpers.reserve(num_helpers);
+  for (size_t ti = 0; ti < num_helpers; ++ti) {
+    helpers.push_back(std::thread(&encode_subfiles_worker, &subfiles,
+                                  &next_subfile, this));
+  }
+
+  // This thread does its share, too.
+  encode_subfiles_worker(&subfiles, &next_subfile, this);
+
+  for (size_t ti = 0; ti < num_helpers; ++ti) {
+    helpers[ti].join();
+  }
+#endif  // HAVE_THREADS && !SIMPLE_THREADS
+}
+
+/**
+ * The body of each thread started by encode_subfiles().  Encodes subfiles from
+ * the list until there are none left.
+ */
+void Multifile::
+encode_subfiles_worker(pvector<Subfile *> *subfiles,
+                       AtomicAdjust::Integer *next_subfile,
+                       Multifile *multifile) {
+  size_t si = (size_t)(AtomicAdjust::add(*next_subfile, 1) - 1);
+  while (si < subfiles->size()) {
+    (*subfiles)[si]->encode_data(multifile);
+    si = (size_t)(AtomicAdjust::add(*next_subfile, 1) - 1);
+  }
+}
+
 /**
  * This variant of open_read_subfile() is used internally only, and accepts a
  * pointer to the internal Subfile object, which is assumed to be valid and
@@ -2047,12 +2314,20 @@ open_read_subfile(Subfile *subfile) {
   nassertr(subfile->_source == nullptr &&
            subfile->_source_filename.empty(), nullptr);
 
-  // Return an ISubStream object that references into the open Multifile
-  // istream.
   nassertr(subfile->_data_start != (streampos)0, nullptr);
-  istream *stream =
-    new ISubStream(_read, _offset + subfile->_data_start,
-                   _offset + subfile->_data_start + (streampos)subfile->_data_length);
+  istream *stream;
+  if (const unsigned char *data = get_mapped_data(subfile)) {
+    // The Multifile is memory-mapped, so return a stream that reads straight
+    // from the mapped pages.
+    stream = _mapping->open_read_stream(data - _mapping->get_data(),
+                                        subfile->_data_length);
+  } else {
+    // Return an ISubStream object that references into the open Multifile
+    // istream.
+    stream =
+      new ISubStream(_read, _offset + subfile->_data_start,
+                     _offset + subfile->_data_start + (streampos)subfile->_data_length);
+  }
 
   if ((subfile->_flags & SF_encrypted) != 0) {
 #ifndef HAVE_OPENSSL
@@ -2084,10 +2359,43 @@ open_read_subfile(Subfile *subfile) {
     delete stream;
     return nullptr;
 #else  // HAVE_ZLIB
-    // Oops, the subfile is compressed.  So actually, return an
-    // IDecompressStream that wraps around the ISubStream.
-    IDecompressStream *wrapper = new IDecompressStream(stream, true);
-    stream = wrapper;
+    // Oops, the subfile is compressed.  So actually, return a decompression
+    // stream of the appropriate kind that wraps around the ISubStream.
+    switch (subfile->get_codec()) {
+    case CC_zlib:
+      stream = new IDecompressStream(stream, true);
+      break;
+
+#ifdef HAVE_LZ4
+    case CC_lz4:
+      stream = new ILz4DecompressStream(stream, true);
+      break;
+#endif  // HAVE_LZ4
+
+#ifdef HAVE_ZSTD
+    case CC_zstd:
+      if ((subfile->_flags & SF_zstd_dict) != 0) {
+        if (_zstd_dictionary == nullptr) {
+          express_cat.error()
+            << "Cannot read " << subfile->_name
+            << " without the Multifile's compression dictionary.\n";
+          delete stream;
+          return nullptr;
+        }
+        stream = new IZstdDecompressStream(stream, true, _zstd_dictionary);
+      } else {
+        stream = new IZstdDecompressStream(stream, true);
+      }
+      break;
+#endif  // HAVE_ZSTD
+
+    default:
+      express_cat.error()
+        << "Compression codec " << (int)subfile->get_codec()
+        << " not compiled in; cannot read " << subfile->_name << ".\n";
+      delete stream;
+      return nullptr;
+    }
 #endif  // HAVE_ZLIB
   }
 
@@ -2100,6 +2408,28 @@ open_read_subfile(Subfile *subfile) {
   return stream;
 }
 
+/**
+ * Returns a pointer to the raw bytes of the indicated subfile, as stored in
+ * the archive, within the memory-mapped Multifile.  Returns NULL if the
+ * Multifile is not memory-mapped, or if the subfile somehow lies outside of
+ * the mapping.
+ */
+const unsigned char *Multifile::
+get_mapped_data(const Subfile *subfile) const {
+  if (_mapping == nullptr || subfile->_data_start == (streampos)0) {
+    return nullptr;
+  }
+
+  streamoff start = (streamoff)(_mapping_start + _offset + subfile->_data_start);
+  size_t size = _mapping->get_size();
+  if (start < 0 || (size_t)start > size ||
+      subfile->_data_length > size - (size_t)start) {
+    return nullptr;
+  }
+
+  return _mapping->get_data() + (size_t)start;
+}
+
 /**
  * Returns the standard form of the subfile name.
  */
@@ -2332,6 +2662,8 @@ read_index() {
 
   delete subfile;
   _read->release();
+
+  read_compression_dictionary();
   return true;
 }
 
@@ -2373,6 +2705,32 @@ write_header() {
   return true;
 }
 
+/**
+ * Called after reading the index, this loads the Zstandard dictionary stored
+ * in the Multifile, if there is one, so that the subfiles compressed against
+ * it may be read.
+ */
+void Multifile::
+read_compression_dictionary() {
+#ifdef HAVE_ZSTD
+  _zstd_dictionary.clear();
+
+  int index = find_subfile(_dictionary_name);
+  if (index < 0 || (_subfiles[index]->_flags & SF_dictionary) == 0) {
+    return;
+  }
+
+  vector_uchar data;
+  if (!read_subfile(index, data) || data.empty()) {
+    express_cat.warning()
+      << "Unable to read compression dictionary from " << _multifile_name
+      << ".\n";
+    return;
+  }
+  _zstd_dictionary = new ZstdDictionary(data);
+#endif  // HAVE_ZSTD
+}
+
 /**
  * Walks through the list of _cert_special entries in the Multifile, moving
  * any valid signatures found to _signatures.  After this call, _cert_special
@@ -2620,7 +2978,7 @@ write_data(ostream &write, istream *read, streampos fpos,
 
   istream *source = _source;
   pifstream source_file;
-  if (source == nullptr && !_source_filename.empty()) {
+  if (source == nullptr && !_source_filename.empty() && !_encoded) {
     // If we have a filename, open it up and read that.
     if (!_source_filename.open_read(source_file)) {
       // Unable to open the source file.
@@ -2634,7 +2992,15 @@ write_data(ostream &write, istream *read, streampos fpos,
     }
   }
 
-  if (source == nullptr) {
+  if (_encoded) {
+    // The data has already been compressed and/or encrypted by encode_data();
+    // we only have to copy it in.
+    write.write(_encoded_data.data(), _encoded_data.size());
+    _data_length = _encoded_data.size();
+    _encoded_data = string();
+    _encoded = false;
+
+  } else if (source == nullptr) {
     // We don't have any source data.  Perhaps we're reading from an already-
     // packed Subfile (e.g.  during repack()).
     if (read == nullptr) {
@@ -2659,41 +3025,8 @@ write_data(ostream &write, istream *read, streampos fpos,
     }
   } else {
     // We do have source data.  Copy it in, and also measure its length.
-    ostream *putter = &write;
-    bool delete_putter = false;
-
-#ifndef HAVE_OPENSSL
-    // Without OpenSSL, we can't support encryption.  The flag had better not
-    // be set.
-    nassertr((_flags & SF_encrypted) == 0, fpos);
-
-#else  // HAVE_OPENSSL
-    if ((_flags & SF_encrypted) != 0) {
-      // Write it encrypted.
-      OEncryptStream *encrypt = new OEncryptStream;
-      encrypt->set_iteration_count(multifile->_encryption_iteration_count);
-      encrypt->open(putter, delete_putter, multifile->_encryption_password);
-
-      putter = encrypt;
-      delete_putter = true;
-
-      // Also write the encrypt_header to the beginning of the encrypted
-      // stream, so we can validate the password on decryption.
-      putter->write(_encrypt_header, _encrypt_header_size);
-    }
-#endif  // HAVE_OPENSSL
-
-#ifndef HAVE_ZLIB
-    // Without ZLIB, we can't support compression.  The flag had better not be
-    // set.
-    nassertr((_flags & SF_compressed) == 0, fpos);
-#else  // HAVE_ZLIB
-    if ((_flags & SF_compressed) != 0) {
-      // Write it compressed.
-      putter = new OCompressStream(putter, delete_putter, _compression_level);
-      delete_putter = true;
-    }
-#endif  // HAVE_ZLIB
+    ostream *putter = open_encoder(&write, multifile);
+    bool delete_putter = (putter != &write);
 
     streampos write_start = fpos;
     _uncompressed_length = 0;
@@ -2798,6 +3131,120 @@ write_data(ostream &write, istream *read, streampos fpos,
   return fpos + (streampos)_data_length;
 }
 
+/**
+ * Compresses and/or encrypts the Subfile's source data into memory, ahead of
+ * the call to write_data(), which then writes out the encoded data as it is.
+ * This is called on several subfiles at once by encode_subfiles(), so it must
+ * not modify anything other than this Subfile.
+ */
+void Multifile::Subfile::
+encode_data(Multifile *multifile) {
+  istream *source = _source;
+  pifstream source_file;
+  if (source == nullptr && !_source_filename.empty()) {
+    if (!_source_filename.open_read(source_file)) {
+      // Leave it for write_data() to report the error.
+      return;
+    }
+    source = &source_file;
+  }
+  if (source == nullptr) {
+    return;
+  }
+
+  std::ostringstream encoded;
+  ostream *putter = open_encoder(&encoded, multifile);
+
+  _uncompressed_length = 0;
+  static const size_t buffer_size = 4096;
+  char buffer[buffer_size];
+
+  source->read(buffer, buffer_size);
+  size_t count = source->gcount();
+  while (count != 0) {
+    _uncompressed_length += count;
+    putter->write(buffer, count);
+    source->read(buffer, buffer_size);
+    count = source->gcount();
+  }
+
+  if (putter != &encoded) {
+    delete putter;
+  }
+
+  _encoded_data = encoded.str();
+  _encoded = true;
+}
+
+/**
+ * Wraps the indicated stream in the encryption and compression streams called
+ * for by the Subfile's flags, in that order.  Returns the stream the Subfile's
+ * data should be written to; if it is not dest itself, the caller should
+ * delete it when it is done writing, which also deletes the intermediate
+ * streams and finishes writing the encoded data to dest.
+ */
+ostream *Multifile::Subfile::
+open_encoder(ostream *dest, Multifile *multifile) {
+  ostream *putter = dest;
+  bool delete_putter = false;
+
+#ifndef HAVE_OPENSSL
+  // Without OpenSSL, we can't support encryption.  The flag had better not
+  // be set.
+  nassertr((_flags & SF_encrypted) == 0, putter);
+
+#else  // HAVE_OPENSSL
+  if ((_flags & SF_encrypted) != 0) {
+    // Write it encrypted.
+    OEncryptStream *encrypt = new OEncryptStream;
+    encrypt->set_iteration_count(multifile->_encryption_iteration_count);
+    encrypt->open(putter, delete_putter, multifile->_encryption_password);
+
+    putter = encrypt;
+    delete_putter = true;
+
+    // Also write the encrypt_header to the beginning of the encrypted
+    // stream, so we can validate the password on decryption.
+    putter->write(_encrypt_header, _encrypt_header_size);
+  }
+#endif  // HAVE_OPENSSL
+
+#ifndef HAVE_ZLIB
+  // Without ZLIB, we can't support compression.  The flag had better not be
+  // set.
+  nassertr((_flags & SF_compressed) == 0, putter);
+#else  // HAVE_ZLIB
+  if ((_flags & SF_compressed) != 0) {
+    // Write it compressed, with whichever codec was chosen for it.
+    switch (get_codec()) {
+#ifdef HAVE_LZ4
+    case CC_lz4:
+      putter = new OLz4CompressStream(putter, delete_putter, _compression_level);
+      break;
+#endif  // HAVE_LZ4
+
+#ifdef HAVE_ZSTD
+    case CC_zstd:
+      nassertr((_flags & SF_zstd_dict) == 0 ||
+               multifile->_zstd_dictionary != nullptr, putter);
+      putter = new OZstdCompressStream(putter, delete_putter, _compression_level,
+                                       (_flags & SF_zstd_dict) != 0 ?
+                                       multifile->_zstd_dictionary.p() : nullptr);
+      break;
+#endif  // HAVE_ZSTD
+
+    default:
+      nassertr(get_codec() == CC_zlib, putter);
+      putter = new OCompressStream(putter, delete_putter, _compression_level);
+      break;
+    }
+    delete_putter = true;
+  }
+#endif  // HAVE_ZLIB
+
+  return putter;
+}
+
 /**
  * Seeks within the indicate pfstream back to the index record and rewrites
  * just the _data_start and _data_length part of the index record.
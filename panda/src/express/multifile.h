@@ -23,8 +23,11 @@
 #include "ordered_vector.h"
 #include "indirectLess.h"
 #include "referenceCount.h"
+#include "atomicAdjust.h"
 #include "pvector.h"
 #include "vector_uchar.h"
+#include "memoryMappedFile.h"
+#include "zstdDictionary.h"
 
 #ifdef HAVE_OPENSSL
 typedef struct x509_st X509;
@@ -36,6 +39,14 @@ typedef struct evp_pkey_st EVP_PKEY;
  */
 class EXPCL_PANDA_EXPRESS Multifile : public ReferenceCount {
 PUBLISHED:
+  // The algorithms that may be used to compress subfiles.  The codec is
+  // recorded separately for each subfile.
+  enum CompressionCodec {
+    CC_zlib = 0,
+    CC_lz4,
+    CC_zstd,
+  };
+
   Multifile();
   Multifile(const Multifile &copy) = delete;
   ~Multifile();
@@ -56,6 +67,7 @@ PUBLISHED:
 
   INLINE bool is_read_valid() const;
   INLINE bool is_write_valid() const;
+  INLINE bool is_memory_mapped() const;
   INLINE bool needs_repack() const;
 
   INLINE time_t get_timestamp() const;
@@ -78,6 +90,16 @@ PUBLISHED:
   INLINE void set_encryption_iteration_count(int encryption_iteration_count);
   INLINE int get_encryption_iteration_count() const;
 
+  INLINE void set_compression_codec(CompressionCodec codec);
+  INLINE CompressionCodec get_compression_codec() const;
+  static bool has_compression_codec(CompressionCodec codec);
+
+  INLINE void set_num_compression_threads(int num_threads);
+  INLINE int get_num_compression_threads() const;
+
+  bool set_compression_dictionary(const vector_uchar &dictionary);
+  bool has_compression_dictionary() const;
+
   std::string add_subfile(const std::string &subfile_name, const Filename &filename,
                      int compression_level);
   std::string add_subfile(const std::string &subfile_name, std::istream *subfile_data,
@@ -120,6 +142,7 @@ PUBLISHED:
   bool is_subfile_compressed(int index) const;
   bool is_subfile_encrypted(int index) const;
   bool is_subfile_text(int index) const;
+  CompressionCodec get_subfile_compression_codec(int index) const;
 
   std::streampos get_index_end() const;
   std::streampos get_subfile_internal_start(int index) const;
@@ -161,6 +184,9 @@ public:
   bool read_subfile(int index, std::string &result);
   bool read_subfile(int index, vector_uchar &result);
 
+  const unsigned char *get_subfile_view(int index) const;
+  INLINE MemoryMappedFile *get_memory_map() const;
+
 private:
   enum SubfileFlags {
     SF_deleted        = 0x0001,
@@ -170,6 +196,15 @@ private:
     SF_encrypted      = 0x0010,
     SF_signature      = 0x0020,
     SF_text           = 0x0040,
+    SF_codec_mask     = 0x0180,
+    SF_dictionary     = 0x0200,
+    SF_zstd_dict      = 0x0400,
+  };
+  enum {
+    // The CompressionCodec of a compressed subfile is stored in the
+    // SF_codec_mask bits of its flags.  Subfiles written before there was a
+    // choice of codec have zero there, which is zlib.
+    SF_codec_shift    = 7,
   };
 
   class Subfile {
@@ -182,12 +217,15 @@ private:
                           Multifile *multifile);
     std::streampos write_data(std::ostream &write, std::istream *read, std::streampos fpos,
                          Multifile *multifile);
+    void encode_data(Multifile *multifile);
+    std::ostream *open_encoder(std::ostream *dest, Multifile *multifile);
     void rewrite_index_data_start(std::ostream &write, Multifile *multifile);
     void rewrite_index_flags(std::ostream &write);
     INLINE bool is_deleted() const;
     INLINE bool is_index_invalid() const;
     INLINE bool is_data_invalid() const;
     INLINE bool is_cert_special() const;
+    INLINE CompressionCodec get_codec() const;
     INLINE std::streampos get_last_byte_pos() const;
 
     std::string _name;
@@ -201,6 +239,8 @@ private:
     Filename _source_filename;
     int _flags;
     int _compression_level;  // Not preserved on disk.
+    bool _encoded;
+    std::string _encoded_data;
 #ifdef HAVE_OPENSSL
     EVP_PKEY *_pkey;         // Not preserved on disk.
 #endif
@@ -212,7 +252,12 @@ private:
   std::streampos pad_to_streampos(std::streampos fpos);
 
   void add_new_subfile(Subfile *subfile, int compression_level);
+  void encode_subfiles(size_t begin, size_t end, int num_threads);
+  static void encode_subfiles_worker(pvector<Subfile *> *subfiles,
+                                     AtomicAdjust::Integer *next_subfile,
+                                     Multifile *multifile);
   std::istream *open_read_subfile(Subfile *subfile);
+  const unsigned char *get_mapped_data(const Subfile *subfile) const;
   std::string standardize_subfile_name(const std::string &subfile_name) const;
 
   void clear_subfiles();
@@ -220,6 +265,7 @@ private:
   bool write_header();
 
   void check_signatures();
+  void read_compression_dictionary();
 
   static INLINE char tohex(unsigned int nibble);
 
@@ -239,6 +285,8 @@ private:
   IStreamWrapper *_read;
   std::ostream *_write;
   bool _owns_stream;
+  PT(MemoryMappedFile) _mapping;
+  std::streampos _mapping_start;
   std::streampos _next_index;
   std::streampos _last_index;
   std::streampos _last_data_byte;
@@ -256,6 +304,13 @@ private:
   int _encryption_key_length;
   int _encryption_iteration_count;
 
+  CompressionCodec _compression_codec;
+  int _num_compression_threads;
+#ifdef HAVE_ZSTD
+  PT(ZstdDictionary) _zstd_dictionary;
+  std::istringstream _dictionary_source;
+#endif
+
   pifstream _read_file;
   IStreamWrapper _read_filew;
   pofstream _write_file;
@@ -275,6 +330,8 @@ private:
   static const char _encrypt_header[];
   static const size_t _encrypt_header_size;
 
+  static const char _dictionary_name[];
+
   friend class Subfile;
 };
 
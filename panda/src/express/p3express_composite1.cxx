@@ -13,7 +13,10 @@
 #include "fileReference.cxx"
 #include "hashGeneratorBase.cxx"
 #include "hashVal.cxx"
+#include "lz4Stream.cxx"
+#include "lz4StreamBuf.cxx"
 #include "memoryInfo.cxx"
+#include "memoryMappedFile.cxx"
 #include "memoryUsage.cxx"
 #include "memoryUsagePointerCounts.cxx"
 #include "memoryUsagePointers.cxx"
@@ -30,3 +30,6 @@
 #include "windowsRegistry.cxx"
 #include "zStream.cxx"
 #include "zStreamBuf.cxx"
+#include "zstdDictionary.cxx"
+#include "zstdStream.cxx"
+#include "zstdStreamBuf.cxx"
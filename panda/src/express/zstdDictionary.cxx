@@ -0,0 +1,85 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file zstdDictionary.cxx
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#include "zstdDictionary.h"
+
+#ifdef HAVE_ZSTD
+
+#include "config_express.h"
+
+#include <zstd.h>
+#include <zdict.h>
+
+/**
+ * Creates a dictionary from its raw contents, which were either trained with
+ * train(), or are simply a sample of typical data.
+ */
+ZstdDictionary::
+ZstdDictionary(const vector_uchar &data) :
+  _data(data),
+  _dict_id(0),
+  _ddict(nullptr)
+{
+  if (!_data.empty()) {
+    _dict_id = ZDICT_getDictID(_data.data(), _data.size());
+    _ddict = ZSTD_createDDict(_data.data(), _data.size());
+  }
+}
+
+/**
+ *
+ */
+ZstdDictionary::
+~ZstdDictionary() {
+  if (_ddict != nullptr) {
+    ZSTD_freeDDict(_ddict);
+  }
+}
+
+/**
+ * Trains a dictionary of at most max_size bytes from the indicated samples,
+ * each of which should be the complete contents of one file.  Returns the
+ * raw contents of the dictionary, or an empty vector if there are too few
+ * samples to train from.
+ */
+vector_uchar ZstdDictionary::
+train(const pvector<vector_uchar> &samples, size_t max_size) {
+  vector_uchar buffer;
+  pvector<size_t> sizes;
+  sizes.reserve(samples.size());
+  for (const vector_uchar &sample : samples) {
+    buffer.insert(buffer.end(), sample.begin(), sample.end());
+    sizes.push_back(sample.size());
+  }
+
+  if (buffer.empty() || max_size == 0) {
+    return vector_uchar();
+  }
+
+  vector_uchar dictionary(max_size);
+
+  size_t result = ZDICT_trainFromBuffer(dictionary.data(), max_size,
+                                        buffer.data(), sizes.data(),
+                                        (unsigned int)sizes.size());
+  if (ZDICT_isError(result)) {
+    express_cat.warning()
+      << "Unable to train Zstandard dictionary from " << sizes.size()
+      << " samples: " << ZDICT_getErrorName(result) << "\n";
+    return vector_uchar();
+  }
+
+  dictionary.resize(result);
+  return dictionary;
+}
+
+#endif  // HAVE_ZSTD
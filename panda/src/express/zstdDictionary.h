@@ -0,0 +1,62 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file zstdDictionary.h
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#ifndef ZSTDDICTIONARY_H
+#define ZSTDDICTIONARY_H
+
+#include "pandabase.h"
+
+// This module is not compiled if Zstandard is not available.
+#ifdef HAVE_ZSTD
+
+#include "referenceCount.h"
+#include "vector_uchar.h"
+#include "pvector.h"
+
+struct ZSTD_DDict_s;
+
+/**
+ * A Zstandard compression dictionary.  Many small files of a similar kind,
+ * such as bam files, compress much better when they are compressed against a
+ * dictionary trained from a sample of them.  The same dictionary must then be
+ * supplied to decompress them.
+ *
+ * The dictionary is digested for decompression once, when it is constructed,
+ * and may then be shared by any number of IZstdDecompressStreams.
+ */
+class EXPCL_PANDA_EXPRESS ZstdDictionary : public ReferenceCount {
+public:
+  explicit ZstdDictionary(const vector_uchar &data);
+  ZstdDictionary(const ZstdDictionary &copy) = delete;
+  virtual ~ZstdDictionary();
+
+  ZstdDictionary &operator = (const ZstdDictionary &copy) = delete;
+
+  INLINE const vector_uchar &get_data() const;
+  INLINE unsigned int get_dict_id() const;
+  INLINE ZSTD_DDict_s *get_ddict() const;
+
+  static vector_uchar train(const pvector<vector_uchar> &samples,
+                            size_t max_size);
+
+private:
+  vector_uchar _data;
+  unsigned int _dict_id;
+  ZSTD_DDict_s *_ddict;
+};
+
+#include "zstdDictionary.I"
+
+#endif  // HAVE_ZSTD
+
+#endif
@@ -0,0 +1,95 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file zstdStream.h
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#ifndef ZSTDSTREAM_H
+#define ZSTDSTREAM_H
+
+#include "pandabase.h"
+
+// This module is not compiled if Zstandard is not available.
+#ifdef HAVE_ZSTD
+
+#include "zstdStreamBuf.h"
+
+/**
+ * An input stream object that decompresses a Zstandard frame from another
+ * source stream on-the-fly.  Zstandard compresses about as well as zlib, or
+ * better, and decompresses several times faster.
+ *
+ * If the data was compressed against a dictionary, the same dictionary must
+ * be supplied here.
+ *
+ * Seeking is not supported, except back to the beginning of the stream.
+ * See also IDecompressStream, which reads zlib streams.
+ */
+class EXPCL_PANDA_EXPRESS IZstdDecompressStream : public std::istream {
+PUBLISHED:
+  INLINE IZstdDecompressStream();
+  INLINE explicit IZstdDecompressStream(std::istream *source, bool owns_source);
+
+#if _MSC_VER >= 1800
+  INLINE IZstdDecompressStream(const IZstdDecompressStream &copy) = delete;
+#endif
+
+  INLINE IZstdDecompressStream &open(std::istream *source, bool owns_source);
+  INLINE IZstdDecompressStream &close();
+
+public:
+  INLINE explicit IZstdDecompressStream(std::istream *source, bool owns_source,
+                                        const ZstdDictionary *dictionary);
+  INLINE IZstdDecompressStream &open(std::istream *source, bool owns_source,
+                                     const ZstdDictionary *dictionary);
+
+private:
+  ZstdStreamBuf _buf;
+};
+
+/**
+ * An output stream object that compresses data to another destination stream
+ * on-the-fly, as a single Zstandard frame, optionally against a dictionary.
+ *
+ * Seeking is not supported.  See also OCompressStream, which writes zlib
+ * streams.
+ */
+class EXPCL_PANDA_EXPRESS OZstdCompressStream : public std::ostream {
+PUBLISHED:
+  INLINE OZstdCompressStream();
+  INLINE explicit OZstdCompressStream(std::ostream *dest, bool owns_dest,
+                                      int compression_level = 6);
+
+#if _MSC_VER >= 1800
+  INLINE OZstdCompressStream(const OZstdCompressStream &copy) = delete;
+#endif
+
+  INLINE OZstdCompressStream &open(std::ostream *dest, bool owns_dest,
+                                   int compression_level = 6);
+  INLINE OZstdCompressStream &close();
+
+public:
+  INLINE explicit OZstdCompressStream(std::ostream *dest, bool owns_dest,
+                                      int compression_level,
+                                      const ZstdDictionary *dictionary);
+  INLINE OZstdCompressStream &open(std::ostream *dest, bool owns_dest,
+                                   int compression_level,
+                                   const ZstdDictionary *dictionary);
+
+private:
+  ZstdStreamBuf _buf;
+};
+
+#include "zstdStream.I"
+
+#endif  // HAVE_ZSTD
+
+
+#endif
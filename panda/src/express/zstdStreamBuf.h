@@ -0,0 +1,82 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file zstdStreamBuf.h
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#ifndef ZSTDSTREAMBUF_H
+#define ZSTDSTREAMBUF_H
+
+#include "pandabase.h"
+
+// This module is not compiled if Zstandard is not available.
+#ifdef HAVE_ZSTD
+
+#include "zstdDictionary.h"
+#include "pointerTo.h"
+
+#include <zstd.h>
+
+/**
+ * The streambuf object that implements IZstdDecompressStream and
+ * OZstdCompressStream.
+ */
+class EXPCL_PANDA_EXPRESS ZstdStreamBuf : public std::streambuf {
+public:
+  ZstdStreamBuf();
+  virtual ~ZstdStreamBuf();
+
+  void open_read(std::istream *source, bool owns_source,
+                 const ZstdDictionary *dictionary);
+  void close_read();
+
+  void open_write(std::ostream *dest, bool owns_dest, int compression_level,
+                  const ZstdDictionary *dictionary);
+  void close_write();
+
+  virtual std::streampos seekoff(std::streamoff off, ios_seekdir dir, ios_openmode which);
+  virtual std::streampos seekpos(std::streampos pos, ios_openmode which);
+
+protected:
+  virtual int overflow(int c);
+  virtual int sync();
+  virtual int underflow();
+
+private:
+  size_t read_chars(char *start, size_t length);
+  void write_chars(const char *start, size_t length, ZSTD_EndDirective mode);
+  void show_zstd_error(const char *function, size_t error_code);
+
+private:
+  std::istream *_source;
+  bool _owns_source;
+
+  std::ostream *_dest;
+  bool _owns_dest;
+
+  ZSTD_DCtx *_dctx;
+  ZSTD_CCtx *_cctx;
+  CPT(ZstdDictionary) _dictionary;
+  size_t _total_out;
+
+  char *_buffer;
+
+  // The decoder might not consume all of the input characters at each call,
+  // so we keep the unconsumed remainder here.
+  enum {
+    decompress_buffer_size = 4096
+  };
+  char _decompress_buffer[decompress_buffer_size];
+  ZSTD_inBuffer _in;
+};
+
+#endif  // HAVE_ZSTD
+
+#endif
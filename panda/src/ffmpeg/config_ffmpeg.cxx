@@ -105,6 +105,31 @@ ConfigVariableBool ffmpeg_prefer_libvpx
           "with an alpha channel, which aren't supported by ffmpeg's own "
           "VP8/VP9 decoders."));
 
+ConfigVariableInt ffmpeg_decode_threads
+("ffmpeg-decode-threads", 1,
+ PRC_DESC("The default number of threads that libavcodec may use to decode "
+          "a single video stream.  Set this to 0 to let ffmpeg choose based "
+          "on the number of CPU cores.  This is the initial value of "
+          "FfmpegVideo::set_decode_threads(), and is independent of "
+          "ffmpeg-max-readahead-frames."));
+
+ConfigVariableBool ffmpeg_frame_threading
+("ffmpeg-frame-threading", false,
+ PRC_DESC("Set this true to allow libavcodec to decode several frames in "
+          "parallel when ffmpeg-decode-threads is not 1, in addition to "
+          "decoding slices of one frame in parallel.  Frame threading "
+          "scales better, but each extra thread delays the decoder output "
+          "by one frame, so the displayed video lags by that many frames."));
+
+ConfigVariableBool ffmpeg_direct_decode
+("ffmpeg-direct-decode", false,
+ PRC_DESC("Set this true to convert frames decoded in the main thread "
+          "(that is, with ffmpeg-max-readahead-frames 0) directly into the "
+          "texture's ram image when the buffer is applied to a texture, "
+          "rather than converting into the buffer and copying it again.  "
+          "This is only safe when the buffers returned by fetch_buffer() "
+          "are consumed through apply_to_texture(), as MovieTexture does."));
+
 /**
  * Initializes the library.  This must be called at least once before any of
  * the functions or classes in this library can be used.  Normally it will be
@@ -32,6 +32,9 @@ extern ConfigVariableBool ffmpeg_global_lock;
 extern ConfigVariableEnum<ThreadPriority> ffmpeg_thread_priority;
 extern ConfigVariableInt ffmpeg_read_buffer_size;
 extern ConfigVariableBool ffmpeg_prefer_libvpx;
+extern ConfigVariableInt ffmpeg_decode_threads;
+extern ConfigVariableBool ffmpeg_frame_threading;
+extern ConfigVariableBool ffmpeg_direct_decode;
 
 extern EXPCL_FFMPEG void init_libffmpeg();
 
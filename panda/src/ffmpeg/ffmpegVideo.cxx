@@ -25,7 +25,9 @@ TypeHandle FfmpegVideo::_type_handle;
  */
 FfmpegVideo::
 FfmpegVideo(const Filename &name) :
-  MovieVideo(name)
+  MovieVideo(name),
+  _decode_threads(ffmpeg_decode_threads),
+  _frame_threading(ffmpeg_frame_threading)
 {
   _filename = name;
 }
@@ -37,7 +39,9 @@ FfmpegVideo(const Filename &name) :
  */
 FfmpegVideo::
 FfmpegVideo(const SubfileInfo &info) :
-  MovieVideo(info.get_filename())
+  MovieVideo(info.get_filename()),
+  _decode_threads(ffmpeg_decode_threads),
+  _frame_threading(ffmpeg_frame_threading)
 {
   _filename = info.get_filename();
   _subfile_info = info;
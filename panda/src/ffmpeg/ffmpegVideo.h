@@ -36,6 +36,14 @@ PUBLISHED:
 
   static PT(MovieVideo) make(const Filename &name);
 
+  INLINE void set_decode_threads(int decode_threads);
+  INLINE int get_decode_threads() const;
+  INLINE void set_frame_threading(bool frame_threading);
+  INLINE bool get_frame_threading() const;
+
+  MAKE_PROPERTY(decode_threads, get_decode_threads, set_decode_threads);
+  MAKE_PROPERTY(frame_threading, get_frame_threading, set_frame_threading);
+
 public:
   static void register_with_read_factory();
   virtual void write_datagram(BamWriter *manager, Datagram &dg);
@@ -59,6 +67,9 @@ public:
   virtual TypeHandle force_init_type() {init_type(); return get_class_type();}
 
 private:
+  int _decode_threads;
+  bool _frame_threading;
+
   static TypeHandle _type_handle;
 
   friend class FfmpegVideoCursor;
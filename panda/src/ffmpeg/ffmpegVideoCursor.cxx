@@ -19,6 +19,7 @@
 #include "reMutexHolder.h"
 #include "ffmpegVideo.h"
 #include "bamReader.h"
+#include <algorithm>
 extern "C" {
   #include <libavcodec/avcodec.h>
   #include <libavformat/avformat.h>
@@ -47,6 +48,9 @@ FfmpegVideoCursor::
 FfmpegVideoCursor() :
   _max_readahead_frames(0),
   _thread_priority(ffmpeg_thread_priority),
+  _decode_threads(ffmpeg_decode_threads),
+  _frame_threading(ffmpeg_frame_threading),
+  _direct_decode(ffmpeg_direct_decode),
   _lock("FfmpegVideoCursor::_lock"),
   _action_cvar(_lock),
   _thread_status(TS_stopped),
@@ -73,6 +77,8 @@ init_from(FfmpegVideo *source) {
   nassertv(source != nullptr);
   _source = source;
   _filename = _source->get_filename();
+  _decode_threads = source->get_decode_threads();
+  _frame_threading = source->get_frame_threading();
 
   if (!open_stream()) {
     cleanup();
@@ -161,6 +167,9 @@ FfmpegVideoCursor::
 FfmpegVideoCursor(FfmpegVideo *src) :
   _max_readahead_frames(0),
   _thread_priority(ffmpeg_thread_priority),
+  _decode_threads(ffmpeg_decode_threads),
+  _frame_threading(ffmpeg_frame_threading),
+  _direct_decode(ffmpeg_direct_decode),
   _lock("FfmpegVideoCursor::_lock"),
   _action_cvar(_lock),
   _thread_status(TS_stopped),
@@ -267,6 +276,10 @@ start_thread() {
   MutexHolder holder(_lock);
 
   if (_thread_status == TS_stopped && _max_readahead_frames > 0) {
+    // The thread will overwrite the decoded frame, so any frame we handed
+    // out without converting it must be converted now.
+    do_export_deferred();
+
     // Get a unique name for the thread's sync name.
     std::ostringstream strm;
     strm << (void *)this;
@@ -325,6 +338,34 @@ is_thread_started() const {
   return (_thread_status != TS_stopped);
 }
 
+/**
+ * Specifies whether frames decoded in the main thread (that is, when
+ * max_readahead_frames is 0) should be converted directly into the texture's
+ * ram image by apply_to_texture(), instead of being converted into the
+ * returned buffer and then copied into the texture.
+ *
+ * When this is enabled, the buffer returned by fetch_buffer() is only filled
+ * in lazily, so its contents should not be read directly; it should only be
+ * passed to one of the apply_to_texture() methods, as MovieTexture does.
+ */
+void FfmpegVideoCursor::
+set_direct_decode(bool direct_decode) {
+  MutexHolder holder(_lock);
+  if (!direct_decode) {
+    do_export_deferred();
+  }
+  _direct_decode = direct_decode;
+}
+
+/**
+ * Returns whether frames decoded in the main thread are converted directly
+ * into the texture.  See set_direct_decode().
+ */
+bool FfmpegVideoCursor::
+get_direct_decode() const {
+  return _direct_decode;
+}
+
 /**
  * See MovieVideoCursor::set_time().
  */
@@ -381,10 +422,19 @@ fetch_buffer() {
   PT(FfmpegBuffer) frame;
   if (_thread_status == TS_stopped) {
     // Non-threaded case.  Just get the next frame directly.
+    do_export_deferred();
     advance_to_frame(_current_frame);
     if (_frame_ready) {
       frame = do_alloc_frame();
-      export_frame(frame);
+      if (_direct_decode) {
+        // Leave the frame in _frame until we know where it should go.
+        frame->_begin_frame = _begin_frame;
+        frame->_end_frame = _end_frame;
+        frame->_pending = true;
+        _deferred_buffer = frame;
+      } else {
+        export_frame(frame);
+      }
     }
 
   } else {
@@ -467,6 +517,65 @@ make_new_buffer() {
   return frame;
 }
 
+/**
+ * See MovieVideoCursor::apply_to_texture().  If the buffer was returned in
+ * direct_decode mode and the texture has a compatible layout, the frame is
+ * converted straight into the texture's ram image.
+ */
+void FfmpegVideoCursor::
+apply_to_texture(const Buffer *buffer, Texture *t, int page) {
+  if (buffer == nullptr) {
+    return;
+  }
+
+  {
+    MutexHolder holder(_lock);
+    if (buffer == _deferred_buffer.p() && _deferred_buffer->_pending) {
+      if (t->get_x_size() >= size_x() && t->get_y_size() >= size_y() &&
+          t->get_num_components() == get_num_components() &&
+          t->get_component_width() == 1 && page < t->get_num_pages()) {
+        PStatTimer timer(_copy_pcollector);
+
+        PTA_uchar img;
+        {
+          PStatTimer timer2(_copy_pcollector_ram);
+          t->set_keep_ram_image(true);
+          img = t->modify_ram_image();
+        }
+
+        unsigned char *data = img.p() + page * t->get_expected_ram_page_size();
+        export_frame_to(data, t->get_x_size() * _num_components);
+
+        // The buffer itself is only filled in if someone else still needs it
+        // when the next frame is decoded.
+        return;
+      }
+
+      export_frame(_deferred_buffer);
+    }
+  }
+
+  MovieVideoCursor::apply_to_texture(buffer, t, page);
+}
+
+/**
+ * See MovieVideoCursor::apply_to_texture_rgb().
+ */
+void FfmpegVideoCursor::
+apply_to_texture_rgb(const Buffer *buffer, Texture *t, int page) {
+  do_resolve_buffer(buffer);
+  MovieVideoCursor::apply_to_texture_rgb(buffer, t, page);
+}
+
+/**
+ * See MovieVideoCursor::apply_to_texture_alpha().
+ */
+void FfmpegVideoCursor::
+apply_to_texture_alpha(const Buffer *buffer, Texture *t, int page, int alpha_src) {
+  do_resolve_buffer(buffer);
+  MovieVideoCursor::apply_to_texture_alpha(buffer, t, page, alpha_src);
+}
+
 /**
  * Opens the stream for the first time, or when needed internally.
  */
@@ -579,6 +688,15 @@ open_stream() {
   avcodec_copy_context(_video_ctx, codecpar);
 #endif
 
+  // Let libavcodec spread the decoding of this stream over several threads,
+  // if so configured.  Slice threading doesn't delay the output; frame
+  // threading does, so it must be requested explicitly.
+  _video_ctx->thread_count = std::max(_decode_threads, 0);
+  _video_ctx->thread_type = FF_THREAD_SLICE;
+  if (_frame_threading) {
+    _video_ctx->thread_type |= FF_THREAD_FRAME;
+  }
+
   if (avcodec_open2(_video_ctx, pVideoCodec, nullptr) < 0) {
     ffmpeg_cat.info()
       << "Couldn't open codec\n";
@@ -633,6 +751,13 @@ close_stream() {
 void FfmpegVideoCursor::
 cleanup() {
   stop_thread();
+
+  {
+    MutexHolder holder(_lock);
+    do_export_deferred();
+    _buffer_pool.clear();
+  }
+
   close_stream();
 
   ReMutexHolder av_holder(_av_lock);
@@ -688,7 +813,11 @@ thread_main() {
 
   // First, push the first frame onto the readahead queue.
   if (_frame_ready) {
-    PT(FfmpegBuffer) frame = do_alloc_frame();
+    PT(FfmpegBuffer) frame;
+    {
+      MutexHolder holder(_lock);
+      frame = do_alloc_frame();
+    }
     export_frame(frame);
     MutexHolder holder(_lock);
     _readahead_frames.push_back(frame);
@@ -793,12 +922,32 @@ do_poll() {
 }
 
 /**
- * Allocates a new Buffer object.  Assumes the lock is held.
+ * Allocates a new Buffer object, or recycles one from the pool that is no
+ * longer referenced anywhere else.  Assumes the lock is held.
  */
 PT(FfmpegVideoCursor::FfmpegBuffer) FfmpegVideoCursor::
 do_alloc_frame() {
+  BufferPool::const_iterator bi;
+  for (bi = _buffer_pool.begin(); bi != _buffer_pool.end(); ++bi) {
+    FfmpegBuffer *buffer = (*bi);
+    if (buffer->get_ref_count() == 1) {
+      // Only the pool holds this one; nobody can get at it but us.
+      buffer->_begin_frame = -1;
+      buffer->_end_frame = 0;
+      buffer->_pending = false;
+      return buffer;
+    }
+  }
+
   PT(Buffer) buffer = make_new_buffer();
-  return (FfmpegBuffer *)buffer.p();
+  PT(FfmpegBuffer) frame = (FfmpegBuffer *)buffer.p();
+
+  // Keep enough buffers around for the readahead queue, the current frame,
+  // and the frame the caller is still holding.
+  if ((int)_buffer_pool.size() < std::max(_max_readahead_frames, 0) + 3) {
+    _buffer_pool.push_back(frame);
+  }
+  return frame;
 }
 
 /**
@@ -809,6 +958,41 @@ do_clear_all_frames() {
   _readahead_frames.clear();
 }
 
+/**
+ * Called before the decoded frame is overwritten.  If the last buffer handed
+ * out in direct_decode mode was never converted, and is still referenced by
+ * someone other than this cursor, converts it now so that it remains valid.
+ * Assumes the lock is held.
+ */
+void FfmpegVideoCursor::
+do_export_deferred() {
+  if (_deferred_buffer == nullptr) {
+    return;
+  }
+
+  // Count the references held by this cursor itself.
+  int own_refs = (_current_frame_buffer == _deferred_buffer) ? 2 : 1;
+  if (std::find(_buffer_pool.begin(), _buffer_pool.end(), _deferred_buffer) != _buffer_pool.end()) {
+    ++own_refs;
+  }
+  if (_deferred_buffer->_pending && _deferred_buffer->get_ref_count() > own_refs) {
+    export_frame(_deferred_buffer);
+  }
+  _deferred_buffer = nullptr;
+}
+
+/**
+ * Ensures that the indicated buffer's block is filled in, in case it was
+ * returned in direct_decode mode.
+ */
+void FfmpegVideoCursor::
+do_resolve_buffer(const Buffer *buffer) {
+  MutexHolder holder(_lock);
+  if (buffer != nullptr && buffer == _deferred_buffer.p() && _deferred_buffer->_pending) {
+    export_frame(_deferred_buffer);
+  }
+}
+
 /**
  * Called within the sub-thread.  Fetches a video packet and stores it in the
  * packet0 buffer.  Sets packet_frame to the packet's timestamp.  If a packet
@@ -1157,6 +1341,7 @@ void FfmpegVideoCursor::
 export_frame(FfmpegBuffer *buffer) {
   PStatTimer timer(_export_frame_pcollector);
 
+  buffer->_pending = false;
   if (!_frame_ready) {
     // No frame data ready, just fill with black.
     if (ffmpeg_cat.is_spam()) {
@@ -1168,10 +1353,20 @@ export_frame(FfmpegBuffer *buffer) {
     return;
   }
 
-  _frame_out->data[0] = buffer->_block + ((_size_y - 1) * _size_x * _num_components);
-  _frame_out->linesize[0] = _size_x * -_num_components;
   buffer->_begin_frame = _begin_frame;
   buffer->_end_frame = _end_frame;
+  export_frame_to(buffer->_block, _size_x * _num_components);
+}
+
+/**
+ * Converts the contents of the frame buffer into the indicated memory, which
+ * holds _size_y rows of the indicated stride in bytes.  The rows are written
+ * bottom-up, as Panda expects them in a texture image.
+ */
+void FfmpegVideoCursor::
+export_frame_to(unsigned char *data, int stride) {
+  _frame_out->data[0] = data + ((_size_y - 1) * stride);
+  _frame_out->linesize[0] = -stride;
 
 #ifdef HAVE_SWSCALE
   nassertv(_convert_ctx != nullptr && _frame != nullptr);
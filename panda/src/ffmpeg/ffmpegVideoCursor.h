@@ -25,6 +25,7 @@
 #include "reMutex.h"
 #include "conditionVar.h"
 #include "pdeque.h"
+#include "pvector.h"
 
 class FfmpegVideo;
 struct AVFormatContext;
@@ -56,10 +57,17 @@ PUBLISHED:
   BLOCKING void stop_thread();
   bool is_thread_started() const;
 
+  void set_direct_decode(bool direct_decode);
+  bool get_direct_decode() const;
+
 public:
   virtual bool set_time(double timestamp, int loop_count);
   virtual PT(Buffer) fetch_buffer();
 
+  virtual void apply_to_texture(const Buffer *buffer, Texture *t, int page);
+  virtual void apply_to_texture_rgb(const Buffer *buffer, Texture *t, int page);
+  virtual void apply_to_texture_alpha(const Buffer *buffer, Texture *t, int page, int alpha_src);
+
 public:
   // Nested class must be public for PT(FfmpegBuffer) to work correctly.
   class EXPCL_FFMPEG FfmpegBuffer : public Buffer {
@@ -73,6 +81,10 @@ public:
     int _end_frame;
     double _video_timebase;
 
+    // True if the frame has not yet been converted into _block; it still
+    // lives in the cursor's decoded frame.  Only set in direct_decode mode.
+    bool _pending;
+
   public:
     static TypeHandle get_class_type() {
       return _type_handle;
@@ -106,6 +118,9 @@ private:
   PT(GenericThread) _thread;
 
   int _pixel_format;
+  int _decode_threads;
+  bool _frame_threading;
+  bool _direct_decode;
 
   // This global Mutex protects calls to avcodec_opencloseetc.
   static ReMutex _av_lock;
@@ -132,6 +147,14 @@ private:
   int _current_frame;
   PT(FfmpegBuffer) _current_frame_buffer;
 
+  // Buffers that are recycled once nobody else holds a reference to them.
+  typedef pvector<PT(FfmpegBuffer) > BufferPool;
+  BufferPool _buffer_pool;
+
+  // The last buffer returned in direct_decode mode, whose contents may still
+  // be pending in _frame.
+  PT(FfmpegBuffer) _deferred_buffer;
+
 private:
   // The following functions will be called in the sub-thread.
   static void st_thread_main(void *self);
@@ -140,6 +163,8 @@ private:
 
   PT(FfmpegBuffer) do_alloc_frame();
   void do_clear_all_frames();
+  void do_export_deferred();
+  void do_resolve_buffer(const Buffer *buffer);
 
   bool fetch_packet(int default_frame);
   bool do_fetch_packet(int default_frame);
@@ -152,6 +177,7 @@ private:
   void advance_to_frame(int frame);
   void reset_stream();
   void export_frame(FfmpegBuffer *buffer);
+  void export_frame_to(unsigned char *data, int stride);
 
   // The following data members will be accessed by the sub-thread.
   AVPacket *_packet;
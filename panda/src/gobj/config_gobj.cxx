@@ -301,6 +301,41 @@ ConfigVariableBool vertex_animation_align_16
           "impacts only vertex formats created within Panda subsystems; custom "
           "vertex formats are not affected."));
 
+ConfigVariableInt cpu_animation_threads
+("cpu-animation-threads", 1,
+ PRC_DESC("Specifies the number of threads that may share the work of "
+          "computing the vertex animation of a single large table of "
+          "vertices on the CPU, when hardware-animated-vertices is not in "
+          "effect.  The additional threads are taken from the engine's "
+          "job pool, which is sized by job-pool-threads.  Set this to 1 "
+          "to do all of the work in the thread that requests the animated "
+          "vertices."));
+
+ConfigVariableInt cpu_animation_thread_min_rows
+("cpu-animation-thread-min-rows", 4096,
+ PRC_DESC("The minimum number of animated vertices a table must have before "
+          "its animation is distributed among the threads specified by "
+          "cpu-animation-threads.  Smaller tables are not worth the "
+          "overhead of waking the threads."));
+
+ConfigVariableBool cpu_animation_incremental
+("cpu-animation-incremental", true,
+ PRC_DESC("When this is true, computing the vertex animation on the CPU "
+          "recomputes only the vertices affected by the sliders and joints "
+          "that have changed since the last time, leaving the rest of the "
+          "previously animated vertices alone.  Set this false to recompute "
+          "all of the vertices every time."));
+
+ConfigVariableInt texture_compression_threads
+("texture-compression-threads", 0,
+ PRC_DESC("Specifies the number of threads that may share the work of "
+          "compressing or decompressing a single large texture image on the "
+          "CPU.  The additional threads are taken from the engine's job "
+          "pool, which is sized by job-pool-threads.  The default of 0 uses "
+          "all of the threads of the pool.  Set this to 1 to do all of the "
+          "work in the thread that requests it.  The result is the same "
+          "regardless of the number of threads."));
+
 ConfigVariableEnum<AutoTextureScale> textures_power_2
 ("textures-power-2", ATS_down,
  PRC_DESC("Specify whether textures should automatically be constrained to "
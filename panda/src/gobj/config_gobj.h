@@ -54,6 +54,10 @@ extern EXPCL_PANDA_GOBJ ConfigVariableBool cache_generated_shaders;
 extern EXPCL_PANDA_GOBJ ConfigVariableBool vertices_float64;
 extern EXPCL_PANDA_GOBJ ConfigVariableInt vertex_column_alignment;
 extern EXPCL_PANDA_GOBJ ConfigVariableBool vertex_animation_align_16;
+extern EXPCL_PANDA_GOBJ ConfigVariableInt cpu_animation_threads;
+extern EXPCL_PANDA_GOBJ ConfigVariableInt cpu_animation_thread_min_rows;
+extern EXPCL_PANDA_GOBJ ConfigVariableBool cpu_animation_incremental;
+extern EXPCL_PANDA_GOBJ ConfigVariableInt texture_compression_threads;
 
 extern EXPCL_PANDA_GOBJ ConfigVariableEnum<AutoTextureScale> textures_power_2;
 extern EXPCL_PANDA_GOBJ ConfigVariableEnum<AutoTextureScale> textures_square;
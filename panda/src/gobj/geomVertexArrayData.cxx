@@ -526,17 +526,36 @@ write_datagram(BamWriter *manager, Datagram &dg, void *extra_data) const {
   GeomVertexArrayData *array_data = (GeomVertexArrayData *)extra_data;
   dg.add_uint8(_usage_hint);
 
-  dg.add_uint32(_buffer.get_size());
+  size_t size = _buffer.get_size();
+  dg.add_uint32(size);
+
+  if (manager->get_file_minor_ver() >= 46) {
+    // Large arrays may be stored outside of the object's datagram, aligned
+    // within the file so that they can be used from a memory mapping.
+    bool aligned = manager->can_align_file_data(size);
+    dg.add_bool(aligned);
+
+    if (aligned) {
+      if (manager->get_file_endian() == BamWriter::BE_native) {
+        manager->write_aligned_file_data(_buffer.get_read_pointer(true), size);
+      } else {
+        VertexDataBuffer new_buffer(size);
+        array_data->reverse_data_endianness(new_buffer.get_write_pointer(), _buffer.get_read_pointer(true), size);
+        manager->write_aligned_file_data(new_buffer.get_read_pointer(true), size);
+      }
+      return;
+    }
+  }
 
   if (manager->get_file_endian() == BamWriter::BE_native) {
     // For native endianness, we only have to write the data directly.
-    dg.append_data(_buffer.get_read_pointer(true), _buffer.get_size());
+    dg.append_data(_buffer.get_read_pointer(true), size);
 
   } else {
     // Otherwise, we have to convert it.
-    unsigned char *new_data = (unsigned char *)alloca(_buffer.get_size());
-    array_data->reverse_data_endianness(new_data, _buffer.get_read_pointer(true), _buffer.get_size());
-    dg.append_data(new_data, _buffer.get_size());
+    unsigned char *new_data = (unsigned char *)alloca(size);
+    array_data->reverse_data_endianness(new_data, _buffer.get_read_pointer(true), size);
+    dg.append_data(new_data, size);
   }
 }
 
@@ -558,15 +577,44 @@ fillin(DatagramIterator &scan, BamReader *manager, void *extra_data) {
     memcpy(_buffer.get_write_pointer(), &new_data[0], new_data.size());
 
   } else {
-    // Now, the array data is just stored directly.
     size_t size = scan.get_uint32();
-    _buffer.unclean_realloc(size);
-    _buffer.set_size(size);
 
-    const unsigned char *source_data =
-      (const unsigned char *)scan.get_datagram().get_data();
-    memcpy(_buffer.get_write_pointer(), source_data + scan.get_current_index(), size);
-    scan.skip_bytes(size);
+    if (manager->get_file_minor_ver() >= 46 && scan.get_bool()) {
+      // The array data is stored in a separate, aligned block of the file.
+      // Reference it straight from the mapped file if we can.
+      SubfileInfo info;
+      manager->read_file_data(info);
+      nassertv((size_t)info.get_size() == size);
+
+      PT(MemoryMappedFile) mapping;
+      const unsigned char *mapped_data = manager->map_file_data(info, mapping);
+      if (mapped_data != nullptr &&
+          ((uintptr_t)mapped_data % MEMORY_HOOK_ALIGNMENT) == 0) {
+        _buffer.set_mapped_data(mapping, mapped_data, size);
+      } else {
+        _buffer.unclean_realloc(size);
+        _buffer.set_size(size);
+        if (mapped_data != nullptr) {
+          memcpy(_buffer.get_write_pointer(), mapped_data, size);
+        } else if (!manager->load_file_data(info, _buffer.get_write_pointer())) {
+          memset(_buffer.get_write_pointer(), 0, size);
+        }
+      }
+
+    } else {
+      // Otherwise, the array data is just stored directly.  The BamReader may
+      // defer the copy, to do it in parallel with other arrays, unless we
+      // need to reverse the data below.
+      _buffer.unclean_realloc(size);
+      _buffer.set_size(size);
+
+      if (manager->get_file_endian() == BamReader::BE_native ||
+          array_data->_array_format == nullptr) {
+        manager->extract_bytes(scan, _buffer.get_write_pointer(), size);
+      } else {
+        scan.extract_bytes(_buffer.get_write_pointer(), size);
+      }
+    }
   }
 
   bool endian_reversed = false;
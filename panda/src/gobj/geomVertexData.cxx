@@ -21,6 +21,14 @@
 #include "bamWriter.h"
 #include "pset.h"
 #include "indent.h"
+#include "config_gobj.h"
+#include "jobGroup.h"
+#include "bitArray.h"
+
+#if defined(__SSE__) || (_M_IX86_FP >= 1) || defined(_M_X64) || defined(_M_AMD64)
+#include <xmmintrin.h>
+#define HAVE_SKINNING_SSE
+#endif
 
 using std::ostream;
 
@@ -997,6 +1005,8 @@ animate_vertices(bool force, Thread *current_thread) const {
   CDWriter cdataw(((GeomVertexData *)this)->_cycler, cdata, false);
   cdataw->_animated_vertices_modified = modified;
   ((GeomVertexData *)this)->update_animated_vertices(cdataw, current_thread);
+  cdataw->_animated_result_modified =
+    cdataw->_animated_vertices->get_modified(current_thread);
 
   return cdataw->_animated_vertices;
 }
@@ -1471,14 +1481,36 @@ update_animated_vertices(GeomVertexData::CData *cdata, Thread *current_thread) {
   }
   PT(GeomVertexData) new_data = cdata->_animated_vertices;
 
-  // We have to make a complete copy of the data first so we can modify it.
-  // If we were clever, we could maybe just figure out the subset of the data
-  // that might have changed since last frame, but that's too much trouble
-  // (and isn't obviously faster than just copying the whole thing).
-  new_data->copy_from(this, true);
+  CPT(SliderTable) slider_table = cdata->_slider_table;
+  CPT(TransformBlendTable) tb_table = cdata->_transform_blend_table.get_read_pointer(current_thread);
+  if (tb_table != nullptr) {
+    // Recompute all the blends up front, so we don't have to test each one
+    // for staleness at each vertex.
+    PStatTimer timer4(_blends_pcollector);
+    int num_blends = tb_table->get_num_blends();
+    for (int bi = 0; bi < num_blends; bi++) {
+      tb_table->get_blend(bi).update_blend(current_thread);
+    }
+  }
+
+  // Usually, only some of the sliders and transforms have changed since the
+  // last update.  In that case, the rows that they don't affect still hold
+  // the right values, and we need only recompute the others.  Otherwise, we
+  // have to make a complete copy of the data first so we can modify it.
+  SparseArray changed_rows;
+  bool incremental =
+    find_changed_animated_rows(cdata, new_data, slider_table, tb_table,
+                               changed_rows, current_thread);
+  if (incremental) {
+    if (changed_rows.is_zero()) {
+      return;
+    }
+    copy_animated_rows(new_data, changed_rows, current_thread);
+  } else {
+    new_data->copy_from(this, true);
+  }
 
   // First, apply all of the morphs.
-  CPT(SliderTable) slider_table = cdata->_slider_table;
   if (slider_table != nullptr) {
     PStatTimer timer2(_morphs_pcollector);
     int num_morphs = orig_format->get_num_morphs();
@@ -1494,8 +1526,11 @@ update_animated_vertices(GeomVertexData::CData *cdata, Thread *current_thread) {
           int slider_end = sliders.get_subrange_end(sni);
           for (int sn = slider_begin; sn < slider_end; ++sn) {
             const VertexSlider *slider = slider_table->get_slider(sn);
-            const SparseArray &rows = slider_table->get_slider_rows(sn);
+            SparseArray rows = slider_table->get_slider_rows(sn);
             nassertv(!rows.is_inverse());
+            if (incremental) {
+              rows &= changed_rows;
+            }
 
             PN_stdfloat slider_value = slider->get_slider();
             if (slider_value != 0.0f) {
@@ -1561,22 +1596,13 @@ update_animated_vertices(GeomVertexData::CData *cdata, Thread *current_thread) {
   }
 
   // Then apply the transforms.
-  CPT(TransformBlendTable) tb_table = cdata->_transform_blend_table.get_read_pointer(current_thread);
   if (tb_table != nullptr) {
-    // Recompute all the blends up front, so we don't have to test each one
-    // for staleness at each vertex.
-    {
-      PStatTimer timer4(_blends_pcollector);
-      int num_blends = tb_table->get_num_blends();
-      for (int bi = 0; bi < num_blends; bi++) {
-        tb_table->get_blend(bi).update_blend(current_thread);
-      }
-    }
-
-    // Now go through and apply the transforms.
     PStatTimer timer3(_skinning_pcollector);
 
-    const SparseArray &rows = tb_table->get_rows();
+    SparseArray rows = tb_table->get_rows();
+    if (incremental) {
+      rows &= changed_rows;
+    }
     int num_subranges = rows.get_num_subranges();
 
     int blend_array_index = orig_format->get_array_with(InternalName::get_transform_blend());
@@ -1596,6 +1622,10 @@ update_animated_vertices(GeomVertexData::CData *cdata, Thread *current_thread) {
         new GeomVertexArrayDataHandle(cdata->_arrays[blend_array_index].get_read_pointer(current_thread), current_thread);
       const unsigned short *blendt = (const unsigned short *)blend_array_handle->get_read_pointer(true);
 
+      if (skin_parallel(new_data, tb_table, rows, blendt, current_thread)) {
+        return;
+      }
+
       size_t ci;
       for (ci = 0; ci < new_format->get_num_points(); ci++) {
         GeomVertexRewriter data(new_data, new_format->get_point(ci));
@@ -1770,6 +1800,176 @@ update_animated_vertices(GeomVertexData::CData *cdata, Thread *current_thread) {
 }
 
 
+/**
+ * Compares the current values of the sliders and transform blends with the
+ * values that were applied by the last update of the animated vertices, and
+ * records the current values for next time.
+ *
+ * Returns true if the animated vertices still hold the results of the last
+ * update, in which case changed_rows is filled in with the rows that are
+ * affected by the sliders and blends that have changed since then.  Returns
+ * false if all of the rows must be recomputed.
+ */
+bool GeomVertexData::
+find_changed_animated_rows(GeomVertexData::CData *cdata,
+                           GeomVertexData *new_data,
+                           const SliderTable *slider_table,
+                           const TransformBlendTable *tb_table,
+                           SparseArray &changed_rows, Thread *current_thread) {
+  // If either this data or the animated data has been modified by anyone but
+  // us since the last update, the previous results can't be trusted.
+  bool valid = cpu_animation_incremental &&
+    cdata->_animated_source_modified == cdata->_modified &&
+    cdata->_animated_result_modified == new_data->get_modified(current_thread);
+  cdata->_animated_source_modified = cdata->_modified;
+
+  size_t num_sliders = (slider_table != nullptr) ? slider_table->get_num_sliders() : 0;
+  if (cdata->_animated_slider_values.size() != num_sliders) {
+    cdata->_animated_slider_values.assign(num_sliders, 0.0f);
+    valid = false;
+  }
+  for (size_t sn = 0; sn < num_sliders; ++sn) {
+    PN_stdfloat value = slider_table->get_slider(sn)->get_slider();
+    if (value != cdata->_animated_slider_values[sn]) {
+      cdata->_animated_slider_values[sn] = value;
+      if (valid) {
+        changed_rows |= slider_table->get_slider_rows(sn);
+      }
+    }
+  }
+
+  size_t num_blends = (tb_table != nullptr) ? tb_table->get_num_blends() : 0;
+  if (cdata->_animated_blend_mats.size() != num_blends) {
+    cdata->_animated_blend_mats.assign(num_blends, LMatrix4::zeros_mat());
+    valid = false;
+  }
+  BitArray changed_blends;
+  for (size_t bi = 0; bi < num_blends; ++bi) {
+    LMatrix4 mat;
+    tb_table->get_blend(bi).get_blend(mat, current_thread);
+    if (mat.compare_to(cdata->_animated_blend_mats[bi], 0.0f) != 0) {
+      cdata->_animated_blend_mats[bi] = mat;
+      changed_blends.set_bit(bi);
+    }
+  }
+
+  if (!valid) {
+    return false;
+  }
+
+  if (!changed_blends.is_zero()) {
+    // Find the runs of rows that use one of the blends that have changed.
+    GeomVertexReader blendi(this, InternalName::get_transform_blend(), current_thread);
+    if (!blendi.has_column()) {
+      return false;
+    }
+
+    const SparseArray &rows = tb_table->get_rows();
+    size_t num_subranges = rows.get_num_subranges();
+    for (size_t i = 0; i < num_subranges; ++i) {
+      int begin = rows.get_subrange_begin(i);
+      int end = rows.get_subrange_end(i);
+      blendi.set_row_unsafe(begin);
+
+      int run_begin = -1;
+      for (int v = begin; v < end; ++v) {
+        if (changed_blends.get_bit(blendi.get_data1i())) {
+          if (run_begin < 0) {
+            run_begin = v;
+          }
+        } else if (run_begin >= 0) {
+          changed_rows.set_range(run_begin, v - run_begin);
+          run_begin = -1;
+        }
+      }
+      if (run_begin >= 0) {
+        changed_rows.set_range(run_begin, end - run_begin);
+      }
+    }
+  }
+
+  // If most of the rows have changed anyway, it's cheaper to copy the whole
+  // table than to copy it piecemeal.
+  return changed_rows.get_num_on_bits() * 2 <= get_num_rows();
+}
+
+/**
+ * Restores the indicated rows of the columns that are modified by the
+ * animation to their original, unanimated values, in preparation for
+ * recomputing the animation of those rows.  The rest of the data in new_data
+ * is left alone.
+ */
+void GeomVertexData::
+copy_animated_rows(GeomVertexData *new_data, const SparseArray &rows,
+                   Thread *current_thread) {
+  const GeomVertexFormat *source_format = get_format();
+  const GeomVertexFormat *dest_format = new_data->get_format();
+
+  pvector<const InternalName *> names;
+  size_t num_points = dest_format->get_num_points();
+  for (size_t ci = 0; ci < num_points; ++ci) {
+    names.push_back(dest_format->get_point(ci));
+  }
+  size_t num_vectors = dest_format->get_num_vectors();
+  for (size_t ci = 0; ci < num_vectors; ++ci) {
+    names.push_back(dest_format->get_vector(ci));
+  }
+  size_t num_morphs = source_format->get_num_morphs();
+  for (size_t mi = 0; mi < num_morphs; ++mi) {
+    const InternalName *name = source_format->get_morph_base(mi);
+    if (std::find(names.begin(), names.end(), name) == names.end()) {
+      names.push_back(name);
+    }
+  }
+
+  size_t num_subranges = rows.get_num_subranges();
+  for (const InternalName *name : names) {
+    int source_i, dest_i;
+    const GeomVertexColumn *source_column, *dest_column;
+    if (!source_format->get_array_info(name, source_i, source_column) ||
+        !dest_format->get_array_info(name, dest_i, dest_column)) {
+      continue;
+    }
+
+    if (dest_column->is_bytewise_equivalent(*source_column)) {
+      // We can do a quick bytewise copy.
+      CPT(GeomVertexArrayDataHandle) source_handle = get_array_handle(source_i);
+      PT(GeomVertexArrayDataHandle) dest_handle = new_data->modify_array_handle(dest_i);
+      int from_stride = source_format->get_array(source_i)->get_stride();
+      int to_stride = dest_format->get_array(dest_i)->get_stride();
+      const unsigned char *from =
+        source_handle->get_read_pointer(true) + source_column->get_start();
+      unsigned char *to =
+        dest_handle->get_write_pointer() + dest_column->get_start();
+
+      for (size_t i = 0; i < num_subranges; ++i) {
+        int begin = rows.get_subrange_begin(i);
+        int end = rows.get_subrange_end(i);
+        bytewise_copy(to + begin * to_stride, to_stride,
+                      from + begin * from_stride, from_stride,
+                      source_column, end - begin);
+      }
+
+    } else {
+      // A generic copy.
+      GeomVertexWriter to(new_data, current_thread);
+      to.set_column(dest_i, dest_column);
+      GeomVertexReader from(this, current_thread);
+      from.set_column(source_i, source_column);
+
+      for (size_t i = 0; i < num_subranges; ++i) {
+        int begin = rows.get_subrange_begin(i);
+        int end = rows.get_subrange_end(i);
+        to.set_row_unsafe(begin);
+        from.set_row_unsafe(begin);
+        for (int j = begin; j < end; ++j) {
+          to.set_data4(from.get_data4());
+        }
+      }
+    }
+  }
+}
+
 /**
  * Transforms a range of vertices for one particular column, as a point.
  */
@@ -1829,30 +2029,7 @@ do_transform_vector_column(const GeomVertexFormat *format, GeomVertexRewriter &d
   LMatrix4 xform;
   bool normalize = false;
   if (data_column->get_contents() == C_normal) {
-    // This is to preserve perpendicularity to the surface.
-    LVecBase3 scale_sq(mat.get_row3(0).length_squared(),
-                       mat.get_row3(1).length_squared(),
-                       mat.get_row3(2).length_squared());
-    if (IS_THRESHOLD_EQUAL(scale_sq[0], scale_sq[1], 2.0e-3f) &&
-        IS_THRESHOLD_EQUAL(scale_sq[0], scale_sq[2], 2.0e-3f)) {
-      // There is a uniform scale.
-      LVecBase3 scale, shear, hpr;
-      if (IS_THRESHOLD_EQUAL(scale_sq[0], 1, 2.0e-3f)) {
-        // No scale to worry about.
-        xform = mat;
-      } else if (decompose_matrix(mat.get_upper_3(), scale, shear, hpr)) {
-        // Make a new matrix with scale/translate taken out of the equation.
-        compose_matrix(xform, LVecBase3(1, 1, 1), shear, hpr, LVecBase3::zero());
-      } else {
-        normalize = true;
-      }
-    } else {
-      // There is a non-uniform scale, so we need to do all this to preserve
-      // orthogonality to the surface.
-      xform.invert_from(mat);
-      xform.transpose_in_place();
-      normalize = true;
-    }
+    normalize = get_normal_xform(mat, xform);
   } else {
     xform = mat;
   }
@@ -1897,6 +2074,240 @@ do_transform_vector_column(const GeomVertexFormat *format, GeomVertexRewriter &d
   }
 }
 
+/**
+ * Computes the matrix that should be applied to the normals of vertices that
+ * are transformed by the indicated matrix, so that they remain perpendicular
+ * to the surface.  Returns true if the normals must also be normalized after
+ * they have been transformed by this matrix, or false if the matrix preserves
+ * their length.
+ */
+bool GeomVertexData::
+get_normal_xform(const LMatrix4 &mat, LMatrix4 &xform) {
+  LVecBase3 scale_sq(mat.get_row3(0).length_squared(),
+                     mat.get_row3(1).length_squared(),
+                     mat.get_row3(2).length_squared());
+  if (IS_THRESHOLD_EQUAL(scale_sq[0], scale_sq[1], 2.0e-3f) &&
+      IS_THRESHOLD_EQUAL(scale_sq[0], scale_sq[2], 2.0e-3f)) {
+    // There is a uniform scale.
+    LVecBase3 scale, shear, hpr;
+    if (IS_THRESHOLD_EQUAL(scale_sq[0], 1, 2.0e-3f)) {
+      // No scale to worry about.
+      xform = mat;
+      return false;
+
+    } else if (decompose_matrix(mat.get_upper_3(), scale, shear, hpr)) {
+      // Make a new matrix with scale/translate taken out of the equation.
+      compose_matrix(xform, LVecBase3(1, 1, 1), shear, hpr, LVecBase3::zero());
+      return false;
+    }
+
+    xform = mat;
+    return true;
+  }
+
+  // There is a non-uniform scale, so we need to do all this to preserve
+  // orthogonality to the surface.
+  xform.invert_from(mat);
+  xform.transpose_in_place();
+  return true;
+}
+
+/**
+ * Applies the transform blends to the indicated rows of new_data, dividing the
+ * vertices among the calling thread and the threads of the "cpu_animation"
+ * task chain.  This is the same work done by the ushort case of
+ * update_animated_vertices().
+ *
+ * Returns true if the vertices have been transformed, or false if the table
+ * is too small to be worth distributing, or has a column that the threads
+ * can't transform directly, in which case the caller should transform them
+ * instead.
+ */
+bool GeomVertexData::
+skin_parallel(GeomVertexData *new_data, const TransformBlendTable *tb_table,
+              const SparseArray &rows, const unsigned short *blendt,
+              Thread *current_thread) {
+  int num_threads = std::min((int)cpu_animation_threads,
+                             JobGroup::get_num_threads() + 1);
+  if (num_threads <= 1) {
+    return false;
+  }
+
+  int num_rows = rows.get_num_on_bits();
+  if (num_rows < cpu_animation_thread_min_rows || num_rows <= 0) {
+    return false;
+  }
+
+  // The threads write directly into the vertex tables, so every column must
+  // be a table of 3- or 4-component floats.
+  const GeomVertexFormat *format = new_data->get_format();
+  size_t num_points = format->get_num_points();
+  size_t num_columns = num_points + format->get_num_vectors();
+
+  vector_int array_indices;
+  pvector<const GeomVertexColumn *> data_columns;
+  bool any_normals = false;
+  for (size_t ci = 0; ci < num_columns; ++ci) {
+    const InternalName *name = (ci < num_points)
+      ? format->get_point(ci) : format->get_vector(ci - num_points);
+
+    int array_index;
+    const GeomVertexColumn *column;
+    if (!format->get_array_info(name, array_index, column)) {
+      return false;
+    }
+    int num_values = column->get_num_values();
+    if ((num_values != 3 && num_values != 4) ||
+        column->get_numeric_type() != NT_float32) {
+      return false;
+    }
+    if (ci >= num_points && column->get_contents() == C_normal) {
+      any_normals = true;
+    }
+    array_indices.push_back(array_index);
+    data_columns.push_back(column);
+  }
+
+  pvector<PT(GeomVertexArrayDataHandle)> handles(format->get_num_arrays());
+  SkinningColumns columns;
+  columns.reserve(num_columns);
+  for (size_t ci = 0; ci < num_columns; ++ci) {
+    PT(GeomVertexArrayDataHandle) &handle = handles[array_indices[ci]];
+    if (handle == nullptr) {
+      handle = new_data->modify_array_handle(array_indices[ci]);
+    }
+
+    const GeomVertexColumn *column = data_columns[ci];
+    SkinningColumn sc;
+    sc._datat = handle->get_write_pointer() + column->get_start();
+    sc._stride = handle->get_array_format()->get_stride();
+    sc._num_values = column->get_num_values();
+    sc._is_point = (ci < num_points);
+    sc._is_normal = !sc._is_point && column->get_contents() == C_normal;
+    columns.push_back(sc);
+  }
+
+  // Divide the rows into runs of vertices that share the same blend, and
+  // look up the matrix of each blend that is used.  Runs longer than a chunk
+  // are broken up, so that a table with only a few blends can still be
+  // distributed.
+  int chunk_rows = std::max(num_rows / (num_threads * 4), 64);
+
+  SkinningBlends blends(tb_table->get_num_blends());
+  for (SkinningBlend &blend : blends) {
+    blend._computed = false;
+  }
+
+  SkinningRuns runs;
+  size_t num_subranges = rows.get_num_subranges();
+  for (size_t i = 0; i < num_subranges; ++i) {
+    int begin = rows.get_subrange_begin(i);
+    int end = rows.get_subrange_end(i);
+    nassertr(begin < end, false);
+
+    int first_vertex = begin;
+    while (first_vertex < end) {
+      int bi = blendt[first_vertex];
+      int next_vertex = first_vertex + 1;
+      int max_vertex = std::min(end, first_vertex + chunk_rows);
+      while (next_vertex < max_vertex && blendt[next_vertex] == bi) {
+        ++next_vertex;
+      }
+
+      nassertr(bi >= 0 && bi < (int)blends.size(), false);
+      SkinningBlend &blend = blends[bi];
+      if (!blend._computed) {
+        LMatrix4 mat;
+        tb_table->get_blend(bi).get_blend(mat, current_thread);
+        blend._mat = LCAST(float, mat);
+        blend._normalize = false;
+        if (any_normals) {
+          LMatrix4 xform;
+          blend._normalize = get_normal_xform(mat, xform);
+          blend._normal_mat = LCAST(float, xform);
+        }
+        blend._computed = true;
+      }
+
+      SkinningRun run;
+      run._begin = first_vertex;
+      run._end = next_vertex;
+      run._bi = bi;
+      runs.push_back(run);
+
+      first_vertex = next_vertex;
+    }
+  }
+
+  // Now group the runs into chunks of roughly chunk_rows vertices.
+  ParallelSkinning ps;
+  ps._columns = &columns;
+  ps._blends = &blends;
+  ps._runs = &runs;
+
+  int chunk_count = 0;
+  for (int ri = 0; ri < (int)runs.size(); ++ri) {
+    if (chunk_count == 0) {
+      ps._chunks.push_back(ri);
+    }
+    chunk_count += runs[ri]._end - runs[ri]._begin;
+    if (chunk_count >= chunk_rows) {
+      chunk_count = 0;
+    }
+  }
+  int num_chunks = (int)ps._chunks.size();
+  ps._chunks.push_back((int)runs.size());
+
+  JobGroup group(num_chunks, &st_skinning_chunk, &ps);
+  group.wait(current_thread);
+
+  return true;
+}
+
+/**
+ * Transforms the vertices of the indicated range of runs, in all of the
+ * columns.
+ */
+void GeomVertexData::
+do_skinning_runs(const ParallelSkinning &ps, int begin_run, int end_run) {
+  const SkinningColumns &columns = *ps._columns;
+  for (int ri = begin_run; ri < end_run; ++ri) {
+    const SkinningRun &run = (*ps._runs)[ri];
+    const SkinningBlend &blend = (*ps._blends)[run._bi];
+    size_t num_rows = run._end - run._begin;
+
+    for (const SkinningColumn &column : columns) {
+      unsigned char *datat = column._datat + run._begin * column._stride;
+      if (column._is_point) {
+        if (column._num_values == 3) {
+          table_xform_point3f(datat, num_rows, column._stride, blend._mat);
+        } else {
+          table_xform_vecbase4f(datat, num_rows, column._stride, blend._mat);
+        }
+      } else {
+        const LMatrix4f &matf = column._is_normal ? blend._normal_mat : blend._mat;
+        if (column._is_normal && blend._normalize) {
+          table_xform_normal3f(datat, num_rows, column._stride, matf);
+        } else if (column._num_values == 3) {
+          table_xform_vector3f(datat, num_rows, column._stride, matf);
+        } else {
+          table_xform_vecbase4f(datat, num_rows, column._stride, matf);
+        }
+      }
+    }
+  }
+}
+
+/**
+ * The JobGroup function that transforms the vertices of the indicated chunk
+ * of runs, for skin_parallel().
+ */
+void GeomVertexData::
+st_skinning_chunk(size_t chunk, void *data) {
+  const ParallelSkinning &ps = *(const ParallelSkinning *)data;
+  do_skinning_runs(ps, ps._chunks[chunk], ps._chunks[chunk + 1]);
+}
+
 /**
  * Transforms each of the LPoint3f objects in the indicated table by the
  * indicated matrix.
@@ -1904,12 +2315,30 @@ do_transform_vector_column(const GeomVertexFormat *format, GeomVertexRewriter &d
 void GeomVertexData::
 table_xform_point3f(unsigned char *datat, size_t num_rows, size_t stride,
                     const LMatrix4f &matf) {
+#ifdef HAVE_SKINNING_SSE
+  const float *m = matf.get_data();
+  const __m128 row0 = _mm_loadu_ps(m);
+  const __m128 row1 = _mm_loadu_ps(m + 4);
+  const __m128 row2 = _mm_loadu_ps(m + 8);
+  const __m128 row3 = _mm_loadu_ps(m + 12);
+  for (size_t i = 0; i < num_rows; ++i) {
+    float *v = (float *)(&datat[i * stride]);
+    __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(v[0]), row0),
+                                     _mm_mul_ps(_mm_set1_ps(v[1]), row1)),
+                          _mm_add_ps(_mm_mul_ps(_mm_set1_ps(v[2]), row2), row3));
+    // Write back only the first three components; the fourth float may be
+    // another column, or past the end of the table.
+    _mm_storel_pi((__m64 *)v, r);
+    _mm_store_ss(v + 2, _mm_movehl_ps(r, r));
+  }
+#else  // HAVE_SKINNING_SSE
   // We don't bother checking for the unaligned case here, because in practice
   // it doesn't matter with a 3-component point.
   for (size_t i = 0; i < num_rows; ++i) {
     LPoint3f &vertex = *(LPoint3f *)(&datat[i * stride]);
     vertex *= matf;
   }
+#endif  // HAVE_SKINNING_SSE
 }
 
 /**
@@ -1919,6 +2348,30 @@ table_xform_point3f(unsigned char *datat, size_t num_rows, size_t stride,
 void GeomVertexData::
 table_xform_normal3f(unsigned char *datat, size_t num_rows, size_t stride,
                      const LMatrix4f &matf) {
+#ifdef HAVE_SKINNING_SSE
+  const float *m = matf.get_data();
+  const __m128 row0 = _mm_loadu_ps(m);
+  const __m128 row1 = _mm_loadu_ps(m + 4);
+  const __m128 row2 = _mm_loadu_ps(m + 8);
+  for (size_t i = 0; i < num_rows; ++i) {
+    float *v = (float *)(&datat[i * stride]);
+    __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(v[0]), row0),
+                                     _mm_mul_ps(_mm_set1_ps(v[1]), row1)),
+                          _mm_mul_ps(_mm_set1_ps(v[2]), row2));
+
+    // Normalize the result the same way LVecBase3f::normalize() does.
+    __m128 sq = _mm_mul_ps(r, r);
+    float l2 = _mm_cvtss_f32(_mm_add_ss(_mm_add_ss(sq, _mm_shuffle_ps(sq, sq, 1)),
+                                        _mm_movehl_ps(sq, sq)));
+    if (l2 == 0.0f) {
+      r = _mm_setzero_ps();
+    } else if (!IS_THRESHOLD_EQUAL(l2, 1.0f, (NEARLY_ZERO(float) * NEARLY_ZERO(float)))) {
+      r = _mm_div_ps(r, _mm_set1_ps(csqrt(l2)));
+    }
+    _mm_storel_pi((__m64 *)v, r);
+    _mm_store_ss(v + 2, _mm_movehl_ps(r, r));
+  }
+#else  // HAVE_SKINNING_SSE
   // We don't bother checking for the unaligned case here, because in practice
   // it doesn't matter with a 3-component vector.
   for (size_t i = 0; i < num_rows; ++i) {
@@ -1926,6 +2379,7 @@ table_xform_normal3f(unsigned char *datat, size_t num_rows, size_t stride,
     vertex *= matf;
     vertex.normalize();
   }
+#endif  // HAVE_SKINNING_SSE
 }
 
 /**
@@ -1935,12 +2389,27 @@ table_xform_normal3f(unsigned char *datat, size_t num_rows, size_t stride,
 void GeomVertexData::
 table_xform_vector3f(unsigned char *datat, size_t num_rows, size_t stride,
                      const LMatrix4f &matf) {
+#ifdef HAVE_SKINNING_SSE
+  const float *m = matf.get_data();
+  const __m128 row0 = _mm_loadu_ps(m);
+  const __m128 row1 = _mm_loadu_ps(m + 4);
+  const __m128 row2 = _mm_loadu_ps(m + 8);
+  for (size_t i = 0; i < num_rows; ++i) {
+    float *v = (float *)(&datat[i * stride]);
+    __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(v[0]), row0),
+                                     _mm_mul_ps(_mm_set1_ps(v[1]), row1)),
+                          _mm_mul_ps(_mm_set1_ps(v[2]), row2));
+    _mm_storel_pi((__m64 *)v, r);
+    _mm_store_ss(v + 2, _mm_movehl_ps(r, r));
+  }
+#else  // HAVE_SKINNING_SSE
   // We don't bother checking for the unaligned case here, because in practice
   // it doesn't matter with a 3-component vector.
   for (size_t i = 0; i < num_rows; ++i) {
     LVector3f &vertex = *(LVector3f *)(&datat[i * stride]);
     vertex *= matf;
   }
+#endif  // HAVE_SKINNING_SSE
 }
 
 /**
@@ -1950,6 +2419,23 @@ table_xform_vector3f(unsigned char *datat, size_t num_rows, size_t stride,
 void GeomVertexData::
 table_xform_vecbase4f(unsigned char *datat, size_t num_rows, size_t stride,
                       const LMatrix4f &matf) {
+#ifdef HAVE_SKINNING_SSE
+  // The unaligned loads and stores are as fast as the aligned ones when the
+  // table does happen to be aligned, so we don't need to check for that.
+  const float *m = matf.get_data();
+  const __m128 row0 = _mm_loadu_ps(m);
+  const __m128 row1 = _mm_loadu_ps(m + 4);
+  const __m128 row2 = _mm_loadu_ps(m + 8);
+  const __m128 row3 = _mm_loadu_ps(m + 12);
+  for (size_t i = 0; i < num_rows; ++i) {
+    float *v = (float *)(&datat[i * stride]);
+    __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(v[0]), row0),
+                                     _mm_mul_ps(_mm_set1_ps(v[1]), row1)),
+                          _mm_add_ps(_mm_mul_ps(_mm_set1_ps(v[2]), row2),
+                                     _mm_mul_ps(_mm_set1_ps(v[3]), row3)));
+    _mm_storeu_ps(v, r);
+  }
+#else  // HAVE_SKINNING_SSE
 #if defined(HAVE_EIGEN) && defined(LINMATH_ALIGN)
   // Check if the table is unaligned.  If it is, we can't use the LVecBase4f
   // object directly, which assumes 16-byte alignment.
@@ -1971,6 +2457,7 @@ table_xform_vecbase4f(unsigned char *datat, size_t num_rows, size_t stride,
     LVecBase4f &vertex = *(LVecBase4f *)(&datat[i * stride]);
     vertex *= matf;
   }
+#endif  // HAVE_SKINNING_SSE
 }
 
 /**
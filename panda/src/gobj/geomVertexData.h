@@ -37,7 +37,10 @@
 #include "pointerTo.h"
 #include "pmap.h"
 #include "pvector.h"
+#include "epvector.h"
+#include "vector_stdfloat.h"
 #include "deletedChain.h"
+#include "vector_int.h"
 
 class FactoryParams;
 class GeomVertexColumn;
@@ -311,6 +314,13 @@ private:
     UpdateSeq _animated_vertices_modified;
     UpdateSeq _modified;
 
+    // These record the inputs of the last update of _animated_vertices, so
+    // that the next update need only recompute the rows that have changed.
+    UpdateSeq _animated_source_modified;
+    UpdateSeq _animated_result_modified;
+    vector_stdfloat _animated_slider_values;
+    epvector<LMatrix4> _animated_blend_mats;
+
   public:
     static TypeHandle get_class_type() {
       return _type_handle;
@@ -335,6 +345,13 @@ private:
 
 private:
   void update_animated_vertices(CData *cdata, Thread *current_thread);
+  bool find_changed_animated_rows(CData *cdata, GeomVertexData *new_data,
+                                  const SliderTable *slider_table,
+                                  const TransformBlendTable *tb_table,
+                                  SparseArray &changed_rows,
+                                  Thread *current_thread);
+  void copy_animated_rows(GeomVertexData *new_data, const SparseArray &rows,
+                          Thread *current_thread);
   void do_transform_point_column(const GeomVertexFormat *format, GeomVertexRewriter &data,
                                  const LMatrix4 &mat, int begin_row, int end_row);
   void do_transform_vector_column(const GeomVertexFormat *format, GeomVertexRewriter &data,
@@ -347,6 +364,52 @@ private:
                                    size_t stride, const LMatrix4f &matf);
   static void table_xform_vecbase4f(unsigned char *datat, size_t num_rows,
                                     size_t stride, const LMatrix4f &matf);
+  static bool get_normal_xform(const LMatrix4 &mat, LMatrix4 &xform);
+
+  // These are used by update_animated_vertices() to distribute the skinning
+  // of a large table among several threads.
+  class SkinningColumn {
+  public:
+    unsigned char *_datat;
+    size_t _stride;
+    int _num_values;
+    bool _is_point;
+    bool _is_normal;
+  };
+  typedef pvector<SkinningColumn> SkinningColumns;
+
+  class SkinningBlend {
+  public:
+    LMatrix4f _mat;
+    LMatrix4f _normal_mat;
+    bool _normalize;
+    bool _computed;
+  };
+  typedef pvector<SkinningBlend> SkinningBlends;
+
+  class SkinningRun {
+  public:
+    int _begin;
+    int _end;
+    int _bi;
+  };
+  typedef pvector<SkinningRun> SkinningRuns;
+
+  class ParallelSkinning {
+  public:
+    const SkinningColumns *_columns;
+    const SkinningBlends *_blends;
+    const SkinningRuns *_runs;
+    vector_int _chunks;
+  };
+
+  bool skin_parallel(GeomVertexData *new_data,
+                     const TransformBlendTable *tb_table,
+                     const SparseArray &rows,
+                     const unsigned short *blendt, Thread *current_thread);
+  static void do_skinning_runs(const ParallelSkinning &ps,
+                               int begin_run, int end_run);
+  static void st_skinning_chunk(size_t chunk, void *data);
 
   static PStatCollector _convert_pcollector;
   static PStatCollector _scale_color_pcollector;
@@ -42,6 +42,7 @@
 #include "streamReader.h"
 #include "texturePeeker.h"
 #include "convert_srgb.h"
+#include "jobGroup.h"
 
 #ifdef HAVE_SQUISH
 #include <squish.h>
@@ -49,6 +50,11 @@
 
 #include <stddef.h>
 
+#if defined(__SSE2__) || (_M_IX86_FP >= 2) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define HAVE_RGTC_SSE2
+#endif
+
 using std::endl;
 using std::istream;
 using std::max;
@@ -6045,93 +6051,21 @@ do_compress_ram_image_bc4(const RamImage &uncompressed_image,
   int x_blocks = (x_size >> 2);
   int y_blocks = (y_size >> 2);
 
-  // NB. This algorithm isn't fully optimal, since it doesn't try to make use
-  // of the secondary interpolation mode supported by BC4.  This is not
-  // important for most textures, but it may be added in the future.
-
   nassertv((size_t)x_blocks * (size_t)y_blocks * 4 * 4 <= uncompressed_image._page_size);
   nassertv((size_t)x_size * (size_t)y_size == uncompressed_image._page_size);
 
-  static const int remap[] = {1, 7, 6, 5, 4, 3, 2, 0};
-
-  for (int z = 0; z < num_pages; ++z) {
-    unsigned char *dest = compressed_image._image.p() + z * compressed_image._page_size;
-    unsigned const char *src = uncompressed_image._image.p() + z * uncompressed_image._page_size;
-
-    // Convert one 4 x 4 block at a time.
-    for (int y = 0; y < y_blocks; ++y) {
-      for (int x = 0; x < x_blocks; ++x) {
-        int a, b, c, d;
-        float fac, add;
-        unsigned char minv, maxv;
-        unsigned const char *blk = src;
-
-        // Find the minimum and maximum value in the block.
-        minv = blk[0];
-        maxv = blk[0];
-        minv = min(blk[1], minv); maxv = max(blk[1], maxv);
-        minv = min(blk[2], minv); maxv = max(blk[2], maxv);
-        minv = min(blk[3], minv); maxv = max(blk[3], maxv);
-        blk += x_size;
-        minv = min(blk[0], minv); maxv = max(blk[0], maxv);
-        minv = min(blk[1], minv); maxv = max(blk[1], maxv);
-        minv = min(blk[2], minv); maxv = max(blk[2], maxv);
-        minv = min(blk[3], minv); maxv = max(blk[3], maxv);
-        blk += x_size;
-        minv = min(blk[0], minv); maxv = max(blk[0], maxv);
-        minv = min(blk[1], minv); maxv = max(blk[1], maxv);
-        minv = min(blk[2], minv); maxv = max(blk[2], maxv);
-        minv = min(blk[3], minv); maxv = max(blk[3], maxv);
-        blk += x_size;
-        minv = min(blk[0], minv); maxv = max(blk[0], maxv);
-        minv = min(blk[1], minv); maxv = max(blk[1], maxv);
-        minv = min(blk[2], minv); maxv = max(blk[2], maxv);
-        minv = min(blk[3], minv); maxv = max(blk[3], maxv);
-
-        // Now calculate the index for each pixel.
-        blk = src;
-        if (maxv > minv) {
-          fac = 7.5f / (maxv - minv);
-        } else {
-          fac = 0;
-        }
-        add = -minv * fac;
-        a = (remap[(int)(blk[0] * fac + add)])
-          | (remap[(int)(blk[1] * fac + add)] << 3)
-          | (remap[(int)(blk[2] * fac + add)] << 6)
-          | (remap[(int)(blk[3] * fac + add)] << 9);
-        blk += x_size;
-        b = (remap[(int)(blk[0] * fac + add)] << 4)
-          | (remap[(int)(blk[1] * fac + add)] << 7)
-          | (remap[(int)(blk[2] * fac + add)] << 10)
-          | (remap[(int)(blk[3] * fac + add)] << 13);
-        blk += x_size;
-        c = (remap[(int)(blk[0] * fac + add)])
-          | (remap[(int)(blk[1] * fac + add)] << 3)
-          | (remap[(int)(blk[2] * fac + add)] << 6)
-          | (remap[(int)(blk[3] * fac + add)] << 9);
-        blk += x_size;
-        d = (remap[(int)(blk[0] * fac + add)] << 4)
-          | (remap[(int)(blk[1] * fac + add)] << 7)
-          | (remap[(int)(blk[2] * fac + add)] << 10)
-          | (remap[(int)(blk[3] * fac + add)] << 13);
-
-        *(dest++) = maxv;
-        *(dest++) = minv;
-        *(dest++) = a & 0xff;
-        *(dest++) = (a >> 8) | (b & 0xf0);
-        *(dest++) = b >> 8;
-        *(dest++) = c & 0xff;
-        *(dest++) = (c >> 8) | (d & 0xf0);
-        *(dest++) = d >> 8;
-
-        // Advance to the beginning of the next 4x4 block.
-        src += 4;
-      }
-      src += x_size * 3;
-    }
-    Thread::consider_yield();
-  }
+  BlockConversion conv;
+  conv._func = &compress_bc4_rows;
+  conv._src = uncompressed_image._image.p();
+  conv._src_page_size = uncompressed_image._page_size;
+  conv._dest = compressed_image._image.p();
+  conv._dest_page_size = compressed_image._page_size;
+  conv._x_size = x_size;
+  conv._rows_per_page = y_blocks;
+  conv._num_pages = num_pages;
+  conv._num_components = 1;
+  conv._squish_flags = 0;
+  convert_blocks(conv);
 }
 
 /**
@@ -6145,152 +6079,21 @@ do_compress_ram_image_bc5(const RamImage &uncompressed_image,
   int y_blocks = (y_size >> 2);
   int stride = x_size * 2;
 
-  // BC5 uses the same compression algorithm as BC4, except repeated for two
-  // channels.
-
   nassertv((size_t)x_blocks * (size_t)y_blocks * 4 * 4 * 2 <= uncompressed_image._page_size);
   nassertv((size_t)stride * (size_t)y_size == uncompressed_image._page_size);
 
-  static const int remap[] = {1, 7, 6, 5, 4, 3, 2, 0};
-
-  for (int z = 0; z < num_pages; ++z) {
-    unsigned char *dest = compressed_image._image.p() + z * compressed_image._page_size;
-    unsigned const char *src = uncompressed_image._image.p() + z * uncompressed_image._page_size;
-
-    // Convert one 4 x 4 block at a time.
-    for (int y = 0; y < y_blocks; ++y) {
-      for (int x = 0; x < x_blocks; ++x) {
-        int a, b, c, d;
-        float fac, add;
-        unsigned char minv, maxv;
-        unsigned const char *blk = src;
-
-        // Find the minimum and maximum red value in the block.
-        minv = blk[0];
-        maxv = blk[0];
-        minv = min(blk[2], minv); maxv = max(blk[2], maxv);
-        minv = min(blk[4], minv); maxv = max(blk[4], maxv);
-        minv = min(blk[6], minv); maxv = max(blk[6], maxv);
-        blk += stride;
-        minv = min(blk[0], minv); maxv = max(blk[0], maxv);
-        minv = min(blk[2], minv); maxv = max(blk[2], maxv);
-        minv = min(blk[4], minv); maxv = max(blk[4], maxv);
-        minv = min(blk[6], minv); maxv = max(blk[6], maxv);
-        blk += stride;
-        minv = min(blk[0], minv); maxv = max(blk[0], maxv);
-        minv = min(blk[2], minv); maxv = max(blk[2], maxv);
-        minv = min(blk[4], minv); maxv = max(blk[4], maxv);
-        minv = min(blk[6], minv); maxv = max(blk[6], maxv);
-        blk += stride;
-        minv = min(blk[0], minv); maxv = max(blk[0], maxv);
-        minv = min(blk[2], minv); maxv = max(blk[2], maxv);
-        minv = min(blk[4], minv); maxv = max(blk[4], maxv);
-        minv = min(blk[6], minv); maxv = max(blk[6], maxv);
-
-        // Now calculate the index for each pixel.
-        if (maxv > minv) {
-          fac = 7.5f / (maxv - minv);
-        } else {
-          fac = 0;
-        }
-        add = -minv * fac;
-        blk = src;
-        a = (remap[(int)(blk[0] * fac + add)])
-          | (remap[(int)(blk[2] * fac + add)] << 3)
-          | (remap[(int)(blk[4] * fac + add)] << 6)
-          | (remap[(int)(blk[6] * fac + add)] << 9);
-        blk += stride;
-        b = (remap[(int)(blk[0] * fac + add)] << 4)
-          | (remap[(int)(blk[2] * fac + add)] << 7)
-          | (remap[(int)(blk[4] * fac + add)] << 10)
-          | (remap[(int)(blk[6] * fac + add)] << 13);
-        blk += stride;
-        c = (remap[(int)(blk[0] * fac + add)])
-          | (remap[(int)(blk[2] * fac + add)] << 3)
-          | (remap[(int)(blk[4] * fac + add)] << 6)
-          | (remap[(int)(blk[6] * fac + add)] << 9);
-        blk += stride;
-        d = (remap[(int)(blk[0] * fac + add)] << 4)
-          | (remap[(int)(blk[2] * fac + add)] << 7)
-          | (remap[(int)(blk[4] * fac + add)] << 10)
-          | (remap[(int)(blk[6] * fac + add)] << 13);
-
-        *(dest++) = maxv;
-        *(dest++) = minv;
-        *(dest++) = a & 0xff;
-        *(dest++) = (a >> 8) | (b & 0xf0);
-        *(dest++) = b >> 8;
-        *(dest++) = c & 0xff;
-        *(dest++) = (c >> 8) | (d & 0xf0);
-        *(dest++) = d >> 8;
-
-        // Find the minimum and maximum green value in the block.
-        blk = src + 1;
-        minv = blk[0];
-        maxv = blk[0];
-        minv = min(blk[2], minv); maxv = max(blk[2], maxv);
-        minv = min(blk[4], minv); maxv = max(blk[4], maxv);
-        minv = min(blk[6], minv); maxv = max(blk[6], maxv);
-        blk += stride;
-        minv = min(blk[0], minv); maxv = max(blk[0], maxv);
-        minv = min(blk[2], minv); maxv = max(blk[2], maxv);
-        minv = min(blk[4], minv); maxv = max(blk[4], maxv);
-        minv = min(blk[6], minv); maxv = max(blk[6], maxv);
-        blk += stride;
-        minv = min(blk[0], minv); maxv = max(blk[0], maxv);
-        minv = min(blk[2], minv); maxv = max(blk[2], maxv);
-        minv = min(blk[4], minv); maxv = max(blk[4], maxv);
-        minv = min(blk[6], minv); maxv = max(blk[6], maxv);
-        blk += stride;
-        minv = min(blk[0], minv); maxv = max(blk[0], maxv);
-        minv = min(blk[2], minv); maxv = max(blk[2], maxv);
-        minv = min(blk[4], minv); maxv = max(blk[4], maxv);
-        minv = min(blk[6], minv); maxv = max(blk[6], maxv);
-
-        // Now calculate the index for each pixel.
-        if (maxv > minv) {
-          fac = 7.5f / (maxv - minv);
-        } else {
-          fac = 0;
-        }
-        add = -minv * fac;
-        blk = src + 1;
-        a = (remap[(int)(blk[0] * fac + add)])
-          | (remap[(int)(blk[2] * fac + add)] << 3)
-          | (remap[(int)(blk[4] * fac + add)] << 6)
-          | (remap[(int)(blk[6] * fac + add)] << 9);
-        blk += stride;
-        b = (remap[(int)(blk[0] * fac + add)] << 4)
-          | (remap[(int)(blk[2] * fac + add)] << 7)
-          | (remap[(int)(blk[4] * fac + add)] << 10)
-          | (remap[(int)(blk[6] * fac + add)] << 13);
-        blk += stride;
-        c = (remap[(int)(blk[0] * fac + add)])
-          | (remap[(int)(blk[2] * fac + add)] << 3)
-          | (remap[(int)(blk[4] * fac + add)] << 6)
-          | (remap[(int)(blk[6] * fac + add)] << 9);
-        blk += stride;
-        d = (remap[(int)(blk[0] * fac + add)] << 4)
-          | (remap[(int)(blk[2] * fac + add)] << 7)
-          | (remap[(int)(blk[4] * fac + add)] << 10)
-          | (remap[(int)(blk[6] * fac + add)] << 13);
-
-        *(dest++) = maxv;
-        *(dest++) = minv;
-        *(dest++) = a & 0xff;
-        *(dest++) = (a >> 8) | (b & 0xf0);
-        *(dest++) = b >> 8;
-        *(dest++) = c & 0xff;
-        *(dest++) = (c >> 8) | (d & 0xf0);
-        *(dest++) = d >> 8;
-
-        // Advance to the beginning of the next 4x4 block.
-        src += 8;
-      }
-      src += stride * 3;
-    }
-    Thread::consider_yield();
-  }
+  BlockConversion conv;
+  conv._func = &compress_bc5_rows;
+  conv._src = uncompressed_image._image.p();
+  conv._src_page_size = uncompressed_image._page_size;
+  conv._dest = compressed_image._image.p();
+  conv._dest_page_size = compressed_image._page_size;
+  conv._x_size = x_size;
+  conv._rows_per_page = y_blocks;
+  conv._num_pages = num_pages;
+  conv._num_components = 2;
+  conv._squish_flags = 0;
+  convert_blocks(conv);
 }
 
 /**
@@ -6300,63 +6103,18 @@ void Texture::
 do_uncompress_ram_image_bc4(const RamImage &compressed_image,
                             RamImage &uncompressed_image,
                             int x_size, int y_size, int num_pages) {
-  int x_blocks = (x_size >> 2);
-  int y_blocks = (y_size >> 2);
-
-  for (int z = 0; z < num_pages; ++z) {
-    unsigned char *dest = uncompressed_image._image.p() + z * uncompressed_image._page_size;
-    unsigned const char *src = compressed_image._image.p() + z * compressed_image._page_size;
-
-    // Unconvert one 4 x 4 block at a time.
-    uint8_t tbl[8];
-    for (int y = 0; y < y_blocks; ++y) {
-      for (int x = 0; x < x_blocks; ++x) {
-        unsigned char *blk = dest;
-        tbl[0] = src[0];
-        tbl[1] = src[1];
-        if (tbl[0] > tbl[1]) {
-          tbl[2] = (tbl[0] * 6 + tbl[1] * 1) / 7.0f;
-          tbl[3] = (tbl[0] * 5 + tbl[1] * 2) / 7.0f;
-          tbl[4] = (tbl[0] * 4 + tbl[1] * 3) / 7.0f;
-          tbl[5] = (tbl[0] * 3 + tbl[1] * 4) / 7.0f;
-          tbl[6] = (tbl[0] * 2 + tbl[1] * 5) / 7.0f;
-          tbl[7] = (tbl[0] * 1 + tbl[1] * 6) / 7.0f;
-        } else {
-          tbl[2] = (tbl[0] * 4 + tbl[1] * 1) / 5.0f;
-          tbl[3] = (tbl[0] * 3 + tbl[1] * 2) / 5.0f;
-          tbl[4] = (tbl[0] * 2 + tbl[1] * 3) / 5.0f;
-          tbl[5] = (tbl[0] * 1 + tbl[1] * 4) / 5.0f;
-          tbl[6] = 0;
-          tbl[7] = 255;
-        }
-        int v = src[2] + (src[3] << 8) + (src[4] << 16);
-        blk[0] = tbl[v & 0x7];
-        blk[1] = tbl[(v & 0x000038) >> 3];
-        blk[2] = tbl[(v & 0x0001c0) >> 6];
-        blk[3] = tbl[(v & 0x000e00) >> 9];
-        blk += x_size;
-        blk[0] = tbl[(v & 0x007000) >> 12];
-        blk[1] = tbl[(v & 0x038000) >> 15];
-        blk[2] = tbl[(v & 0x1c0000) >> 18];
-        blk[3] = tbl[(v & 0xe00000) >> 21];
-        blk += x_size;
-        v = src[5] + (src[6] << 8) + (src[7] << 16);
-        blk[0] = tbl[v & 0x7];
-        blk[1] = tbl[(v & 0x000038) >> 3];
-        blk[2] = tbl[(v & 0x0001c0) >> 6];
-        blk[3] = tbl[(v & 0x000e00) >> 9];
-        blk += x_size;
-        blk[0] = tbl[(v & 0x007000) >> 12];
-        blk[1] = tbl[(v & 0x038000) >> 15];
-        blk[2] = tbl[(v & 0x1c0000) >> 18];
-        blk[3] = tbl[(v & 0xe00000) >> 21];
-        src += 8;
-        dest += 4;
-      }
-      dest += x_size * 3;
-    }
-    Thread::consider_yield();
-  }
+  BlockConversion conv;
+  conv._func = &uncompress_bc4_rows;
+  conv._src = compressed_image._image.p();
+  conv._src_page_size = compressed_image._page_size;
+  conv._dest = uncompressed_image._image.p();
+  conv._dest_page_size = uncompressed_image._page_size;
+  conv._x_size = x_size;
+  conv._rows_per_page = (y_size >> 2);
+  conv._num_pages = num_pages;
+  conv._num_components = 1;
+  conv._squish_flags = 0;
+  convert_blocks(conv);
 }
 
 /**
@@ -6366,99 +6124,628 @@ void Texture::
 do_uncompress_ram_image_bc5(const RamImage &compressed_image,
                             RamImage &uncompressed_image,
                             int x_size, int y_size, int num_pages) {
+  BlockConversion conv;
+  conv._func = &uncompress_bc5_rows;
+  conv._src = compressed_image._image.p();
+  conv._src_page_size = compressed_image._page_size;
+  conv._dest = uncompressed_image._image.p();
+  conv._dest_page_size = uncompressed_image._page_size;
+  conv._x_size = x_size;
+  conv._rows_per_page = (y_size >> 2);
+  conv._num_pages = num_pages;
+  conv._num_components = 2;
+  conv._squish_flags = 0;
+  convert_blocks(conv);
+}
+
+/**
+ * Converts all of the rows of blocks described by the BlockConversion.  If
+ * the image is large enough, the rows are divided into chunks, which are
+ * converted in parallel on the job pool; see texture-compression-threads.
+ * Since each row of blocks is converted independently, the result is the
+ * same either way.
+ */
+void Texture::
+convert_blocks(BlockConversion &conv) {
+  int num_threads = texture_compression_threads;
+  if (num_threads <= 0) {
+    num_threads = JobGroup::get_num_threads() + 1;
+  } else {
+    num_threads = std::min(num_threads, JobGroup::get_num_threads() + 1);
+  }
+
+  // Don't bother waking up the threads for a small image.
+  static const size_t min_blocks_per_chunk = 4096;
+  size_t x_blocks = (size_t)((conv._x_size + 3) >> 2);
+  size_t num_rows = (size_t)conv._rows_per_page * (size_t)conv._num_pages;
+  size_t max_chunks = (x_blocks * num_rows) / min_blocks_per_chunk;
+  conv._num_chunks = (int)std::min((size_t)num_threads, max_chunks);
+
+  if (conv._num_chunks <= 1) {
+    for (int z = 0; z < conv._num_pages; ++z) {
+      (*conv._func)(conv, z, 0, conv._rows_per_page);
+      Thread::consider_yield();
+    }
+    return;
+  }
+
+  JobGroup group(conv._num_chunks, &st_convert_block_chunk, &conv);
+  group.wait();
+}
+
+/**
+ * The JobGroup function that converts the indicated chunk of rows of blocks,
+ * for convert_blocks().  The rows of all of the pages are numbered
+ * consecutively, and each chunk gets an equal share of them, which may span
+ * more than one page.
+ */
+void Texture::
+st_convert_block_chunk(size_t chunk, void *data) {
+  const BlockConversion &conv = *(const BlockConversion *)data;
+  size_t num_rows = (size_t)conv._rows_per_page * (size_t)conv._num_pages;
+  size_t begin = num_rows * chunk / conv._num_chunks;
+  size_t end = num_rows * (chunk + 1) / conv._num_chunks;
+
+  while (begin < end) {
+    int z = (int)(begin / conv._rows_per_page);
+    int begin_row = (int)(begin % conv._rows_per_page);
+    int end_row = (int)std::min((size_t)conv._rows_per_page,
+                                begin_row + (end - begin));
+    (*conv._func)(conv, z, begin_row, end_row);
+    begin += end_row - begin_row;
+  }
+}
+
+#ifdef HAVE_RGTC_SSE2
+/**
+ * Encodes a single channel of a 4x4 block, given as 16 values in row order,
+ * into the 8 bytes of a BC4 block.  This produces exactly the same result as
+ * the scalar code in compress_bc4_rows().
+ */
+static INLINE void
+encode_rgtc_block_sse2(__m128i values, unsigned char *dest) {
+  // Find the minimum and maximum value in the block.
+  __m128i minv = _mm_min_epu8(values, _mm_srli_si128(values, 8));
+  __m128i maxv = _mm_max_epu8(values, _mm_srli_si128(values, 8));
+  minv = _mm_min_epu8(minv, _mm_srli_si128(minv, 4));
+  maxv = _mm_max_epu8(maxv, _mm_srli_si128(maxv, 4));
+  minv = _mm_min_epu8(minv, _mm_srli_si128(minv, 2));
+  maxv = _mm_max_epu8(maxv, _mm_srli_si128(maxv, 2));
+  minv = _mm_min_epu8(minv, _mm_srli_si128(minv, 1));
+  maxv = _mm_max_epu8(maxv, _mm_srli_si128(maxv, 1));
+  int mini = _mm_cvtsi128_si32(minv) & 0xff;
+  int maxi = _mm_cvtsi128_si32(maxv) & 0xff;
+
+  // Now calculate the index for each value, with the same floating-point
+  // operations as the scalar code.
+  float fac;
+  if (maxi > mini) {
+    fac = 7.5f / (maxi - mini);
+  } else {
+    fac = 0;
+  }
+  float add = -mini * fac;
+  __m128 vfac = _mm_set1_ps(fac);
+  __m128 vadd = _mm_set1_ps(add);
+
+  __m128i zero = _mm_setzero_si128();
+  __m128i lo = _mm_unpacklo_epi8(values, zero);
+  __m128i hi = _mm_unpackhi_epi8(values, zero);
+  __m128i i0 = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), vfac), vadd));
+  __m128i i1 = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), vfac), vadd));
+  __m128i i2 = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), vfac), vadd));
+  __m128i i3 = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), vfac), vadd));
+  __m128i idx = _mm_packus_epi16(_mm_packs_epi32(i0, i1), _mm_packs_epi32(i2, i3));
+
+  // Remap the indices from 0..7 to {1, 7, 6, 5, 4, 3, 2, 0}: that is, 8 - i
+  // modulo 8, with 0 and 1 swapped.
+  idx = _mm_and_si128(_mm_sub_epi8(_mm_set1_epi8(8), idx), _mm_set1_epi8(7));
+  idx = _mm_xor_si128(idx, _mm_and_si128(_mm_cmplt_epi8(idx, _mm_set1_epi8(2)),
+                                         _mm_set1_epi8(1)));
+
+  // Pack the 3-bit indices together, two at a time, until each half of the
+  // register holds the 24 bits for two rows of the block.
+  idx = _mm_or_si128(_mm_and_si128(idx, _mm_set1_epi16(0x00ff)),
+                     _mm_srli_epi16(idx, 5));
+  idx = _mm_or_si128(_mm_and_si128(idx, _mm_set1_epi32(0xffff)),
+                     _mm_srli_epi32(idx, 10));
+  idx = _mm_or_si128(idx, _mm_srli_epi64(idx, 20));
+  uint32_t a = (uint32_t)_mm_cvtsi128_si32(idx);
+  uint32_t c = (uint32_t)_mm_cvtsi128_si32(_mm_srli_si128(idx, 8));
+
+  dest[0] = (unsigned char)maxi;
+  dest[1] = (unsigned char)mini;
+  dest[2] = a & 0xff;
+  dest[3] = (a >> 8) & 0xff;
+  dest[4] = (a >> 16) & 0xff;
+  dest[5] = c & 0xff;
+  dest[6] = (c >> 8) & 0xff;
+  dest[7] = (c >> 16) & 0xff;
+}
+
+/**
+ * Loads four bytes from a possibly unaligned address.
+ */
+static INLINE __m128i
+load_rgtc_row_sse2(const unsigned char *p) {
+  int value;
+  memcpy(&value, p, 4);
+  return _mm_cvtsi32_si128(value);
+}
+
+/**
+ * Fills in the 8-entry lookup table of a BC4 block.  Rather than dividing by
+ * 7 or 5 in floating-point, as the scalar code does, this multiplies by a
+ * fixed-point reciprocal, which gives the same truncated result for every
+ * possible pair of endpoints.
+ */
+static INLINE void
+decode_rgtc_table_sse2(const unsigned char *src, uint8_t *tbl) {
+  __m128i v0 = _mm_set1_epi16(src[0]);
+  __m128i v1 = _mm_set1_epi16(src[1]);
+  __m128i table;
+  if (src[0] > src[1]) {
+    __m128i n = _mm_add_epi16(_mm_mullo_epi16(v0, _mm_setr_epi16(7, 0, 6, 5, 4, 3, 2, 1)),
+                              _mm_mullo_epi16(v1, _mm_setr_epi16(0, 7, 1, 2, 3, 4, 5, 6)));
+    table = _mm_mulhi_epu16(n, _mm_set1_epi16(9363));
+  } else {
+    __m128i n = _mm_add_epi16(_mm_mullo_epi16(v0, _mm_setr_epi16(5, 0, 4, 3, 2, 1, 0, 0)),
+                              _mm_mullo_epi16(v1, _mm_setr_epi16(0, 5, 1, 2, 3, 4, 0, 0)));
+    table = _mm_mulhi_epu16(n, _mm_set1_epi16(13108));
+    table = _mm_or_si128(table, _mm_setr_epi16(0, 0, 0, 0, 0, 0, 0, 255));
+  }
+  _mm_storel_epi64((__m128i *)tbl, _mm_packus_epi16(table, table));
+}
+#endif  // HAVE_RGTC_SSE2
+
+/**
+ * Compresses the indicated rows of blocks of one page using BC4 compression.
+ */
+void Texture::
+compress_bc4_rows(const BlockConversion &conv, int z,
+                  int begin_row, int end_row) {
+  int x_size = conv._x_size;
+  int x_blocks = (x_size >> 2);
+
+  // NB. This algorithm isn't fully optimal, since it doesn't try to make use
+  // of the secondary interpolation mode supported by BC4.  This is not
+  // important for most textures, but it may be added in the future.
+
+#ifndef HAVE_RGTC_SSE2
+  static const int remap[] = {1, 7, 6, 5, 4, 3, 2, 0};
+#endif
+
+  unsigned char *dest = conv._dest + z * conv._dest_page_size
+    + (size_t)begin_row * x_blocks * 8;
+  unsigned const char *src = conv._src + z * conv._src_page_size
+    + (size_t)begin_row * (x_blocks * 4 + x_size * 3);
+
+  // Convert one 4 x 4 block at a time.
+  for (int y = begin_row; y < end_row; ++y) {
+    for (int x = 0; x < x_blocks; ++x) {
+#ifdef HAVE_RGTC_SSE2
+      __m128i r01 = _mm_unpacklo_epi32(load_rgtc_row_sse2(src),
+                                       load_rgtc_row_sse2(src + x_size));
+      __m128i r23 = _mm_unpacklo_epi32(load_rgtc_row_sse2(src + x_size * 2),
+                                       load_rgtc_row_sse2(src + x_size * 3));
+      encode_rgtc_block_sse2(_mm_unpacklo_epi64(r01, r23), dest);
+      dest += 8;
+
+#else  // HAVE_RGTC_SSE2
+      int a, b, c, d;
+      float fac, add;
+      unsigned char minv, maxv;
+      unsigned const char *blk = src;
+
+      // Find the minimum and maximum value in the block.
+      minv = blk[0];
+      maxv = blk[0];
+      minv = min(blk[1], minv); maxv = max(blk[1], maxv);
+      minv = min(blk[2], minv); maxv = max(blk[2], maxv);
+      minv = min(blk[3], minv); maxv = max(blk[3], maxv);
+      blk += x_size;
+      minv = min(blk[0], minv); maxv = max(blk[0], maxv);
+      minv = min(blk[1], minv); maxv = max(blk[1], maxv);
+      minv = min(blk[2], minv); maxv = max(blk[2], maxv);
+      minv = min(blk[3], minv); maxv = max(blk[3], maxv);
+      blk += x_size;
+      minv = min(blk[0], minv); maxv = max(blk[0], maxv);
+      minv = min(blk[1], minv); maxv = max(blk[1], maxv);
+      minv = min(blk[2], minv); maxv = max(blk[2], maxv);
+      minv = min(blk[3], minv); maxv = max(blk[3], maxv);
+      blk += x_size;
+      minv = min(blk[0], minv); maxv = max(blk[0], maxv);
+      minv = min(blk[1], minv); maxv = max(blk[1], maxv);
+      minv = min(blk[2], minv); maxv = max(blk[2], maxv);
+      minv = min(blk[3], minv); maxv = max(blk[3], maxv);
+
+      // Now calculate the index for each pixel.
+      blk = src;
+      if (maxv > minv) {
+        fac = 7.5f / (maxv - minv);
+      } else {
+        fac = 0;
+      }
+      add = -minv * fac;
+      a = (remap[(int)(blk[0] * fac + add)])
+        | (remap[(int)(blk[1] * fac + add)] << 3)
+        | (remap[(int)(blk[2] * fac + add)] << 6)
+        | (remap[(int)(blk[3] * fac + add)] << 9);
+      blk += x_size;
+      b = (remap[(int)(blk[0] * fac + add)] << 4)
+        | (remap[(int)(blk[1] * fac + add)] << 7)
+        | (remap[(int)(blk[2] * fac + add)] << 10)
+        | (remap[(int)(blk[3] * fac + add)] << 13);
+      blk += x_size;
+      c = (remap[(int)(blk[0] * fac + add)])
+        | (remap[(int)(blk[1] * fac + add)] << 3)
+        | (remap[(int)(blk[2] * fac + add)] << 6)
+        | (remap[(int)(blk[3] * fac + add)] << 9);
+      blk += x_size;
+      d = (remap[(int)(blk[0] * fac + add)] << 4)
+        | (remap[(int)(blk[1] * fac + add)] << 7)
+        | (remap[(int)(blk[2] * fac + add)] << 10)
+        | (remap[(int)(blk[3] * fac + add)] << 13);
+
+      *(dest++) = maxv;
+      *(dest++) = minv;
+      *(dest++) = a & 0xff;
+      *(dest++) = (a >> 8) | (b & 0xf0);
+      *(dest++) = b >> 8;
+      *(dest++) = c & 0xff;
+      *(dest++) = (c >> 8) | (d & 0xf0);
+      *(dest++) = d >> 8;
+#endif  // HAVE_RGTC_SSE2
+
+      // Advance to the beginning of the next 4x4 block.
+      src += 4;
+    }
+    src += x_size * 3;
+  }
+}
+
+/**
+ * Compresses the indicated rows of blocks of one page using BC5 compression.
+ */
+void Texture::
+compress_bc5_rows(const BlockConversion &conv, int z,
+                  int begin_row, int end_row) {
+  int x_size = conv._x_size;
   int x_blocks = (x_size >> 2);
-  int y_blocks = (y_size >> 2);
   int stride = x_size * 2;
 
-  for (int z = 0; z < num_pages; ++z) {
-    unsigned char *dest = uncompressed_image._image.p() + z * uncompressed_image._page_size;
-    unsigned const char *src = compressed_image._image.p() + z * compressed_image._page_size;
-
-    // Unconvert one 4 x 4 block at a time.
-    uint8_t red[8];
-    uint8_t grn[8];
-    for (int y = 0; y < y_blocks; ++y) {
-      for (int x = 0; x < x_blocks; ++x) {
-        unsigned char *blk = dest;
-        red[0] = src[0];
-        red[1] = src[1];
-        if (red[0] > red[1]) {
-          red[2] = (red[0] * 6 + red[1] * 1) / 7.0f;
-          red[3] = (red[0] * 5 + red[1] * 2) / 7.0f;
-          red[4] = (red[0] * 4 + red[1] * 3) / 7.0f;
-          red[5] = (red[0] * 3 + red[1] * 4) / 7.0f;
-          red[6] = (red[0] * 2 + red[1] * 5) / 7.0f;
-          red[7] = (red[0] * 1 + red[1] * 6) / 7.0f;
-        } else {
-          red[2] = (red[0] * 4 + red[1] * 1) / 5.0f;
-          red[3] = (red[0] * 3 + red[1] * 2) / 5.0f;
-          red[4] = (red[0] * 2 + red[1] * 3) / 5.0f;
-          red[5] = (red[0] * 1 + red[1] * 4) / 5.0f;
-          red[6] = 0;
-          red[7] = 255;
-        }
-        grn[0] = src[8];
-        grn[1] = src[9];
-        if (grn[0] > grn[1]) {
-          grn[2] = (grn[0] * 6 + grn[1] * 1) / 7.0f;
-          grn[3] = (grn[0] * 5 + grn[1] * 2) / 7.0f;
-          grn[4] = (grn[0] * 4 + grn[1] * 3) / 7.0f;
-          grn[5] = (grn[0] * 3 + grn[1] * 4) / 7.0f;
-          grn[6] = (grn[0] * 2 + grn[1] * 5) / 7.0f;
-          grn[7] = (grn[0] * 1 + grn[1] * 6) / 7.0f;
-        } else {
-          grn[2] = (grn[0] * 4 + grn[1] * 1) / 5.0f;
-          grn[3] = (grn[0] * 3 + grn[1] * 2) / 5.0f;
-          grn[4] = (grn[0] * 2 + grn[1] * 3) / 5.0f;
-          grn[5] = (grn[0] * 1 + grn[1] * 4) / 5.0f;
-          grn[6] = 0;
-          grn[7] = 255;
-        }
-        int r = src[2] + (src[3] << 8) + (src[4] << 16);
-        int g = src[10] + (src[11] << 8) + (src[12] << 16);
-        blk[0] = red[r & 0x7];
-        blk[1] = grn[g & 0x7];
-        blk[2] = red[(r & 0x000038) >> 3];
-        blk[3] = grn[(g & 0x000038) >> 3];
-        blk[4] = red[(r & 0x0001c0) >> 6];
-        blk[5] = grn[(g & 0x0001c0) >> 6];
-        blk[6] = red[(r & 0x000e00) >> 9];
-        blk[7] = grn[(g & 0x000e00) >> 9];
-        blk += stride;
-        blk[0] = red[(r & 0x007000) >> 12];
-        blk[1] = grn[(g & 0x007000) >> 12];
-        blk[2] = red[(r & 0x038000) >> 15];
-        blk[3] = grn[(g & 0x038000) >> 15];
-        blk[4] = red[(r & 0x1c0000) >> 18];
-        blk[5] = grn[(g & 0x1c0000) >> 18];
-        blk[6] = red[(r & 0xe00000) >> 21];
-        blk[7] = grn[(g & 0xe00000) >> 21];
-        blk += stride;
-        r = src[5] + (src[6] << 8) + (src[7] << 16);
-        g = src[13] + (src[14] << 8) + (src[15] << 16);
-        blk[0] = red[r & 0x7];
-        blk[1] = grn[g & 0x7];
-        blk[2] = red[(r & 0x000038) >> 3];
-        blk[3] = grn[(g & 0x000038) >> 3];
-        blk[4] = red[(r & 0x0001c0) >> 6];
-        blk[5] = grn[(g & 0x0001c0) >> 6];
-        blk[6] = red[(r & 0x000e00) >> 9];
-        blk[7] = grn[(g & 0x000e00) >> 9];
-        blk += stride;
-        blk[0] = red[(r & 0x007000) >> 12];
-        blk[1] = grn[(g & 0x007000) >> 12];
-        blk[2] = red[(r & 0x038000) >> 15];
-        blk[3] = grn[(g & 0x038000) >> 15];
-        blk[4] = red[(r & 0x1c0000) >> 18];
-        blk[5] = grn[(g & 0x1c0000) >> 18];
-        blk[6] = red[(r & 0xe00000) >> 21];
-        blk[7] = grn[(g & 0xe00000) >> 21];
-        src += 16;
-        dest += 8;
-      }
-      dest += stride * 3;
-    }
-    Thread::consider_yield();
+  // BC5 uses the same compression algorithm as BC4, except repeated for two
+  // channels.
+
+#ifndef HAVE_RGTC_SSE2
+  static const int remap[] = {1, 7, 6, 5, 4, 3, 2, 0};
+#endif
+
+  unsigned char *dest = conv._dest + z * conv._dest_page_size
+    + (size_t)begin_row * x_blocks * 16;
+  unsigned const char *src = conv._src + z * conv._src_page_size
+    + (size_t)begin_row * (x_blocks * 8 + stride * 3);
+
+  // Convert one 4 x 4 block at a time.
+  for (int y = begin_row; y < end_row; ++y) {
+    for (int x = 0; x < x_blocks; ++x) {
+#ifdef HAVE_RGTC_SSE2
+      // Separate the red and green values of the four rows.
+      __m128i r01 = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)src),
+                                       _mm_loadl_epi64((const __m128i *)(src + stride)));
+      __m128i r23 = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)(src + stride * 2)),
+                                       _mm_loadl_epi64((const __m128i *)(src + stride * 3)));
+      __m128i mask = _mm_set1_epi16(0x00ff);
+      encode_rgtc_block_sse2(_mm_packus_epi16(_mm_and_si128(r01, mask),
+                                              _mm_and_si128(r23, mask)), dest);
+      encode_rgtc_block_sse2(_mm_packus_epi16(_mm_srli_epi16(r01, 8),
+                                              _mm_srli_epi16(r23, 8)), dest + 8);
+      dest += 16;
+
+#else  // HAVE_RGTC_SSE2
+      int a, b, c, d;
+      float fac, add;
+      unsigned char minv, maxv;
+      unsigned const char *blk = src;
+
+      // Find the minimum and maximum red value in the block.
+      minv = blk[0];
+      maxv = blk[0];
+      minv = min(blk[2], minv); maxv = max(blk[2], maxv);
+      minv = min(blk[4], minv); maxv = max(blk[4], maxv);
+      minv = min(blk[6], minv); maxv = max(blk[6], maxv);
+      blk += stride;
+      minv = min(blk[0], minv); maxv = max(blk[0], maxv);
+      minv = min(blk[2], minv); maxv = max(blk[2], maxv);
+      minv = min(blk[4], minv); maxv = max(blk[4], maxv);
+      minv = min(blk[6], minv); maxv = max(blk[6], maxv);
+      blk += stride;
+      minv = min(blk[0], minv); maxv = max(blk[0], maxv);
+      minv = min(blk[2], minv); maxv = max(blk[2], maxv);
+      minv = min(blk[4], minv); maxv = max(blk[4], maxv);
+      minv = min(blk[6], minv); maxv = max(blk[6], maxv);
+      blk += stride;
+      minv = min(blk[0], minv); maxv = max(blk[0], maxv);
+      minv = min(blk[2], minv); maxv = max(blk[2], maxv);
+      minv = min(blk[4], minv); maxv = max(blk[4], maxv);
+      minv = min(blk[6], minv); maxv = max(blk[6], maxv);
+
+      // Now calculate the index for each pixel.
+      if (maxv > minv) {
+        fac = 7.5f / (maxv - minv);
+      } else {
+        fac = 0;
+      }
+      add = -minv * fac;
+      blk = src;
+      a = (remap[(int)(blk[0] * fac + add)])
+        | (remap[(int)(blk[2] * fac + add)] << 3)
+        | (remap[(int)(blk[4] * fac + add)] << 6)
+        | (remap[(int)(blk[6] * fac + add)] << 9);
+      blk += stride;
+      b = (remap[(int)(blk[0] * fac + add)] << 4)
+        | (remap[(int)(blk[2] * fac + add)] << 7)
+        | (remap[(int)(blk[4] * fac + add)] << 10)
+        | (remap[(int)(blk[6] * fac + add)] << 13);
+      blk += stride;
+      c = (remap[(int)(blk[0] * fac + add)])
+        | (remap[(int)(blk[2] * fac + add)] << 3)
+        | (remap[(int)(blk[4] * fac + add)] << 6)
+        | (remap[(int)(blk[6] * fac + add)] << 9);
+      blk += stride;
+      d = (remap[(int)(blk[0] * fac + add)] << 4)
+        | (remap[(int)(blk[2] * fac + add)] << 7)
+        | (remap[(int)(blk[4] * fac + add)] << 10)
+        | (remap[(int)(blk[6] * fac + add)] << 13);
+
+      *(dest++) = maxv;
+      *(dest++) = minv;
+      *(dest++) = a & 0xff;
+      *(dest++) = (a >> 8) | (b & 0xf0);
+      *(dest++) = b >> 8;
+      *(dest++) = c & 0xff;
+      *(dest++) = (c >> 8) | (d & 0xf0);
+      *(dest++) = d >> 8;
+
+      // Find the minimum and maximum green value in the block.
+      blk = src + 1;
+      minv = blk[0];
+      maxv = blk[0];
+      minv = min(blk[2], minv); maxv = max(blk[2], maxv);
+      minv = min(blk[4], minv); maxv = max(blk[4], maxv);
+      minv = min(blk[6], minv); maxv = max(blk[6], maxv);
+      blk += stride;
+      minv = min(blk[0], minv); maxv = max(blk[0], maxv);
+      minv = min(blk[2], minv); maxv = max(blk[2], maxv);
+      minv = min(blk[4], minv); maxv = max(blk[4], maxv);
+      minv = min(blk[6], minv); maxv = max(blk[6], maxv);
+      blk += stride;
+      minv = min(blk[0], minv); maxv = max(blk[0], maxv);
+      minv = min(blk[2], minv); maxv = max(blk[2], maxv);
+      minv = min(blk[4], minv); maxv = max(blk[4], maxv);
+      minv = min(blk[6], minv); maxv = max(blk[6], maxv);
+      blk += stride;
+      minv = min(blk[0], minv); maxv = max(blk[0], maxv);
+      minv = min(blk[2], minv); maxv = max(blk[2], maxv);
+      minv = min(blk[4], minv); maxv = max(blk[4], maxv);
+      minv = min(blk[6], minv); maxv = max(blk[6], maxv);
+
+      // Now calculate the index for each pixel.
+      if (maxv > minv) {
+        fac = 7.5f / (maxv - minv);
+      } else {
+        fac = 0;
+      }
+      add = -minv * fac;
+      blk = src + 1;
+      a = (remap[(int)(blk[0] * fac + add)])
+        | (remap[(int)(blk[2] * fac + add)] << 3)
+        | (remap[(int)(blk[4] * fac + add)] << 6)
+        | (remap[(int)(blk[6] * fac + add)] << 9);
+      blk += stride;
+      b = (remap[(int)(blk[0] * fac + add)] << 4)
+        | (remap[(int)(blk[2] * fac + add)] << 7)
+        | (remap[(int)(blk[4] * fac + add)] << 10)
+        | (remap[(int)(blk[6] * fac + add)] << 13);
+      blk += stride;
+      c = (remap[(int)(blk[0] * fac + add)])
+        | (remap[(int)(blk[2] * fac + add)] << 3)
+        | (remap[(int)(blk[4] * fac + add)] << 6)
+        | (remap[(int)(blk[6] * fac + add)] << 9);
+      blk += stride;
+      d = (remap[(int)(blk[0] * fac + add)] << 4)
+        | (remap[(int)(blk[2] * fac + add)] << 7)
+        | (remap[(int)(blk[4] * fac + add)] << 10)
+        | (remap[(int)(blk[6] * fac + add)] << 13);
+
+      *(dest++) = maxv;
+      *(dest++) = minv;
+      *(dest++) = a & 0xff;
+      *(dest++) = (a >> 8) | (b & 0xf0);
+      *(dest++) = b >> 8;
+      *(dest++) = c & 0xff;
+      *(dest++) = (c >> 8) | (d & 0xf0);
+      *(dest++) = d >> 8;
+#endif  // HAVE_RGTC_SSE2
+
+      // Advance to the beginning of the next 4x4 block.
+      src += 8;
+    }
+    src += stride * 3;
+  }
+}
+
+/**
+ * Decompresses the indicated rows of blocks of one page compressed using BC4.
+ */
+void Texture::
+uncompress_bc4_rows(const BlockConversion &conv, int z,
+                    int begin_row, int end_row) {
+  int x_size = conv._x_size;
+  int x_blocks = (x_size >> 2);
+
+  unsigned char *dest = conv._dest + z * conv._dest_page_size
+    + (size_t)begin_row * (x_blocks * 4 + x_size * 3);
+  unsigned const char *src = conv._src + z * conv._src_page_size
+    + (size_t)begin_row * x_blocks * 8;
+
+  // Unconvert one 4 x 4 block at a time.
+  uint8_t tbl[8];
+  for (int y = begin_row; y < end_row; ++y) {
+    for (int x = 0; x < x_blocks; ++x) {
+      unsigned char *blk = dest;
+#ifdef HAVE_RGTC_SSE2
+      decode_rgtc_table_sse2(src, tbl);
+#else
+      tbl[0] = src[0];
+      tbl[1] = src[1];
+      if (tbl[0] > tbl[1]) {
+        tbl[2] = (tbl[0] * 6 + tbl[1] * 1) / 7.0f;
+        tbl[3] = (tbl[0] * 5 + tbl[1] * 2) / 7.0f;
+        tbl[4] = (tbl[0] * 4 + tbl[1] * 3) / 7.0f;
+        tbl[5] = (tbl[0] * 3 + tbl[1] * 4) / 7.0f;
+        tbl[6] = (tbl[0] * 2 + tbl[1] * 5) / 7.0f;
+        tbl[7] = (tbl[0] * 1 + tbl[1] * 6) / 7.0f;
+      } else {
+        tbl[2] = (tbl[0] * 4 + tbl[1] * 1) / 5.0f;
+        tbl[3] = (tbl[0] * 3 + tbl[1] * 2) / 5.0f;
+        tbl[4] = (tbl[0] * 2 + tbl[1] * 3) / 5.0f;
+        tbl[5] = (tbl[0] * 1 + tbl[1] * 4) / 5.0f;
+        tbl[6] = 0;
+        tbl[7] = 255;
+      }
+#endif  // HAVE_RGTC_SSE2
+      int v = src[2] + (src[3] << 8) + (src[4] << 16);
+      blk[0] = tbl[v & 0x7];
+      blk[1] = tbl[(v & 0x000038) >> 3];
+      blk[2] = tbl[(v & 0x0001c0) >> 6];
+      blk[3] = tbl[(v & 0x000e00) >> 9];
+      blk += x_size;
+      blk[0] = tbl[(v & 0x007000) >> 12];
+      blk[1] = tbl[(v & 0x038000) >> 15];
+      blk[2] = tbl[(v & 0x1c0000) >> 18];
+      blk[3] = tbl[(v & 0xe00000) >> 21];
+      blk += x_size;
+      v = src[5] + (src[6] << 8) + (src[7] << 16);
+      blk[0] = tbl[v & 0x7];
+      blk[1] = tbl[(v & 0x000038) >> 3];
+      blk[2] = tbl[(v & 0x0001c0) >> 6];
+      blk[3] = tbl[(v & 0x000e00) >> 9];
+      blk += x_size;
+      blk[0] = tbl[(v & 0x007000) >> 12];
+      blk[1] = tbl[(v & 0x038000) >> 15];
+      blk[2] = tbl[(v & 0x1c0000) >> 18];
+      blk[3] = tbl[(v & 0xe00000) >> 21];
+      src += 8;
+      dest += 4;
+    }
+    dest += x_size * 3;
+  }
+}
+
+/**
+ * Decompresses the indicated rows of blocks of one page compressed using BC5.
+ */
+void Texture::
+uncompress_bc5_rows(const BlockConversion &conv, int z,
+                    int begin_row, int end_row) {
+  int x_size = conv._x_size;
+  int x_blocks = (x_size >> 2);
+  int stride = x_size * 2;
+
+  unsigned char *dest = conv._dest + z * conv._dest_page_size
+    + (size_t)begin_row * (x_blocks * 8 + stride * 3);
+  unsigned const char *src = conv._src + z * conv._src_page_size
+    + (size_t)begin_row * x_blocks * 16;
+
+  // Unconvert one 4 x 4 block at a time.
+  uint8_t red[8];
+  uint8_t grn[8];
+  for (int y = begin_row; y < end_row; ++y) {
+    for (int x = 0; x < x_blocks; ++x) {
+      unsigned char *blk = dest;
+#ifdef HAVE_RGTC_SSE2
+      decode_rgtc_table_sse2(src, red);
+      decode_rgtc_table_sse2(src + 8, grn);
+#else
+      red[0] = src[0];
+      red[1] = src[1];
+      if (red[0] > red[1]) {
+        red[2] = (red[0] * 6 + red[1] * 1) / 7.0f;
+        red[3] = (red[0] * 5 + red[1] * 2) / 7.0f;
+        red[4] = (red[0] * 4 + red[1] * 3) / 7.0f;
+        red[5] = (red[0] * 3 + red[1] * 4) / 7.0f;
+        red[6] = (red[0] * 2 + red[1] * 5) / 7.0f;
+        red[7] = (red[0] * 1 + red[1] * 6) / 7.0f;
+      } else {
+        red[2] = (red[0] * 4 + red[1] * 1) / 5.0f;
+        red[3] = (red[0] * 3 + red[1] * 2) / 5.0f;
+        red[4] = (red[0] * 2 + red[1] * 3) / 5.0f;
+        red[5] = (red[0] * 1 + red[1] * 4) / 5.0f;
+        red[6] = 0;
+        red[7] = 255;
+      }
+      grn[0] = src[8];
+      grn[1] = src[9];
+      if (grn[0] > grn[1]) {
+        grn[2] = (grn[0] * 6 + grn[1] * 1) / 7.0f;
+        grn[3] = (grn[0] * 5 + grn[1] * 2) / 7.0f;
+        grn[4] = (grn[0] * 4 + grn[1] * 3) / 7.0f;
+        grn[5] = (grn[0] * 3 + grn[1] * 4) / 7.0f;
+        grn[6] = (grn[0] * 2 + grn[1] * 5) / 7.0f;
+        grn[7] = (grn[0] * 1 + grn[1] * 6) / 7.0f;
+      } else {
+        grn[2] = (grn[0] * 4 + grn[1] * 1) / 5.0f;
+        grn[3] = (grn[0] * 3 + grn[1] * 2) / 5.0f;
+        grn[4] = (grn[0] * 2 + grn[1] * 3) / 5.0f;
+        grn[5] = (grn[0] * 1 + grn[1] * 4) / 5.0f;
+        grn[6] = 0;
+        grn[7] = 255;
+      }
+#endif  // HAVE_RGTC_SSE2
+      int r = src[2] + (src[3] << 8) + (src[4] << 16);
+      int g = src[10] + (src[11] << 8) + (src[12] << 16);
+      blk[0] = red[r & 0x7];
+      blk[1] = grn[g & 0x7];
+      blk[2] = red[(r & 0x000038) >> 3];
+      blk[3] = grn[(g & 0x000038) >> 3];
+      blk[4] = red[(r & 0x0001c0) >> 6];
+      blk[5] = grn[(g & 0x0001c0) >> 6];
+      blk[6] = red[(r & 0x000e00) >> 9];
+      blk[7] = grn[(g & 0x000e00) >> 9];
+      blk += stride;
+      blk[0] = red[(r & 0x007000) >> 12];
+      blk[1] = grn[(g & 0x007000) >> 12];
+      blk[2] = red[(r & 0x038000) >> 15];
+      blk[3] = grn[(g & 0x038000) >> 15];
+      blk[4] = red[(r & 0x1c0000) >> 18];
+      blk[5] = grn[(g & 0x1c0000) >> 18];
+      blk[6] = red[(r & 0xe00000) >> 21];
+      blk[7] = grn[(g & 0xe00000) >> 21];
+      blk += stride;
+      r = src[5] + (src[6] << 8) + (src[7] << 16);
+      g = src[13] + (src[14] << 8) + (src[15] << 16);
+      blk[0] = red[r & 0x7];
+      blk[1] = grn[g & 0x7];
+      blk[2] = red[(r & 0x000038) >> 3];
+      blk[3] = grn[(g & 0x000038) >> 3];
+      blk[4] = red[(r & 0x0001c0) >> 6];
+      blk[5] = grn[(g & 0x0001c0) >> 6];
+      blk[6] = red[(r & 0x000e00) >> 9];
+      blk[7] = grn[(g & 0x000e00) >> 9];
+      blk += stride;
+      blk[0] = red[(r & 0x007000) >> 12];
+      blk[1] = grn[(g & 0x007000) >> 12];
+      blk[2] = red[(r & 0x038000) >> 15];
+      blk[3] = grn[(g & 0x038000) >> 15];
+      blk[4] = red[(r & 0x1c0000) >> 18];
+      blk[5] = grn[(g & 0x1c0000) >> 18];
+      blk[6] = red[(r & 0xe00000) >> 21];
+      blk[7] = grn[(g & 0xe00000) >> 21];
+      src += 16;
+      dest += 8;
+    }
+    dest += stride * 3;
   }
 }
 
@@ -9674,65 +9961,23 @@ do_squish(CData *cdata, Texture::CompressionMode compression, int squish_flags)
     int y_size = do_get_expected_mipmap_y_size(cdata, n);
     int num_pages = do_get_expected_mipmap_num_pages(cdata, n);
     int page_size = squish::GetStorageRequirements(x_size, y_size, squish_flags);
-    int cell_size = squish::GetStorageRequirements(4, 4, squish_flags);
 
     compressed_image._page_size = page_size;
     compressed_image._image = PTA_uchar::empty_array(page_size * num_pages);
-    for (int z = 0; z < num_pages; ++z) {
-      unsigned char *dest_page = compressed_image._image.p() + z * page_size;
-      unsigned const char *source_page = cdata->_ram_images[n]._image.p() + z * cdata->_ram_images[n]._page_size;
-      unsigned const char *source_page_end = source_page + cdata->_ram_images[n]._page_size;
-      // Convert one 4 x 4 cell at a time.
-      unsigned char *d = dest_page;
-      for (int y = 0; y < y_size; y += 4) {
-        for (int x = 0; x < x_size; x += 4) {
-          unsigned char tb[16 * 4];
-          int mask = 0;
-          unsigned char *t = tb;
-          for (int i = 0; i < 16; ++i) {
-            int xi = x + i % 4;
-            int yi = y + i / 4;
-            unsigned const char *s = source_page + (yi * x_size + xi) * cdata->_num_components;
-            if (s < source_page_end) {
-              switch (cdata->_num_components) {
-              case 1:
-                t[0] = s[0];   // r
-                t[1] = s[0];   // g
-                t[2] = s[0];   // b
-                t[3] = 255;    // a
-                break;
-
-              case 2:
-                t[0] = s[0];   // r
-                t[1] = s[0];   // g
-                t[2] = s[0];   // b
-                t[3] = s[1];   // a
-                break;
-
-              case 3:
-                t[0] = s[2];   // r
-                t[1] = s[1];   // g
-                t[2] = s[0];   // b
-                t[3] = 255;    // a
-                break;
-
-              case 4:
-                t[0] = s[2];   // r
-                t[1] = s[1];   // g
-                t[2] = s[0];   // b
-                t[3] = s[3];   // a
-                break;
-              }
-              mask |= (1 << i);
-            }
-            t += 4;
-          }
-          squish::CompressMasked(tb, mask, d, squish_flags);
-          d += cell_size;
-          Thread::consider_yield();
-        }
-      }
-    }
+
+    BlockConversion conv;
+    conv._func = &squish_rows;
+    conv._src = cdata->_ram_images[n]._image.p();
+    conv._src_page_size = cdata->_ram_images[n]._page_size;
+    conv._dest = compressed_image._image.p();
+    conv._dest_page_size = page_size;
+    conv._x_size = x_size;
+    conv._rows_per_page = (y_size + 3) >> 2;
+    conv._num_pages = num_pages;
+    conv._num_components = cdata->_num_components;
+    conv._squish_flags = squish_flags;
+    convert_blocks(conv);
+
     compressed_ram_images.push_back(compressed_image);
   }
   cdata->_ram_images.swap(compressed_ram_images);
@@ -9759,58 +10004,23 @@ do_unsquish(CData *cdata, int squish_flags) {
     int y_size = do_get_expected_mipmap_y_size(cdata, n);
     int num_pages = do_get_expected_mipmap_num_pages(cdata, n);
     int page_size = squish::GetStorageRequirements(x_size, y_size, squish_flags);
-    int cell_size = squish::GetStorageRequirements(4, 4, squish_flags);
 
     uncompressed_image._page_size = do_get_expected_ram_mipmap_page_size(cdata, n);
     uncompressed_image._image = PTA_uchar::empty_array(uncompressed_image._page_size * num_pages);
-    for (int z = 0; z < num_pages; ++z) {
-      unsigned char *dest_page = uncompressed_image._image.p() + z * uncompressed_image._page_size;
-      unsigned char *dest_page_end = dest_page + uncompressed_image._page_size;
-      unsigned const char *source_page = cdata->_ram_images[n]._image.p() + z * page_size;
-      // Unconvert one 4 x 4 cell at a time.
-      unsigned const char *s = source_page;
-      for (int y = 0; y < y_size; y += 4) {
-        for (int x = 0; x < x_size; x += 4) {
-          unsigned char tb[16 * 4];
-          squish::Decompress(tb, s, squish_flags);
-          s += cell_size;
-
-          unsigned char *t = tb;
-          for (int i = 0; i < 16; ++i) {
-            int xi = x + i % 4;
-            int yi = y + i / 4;
-            unsigned char *d = dest_page + (yi * x_size + xi) * cdata->_num_components;
-            if (d < dest_page_end) {
-              switch (cdata->_num_components) {
-              case 1:
-                d[0] = t[1];   // g
-                break;
-
-              case 2:
-                d[0] = t[1];   // g
-                d[1] = t[3];   // a
-                break;
-
-              case 3:
-                d[2] = t[0];   // r
-                d[1] = t[1];   // g
-                d[0] = t[2];   // b
-                break;
-
-              case 4:
-                d[2] = t[0];   // r
-                d[1] = t[1];   // g
-                d[0] = t[2];   // b
-                d[3] = t[3];   // a
-                break;
-              }
-            }
-            t += 4;
-          }
-        }
-        Thread::consider_yield();
-      }
-    }
+
+    BlockConversion conv;
+    conv._func = &unsquish_rows;
+    conv._src = cdata->_ram_images[n]._image.p();
+    conv._src_page_size = page_size;
+    conv._dest = uncompressed_image._image.p();
+    conv._dest_page_size = uncompressed_image._page_size;
+    conv._x_size = x_size;
+    conv._rows_per_page = (y_size + 3) >> 2;
+    conv._num_pages = num_pages;
+    conv._num_components = cdata->_num_components;
+    conv._squish_flags = squish_flags;
+    convert_blocks(conv);
+
     uncompressed_ram_images.push_back(uncompressed_image);
   }
   cdata->_ram_images.swap(uncompressed_ram_images);
@@ -9823,6 +10033,137 @@ do_unsquish(CData *cdata, int squish_flags) {
 #endif  // HAVE_SQUISH
 }
 
+#ifdef HAVE_SQUISH
+/**
+ * Invokes the squish library to compress the indicated rows of blocks of one
+ * page, for do_squish().
+ */
+void Texture::
+squish_rows(const BlockConversion &conv, int z, int begin_row, int end_row) {
+  int x_size = conv._x_size;
+  int num_components = conv._num_components;
+  int squish_flags = conv._squish_flags;
+  int cell_size = squish::GetStorageRequirements(4, 4, squish_flags);
+  int x_cells = (x_size + 3) >> 2;
+
+  unsigned const char *source_page = conv._src + z * conv._src_page_size;
+  unsigned const char *source_page_end = source_page + conv._src_page_size;
+
+  // Convert one 4 x 4 cell at a time.
+  unsigned char *d = conv._dest + z * conv._dest_page_size
+    + (size_t)begin_row * x_cells * cell_size;
+  for (int y = begin_row * 4; y < end_row * 4; y += 4) {
+    for (int x = 0; x < x_size; x += 4) {
+      unsigned char tb[16 * 4];
+      int mask = 0;
+      unsigned char *t = tb;
+      for (int i = 0; i < 16; ++i) {
+        int xi = x + i % 4;
+        int yi = y + i / 4;
+        unsigned const char *s = source_page + (yi * x_size + xi) * num_components;
+        if (s < source_page_end) {
+          switch (num_components) {
+          case 1:
+            t[0] = s[0];   // r
+            t[1] = s[0];   // g
+            t[2] = s[0];   // b
+            t[3] = 255;    // a
+            break;
+
+          case 2:
+            t[0] = s[0];   // r
+            t[1] = s[0];   // g
+            t[2] = s[0];   // b
+            t[3] = s[1];   // a
+            break;
+
+          case 3:
+            t[0] = s[2];   // r
+            t[1] = s[1];   // g
+            t[2] = s[0];   // b
+            t[3] = 255;    // a
+            break;
+
+          case 4:
+            t[0] = s[2];   // r
+            t[1] = s[1];   // g
+            t[2] = s[0];   // b
+            t[3] = s[3];   // a
+            break;
+          }
+          mask |= (1 << i);
+        }
+        t += 4;
+      }
+      squish::CompressMasked(tb, mask, d, squish_flags);
+      d += cell_size;
+      Thread::consider_yield();
+    }
+  }
+}
+
+/**
+ * Invokes the squish library to uncompress the indicated rows of blocks of
+ * one page, for do_unsquish().
+ */
+void Texture::
+unsquish_rows(const BlockConversion &conv, int z, int begin_row, int end_row) {
+  int x_size = conv._x_size;
+  int num_components = conv._num_components;
+  int squish_flags = conv._squish_flags;
+  int cell_size = squish::GetStorageRequirements(4, 4, squish_flags);
+  int x_cells = (x_size + 3) >> 2;
+
+  unsigned char *dest_page = conv._dest + z * conv._dest_page_size;
+  unsigned char *dest_page_end = dest_page + conv._dest_page_size;
+
+  // Unconvert one 4 x 4 cell at a time.
+  unsigned const char *s = conv._src + z * conv._src_page_size
+    + (size_t)begin_row * x_cells * cell_size;
+  for (int y = begin_row * 4; y < end_row * 4; y += 4) {
+    for (int x = 0; x < x_size; x += 4) {
+      unsigned char tb[16 * 4];
+      squish::Decompress(tb, s, squish_flags);
+      s += cell_size;
+
+      unsigned char *t = tb;
+      for (int i = 0; i < 16; ++i) {
+        int xi = x + i % 4;
+        int yi = y + i / 4;
+        unsigned char *d = dest_page + (yi * x_size + xi) * num_components;
+        if (d < dest_page_end) {
+          switch (num_components) {
+          case 1:
+            d[0] = t[1];   // g
+            break;
+
+          case 2:
+            d[0] = t[1];   // g
+            d[1] = t[3];   // a
+            break;
+
+          case 3:
+            d[2] = t[0];   // r
+            d[1] = t[1];   // g
+            d[0] = t[2];   // b
+            break;
+
+          case 4:
+            d[2] = t[0];   // r
+            d[1] = t[1];   // g
+            d[0] = t[2];   // b
+            d[3] = t[3];   // a
+            break;
+          }
+        }
+        t += 4;
+      }
+    }
+    Thread::consider_yield();
+  }
+}
+#endif  // HAVE_SQUISH
+
 /**
  * Factory method to generate a Texture object
  */
@@ -10290,8 +10631,10 @@ do_fillin_body(CData *cdata, DatagramIterator &scan, BamReader *manager) {
       return;
     }
 
+    // The BamReader may defer the copy, to do it in parallel with other
+    // images and vertex arrays.
     PTA_uchar image = PTA_uchar::empty_array(u_size, get_class_type());
-    scan.extract_bytes(image.p(), u_size);
+    manager->extract_bytes(scan, image.p(), u_size);
 
     cdata->_simple_ram_image._image = image;
     cdata->_simple_ram_image._page_size = u_size;
@@ -711,6 +711,44 @@ protected:
                                           int x_size, int y_size, int z_size);
   static void do_uncompress_ram_image_bc5(const RamImage &src, RamImage &dest,
                                           int x_size, int y_size, int z_size);
+
+  class BlockConversion;
+  typedef void ConvertBlockRows(const BlockConversion &conv, int z,
+                                int begin_row, int end_row);
+
+  // Describes the conversion of all of the pages of one mipmap level to or
+  // from a format made of 4x4 blocks.  Each row of blocks is converted
+  // independently, so convert_blocks() may spread the rows across threads.
+  class BlockConversion {
+  public:
+    ConvertBlockRows *_func;
+    const unsigned char *_src;
+    size_t _src_page_size;
+    unsigned char *_dest;
+    size_t _dest_page_size;
+    int _x_size;
+    int _rows_per_page;
+    int _num_pages;
+    int _num_components;
+    int _squish_flags;
+    int _num_chunks;
+  };
+
+  static void convert_blocks(BlockConversion &conv);
+  static void st_convert_block_chunk(size_t chunk, void *data);
+  static void compress_bc4_rows(const BlockConversion &conv, int z,
+                                int begin_row, int end_row);
+  static void compress_bc5_rows(const BlockConversion &conv, int z,
+                                int begin_row, int end_row);
+  static void uncompress_bc4_rows(const BlockConversion &conv, int z,
+                                  int begin_row, int end_row);
+  static void uncompress_bc5_rows(const BlockConversion &conv, int z,
+                                  int begin_row, int end_row);
+  static void squish_rows(const BlockConversion &conv, int z,
+                          int begin_row, int end_row);
+  static void unsquish_rows(const BlockConversion &conv, int z,
+                            int begin_row, int end_row);
+
   bool do_has_all_ram_mipmap_images(const CData *cdata) const;
 
   bool do_reconsider_z_size(CData *cdata, int z, const LoaderOptions &options);
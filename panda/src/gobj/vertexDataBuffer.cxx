@@ -39,6 +39,8 @@ operator = (const VertexDataBuffer &copy) {
   _size = copy._size;
   _reserved_size = copy._size;
   _block = copy._block;
+  _mapping = copy._mapping;
+  _mapped_data = copy._mapped_data;
   nassertv(_reserved_size >= _size);
 }
 
@@ -53,19 +55,46 @@ swap(VertexDataBuffer &other) {
   unsigned char *resident_data = _resident_data;
   size_t size = _size;
   size_t reserved_size = _reserved_size;
+  const unsigned char *mapped_data = _mapped_data;
 
   _block.swap(other._block);
+  _mapping.swap(other._mapping);
 
   _resident_data = other._resident_data;
   _size = other._size;
   _reserved_size = other._reserved_size;
+  _mapped_data = other._mapped_data;
 
   other._resident_data = resident_data;
   other._size = size;
   other._reserved_size = reserved_size;
+  other._mapped_data = mapped_data;
   nassertv(_reserved_size >= _size);
 }
 
+/**
+ * Makes this buffer reference the indicated bytes within the indicated memory
+ * mapping, instead of holding its own copy of the data.  The data must remain
+ * unchanged for as long as the mapping is open, and must be aligned to
+ * MEMORY_HOOK_ALIGNMENT.  The data is copied into independent memory the
+ * first time the buffer is modified.
+ */
+void VertexDataBuffer::
+set_mapped_data(MemoryMappedFile *mapping, const unsigned char *data,
+                size_t size) {
+  nassertv(((uintptr_t)data % MEMORY_HOOK_ALIGNMENT) == 0);
+
+  LightMutexHolder holder(_lock);
+  do_unclean_realloc(0);
+
+  if (size != 0) {
+    _mapping = mapping;
+    _mapped_data = data;
+    _size = size;
+    _reserved_size = size;
+  }
+}
+
 /**
  * Changes the reserved size of the buffer, preserving its data (except for
  * any data beyond the new end of the buffer, if the buffer is being reduced).
@@ -119,8 +148,10 @@ do_unclean_realloc(size_t reserved_size) {
         << this << ".unclean_realloc(" << reserved_size << ")\n";
     }
 
-    // If we're paged out, discard the page.
+    // If we're paged out or mapped, discard the page or the mapping.
     _block = nullptr;
+    _mapping = nullptr;
+    _mapped_data = nullptr;
 
     if (_resident_data != nullptr) {
       nassertv(_reserved_size != 0);
@@ -155,6 +186,11 @@ do_page_out(VertexDataBook &book) {
     // We're already paged out.
     return;
   }
+  if (_mapped_data != nullptr) {
+    // The data is already backed by a file on disk; there's no point in
+    // copying it to a page.
+    return;
+  }
   nassertv(_resident_data != nullptr);
 
   if (_size == 0) {
@@ -194,9 +230,21 @@ do_page_in() {
     return;
   }
 
-  nassertv(_block != nullptr);
   nassertv(_reserved_size == _size);
 
+  if (_mapped_data != nullptr) {
+    // Copy the data out of the mapping, so that it may be modified.
+    _resident_data = (unsigned char *)get_class_type().allocate_array(_size);
+    nassertv(_resident_data != nullptr);
+
+    memcpy(_resident_data, _mapped_data, _size);
+    _mapping = nullptr;
+    _mapped_data = nullptr;
+    return;
+  }
+
+  nassertv(_block != nullptr);
+
   _resident_data = (unsigned char *)get_class_type().allocate_array(_size);
   nassertv(_resident_data != nullptr);
 
@@ -19,6 +19,7 @@
 #include "vertexDataBlock.h"
 #include "pointerTo.h"
 #include "virtualFile.h"
+#include "memoryMappedFile.h"
 #include "pStatCollector.h"
 #include "lightMutex.h"
 #include "lightMutexHolder.h"
@@ -27,7 +28,7 @@
  * A block of bytes that stores the actual raw vertex data referenced by a
  * GeomVertexArrayData object.
  *
- * At any point, a buffer may be in any of two states:
+ * At any point, a buffer may be in any of three states:
  *
  * independent - the buffer's memory is resident, and owned by the
  * VertexDataBuffer object itself (in _resident_data).  In this state,
@@ -39,10 +40,17 @@
  * memory is considered read-only.  In this state, _reserved_size will always
  * equal _size.
  *
+ * mapped - the buffer's memory is part of a read-only MemoryMappedFile,
+ * typically a bam file that was written with aligned file data, and is
+ * referenced directly from there (in _mapped_data).  This memory is also
+ * considered read-only, and _reserved_size will always equal _size.
+ *
  * VertexDataBuffers start out in independent state.  They get moved to paged
  * state when their owning GeomVertexArrayData objects get evicted from the
  * _independent_lru.  They can get moved back to independent state if they are
- * modified (e.g.  get_write_pointer() or realloc() is called).
+ * modified (e.g.  get_write_pointer() or realloc() is called).  Mapped
+ * buffers are created with set_mapped_data(); they likewise get copied into
+ * independent memory when they are modified, but are never moved onto a page.
  *
  * The idea is to keep the highly dynamic and frequently-modified
  * VertexDataBuffers resident in easy-to-access memory, while collecting the
@@ -69,6 +77,9 @@ public:
 
   INLINE void page_out(VertexDataBook &book);
 
+  void set_mapped_data(MemoryMappedFile *mapping, const unsigned char *data,
+                       size_t size);
+
   void swap(VertexDataBuffer &other);
 
 private:
@@ -82,6 +93,8 @@ private:
   size_t _size;
   size_t _reserved_size;
   PT(VertexDataBlock) _block;
+  PT(MemoryMappedFile) _mapping;
+  const unsigned char *_mapped_data;
   LightMutex _lock;
 
 public:
@@ -25,8 +25,10 @@ PUBLISHED:
   inline int WaitForRead(bool zeroFds, const Time_Span & timeout);
   inline void clear();
 
-private:
+public:
   inline void setForSocketNative(const SOCKET inid);
+
+private:
   inline bool isSetForNative(const SOCKET inid) const;
 
   friend struct Socket_Selector;
@@ -146,6 +146,14 @@ ConfigVariableEnum<ThreadPriority> net_thread_priority
  PRC_DESC("The default thread priority when creating threaded readers "
           "or writers."));
 
+ConfigVariableBool net_use_epoll
+("net-use-epoll", true,
+ PRC_DESC("On Linux, set this true to have ConnectionReaders and "
+          "ConnectionListeners wait for activity on their sockets with "
+          "epoll, rather than select().  This scales to many thousands of "
+          "connections, and is not limited to sockets numbered below "
+          "FD_SETSIZE.  It has no effect on other platforms."));
+
 
 /**
  * Initializes the library.  This must be called at least once before any of
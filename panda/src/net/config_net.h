@@ -37,6 +37,7 @@ extern ConfigVariableInt net_max_read_per_epoch;
 extern ConfigVariableInt net_max_write_per_epoch;
 
 extern ConfigVariableEnum<ThreadPriority> net_thread_priority;
+extern ConfigVariableBool net_use_epoll;
 
 extern EXPCL_PANDA_NET void init_libnet();
 
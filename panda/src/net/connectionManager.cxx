@@ -394,6 +394,7 @@ wait_for_readers(double timeout) {
     Socket_fdset fdset;
     fdset.clear();
     bool any_threaded = false;
+    bool any_pending = false;
 
     {
       LightMutexHolder holder(_set_mutex);
@@ -404,7 +405,11 @@ wait_for_readers(double timeout) {
         if (reader->is_polling()) {
           // If it's a polling reader, we can wait for its socket.  (If it's a
           // threaded reader, we can't do anything here.)
-          reader->accumulate_fdset(fdset);
+          if (reader->accumulate_fdset(fdset)) {
+            // This reader already knows of sockets with noise that it
+            // hasn't read yet.
+            any_pending = true;
+          }
         } else {
           any_threaded = true;
           stop = now;
@@ -413,6 +418,10 @@ wait_for_readers(double timeout) {
       }
     }
 
+    if (any_pending) {
+      return true;
+    }
+
     double wait_timeout = get_net_max_block();
     if (!block_forever) {
       wait_timeout = std::min(wait_timeout, stop - now);
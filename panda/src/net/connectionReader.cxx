@@ -27,10 +27,41 @@
 #include "atomicAdjust.h"
 #include "config_downloader.h"
 
+#ifdef HAVE_EPOLL
+#include <poll.h>
+#include <string.h>
+#endif
+
 using std::min;
 
 static const int read_buffer_size = maximum_udp_datagram + datagram_udp_header_size;
 
+#ifdef HAVE_EPOLL
+// The maximum number of sockets returned by one call to epoll_wait().
+static const int max_epoll_events = 256;
+#endif
+
+/**
+ * Returns true if there is noise on the indicated socket right now (or if
+ * there was an error checking it).
+ */
+static bool
+is_socket_readable(Socket_IP *socket) {
+#ifdef HAVE_EPOLL
+  // Unlike select(), poll() works on any socket number.
+  struct pollfd pfd;
+  pfd.fd = socket->GetSocket();
+  pfd.events = POLLIN;
+  pfd.revents = 0;
+  return ::poll(&pfd, 1, 0) != 0;
+#else
+  Socket_fdset fdset;
+  fdset.clear();
+  fdset.setForSocket(*socket);
+  return fdset.WaitForRead(true, 0) != 0;
+#endif
+}
+
 /**
  *
  */
@@ -40,6 +71,9 @@ SocketInfo(const PT(Connection) &connection) :
 {
   _busy = false;
   _error = false;
+#ifdef HAVE_EPOLL
+  _removed = false;
+#endif
 }
 
 /**
@@ -113,6 +147,20 @@ ConnectionReader(ConnectionManager *manager, int num_threads,
 
   _currently_polling_thread = -1;
 
+#ifdef HAVE_EPOLL
+  _epoll_fd = -1;
+  if (net_use_epoll) {
+    _epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (_epoll_fd == -1) {
+      net_cat.warning()
+        << "Unable to create epoll instance (" << strerror(errno)
+        << "), using select() instead.\n";
+    } else {
+      _epoll_events.resize(max_epoll_events);
+    }
+  }
+#endif
+
   std::string reader_thread_name = thread_name;
   if (thread_name.empty()) {
     reader_thread_name = "ReaderThread";
@@ -158,6 +206,12 @@ ConnectionReader::
       sinfo->_connection.clear();
     }
   }
+
+#ifdef HAVE_EPOLL
+  if (_epoll_fd != -1) {
+    close(_epoll_fd);
+  }
+#endif
 }
 
 /**
@@ -187,7 +241,14 @@ add_connection(Connection *connection) {
     }
   }
 
-  _sockets.push_back(new SocketInfo(connection));
+  SocketInfo *sinfo = new SocketInfo(connection);
+  _sockets.push_back(sinfo);
+
+#ifdef HAVE_EPOLL
+  if (_epoll_fd != -1) {
+    watch_socket(sinfo, EPOLL_CTL_ADD);
+  }
+#endif
 
   return true;
 }
@@ -214,9 +275,17 @@ remove_connection(Connection *connection) {
     return false;
   }
 
-  _removed_sockets.push_back(*si);
+  SocketInfo *sinfo = (*si);
+  _removed_sockets.push_back(sinfo);
   _sockets.erase(si);
 
+#ifdef HAVE_EPOLL
+  sinfo->_removed = true;
+  if (_epoll_fd != -1) {
+    epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, sinfo->get_socket()->GetSocket(), nullptr);
+  }
+#endif
+
   return true;
 }
 
@@ -375,6 +444,9 @@ void ConnectionReader::
 flush_read_connection(Connection *connection) {
   // Ensure it doesn't get deleted.
   SocketInfo sinfo(connection);
+#ifdef HAVE_EPOLL
+  sinfo._removed = true;
+#endif
 
   if (!remove_connection(connection)) {
     // Not already in the reader.
@@ -386,17 +458,11 @@ flush_read_connection(Connection *connection) {
   // available on just this one socket; we can do this right here in this
   // thread, since we've already removed this connection from the reader.
 
-  Socket_fdset fdset;
-  fdset.clear();
-  fdset.setForSocket(*(sinfo.get_socket()));
-  int num_results = fdset.WaitForRead(true, 0);
-  while (num_results != 0) {
+  while (is_socket_readable(sinfo.get_socket())) {
     sinfo._busy = true;
     if (!process_incoming_data(&sinfo)) {
       break;
     }
-    fdset.setForSocket(*(sinfo.get_socket()));
-    num_results = fdset.WaitForRead(true, 0);
   }
 }
 
@@ -419,6 +485,21 @@ void ConnectionReader::
 finish_socket(SocketInfo *sinfo) {
   nassertv(sinfo->_busy);
 
+#ifdef HAVE_EPOLL
+  if (_epoll_fd != -1) {
+    // The socket has been disarmed since epoll reported it.  Rearming it
+    // makes it report again right away if more data arrived in the meantime.
+    // This must be done under the lock, so we don't rearm a socket number
+    // that has since been removed and reused for another connection.
+    LightMutexHolder holder(_sockets_mutex);
+    sinfo->_busy = false;
+    if (!sinfo->_removed) {
+      watch_socket(sinfo, EPOLL_CTL_MOD);
+    }
+    return;
+  }
+#endif
+
   // By marking the SocketInfo nonbusy, we make it available for future polls.
   sinfo->_busy = false;
 }
@@ -803,6 +884,23 @@ get_next_available_socket(bool allow_block, int current_thread_index) {
     // First, check the result from the previous select call.  If there are
     // any sockets remaining there, process them first.
     while (!_shutdown && _num_results > 0) {
+#ifdef HAVE_EPOLL
+      if (_epoll_fd != -1) {
+        // Every socket returned by epoll_wait() has noise on it, but it may
+        // have been removed since.
+        nassertr(_next_index < (int)_epoll_events.size(), nullptr);
+        SocketInfo *sinfo = (SocketInfo *)_epoll_events[_next_index].data.ptr;
+        _next_index++;
+        _num_results--;
+
+        LightMutexHolder sockets_holder(_sockets_mutex);
+        if (!sinfo->_removed) {
+          sinfo->_busy = true;
+          return sinfo;
+        }
+        continue;
+      }
+#endif
       nassertr(_next_index < (int)_selecting_sockets.size(), nullptr);
       int i = _next_index;
       _next_index++;
@@ -847,7 +945,15 @@ get_next_available_socket(bool allow_block, int current_thread_index) {
         timeout = 0;
 #endif
 
-        _num_results = _fdset.WaitForRead(false, timeout);
+#ifdef HAVE_EPOLL
+        if (_epoll_fd != -1) {
+          _num_results = epoll_wait(_epoll_fd, &_epoll_events[0],
+                                    (int)_epoll_events.size(), (int)timeout);
+        } else
+#endif
+        {
+          _num_results = _fdset.WaitForRead(false, timeout);
+        }
       }
 
       if (_num_results == 0 && allow_block) {
@@ -884,6 +990,14 @@ rebuild_select_list() {
   _selecting_sockets.clear();
 
   LightMutexHolder holder(_sockets_mutex);
+#ifdef HAVE_EPOLL
+  if (_epoll_fd != -1) {
+    // The epoll set is kept up to date as sockets are added and removed.
+    delete_removed_sockets();
+    return;
+  }
+#endif
+
   Sockets::const_iterator si;
   for (si = _sockets.begin(); si != _sockets.end(); ++si) {
     SocketInfo *sinfo = (*si);
@@ -895,8 +1009,19 @@ rebuild_select_list() {
 
   // This is also a fine time to delete the contents of the _removed_sockets
   // list.
+  delete_removed_sockets();
+}
+
+/**
+ * Deletes the sockets on the _removed_sockets list that are no longer busy.
+ * The _sockets_mutex must be held, and there must not be any unread results
+ * from the last poll, which might still reference them.
+ */
+void ConnectionReader::
+delete_removed_sockets() {
   if (!_removed_sockets.empty()) {
     Sockets still_busy_sockets;
+    Sockets::const_iterator si;
     for (si = _removed_sockets.begin(); si != _removed_sockets.end(); ++si) {
       SocketInfo *sinfo = (*si);
       if (sinfo->_busy) {
@@ -913,9 +1038,20 @@ rebuild_select_list() {
  * Adds the sockets from this ConnectionReader (or ConnectionListener) to the
  * indicated fdset.  This is used by ConnectionManager::block() to build an
  * fdset of all attached readers.
+ *
+ * Returns true if the reader already knows of sockets with noise on them,
+ * from a previous poll, that it has not yet read.
  */
-void ConnectionReader::
+bool ConnectionReader::
 accumulate_fdset(Socket_fdset &fdset) {
+#ifdef HAVE_EPOLL
+  if (_epoll_fd != -1) {
+    // The epoll descriptor becomes readable when any of its sockets does.
+    fdset.setForSocketNative(_epoll_fd);
+    return (_num_results > 0);
+  }
+#endif
+
   LightMutexHolder holder(_sockets_mutex);
   Sockets::const_iterator si;
   for (si = _sockets.begin(); si != _sockets.end(); ++si) {
@@ -924,4 +1060,25 @@ accumulate_fdset(Socket_fdset &fdset) {
       fdset.setForSocket(*sinfo->get_socket());
     }
   }
+
+  return (_num_results > 0);
+}
+
+#ifdef HAVE_EPOLL
+/**
+ * Adds the socket to the epoll set (op is EPOLL_CTL_ADD), or rearms it after
+ * it has been read (op is EPOLL_CTL_MOD).  The socket will report once the
+ * next time it has noise on it.  The _sockets_mutex must be held.
+ */
+void ConnectionReader::
+watch_socket(SocketInfo *sinfo, int op) {
+  struct epoll_event event;
+  event.events = EPOLLIN | EPOLLET | EPOLLONESHOT;
+  event.data.ptr = sinfo;
+  if (epoll_ctl(_epoll_fd, op, sinfo->get_socket()->GetSocket(), &event) == -1) {
+    net_cat.error()
+      << "Unable to monitor socket " << sinfo->get_socket()->GetSocket()
+      << " with epoll: " << strerror(errno) << "\n";
+  }
 }
+#endif  // HAVE_EPOLL
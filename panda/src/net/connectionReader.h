@@ -26,6 +26,13 @@
 #include "socket_fdset.h"
 #include "atomicAdjust.h"
 
+// On Linux, the sockets are monitored with epoll rather than select(), which
+// is not limited to FD_SETSIZE sockets.
+#if defined(IS_LINUX) && !defined(CPPPARSER)
+#define HAVE_EPOLL 1
+#include <sys/epoll.h>
+#endif
+
 class NetDatagram;
 class ConnectionManager;
 class Socket_Address;
@@ -95,6 +102,11 @@ protected:
     PT(Connection) _connection;
     bool _busy;
     bool _error;
+#ifdef HAVE_EPOLL
+    // Set once the socket is no longer on the _sockets list, and so is no
+    // longer registered with the epoll set.
+    bool _removed;
+#endif
   };
   typedef pvector<SocketInfo *> Sockets;
 
@@ -126,7 +138,12 @@ private:
                                         int current_thread_index);
 
   void rebuild_select_list();
-  void accumulate_fdset(Socket_fdset &fdset);
+  void delete_removed_sockets();
+  bool accumulate_fdset(Socket_fdset &fdset);
+
+#ifdef HAVE_EPOLL
+  void watch_socket(SocketInfo *sinfo, int op);
+#endif
 
 private:
   bool _raw_mode;
@@ -153,6 +170,14 @@ private:
   Sockets _selecting_sockets;
   int _next_index;
   int _num_results;
+
+#ifdef HAVE_EPOLL
+  // If this is not -1, the sockets are monitored by this epoll instance
+  // instead of by _fdset.  Each socket is registered one-shot, so that it
+  // reports only once until it has been read and finish_socket() rearms it.
+  int _epoll_fd;
+  pvector<struct epoll_event> _epoll_events;
+#endif
   // Threads go to sleep on this mutex waiting for their chance to read a
   // socket.
   Mutex _select_mutex;
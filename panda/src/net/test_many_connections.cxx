@@ -0,0 +1,195 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_many_connections.cxx
+ * @author agent
+ * @date 2026-10-17
+ */
+
+/**
+ * A loopback benchmark of a polling ConnectionListener and ConnectionReader
+ * with many TCP connections open at once.  It opens the indicated number of
+ * client connections to itself, then measures the cost of polling the reader
+ * when all of the connections are idle, when a few of them are sending, and
+ * when all of them are sending.
+ *
+ * Usage: test_many_connections [-s] [connections [port]]
+ *
+ * With -s, the reader uses select() instead of epoll; this is limited to
+ * sockets numbered below FD_SETSIZE.  Each connection takes two sockets, so
+ * the file descriptor limit (ulimit -n) must be at least twice the number of
+ * connections.
+ */
+
+#include "pandabase.h"
+
+#include "queuedConnectionManager.h"
+#include "queuedConnectionListener.h"
+#include "queuedConnectionReader.h"
+#include "connectionWriter.h"
+#include "netAddress.h"
+#include "connection.h"
+#include "netDatagram.h"
+#include "socket_tcp.h"
+#include "trueClock.h"
+#include "load_prc_file.h"
+
+#include "pvector.h"
+
+typedef pvector< PT(Connection) > Connections;
+
+/**
+ * Reads datagrams from the reader until the indicated number have arrived,
+ * or until a few seconds pass without any.  Returns the number read.
+ */
+static int
+receive_datagrams(QueuedConnectionReader &reader, int count) {
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double give_up = clock->get_short_time() + 5.0;
+  int received = 0;
+  while (received < count && clock->get_short_time() < give_up) {
+    while (reader.data_available()) {
+      NetDatagram datagram;
+      if (reader.get_data(datagram)) {
+        ++received;
+        give_up = clock->get_short_time() + 5.0;
+      }
+    }
+  }
+  return received;
+}
+
+/**
+ * Sends one datagram on each of every stride'th client connection, reads
+ * them all back from the reader, and returns the number of seconds it took.
+ */
+static double
+send_round(ConnectionWriter &writer, QueuedConnectionReader &reader,
+           const Connections &clients, int stride) {
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+
+  int count = 0;
+  for (size_t i = 0; i < clients.size(); i += stride) {
+    NetDatagram datagram;
+    datagram.add_uint32((uint32_t)i);
+    datagram.add_string("hello");
+    writer.send(datagram, clients[i]);
+    ++count;
+  }
+
+  int received = receive_datagrams(reader, count);
+  double elapsed = clock->get_short_time() - start;
+  if (received != count) {
+    nout << "Received only " << received << " of " << count << " datagrams.\n";
+    exit(1);
+  }
+  return elapsed;
+}
+
+int
+main(int argc, char *argv[]) {
+  bool use_select = false;
+  if (argc > 1 && strcmp(argv[1], "-s") == 0) {
+    use_select = true;
+    --argc;
+    ++argv;
+  }
+  int num_connections = (argc > 1) ? atoi(argv[1]) : 10000;
+  int port = (argc > 2) ? atoi(argv[2]) : 9099;
+
+  load_prc_file_data("test_many_connections",
+                     "notify-level-net warning\n"
+                     "net-max-response-queue 1000000\n");
+  if (use_select) {
+    load_prc_file_data("test_many_connections", "net-use-epoll false\n");
+  }
+
+  QueuedConnectionManager cm;
+  PT(Connection) rendezvous = cm.open_TCP_server_rendezvous(port, 1000);
+  if (rendezvous.is_null()) {
+    nout << "Cannot grab port " << port << ".\n";
+    exit(1);
+  }
+
+  QueuedConnectionListener listener(&cm, 0);
+  listener.add_connection(rendezvous);
+  QueuedConnectionReader reader(&cm, 0);
+  ConnectionWriter writer(&cm, 0);
+
+  // Open the client connections in batches, accepting each batch before
+  // opening the next, so we don't overflow the listen backlog.
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+
+  Socket_Address server_address;
+  server_address.set_host("127.0.0.1", port);
+
+  Connections clients, servers;
+  static const int batch_size = 100;
+  while ((int)clients.size() < num_connections) {
+    int batch = std::min(batch_size, num_connections - (int)clients.size());
+    for (int i = 0; i < batch; ++i) {
+      Socket_TCP *socket = new Socket_TCP;
+      if (!socket->ActiveOpen(server_address, false)) {
+        nout << "Unable to open connection " << clients.size()
+             << "; check ulimit -n.\n";
+        exit(1);
+      }
+      clients.push_back(new Connection(&cm, socket));
+    }
+
+    double give_up = clock->get_short_time() + 5.0;
+    while ((int)servers.size() < (int)clients.size()) {
+      if (clock->get_short_time() > give_up) {
+        nout << "Accepted only " << servers.size() << " of "
+             << clients.size() << " connections.\n";
+        exit(1);
+      }
+      while (listener.new_connection_available()) {
+        PT(Connection) new_connection;
+        if (listener.get_new_connection(new_connection)) {
+          reader.add_connection(new_connection);
+          servers.push_back(new_connection);
+        }
+      }
+    }
+  }
+
+  double elapsed = clock->get_short_time() - start;
+  nout << "Using " << (use_select ? "select()" : "epoll") << ".\n"
+       << "Opened " << num_connections << " connections in "
+       << elapsed * 1000.0 << " ms.\n";
+
+  // Polling with nothing to read.
+  static const int num_idle_polls = 1000;
+  start = clock->get_short_time();
+  for (int i = 0; i < num_idle_polls; ++i) {
+    reader.poll();
+  }
+  elapsed = clock->get_short_time() - start;
+  nout << "Idle poll: " << elapsed * 1000000.0 / num_idle_polls
+       << " us per poll.\n";
+
+  // A few connections sending at a time, then all of them.
+  static const int num_rounds = 10;
+  static const int strides[] = { 100, 1 };
+  for (size_t s = 0; s < sizeof(strides) / sizeof(strides[0]); ++s) {
+    int stride = strides[s];
+    int per_round = (num_connections + stride - 1) / stride;
+    elapsed = 0.0;
+    for (int i = 0; i < num_rounds; ++i) {
+      elapsed += send_round(writer, reader, clients, stride);
+    }
+    nout << per_round << " datagrams per round: "
+         << elapsed * 1000000.0 / (num_rounds * per_round)
+         << " us per datagram.\n";
+  }
+
+  return 0;
+}
@@ -65,6 +65,16 @@ populate_particle(BaseParticle *bp) {
   populate_child_particle(bp);
 }
 
+/**
+ * Returns true if the particles made by this factory do any work in their
+ * update() method.  A ParticleSystem that keeps its particles in arrays
+ * skips the per-particle update() calls when this returns false.
+ */
+bool BaseParticleFactory::
+needs_particle_update() const {
+  return true;
+}
+
 /**
  * Write a string representation of this instance to <out>.
  */
@@ -47,6 +47,9 @@ PUBLISHED:
 
   void populate_particle(BaseParticle* bp);
 
+public:
+  virtual bool needs_particle_update() const;
+
   virtual void output(std::ostream &out) const;
   virtual void write(std::ostream &out, int indent=0) const;
 
@@ -75,6 +75,28 @@ set_ignore_scale(bool ignore_scale) {
   }
 }
 
+/**
+ * Renders the particles of a system that keeps their state in arrays.  The
+ * default implementation copies the state of the living particles back to
+ * their BaseParticles and calls render(); renderers that are used with large
+ * systems override this to read the arrays directly.
+ */
+void BaseParticleRenderer::
+render_arrays(pvector< PT(PhysicsObject) >& po_vector,
+              ParticleArrays &arrays, int ttl_particles) {
+  int remaining = ttl_particles;
+  size_t size = std::min(po_vector.size(), arrays.get_size());
+  for (size_t i = 0; i < size && remaining > 0; ++i) {
+    BaseParticle *bp = (BaseParticle *)po_vector[i].p();
+    if (bp->get_alive()) {
+      arrays.store_particle(i, bp);
+      --remaining;
+    }
+  }
+
+  render(po_vector, ttl_particles);
+}
+
 /**
  * Write a string representation of this instance to <out>.
  */
@@ -19,10 +19,12 @@
 #include "physicsObject.h"
 #include "renderState.h"
 #include "geomNode.h"
+#include "geomVertexData.h"
 #include "colorBlendAttrib.h"
 #include "nodePath.h"
 #include "particleCommonFuncs.h"
 #include "baseParticle.h"
+#include "particleArrays.h"
 
 #include "pvector.h"
 
@@ -80,6 +82,7 @@ protected:
   void disable_alpha();
 
   INLINE PN_stdfloat get_cur_alpha(BaseParticle* bp);
+  static INLINE uint32_t pack_color(const LColor &color);
 
   virtual void resize_pool(int new_size) = 0;
 
@@ -105,6 +108,9 @@ private:
   virtual void init_geoms() = 0;
   virtual void render(pvector< PT(PhysicsObject) >& po_vector,
                       int ttl_particles) = 0;
+  virtual void render_arrays(pvector< PT(PhysicsObject) >& po_vector,
+                             ParticleArrays &arrays,
+                             int ttl_particles);
 
   friend class ParticleSystem;
 };
@@ -0,0 +1,65 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file particleArrays.cxx
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#include "particleArrays.h"
+#include "baseParticle.h"
+
+/**
+ * Changes the number of slots.  New slots are inactive.
+ */
+void ParticleArrays::
+resize(size_t size) {
+  PhysicsObjectArrays::resize(size);
+  _age.resize(size, 0.0f);
+  _lifespan.resize(size, 0.0f);
+  _terminal_velocity.resize(size, 0.0f);
+}
+
+/**
+ * Copies the state of the indicated particle into the nth slot, and marks
+ * the slot in use.  The particle's mass must not be zero.
+ */
+void ParticleArrays::
+load_particle(size_t n, const BaseParticle *bp) {
+  nassertv(n < get_size());
+  nassertv(bp->get_mass() != 0.0f);
+
+  LPoint3 pos = bp->get_position();
+  LPoint3 last_pos = bp->get_last_position();
+  LVector3 vel = bp->get_velocity();
+  for (int c = 0; c < 3; ++c) {
+    _position[c][n] = pos[c];
+    _last_position[c][n] = last_pos[c];
+    _velocity[c][n] = vel[c];
+  }
+  _mass[n] = bp->get_mass();
+  _age[n] = bp->get_age();
+  _lifespan[n] = bp->get_lifespan();
+  _terminal_velocity[n] = bp->get_terminal_velocity();
+  _active[n] = 1.0f;
+}
+
+/**
+ * Copies the state of the nth slot back to the indicated particle, so that
+ * code that works with BaseParticles, such as the renderers and the
+ * particles' own update() methods, sees it.
+ */
+void ParticleArrays::
+store_particle(size_t n, BaseParticle *bp) const {
+  nassertv(n < get_size());
+
+  bp->set_position(get_position(n));
+  bp->set_last_position(get_last_position(n));
+  bp->set_velocity(get_velocity(n));
+  bp->set_age(_age[n]);
+}
@@ -0,0 +1,46 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file particleArrays.h
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#ifndef PARTICLEARRAYS_H
+#define PARTICLEARRAYS_H
+
+#include "pandabase.h"
+#include "physicsObjectArrays.h"
+#include "nearly_zero.h"
+
+class BaseParticle;
+
+/**
+ * The per-frame state of a ParticleSystem's particle pool, kept in arrays
+ * when the system's soa flag is set.  This adds the particles' ages to the
+ * linear state that the integrator works on, so that the system can age and
+ * expire its particles without visiting each BaseParticle.
+ */
+class EXPCL_PANDA_PARTICLESYSTEM ParticleArrays : public PhysicsObjectArrays {
+public:
+  void resize(size_t size);
+
+  void load_particle(size_t n, const BaseParticle *bp);
+  void store_particle(size_t n, BaseParticle *bp) const;
+
+  INLINE PN_stdfloat get_parameterized_age(size_t n) const;
+  INLINE PN_stdfloat get_parameterized_vel(size_t n) const;
+
+  Array _age;
+  Array _lifespan;
+  Array _terminal_velocity;
+};
+
+#include "particleArrays.I"
+
+#endif  // PARTICLEARRAYS_H
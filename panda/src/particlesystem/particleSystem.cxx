@@ -60,6 +60,7 @@ ParticleSystem(int pool_size) :
   _i_was_spawned_flag = false;
   _particle_pool_size = 0;
   _floor_z = -HUGE_VAL;
+  _soa_flag = false;
 
   // just in case someone tries to do something that requires the use of an
   // emitter, renderer, or factory before they've actually assigned one.  This
@@ -88,7 +89,8 @@ ParticleSystem::
 ParticleSystem(const ParticleSystem& copy) :
   Physical(copy),
   _system_age(0.0f),
-  _template_system_flag(false)
+  _template_system_flag(false),
+  _soa_flag(false)
 {
   _birth_rate = copy._birth_rate;
   _cur_birth_rate = copy._cur_birth_rate;
@@ -112,6 +114,7 @@ ParticleSystem(const ParticleSystem& copy) :
   _living_particles = 0;
 
   set_pool_size(copy._particle_pool_size);
+  set_soa_flag(copy._soa_flag);
 }
 
 /**
@@ -188,6 +191,10 @@ birth_particle() {
   bp->reset_position(world_pos/* + (NORMALIZED_RAND() * new_vel)*/);
   bp->set_velocity(new_vel);
 
+  if (_soa_flag) {
+    _arrays.load_particle(pool_index, bp);
+  }
+
   ++_living_particles;
 
   // propogate information down to renderer
@@ -291,6 +298,13 @@ kill_particle(int pool_index) {
   // get a handle on our particle
   BaseParticle *bp = (BaseParticle *) _physics_objects[pool_index].p();
 
+  if (_soa_flag) {
+    if (_spawn_on_death_flag == true) {
+      _arrays.store_particle(pool_index, bp);
+    }
+    _arrays._active[pool_index] = 0.0f;
+  }
+
   // create a new system where this one died, maybe.
   if (_spawn_on_death_flag == true) {
     spawn_child_system(bp);
@@ -383,6 +397,10 @@ resize_pool(int size) {
     }
   }
 
+  if (_soa_flag) {
+    _arrays.resize(_physics_objects.size());
+  }
+
   // disregard no change
   if (delta == 0)
     return;
@@ -440,6 +458,10 @@ resize_pool(int size) {
     }
   }
 
+  if (_soa_flag) {
+    _arrays.resize(_physics_objects.size());
+  }
+
   _renderer->resize_pool(_particle_pool_size);
 
   #ifdef PARTICLE_SYSTEM_RESIZE_POOL_SENTRIES
@@ -472,55 +494,58 @@ update(PN_stdfloat dt) {
        << ", live particles: " << _living_particles << endl;
   #endif
 
-  // run through the particle array
-  while (ttl_updates_left) {
-    current_index = index_counter;
-    index_counter++;
+  if (_soa_flag) {
+    update_arrays(dt);
+  } else {
+    // run through the particle array
+    while (ttl_updates_left) {
+      current_index = index_counter;
+      index_counter++;
 
-    #ifdef PSDEBUG
-    if (current_index >= _particle_pool_size) {
-      cout << "ERROR: _living_particles is out of sync (too large)" << endl;
-      cout << "pool size: " << _particle_pool_size
-           << ", live particles: " << _living_particles
-           << ", updates left: " << ttl_updates_left << endl;
-      break;
-    }
-    #endif
+      #ifdef PSDEBUG
+      if (current_index >= _particle_pool_size) {
+        cout << "ERROR: _living_particles is out of sync (too large)" << endl;
+        cout << "pool size: " << _particle_pool_size
+             << ", live particles: " << _living_particles
+             << ", updates left: " << ttl_updates_left << endl;
+        break;
+      }
+      #endif
 
-    // get the current particle.
-    bp = (BaseParticle *) _physics_objects[current_index].p();
+      // get the current particle.
+      bp = (BaseParticle *) _physics_objects[current_index].p();
 
-    #ifdef PSDEBUG
-    if (!bp) {
-      cout << "NULL ptr at index " << current_index << endl;
-      continue;
-    }
-    #endif
+      #ifdef PSDEBUG
+      if (!bp) {
+        cout << "NULL ptr at index " << current_index << endl;
+        continue;
+      }
+      #endif
 
-    if (bp->get_alive() == false)
-      continue;
+      if (bp->get_alive() == false)
+        continue;
+
+      age = bp->get_age() + dt;
+      bp->set_age(age);
+
+      // cerr<<"bp->get_position().get_z() returning
+      // "<<bp->get_position().get_z()<<endl;
+      if (age >= bp->get_lifespan()) {
+        kill_particle(current_index);
+      } else if (get_floor_z() != -HUGE_VAL
+              && bp->get_position().get_z() <= get_floor_z()) {
+        // ...the particle is going under the floor.  Maybe tell the particle to
+        // bounce: bp->bounce()?
+        kill_particle(current_index);
+      } else {
+        bp->update();
+      }
 
-    age = bp->get_age() + dt;
-    bp->set_age(age);
-
-    // cerr<<"bp->get_position().get_z() returning
-    // "<<bp->get_position().get_z()<<endl;
-    if (age >= bp->get_lifespan()) {
-      kill_particle(current_index);
-    } else if (get_floor_z() != -HUGE_VAL
-            && bp->get_position().get_z() <= get_floor_z()) {
-      // ...the particle is going under the floor.  Maybe tell the particle to
-      // bounce: bp->bounce()?
-      kill_particle(current_index);
-    } else {
-      bp->update();
+      // break out early if we're lucky
+      ttl_updates_left--;
     }
-
-    // break out early if we're lucky
-    ttl_updates_left--;
   }
 
-
   // generate new particles if necessary.
   _tics_since_birth += dt;
 
@@ -535,6 +560,90 @@ update(PN_stdfloat dt) {
 
 }
 
+/**
+ * Does the work of update() for the living particles of a system that keeps
+ * them in arrays.  The particles are aged all at once, and only visited
+ * individually to be killed, or if the factory's particles need to be
+ * updated.
+ */
+void ParticleSystem::
+update_arrays(PN_stdfloat dt) {
+  size_t size = _arrays.get_size();
+  PN_stdfloat *age = _arrays._age.data();
+  const PN_stdfloat *lifespan = _arrays._lifespan.data();
+  const PN_stdfloat *active = _arrays._active.data();
+  const PN_stdfloat *z = _arrays._position[2].data();
+
+  for (size_t i = 0; i < size; ++i) {
+    age[i] += dt * active[i];
+  }
+
+  bool update_particles = _factory->needs_particle_update();
+  PN_stdfloat floor_z = get_floor_z();
+
+  int ttl_updates_left = _living_particles;
+  for (size_t i = 0; i < size && ttl_updates_left > 0; ++i) {
+    if (active[i] == 0.0f) {
+      continue;
+    }
+
+    if (age[i] >= lifespan[i]) {
+      kill_particle(i);
+    } else if (floor_z != -HUGE_VAL && z[i] <= floor_z) {
+      kill_particle(i);
+    } else if (update_particles) {
+      BaseParticle *bp = (BaseParticle *) _physics_objects[i].p();
+      bp->set_age(age[i]);
+      bp->update();
+    }
+
+    ttl_updates_left--;
+  }
+}
+
+/**
+ * Sets the flag that causes the system to keep the position, velocity and
+ * age of its particles in arrays, rather than in the BaseParticle objects.
+ * The physics integrator and the system's update() then process the whole
+ * particle pool a force at a time, which is considerably faster for large
+ * systems.
+ *
+ * While this is set, the BaseParticles returned by get_objects() are not
+ * kept up to date, except when the system is rendered.  Clearing the flag
+ * copies the particles' state back to them.
+ */
+void ParticleSystem::
+set_soa_flag(bool soa) {
+  if (soa == _soa_flag) {
+    return;
+  }
+
+  size_t size = _physics_objects.size();
+  if (soa) {
+    _arrays.resize(0);
+    _arrays.resize(size);
+    for (size_t i = 0; i < size; ++i) {
+      BaseParticle *bp = (BaseParticle *) _physics_objects[i].p();
+      if (bp->get_alive()) {
+        _arrays.load_particle(i, bp);
+      }
+    }
+    _object_arrays = &_arrays;
+
+  } else {
+    for (size_t i = 0; i < size; ++i) {
+      BaseParticle *bp = (BaseParticle *) _physics_objects[i].p();
+      if (bp->get_alive()) {
+        _arrays.store_particle(i, bp);
+      }
+    }
+    _arrays.resize(0);
+    _object_arrays = nullptr;
+  }
+
+  _soa_flag = soa;
+}
+
 #ifdef PSSANITYCHECK
 /**
  * Checks consistency of live particle count, free particle list, etc.
@@ -739,6 +848,7 @@ write(ostream &out, int indent) const {
   out.width(indent+2); out<<""; out<<"_local_velocity_flag "<<_local_velocity_flag<<"\n";
   out.width(indent+2); out<<""; out<<"_system_grows_older_flag "<<_system_grows_older_flag<<"\n";
   out.width(indent+2); out<<""; out<<"_spawn_on_death_flag "<<_spawn_on_death_flag<<"\n";
+  out.width(indent+2); out<<""; out<<"_soa_flag "<<_soa_flag<<"\n";
   out.width(indent+2); out<<""; out<<"_spawn_render_node "<<_spawn_render_node_path<<"\n";
   out.width(indent+2); out<<""; out<<"_i_was_spawned_flag "<<_i_was_spawned_flag<<"\n";
   write_free_particle_fifo(out, indent+2);
@@ -25,6 +25,7 @@
 #include "baseParticleRenderer.h"
 #include "baseParticleEmitter.h"
 #include "baseParticleFactory.h"
+#include "particleArrays.h"
 
 class ParticleSystemManager;
 
@@ -60,6 +61,7 @@ PUBLISHED:
   INLINE void set_emitter(BaseParticleEmitter *e);
   INLINE void set_factory(BaseParticleFactory *f);
   INLINE void set_floor_z(PN_stdfloat z);
+  void set_soa_flag(bool soa);
 
   INLINE void clear_floor_z();
 
@@ -84,6 +86,7 @@ PUBLISHED:
   INLINE BaseParticleFactory *get_factory() const;
   INLINE PN_stdfloat get_floor_z() const;
   INLINE PN_stdfloat get_tics_since_birth() const;
+  INLINE bool get_soa_flag() const;
 
   // particle template vector
 
@@ -114,6 +117,7 @@ private:
   bool birth_particle();
   void kill_particle(int pool_index);
   void resize_pool(int size);
+  void update_arrays(PN_stdfloat dt);
 
   pdeque< int > _free_particle_fifo;
 
@@ -146,6 +150,10 @@ private:
   bool _local_velocity_flag;
   bool _system_grows_older_flag;
 
+  // information for systems that keep their particles in arrays
+  bool _soa_flag;
+  ParticleArrays _arrays;
+
   // information for systems that will spawn
 
   bool _spawn_on_death_flag;
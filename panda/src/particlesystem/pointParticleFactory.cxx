@@ -55,6 +55,14 @@ alloc_particle() const {
   return new PointParticle;
 }
 
+/**
+ * PointParticle::update() does nothing.
+ */
+bool PointParticleFactory::
+needs_particle_update() const {
+  return false;
+}
+
 /**
  * Write a string representation of this instance to <out>.
  */
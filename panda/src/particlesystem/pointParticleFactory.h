@@ -29,6 +29,9 @@ PUBLISHED:
   virtual void output(std::ostream &out) const;
   virtual void write(std::ostream &out, int indent=0) const;
 
+public:
+  virtual bool needs_particle_update() const;
+
 private:
   virtual BaseParticle *alloc_particle() const;
   virtual void populate_child_particle(BaseParticle *bp) const;
@@ -94,6 +94,8 @@ init_geoms() {
   _point_primitive = geom;
   _points = new GeomPoints(Geom::UH_stream);
   geom->add_primitive(_points);
+  _indices = new GeomVertexArrayData
+    (GeomPrimitive::get_index_format(GeomEnums::NT_uint32), Geom::UH_stream);
 
   GeomNode *render_node = get_render_node();
   render_node->remove_all_geoms();
@@ -119,10 +121,21 @@ kill_particle(int) {
  */
 LColor PointParticleRenderer::
 create_color(const BaseParticle *p) {
+  PN_stdfloat parameterized_vel = 0.0f;
+  if (_blend_type == PP_BLEND_VEL) {
+    parameterized_vel = p->get_parameterized_vel();
+  }
+  return create_color(p->get_parameterized_age(), parameterized_vel);
+}
+
+/**
+ * Generates the point color based on the render_type, given the particle's
+ * parameterized age and velocity.
+ */
+LColor PointParticleRenderer::
+create_color(PN_stdfloat parameterized_age, PN_stdfloat parameterized_vel) {
   LColor color;
   PN_stdfloat life_t, vel_t;
-  PN_stdfloat parameterized_age = 1.0f;
-  bool have_alpha_t = false;
 
   switch (_blend_type) {
   case PP_ONE_COLOR:
@@ -132,9 +145,7 @@ create_color(const BaseParticle *p) {
 
   case PP_BLEND_LIFE:
     // Blending colors based on life
-    parameterized_age = p->get_parameterized_age();
     life_t = parameterized_age;
-    have_alpha_t = true;
 
     if (_blend_method == PP_BLEND_CUBIC) {
       life_t = CUBIC_T(life_t);
@@ -145,7 +156,7 @@ create_color(const BaseParticle *p) {
 
   case PP_BLEND_VEL:
     // Blending colors based on vel
-    vel_t = p->get_parameterized_vel();
+    vel_t = parameterized_vel;
 
     if (_blend_method == PP_BLEND_CUBIC) {
       vel_t = CUBIC_T(vel_t);
@@ -160,10 +171,6 @@ create_color(const BaseParticle *p) {
     if (_alpha_mode == PR_ALPHA_USER) {
       parameterized_age = 1.0;
     } else {
-      if (!have_alpha_t) {
-        parameterized_age = p->get_parameterized_age();
-      }
-
       if (_alpha_mode == PR_ALPHA_OUT) {
         parameterized_age = 1.0f - parameterized_age;
       } else if (_alpha_mode == PR_ALPHA_IN_OUT) {
@@ -253,6 +260,83 @@ render(pvector< PT(PhysicsObject) >& po_vector, int ttl_particles) {
   get_render_node()->mark_internal_bounds_stale();
 }
 
+/**
+ * Renders the particles of a system that keeps them in arrays.  The vertex
+ * data holds a row for every slot in the pool, whether or not it is in use;
+ * only the rows of the living particles are written, and the points index
+ * just those rows.
+ */
+void PointParticleRenderer::
+render_arrays(pvector< PT(PhysicsObject) >& po_vector,
+              ParticleArrays &arrays, int ttl_particles) {
+  PStatTimer t1(_render_collector);
+
+  int size = (int)arrays.get_size();
+
+  PT(GeomVertexArrayDataHandle) vertices = _vdata->modify_array_handle(0);
+  if (vertices->get_num_rows() != size) {
+    vertices->unclean_set_num_rows(size);
+  }
+  PT(GeomVertexArrayDataHandle) indices = _indices->modify_handle();
+  if (indices->get_num_rows() != size) {
+    indices->unclean_set_num_rows(size);
+  }
+
+  const GeomVertexArrayFormat *format = vertices->get_array_format();
+  int stride = format->get_stride();
+  unsigned char *vertex_data = vertices->get_write_pointer() +
+    format->get_column(InternalName::get_vertex())->get_start();
+  unsigned char *color_data = vertices->get_write_pointer() +
+    format->get_column(InternalName::get_color())->get_start();
+  uint32_t *index_data = (uint32_t *)indices->get_write_pointer();
+
+  const PN_stdfloat *px = arrays._position[0].data();
+  const PN_stdfloat *py = arrays._position[1].data();
+  const PN_stdfloat *pz = arrays._position[2].data();
+  const PN_stdfloat *active = arrays._active.data();
+
+  _aabb_min.set(99999.0f, 99999.0f, 99999.0f);
+  _aabb_max.set(-99999.0f, -99999.0f, -99999.0f);
+
+  int num_points = 0;
+  for (int i = 0; i < size && num_points < ttl_particles; ++i) {
+    if (active[i] == 0.0f) {
+      continue;
+    }
+
+    PN_stdfloat *vertex = (PN_stdfloat *)(vertex_data + i * stride);
+    vertex[0] = px[i];
+    vertex[1] = py[i];
+    vertex[2] = pz[i];
+
+    _aabb_min.set(std::min(_aabb_min[0], px[i]),
+                  std::min(_aabb_min[1], py[i]),
+                  std::min(_aabb_min[2], pz[i]));
+    _aabb_max.set(std::max(_aabb_max[0], px[i]),
+                  std::max(_aabb_max[1], py[i]),
+                  std::max(_aabb_max[2], pz[i]));
+
+    PN_stdfloat parameterized_vel = 0.0f;
+    if (_blend_type == PP_BLEND_VEL) {
+      parameterized_vel = arrays.get_parameterized_vel(i);
+    }
+    LColor color = create_color(arrays.get_parameterized_age(i),
+                                parameterized_vel);
+    *(uint32_t *)(color_data + i * stride) = pack_color(color);
+
+    index_data[num_points++] = i;
+  }
+
+  _points->set_vertices(_indices, num_points);
+
+  LPoint3 aabb_center = _aabb_min + ((_aabb_max - _aabb_min) * 0.5f);
+  PN_stdfloat radius = (aabb_center - _aabb_min).length();
+
+  BoundingSphere sphere(aabb_center, radius);
+  _point_primitive->set_bounds(&sphere);
+  get_render_node()->mark_internal_bounds_stale();
+}
+
 /**
  * Write a string representation of this instance to <out>.
  */
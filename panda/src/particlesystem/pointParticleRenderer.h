@@ -76,6 +76,7 @@ private:
   PT(Geom) _point_primitive;
   PT(GeomPoints) _points;
   PT(GeomVertexData) _vdata;
+  PT(GeomVertexArrayData) _indices;
 
   int _max_pool_size;
 
@@ -86,12 +87,16 @@ private:
   LPoint3 _aabb_max;
 
   LColor create_color(const BaseParticle *p);
+  LColor create_color(PN_stdfloat parameterized_age,
+                      PN_stdfloat parameterized_vel);
 
   virtual void birth_particle(int index);
   virtual void kill_particle(int index);
   virtual void init_geoms();
   virtual void render(pvector< PT(PhysicsObject) >& po_vector,
                       int ttl_particles);
+  virtual void render_arrays(pvector< PT(PhysicsObject) >& po_vector,
+                             ParticleArrays &arrays, int ttl_particles);
   virtual void resize_pool(int new_size);
 
   static PStatCollector _render_collector;
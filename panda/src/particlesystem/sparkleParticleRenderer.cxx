@@ -115,6 +115,8 @@ init_geoms() {
   _line_primitive = geom;
   _lines = new GeomLines(Geom::UH_stream);
   geom->add_primitive(_lines);
+  _indices = new GeomVertexArrayData
+    (GeomPrimitive::get_index_format(GeomEnums::NT_uint32), Geom::UH_stream);
 
   GeomNode *render_node = get_render_node();
   render_node->remove_all_geoms();
@@ -258,6 +260,133 @@ render(pvector< PT(PhysicsObject) >& po_vector, int ttl_particles) {
   get_render_node()->mark_internal_bounds_stale();
 }
 
+/**
+ * Renders the particles of a system that keeps them in arrays.  Each slot in
+ * the pool has its own block of rows in the vertex data, which are only
+ * written while the particle in it is alive; the lines index just the blocks
+ * of the living particles.
+ */
+void SparkleParticleRenderer::
+render_arrays(pvector< PT(PhysicsObject) >& po_vector,
+              ParticleArrays &arrays, int ttl_particles) {
+  PStatTimer t1(_render_collector);
+  if (!ttl_particles) {
+    _lines->clear_vertices();
+    return;
+  }
+
+  // Each particle is drawn as 6 lines coming from the center point.
+  static const int rows_per_particle = 12;
+  static const LVector3 offsets[6] = {
+    LVector3(1.0f, 0.0f, 0.0f),
+    LVector3(-1.0f, 0.0f, 0.0f),
+    LVector3(0.0f, 1.0f, 0.0f),
+    LVector3(0.0f, -1.0f, 0.0f),
+    LVector3(0.0f, 0.0f, 1.0f),
+    LVector3(0.0f, 0.0f, -1.0f),
+  };
+
+  int size = (int)arrays.get_size();
+  int num_rows = size * rows_per_particle;
+
+  PT(GeomVertexArrayDataHandle) vertices = _vdata->modify_array_handle(0);
+  if (vertices->get_num_rows() != num_rows) {
+    vertices->unclean_set_num_rows(num_rows);
+  }
+  PT(GeomVertexArrayDataHandle) indices = _indices->modify_handle();
+  if (indices->get_num_rows() != num_rows) {
+    indices->unclean_set_num_rows(num_rows);
+  }
+
+  const GeomVertexArrayFormat *format = vertices->get_array_format();
+  int stride = format->get_stride();
+  unsigned char *vertex_data = vertices->get_write_pointer() +
+    format->get_column(InternalName::get_vertex())->get_start();
+  unsigned char *color_data = vertices->get_write_pointer() +
+    format->get_column(InternalName::get_color())->get_start();
+  uint32_t *index_data = (uint32_t *)indices->get_write_pointer();
+
+  const PN_stdfloat *active = arrays._active.data();
+
+  _aabb_min.set(99999.0f, 99999.0f, 99999.0f);
+  _aabb_max.set(-99999.0f, -99999.0f, -99999.0f);
+
+  uint32_t center_color = pack_color(_center_color);
+  uint32_t edge_color = pack_color(_edge_color);
+
+  int remaining_particles = ttl_particles;
+  int num_indices = 0;
+  for (int i = 0; i < size && remaining_particles > 0; ++i) {
+    if (active[i] == 0.0f) {
+      continue;
+    }
+
+    LPoint3 position = arrays.get_position(i);
+    _aabb_min.set(std::min(_aabb_min[0], position[0]),
+                  std::min(_aabb_min[1], position[1]),
+                  std::min(_aabb_min[2], position[2]));
+    _aabb_max.set(std::max(_aabb_max[0], position[0]),
+                  std::max(_aabb_max[1], position[1]),
+                  std::max(_aabb_max[2], position[2]));
+
+    PN_stdfloat parameterized_age = arrays.get_parameterized_age(i);
+    PN_stdfloat radius = get_radius(parameterized_age);
+
+    // handle alpha
+    if (_alpha_mode != PR_ALPHA_NONE) {
+      PN_stdfloat alpha;
+      if (_alpha_mode == PR_ALPHA_USER) {
+        alpha = get_user_alpha();
+      } else {
+        alpha = parameterized_age;
+        if (_alpha_mode == PR_ALPHA_OUT)
+          alpha = 1.0f - alpha;
+        else if (_alpha_mode == PR_ALPHA_IN_OUT)
+          alpha = 2.0f * std::min(alpha, 1.0f - alpha);
+
+        alpha *= get_user_alpha();
+      }
+
+      LColor color = _center_color;
+      color[3] = alpha;
+      center_color = pack_color(color);
+      color = _edge_color;
+      color[3] = alpha;
+      edge_color = pack_color(color);
+    }
+
+    int row = i * rows_per_particle;
+    for (int j = 0; j < 6; ++j) {
+      LPoint3 edge = position + offsets[j] * radius;
+
+      PN_stdfloat *vertex = (PN_stdfloat *)(vertex_data + row * stride);
+      vertex[0] = position[0];
+      vertex[1] = position[1];
+      vertex[2] = position[2];
+      *(uint32_t *)(color_data + row * stride) = center_color;
+      index_data[num_indices++] = row++;
+
+      vertex = (PN_stdfloat *)(vertex_data + row * stride);
+      vertex[0] = edge[0];
+      vertex[1] = edge[1];
+      vertex[2] = edge[2];
+      *(uint32_t *)(color_data + row * stride) = edge_color;
+      index_data[num_indices++] = row++;
+    }
+
+    remaining_particles--;
+  }
+
+  _lines->set_vertices(_indices, num_indices);
+
+  LPoint3 aabb_center = _aabb_min + ((_aabb_max - _aabb_min) * 0.5f);
+  PN_stdfloat radius = (aabb_center - _aabb_min).length();
+
+  BoundingSphere sphere(aabb_center, radius);
+  _line_primitive->set_bounds(&sphere);
+  get_render_node()->mark_internal_bounds_stale();
+}
+
 /**
  * Write a string representation of this instance to <out>.
  */
@@ -78,6 +78,7 @@ private:
   PT(Geom) _line_primitive;
   PT(GeomLines) _lines;
   PT(GeomVertexData) _vdata;
+  PT(GeomVertexArrayData) _indices;
 
   int _max_pool_size;
 
@@ -86,12 +87,15 @@ private:
   LPoint3 _aabb_max;
 
   INLINE PN_stdfloat get_radius(BaseParticle *bp);
+  INLINE PN_stdfloat get_radius(PN_stdfloat parameterized_age);
 
   virtual void birth_particle(int index);
   virtual void kill_particle(int index);
   virtual void init_geoms();
   virtual void render(pvector< PT(PhysicsObject) >& po_vector,
                       int ttl_particles);
+  virtual void render_arrays(pvector< PT(PhysicsObject) >& po_vector,
+                             ParticleArrays &arrays, int ttl_particles);
   virtual void resize_pool(int new_size);
 
   static PStatCollector _render_collector;
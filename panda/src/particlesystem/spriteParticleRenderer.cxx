@@ -454,6 +454,8 @@ init_geoms() {
   _sprites.clear();
   _vdata.clear();
   _sprite_writer.clear();
+  _pool_vdata = new GeomVertexData("sprite_particles", format, Geom::UH_stream);
+  _pool_indices.clear();
 
   GeomNode *render_node = get_render_node();
   render_node->remove_all_geoms();
@@ -480,6 +482,8 @@ init_geoms() {
       // This will be overwritten in render(), but we had to have some initial
       // value
       _sprite_writer[i].push_back(SpriteWriter());
+      _pool_indices.push_back(new GeomVertexArrayData
+        (GeomPrimitive::get_index_format(GeomEnums::NT_uint32), Geom::UH_stream));
 
       state = state->add_attrib(RenderModeAttrib::make(RenderModeAttrib::M_unchanged, _base_y_scale * _height, true));
       if (anim->get_frame(j) != nullptr) {
@@ -743,6 +747,220 @@ render(pvector< PT(PhysicsObject) >& po_vector, int ttl_particles) {
   _animation_removed = false;
 }
 
+/**
+ * Renders the particles of a system that keeps them in arrays.  Rather than
+ * packing the particles into a separate vertex data for each geom, this
+ * writes each living particle into its own row of a single vertex data that
+ * holds a row for every slot in the pool, and gives each geom the list of
+ * rows it should draw.  The rows of dead particles are simply left out of
+ * the lists.
+ */
+void SpriteParticleRenderer::
+render_arrays(pvector< PT(PhysicsObject) > &po_vector,
+              ParticleArrays &arrays, int ttl_particles) {
+  PStatTimer t1(_render_collector);
+  // There is no texture data available, exit.
+  if (_anims.empty()) {
+    return;
+  }
+
+  BaseParticle *cur_particle;
+  int i,j;                                  // loop counters
+  int anim_count = _anims.size();           // number of animations
+  int frame;                                // frame index, used in indicating which frame to use when not animated
+
+  // Do the same delayed initialization as render(), but adjust the ages in
+  // the arrays, which are the ones the system uses.
+  for (vector_int::iterator vIter = _birth_list.begin(); vIter != _birth_list.end(); ++vIter) {
+    cur_particle = (BaseParticle*)po_vector[*vIter].p();
+    i = int(NORMALIZED_RAND()*anim_count);
+    cur_particle->set_index(i < anim_count?i:i-1);
+    if (_animate_frames) {
+      arrays._age[*vIter] += i/10.0*arrays._lifespan[*vIter];
+    }
+  }
+  _birth_list.clear();
+
+  int size = (int)arrays.get_size();
+
+  PT(GeomVertexArrayDataHandle) vertices = _pool_vdata->modify_array_handle(0);
+  if (vertices->get_num_rows() != size) {
+    vertices->unclean_set_num_rows(size);
+  }
+
+  const GeomVertexArrayFormat *format = vertices->get_array_format();
+  int stride = format->get_stride();
+  unsigned char *data = vertices->get_write_pointer();
+  int vertex_start = format->get_column(InternalName::get_vertex())->get_start();
+  int color_start = format->get_column(InternalName::get_color())->get_start();
+  const GeomVertexColumn *rotate = format->get_column(InternalName::get_rotate());
+  const GeomVertexColumn *size_column = format->get_column(InternalName::get_size());
+  const GeomVertexColumn *aspect_ratio = format->get_column(InternalName::get_aspect_ratio());
+
+  // Get a pointer to the row list of each geom.  The geoms are numbered in
+  // the same order as they were added to the render node.
+  pvector< PT(GeomVertexArrayDataHandle) > index_handles;
+  pvector<uint32_t *> index_data;
+  vector_int num_indices;
+  vector_int first_geom(anim_count);
+  for (i = 0; i < anim_count; ++i) {
+    first_geom[i] = (int)index_handles.size();
+    for (j = 0; j < _anim_size[i]; ++j) {
+      PT(GeomVertexArrayDataHandle) handle = _pool_indices[first_geom[i] + j]->modify_handle();
+      if (handle->get_num_rows() != size) {
+        handle->unclean_set_num_rows(size);
+      }
+      index_data.push_back((uint32_t *)handle->get_write_pointer());
+      index_handles.push_back(std::move(handle));
+      num_indices.push_back(0);
+    }
+  }
+
+  const PN_stdfloat *px = arrays._position[0].data();
+  const PN_stdfloat *py = arrays._position[1].data();
+  const PN_stdfloat *pz = arrays._position[2].data();
+  const PN_stdfloat *active = arrays._active.data();
+  int alphamode = get_alpha_mode();
+
+  // init the aabb
+  _aabb_min.set(99999.0f, 99999.0f, 99999.0f);
+  _aabb_max.set(-99999.0f, -99999.0f, -99999.0f);
+
+  int remaining_particles = ttl_particles;
+  for (int n = 0; n < size && remaining_particles > 0; ++n) {
+    if (active[n] == 0.0f) {
+      continue;
+    }
+    remaining_particles--;
+
+    _aabb_min.set(min(_aabb_min[0], px[n]),
+                  min(_aabb_min[1], py[n]),
+                  min(_aabb_min[2], pz[n]));
+    _aabb_max.set(max(_aabb_max[0], px[n]),
+                  max(_aabb_max[1], py[n]),
+                  max(_aabb_max[2], pz[n]));
+
+    PN_stdfloat t = arrays.get_parameterized_age(n);
+
+    // Only look at the particle itself if there is more than one animation
+    // it might be using.
+    int anim_index = 0;
+    if (anim_count > 1 || _animation_removed) {
+      cur_particle = (BaseParticle *)po_vector[n].p();
+      anim_index = cur_particle->get_index();
+      if (_animation_removed && (anim_index >= anim_count)) {
+        anim_index = int(NORMALIZED_RAND()*anim_count);
+        anim_index = anim_index<anim_count?anim_index:anim_index-1;
+        cur_particle->set_index(anim_index);
+      }
+    }
+
+    // Find the frame
+    if (_animate_frames) {
+      if (_animate_frames_rate == 0.0f) {
+        frame = (int)(t*_anim_size[anim_index]);
+      } else {
+        frame = (int)fmod(arrays._age[n]*_animate_frames_rate+1,_anim_size[anim_index]);
+      }
+    } else {
+      frame = _animate_frames_index;
+    }
+    frame = (frame < _anim_size[anim_index]) ? frame : (_anim_size[anim_index]-1);
+
+    LColor c = _color_interpolation_manager->generateColor(t);
+
+    if (alphamode != PR_ALPHA_NONE) {
+      if (alphamode == PR_ALPHA_OUT)
+        c[3] *= (1.0f - t) * get_user_alpha();
+      else if (alphamode == PR_ALPHA_IN)
+        c[3] *= t * get_user_alpha();
+      else if (alphamode == PR_ALPHA_IN_OUT) {
+        c[3] *= 2.0f * min(t, 1.0f - t) * get_user_alpha();
+      }
+      else {
+        assert(alphamode == PR_ALPHA_USER);
+        c[3] *= get_user_alpha();
+      }
+    }
+
+    unsigned char *row = data + n * stride;
+    PN_stdfloat *vertex = (PN_stdfloat *)(row + vertex_start);
+    vertex[0] = px[n];
+    vertex[1] = py[n];
+    vertex[2] = pz[n];
+    *(uint32_t *)(row + color_start) = pack_color(c);
+
+    PN_stdfloat current_x_scale = _initial_x_scale;
+    PN_stdfloat current_y_scale = _initial_y_scale;
+
+    if (_animate_x_ratio || _animate_y_ratio) {
+      if (_blend_method == PP_BLEND_CUBIC) {
+        t = CUBIC_T(t);
+      }
+
+      if (_animate_x_ratio) {
+        current_x_scale = (_initial_x_scale +
+                           (t * (_final_x_scale - _initial_x_scale)));
+      }
+      if (_animate_y_ratio) {
+        current_y_scale = (_initial_y_scale +
+                           (t * (_final_y_scale - _initial_y_scale)));
+      }
+    }
+
+    if (size_column != nullptr) {
+      *(PN_stdfloat *)(row + size_column->get_start()) = current_y_scale * _height;
+    }
+    if (aspect_ratio != nullptr) {
+      *(PN_stdfloat *)(row + aspect_ratio->get_start()) = _aspect_ratio * current_x_scale / current_y_scale;
+    }
+    if (rotate != nullptr) {
+      PN_stdfloat theta = _theta;
+      if (_animate_theta) {
+        theta = ((BaseParticle *)po_vector[n].p())->get_theta();
+      }
+      *(PN_stdfloat *)(row + rotate->get_start()) = theta;
+    }
+
+    int geom_index = first_geom[anim_index] + frame;
+    index_data[geom_index][num_indices[geom_index]++] = n;
+  }
+
+  int n = 0;
+  GeomNode *render_node = get_render_node();
+
+  for (i = 0; i < anim_count; ++i) {
+    for (j = 0; j < _anim_size[i]; ++j) {
+      _sprites[i][j]->set_vertices(_pool_indices[n], num_indices[n]);
+
+      // We have to reassign the GeomVertexData and GeomPrimitive to the Geom,
+      // and the Geom to the GeomNode, in case it got flattened away.  The
+      // vertex data goes first, since the new primitive indexes into it.
+      _sprite_primitive[i][j]->set_vertex_data(_pool_vdata);
+      _sprite_primitive[i][j]->set_primitive(0, _sprites[i][j]);
+
+      render_node->set_geom(n, _sprite_primitive[i][j]);
+      ++n;
+    }
+  }
+
+  // done filling geompoint node, now do the bb stuff
+  LPoint3 aabb_center = _aabb_min + ((_aabb_max - _aabb_min) * 0.5f);
+  PN_stdfloat radius = (aabb_center - _aabb_min).length();
+
+  for (i = 0; i < anim_count; ++i) {
+    for (j = 0; j < _anim_size[i]; ++j) {
+      nassertv(_sprite_primitive[i][j]->check_valid());
+      BoundingSphere sphere(aabb_center, radius);
+      _sprite_primitive[i][j]->set_bounds(&sphere);
+    }
+  }
+
+  get_render_node()->mark_internal_bounds_stale();
+  nassertv(render_node->check_valid());
+  _animation_removed = false;
+}
+
 /**
  * Write a string representation of this instance to <out>.
  */
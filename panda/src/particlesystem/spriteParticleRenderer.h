@@ -226,6 +226,11 @@ private:
   pvector< pvector< SpriteWriter > > _sprite_writer;
   pvector< pvector< PT(GeomVertexData) > > _vdata;
 
+  // Used by render_arrays(): one vertex data with a row per pool slot, shared
+  // by all of the geoms, and the list of rows that each geom draws.
+  PT(GeomVertexData) _pool_vdata;
+  pvector< PT(GeomVertexArrayData) > _pool_indices;
+
   pvector< PT(SpriteAnim) > _anims;            // Stores texture references and UV info for each geom.
 
   LColor _color;
@@ -262,6 +267,8 @@ private:
   virtual void init_geoms();
   virtual void render(pvector< PT(PhysicsObject) > &po_vector,
                       int ttl_particles);
+  virtual void render_arrays(pvector< PT(PhysicsObject) > &po_vector,
+                             ParticleArrays &arrays, int ttl_particles);
   virtual void resize_pool(int new_size);
   int extract_textures_from_node(const NodePath &node_path, NodePathCollection &np_col, TextureCollection &tex_col);
 
@@ -39,6 +39,8 @@ public:
 
 private:
 #ifndef NDEBUG
+  // These may be updated by several threads at once, each holding a
+  // different shard lock, so they are only approximate.
   int _cache_hits = 0;
   int _cache_misses = 0;
   int _cache_adds = 0;
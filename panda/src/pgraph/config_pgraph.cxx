@@ -130,6 +130,32 @@ ConfigVariableBool debug_portal_cull
           "(You first need to enable portal culling, using the allow-portal-cull"
           "variable.)"));
 
+ConfigVariableInt cull_traverser_threads
+("cull-traverser-threads", 1,
+ PRC_DESC("The default number of threads used by each CullTraverser; see "
+          "CullTraverser::set_num_threads().  Set this greater than 1 to "
+          "distribute the traversal of large scenes among multiple threads.  "
+          "This only has an effect if Panda was compiled with true threading "
+          "support."));
+
+ConfigVariableInt cull_parallel_min_children
+("cull-parallel-min-children", 16,
+ PRC_DESC("When a CullTraverser is using multiple threads, this is the "
+          "minimum number of children a node must have before the subgraphs "
+          "below its children are distributed among the threads."));
+
+ConfigVariableBool cullable_object_arena
+("cullable-object-arena", true,
+ PRC_DESC("Set this true to allocate the objects found by the cull traversal "
+          "for each frame out of a few large blocks of memory, which are "
+          "released all at once after the frame has been drawn, rather than "
+          "allocating and freeing each object individually."));
+
+ConfigVariableInt cullable_object_arena_block_size
+("cullable-object-arena-block-size", 1024,
+ PRC_DESC("The maximum number of objects in each of the blocks allocated "
+          "when cullable-object-arena is true."));
+
 ConfigVariableBool show_occluder_volumes
 ("show-occluder-volumes", false,
  PRC_DESC("Set this true to enable debug visualization of the volumes used "
@@ -34,6 +34,10 @@ extern ConfigVariableBool fake_view_frustum_cull;
 extern ConfigVariableBool clip_plane_cull;
 extern ConfigVariableBool allow_portal_cull;
 extern ConfigVariableBool debug_portal_cull;
+extern ConfigVariableInt cull_traverser_threads;
+extern ConfigVariableInt cull_parallel_min_children;
+extern ConfigVariableBool cullable_object_arena;
+extern ConfigVariableInt cullable_object_arena_block_size;
 extern ConfigVariableBool show_occluder_volumes;
 extern ConfigVariableBool unambiguous_graph;
 extern ConfigVariableBool detect_graph_cycles;
@@ -22,7 +22,9 @@
  *
  */
 CullHandler::
-CullHandler() {
+CullHandler() :
+  _arena(nullptr)
+{
 }
 
 /**
@@ -16,6 +16,7 @@
 
 #include "pandabase.h"
 #include "cullableObject.h"
+#include "cullableObjectArena.h"
 #include "graphicsStateGuardianBase.h"
 
 class CullTraverser;
@@ -34,9 +35,15 @@ public:
                              const CullTraverser *traverser);
   virtual void end_traverse();
 
+  INLINE CullableObject *make_object(CPT(Geom) geom, CPT(RenderState) state,
+                                     CPT(TransformState) internal_transform);
+
   INLINE static void draw(CullableObject *object,
                           GraphicsStateGuardianBase *gsg,
                           bool force, Thread *current_thread);
+
+protected:
+  CullableObjectArena *_arena;
 };
 
 #include "cullHandler.I"
@@ -58,7 +58,8 @@ CullResult::
 CullResult(GraphicsStateGuardianBase *gsg,
            const PStatCollector &draw_region_pcollector) :
   _gsg(gsg),
-  _draw_region_pcollector(draw_region_pcollector)
+  _draw_region_pcollector(draw_region_pcollector),
+  _use_arena(cullable_object_arena)
 {
 #ifdef DO_MEMORY_USAGE
   MemoryUsage::update_type(this, get_class_type());
@@ -132,7 +133,7 @@ add_object(CullableObject *object, const CullTraverser *traverser) {
   const RenderModeAttrib *rmode;
   if (object->_state->get_attrib(rmode)) {
     if (rmode->get_mode() == RenderModeAttrib::M_filled_wireframe) {
-      CullableObject *wireframe_part = new CullableObject(*object);
+      CullableObject *wireframe_part = make_copy(*object);
       wireframe_part->_state = get_wireframe_overlay_state(rmode);
 
       if (wireframe_part->munge_geom
@@ -203,7 +204,7 @@ add_object(CullableObject *object, const CullTraverser *traverser) {
           if (m_dual_transparent)
 #endif
             {
-              CullableObject *transparent_part = new CullableObject(*object);
+              CullableObject *transparent_part = make_copy(*object);
               CPT(RenderState) transparent_state = get_dual_transparent_state();
               transparent_part->_state = object->_state->compose(transparent_state);
               if (transparent_part->munge_geom
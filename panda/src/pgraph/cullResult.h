@@ -19,6 +19,7 @@
 #include "cullBinManager.h"
 #include "renderState.h"
 #include "cullableObject.h"
+#include "cullableObjectArena.h"
 #include "geomMunger.h"
 #include "referenceCount.h"
 #include "pointerTo.h"
@@ -59,10 +60,13 @@ PUBLISHED:
   PT(PandaNode) make_result_graph();
 
 public:
+  INLINE CullableObjectArena *get_arena();
+
   static void bin_removed(int bin_index);
 
 private:
   CullBin *make_new_bin(int bin_index);
+  INLINE CullableObject *make_copy(const CullableObject &copy);
 
   INLINE void check_flash_bin(CPT(RenderState) &state, CullBinManager *bin_manager, int bin_index);
   INLINE void check_flash_transparency(CPT(RenderState) &state, const LColor &color);
@@ -82,6 +86,11 @@ private:
   GraphicsStateGuardianBase *_gsg;
   PStatCollector _draw_region_pcollector;
 
+  // The objects in the bins may have been allocated from this arena, so it
+  // must be declared before, and therefore destroyed after, the bins.
+  CullableObjectArena _arena;
+  bool _use_arena;
+
   typedef pvector< PT(CullBin) > Bins;
   Bins _bins;
 
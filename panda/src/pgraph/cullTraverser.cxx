@@ -34,6 +34,7 @@
 #include "geomLinestrips.h"
 #include "geomLines.h"
 #include "geomVertexWriter.h"
+#include "asyncTaskManager.h"
 
 PStatCollector CullTraverser::_nodes_pcollector("Nodes");
 PStatCollector CullTraverser::_geom_nodes_pcollector("Nodes:GeomNodes");
@@ -42,6 +43,21 @@ PStatCollector CullTraverser::_geoms_occluded_pcollector("Geoms:Occluded");
 
 TypeHandle CullTraverser::_type_handle;
 
+/**
+ * The CullHandler used by each thread participating in a parallel traversal.
+ * It merely saves up the objects it is given, so that they may be passed on
+ * to the real CullHandler later, in order.
+ */
+class CullTraverser::DeferredCullHandler : public CullHandler {
+public:
+  virtual void record_object(CullableObject *object,
+                             const CullTraverser *traverser) {
+    _objects->push_back(object);
+  }
+
+  DeferredObjects *_objects = nullptr;
+};
+
 /**
  *
  */
@@ -56,6 +72,7 @@ CullTraverser() :
   _cull_handler = nullptr;
   _portal_clipper = nullptr;
   _effective_incomplete_render = true;
+  _num_threads = cull_traverser_threads;
 }
 
 /**
@@ -73,7 +90,8 @@ CullTraverser(const CullTraverser &copy) :
   _view_frustum(copy._view_frustum),
   _cull_handler(copy._cull_handler),
   _portal_clipper(copy._portal_clipper),
-  _effective_incomplete_render(copy._effective_incomplete_render)
+  _effective_incomplete_render(copy._effective_incomplete_render),
+  _num_threads(copy._num_threads)
 {
 }
 
@@ -200,9 +218,13 @@ traverse_below(CullTraverserData &data) {
   node_reader->release();
   int num_children = children.get_num_children();
   if (!node->has_selective_visibility()) {
-    for (int i = 0; i < num_children; ++i) {
-      CullTraverserData next_data(data, children.get_child(i));
-      do_traverse(next_data);
+    if (should_traverse_parallel(num_children)) {
+      traverse_children_parallel(data, children);
+    } else {
+      for (int i = 0; i < num_children; ++i) {
+        CullTraverserData next_data(data, children.get_child(i));
+        do_traverse(next_data);
+      }
     }
   } else {
     int i = node->get_first_visible_child();
@@ -214,6 +236,142 @@ traverse_below(CullTraverserData &data) {
   }
 }
 
+/**
+ * Returns true if the children of a node with the indicated number of
+ * children should be distributed among multiple threads, or false if they
+ * should be traversed by this thread alone.
+ */
+bool CullTraverser::
+should_traverse_parallel(int num_children) const {
+  if (_num_threads <= 1 || num_children < cull_parallel_min_children ||
+      !Thread::is_true_threads()) {
+    return false;
+  }
+
+  // The PortalClipper keeps track of the portals it is currently looking
+  // through, so it can't be shared.  Similarly, a derived traverser may keep
+  // its own state, which would be lost by the copies the threads make.
+  return _portal_clipper == nullptr &&
+         get_type() == CullTraverser::get_class_type();
+}
+
+/**
+ * Traverses the subgraphs below the indicated children of the node described
+ * by data, distributing them among the calling thread and the threads of the
+ * "cull" task chain.  Each thread saves up the objects it finds; these are
+ * passed to the CullHandler only after all of the subgraphs have been
+ * traversed, in the same order in which the serial traversal would have
+ * passed them.
+ */
+void CullTraverser::
+traverse_children_parallel(CullTraverserData &data,
+                           const PandaNode::Children &children) {
+  ParallelChildren pc;
+  pc._trav = this;
+  pc._data = &data;
+  pc._children = &children;
+  pc._num_children = children.get_num_children();
+  pc._pipeline_stage = _current_thread->get_pipeline_stage();
+  pc._next_chunk = 0;
+
+  // Divide the children into several chunks per thread, so that the work is
+  // still evenly balanced if some subgraphs are much larger than others.
+  int num_chunks = std::min(pc._num_children, _num_threads * 4);
+  pc._chunk_size = (pc._num_children + num_chunks - 1) / num_chunks;
+  num_chunks = (pc._num_children + pc._chunk_size - 1) / pc._chunk_size;
+  pc._chunks.resize(num_chunks);
+
+  int num_tasks = std::min(_num_threads, num_chunks) - 1;
+  pvector<PT(AsyncTask)> tasks;
+  if (num_tasks > 0) {
+    AsyncTaskManager *task_mgr = AsyncTaskManager::get_global_ptr();
+    AsyncTaskChain *chain = task_mgr->make_task_chain("cull");
+    if (chain->get_num_threads() < num_tasks) {
+      chain->set_num_threads(num_tasks);
+    }
+
+    tasks.reserve(num_tasks);
+    for (int i = 0; i < num_tasks; ++i) {
+      PT(GenericAsyncTask) task =
+        new GenericAsyncTask("cull_children", &st_parallel_children, &pc);
+      task->set_task_chain("cull");
+      task_mgr->add(task);
+      tasks.push_back(task);
+    }
+  }
+
+  // The calling thread takes its share of the chunks, too.
+  do_parallel_children(pc);
+
+  for (AsyncTask *task : tasks) {
+    task->wait();
+  }
+
+  // Now hand the objects to the real CullHandler, in traversal order.
+  for (const DeferredObjects &objects : pc._chunks) {
+    for (CullableObject *object : objects) {
+      _cull_handler->record_object(object, this);
+    }
+  }
+}
+
+/**
+ * Repeatedly claims the next unclaimed chunk of children and traverses the
+ * subgraphs below them, until there are no more chunks.  This is called by
+ * each of the threads participating in traverse_children_parallel().
+ */
+void CullTraverser::
+do_parallel_children(CullTraverser::ParallelChildren &pc) {
+  // This thread must observe the same pipeline stage as the thread that
+  // started the traversal.
+  Thread *current_thread = Thread::get_current_thread();
+  int old_stage = current_thread->get_pipeline_stage();
+  if (old_stage != pc._pipeline_stage) {
+    current_thread->set_pipeline_stage(pc._pipeline_stage);
+  }
+
+  // Each thread uses its own copy of the traverser, which records the objects
+  // it finds instead of passing them on, and which doesn't split the
+  // traversal any further.
+  DeferredCullHandler handler;
+  CullTraverser trav(*this);
+  trav._current_thread = current_thread;
+  trav._cull_handler = &handler;
+  trav._num_threads = 1;
+
+  int num_chunks = (int)pc._chunks.size();
+  while (true) {
+    int chunk = (int)(AtomicAdjust::add(pc._next_chunk, 1) - 1);
+    if (chunk >= num_chunks) {
+      break;
+    }
+
+    handler._objects = &pc._chunks[chunk];
+    int begin = chunk * pc._chunk_size;
+    int end = std::min(begin + pc._chunk_size, pc._num_children);
+    for (int i = begin; i < end; ++i) {
+      CullTraverserData next_data(*pc._data, pc._children->get_child(i),
+                                  current_thread);
+      trav.do_traverse(next_data);
+    }
+  }
+
+  if (old_stage != pc._pipeline_stage) {
+    current_thread->set_pipeline_stage(old_stage);
+  }
+}
+
+/**
+ * The task function for the threads participating in
+ * traverse_children_parallel().
+ */
+AsyncTask::DoneStatus CullTraverser::
+st_parallel_children(GenericAsyncTask *task, void *data) {
+  ParallelChildren *pc = (ParallelChildren *)data;
+  pc->_trav->do_parallel_children(*pc);
+  return AsyncTask::DS_done;
+}
+
 /**
  * Should be called when the traverser has finished traversing its scene, this
  * gives it a chance to do any necessary finalization.
@@ -27,6 +27,9 @@
 #include "typedReferenceCount.h"
 #include "pStatCollector.h"
 #include "fogAttrib.h"
+#include "genericAsyncTask.h"
+#include "atomicAdjust.h"
+#include "pvector.h"
 
 class GraphicsStateGuardian;
 class PandaNode;
@@ -77,6 +80,10 @@ PUBLISHED:
 
   INLINE bool get_effective_incomplete_render() const;
 
+  INLINE void set_num_threads(int num_threads);
+  INLINE int get_num_threads() const;
+  MAKE_PROPERTY(num_threads, get_num_threads, set_num_threads);
+
   void traverse(const NodePath &root);
   void traverse(CullTraverserData &data);
   virtual void traverse_below(CullTraverserData &data);
@@ -101,6 +108,30 @@ public:
   static PStatCollector _geoms_occluded_pcollector;
 
 private:
+  class DeferredCullHandler;
+  typedef pvector<CullableObject *> DeferredObjects;
+
+  // The state shared by the threads participating in
+  // traverse_children_parallel().
+  class ParallelChildren {
+  public:
+    CullTraverser *_trav;
+    const CullTraverserData *_data;
+    const PandaNode::Children *_children;
+    int _num_children;
+    int _chunk_size;
+    int _pipeline_stage;
+    pvector<DeferredObjects> _chunks;
+    AtomicAdjust::Integer _next_chunk;
+  };
+
+  bool should_traverse_parallel(int num_children) const;
+  void traverse_children_parallel(CullTraverserData &data,
+                                  const PandaNode::Children &children);
+  void do_parallel_children(ParallelChildren &pc);
+  static AsyncTask::DoneStatus st_parallel_children(GenericAsyncTask *task,
+                                                    void *data);
+
   void show_bounds(CullTraverserData &data, bool tight);
   static PT(Geom) make_bounds_viz(const BoundingVolume *vol);
   PT(Geom) make_tight_bounds_viz(PandaNode *node) const;
@@ -121,6 +152,7 @@ private:
   CullHandler *_cull_handler;
   PortalClipper *_portal_clipper;
   bool _effective_incomplete_render;
+  int _num_threads;
 
 public:
   static TypeHandle get_class_type() {
@@ -46,6 +46,8 @@ public:
                            Thread *current_thread);
   INLINE CullTraverserData(const CullTraverserData &parent,
                            PandaNode *child);
+  INLINE CullTraverserData(const CullTraverserData &parent,
+                           PandaNode *child, Thread *current_thread);
 
 PUBLISHED:
   INLINE PandaNode *node() const;
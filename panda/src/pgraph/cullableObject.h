@@ -32,6 +32,7 @@
 #include "geomDrawCallbackData.h"
 
 class CullTraverser;
+class CullableObjectArena;
 class GeomMunger;
 
 /**
@@ -63,7 +64,10 @@ public:
                             bool force, Thread *current_thread);
 
 public:
-  ALLOC_DELETED_CHAIN(CullableObject);
+  INLINE void *operator new(size_t size);
+  INLINE void *operator new(size_t size, void *ptr);
+  INLINE void operator delete(void *ptr);
+  INLINE void operator delete(void *, void *);
 
   void output(std::ostream &out) const;
 
@@ -75,6 +79,9 @@ public:
   PT(CallbackObject) _draw_callback;
 
 private:
+  class Slot;
+  friend class CullableObjectArena;
+
   bool munge_points_to_quads(const CullTraverser *traverser, bool force);
 
   static CPT(RenderState) get_flash_cpu_state();
@@ -127,6 +134,18 @@ private:
   static TypeHandle _type_handle;
 };
 
+/**
+ * The memory in which a CullableObject is constructed.  The object is preceded
+ * by a pointer to the CullableObjectArena that owns the memory, if any, so
+ * that operator delete can tell whether the memory should be freed now, or
+ * left for the arena to release all at once.
+ */
+class CullableObject::Slot {
+public:
+  CullableObjectArena *_arena;
+  alignas(CullableObject) unsigned char _storage[sizeof(CullableObject)];
+};
+
 INLINE std::ostream &operator << (std::ostream &out, const CullableObject &object) {
   object.output(out);
   return out;
@@ -0,0 +1,45 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file cullableObjectArena.cxx
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#include "cullableObjectArena.h"
+#include "config_pgraph.h"
+
+/**
+ * Releases the memory for all of the objects in the arena.  By this time, all
+ * of the objects must already have been deleted.
+ */
+CullableObjectArena::
+~CullableObjectArena() {
+  for (CullableObject::Slot *block : _blocks) {
+    PANDA_FREE_ARRAY(block);
+  }
+}
+
+/**
+ * Allocates a new block of memory from which to construct objects.  Each
+ * block is twice the size of the previous one, up to a limit.
+ */
+void CullableObjectArena::
+new_block() {
+  size_t max_slots = (size_t)std::max((int)cullable_object_arena_block_size, 1);
+  size_t num_slots = max_slots;
+  if (_blocks.size() < 16) {
+    num_slots = std::min((size_t)64 << _blocks.size(), max_slots);
+  }
+
+  CullableObject::Slot *block = (CullableObject::Slot *)
+    PANDA_MALLOC_ARRAY(num_slots * sizeof(CullableObject::Slot));
+  _blocks.push_back(block);
+  _next = block;
+  _end = block + num_slots;
+}
@@ -0,0 +1,58 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file cullableObjectArena.h
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#ifndef CULLABLEOBJECTARENA_H
+#define CULLABLEOBJECTARENA_H
+
+#include "pandabase.h"
+#include "cullableObject.h"
+#include "pvector.h"
+
+/**
+ * Allocates the CullableObjects for one frame's CullResult out of a few large
+ * blocks of memory, rather than one at a time.  This avoids a trip through
+ * the allocator, and the lock it takes, for each object.
+ *
+ * The objects are still deleted individually, by whichever CullBin ends up
+ * owning them, but their memory is not released until the arena itself is
+ * destroyed, which happens along with the CullResult after it has been drawn.
+ *
+ * This class is not thread-safe; each arena should be filled by only one
+ * thread at a time.
+ */
+class EXPCL_PANDA_PGRAPH CullableObjectArena {
+public:
+  INLINE CullableObjectArena();
+  ~CullableObjectArena();
+
+  INLINE CullableObject *make_object(CPT(Geom) geom, CPT(RenderState) state,
+                                     CPT(TransformState) internal_transform);
+  INLINE CullableObject *make_copy(const CullableObject &copy);
+
+private:
+  CullableObjectArena(const CullableObjectArena &copy) = delete;
+  CullableObjectArena &operator = (const CullableObjectArena &copy) = delete;
+
+  INLINE void *alloc_object();
+  void new_block();
+
+  typedef pvector<CullableObject::Slot *> Blocks;
+  Blocks _blocks;
+
+  CullableObject::Slot *_next;
+  CullableObject::Slot *_end;
+};
+
+#include "cullableObjectArena.I"
+
+#endif
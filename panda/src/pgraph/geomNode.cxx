@@ -556,9 +556,10 @@ add_for_draw(CullTraverser *trav, CullTraverserData &data) {
       }
     }
 
+    CullHandler *handler = trav->get_cull_handler();
     CullableObject *object =
-      new CullableObject(std::move(geom), std::move(state), internal_transform);
-    trav->get_cull_handler()->record_object(object, trav);
+      handler->make_object(std::move(geom), std::move(state), internal_transform);
+    handler->record_object(object, trav);
   }
 }
 
@@ -8,6 +8,7 @@
 #include "cullTraverser.cxx"
 #include "cullTraverserData.cxx"
 #include "cullableObject.cxx"
+#include "cullableObjectArena.cxx"
 #include "decalEffect.cxx"
 #include "depthOffsetAttrib.cxx"
 #include "depthTestAttrib.cxx"
@@ -20,12 +20,9 @@
 
 using std::ostream;
 
-LightReMutex *RenderAttrib::_attribs_lock = nullptr;
-RenderAttrib::Attribs RenderAttrib::_attribs;
+RenderAttrib::Attribs *RenderAttrib::_attribs = nullptr;
 TypeHandle RenderAttrib::_type_handle;
 
-size_t RenderAttrib::_garbage_index = 0;
-
 PStatCollector RenderAttrib::_garbage_collect_pcollector("*:State Cache:Garbage Collect");
 
 /**
@@ -33,7 +30,7 @@ PStatCollector RenderAttrib::_garbage_collect_pcollector("*:State Cache:Garbage
  */
 RenderAttrib::
 RenderAttrib() {
-  if (_attribs_lock == nullptr) {
+  if (_attribs == nullptr) {
     init_attribs();
   }
   _saved_entry = -1;
@@ -113,10 +110,9 @@ unref() const {
   // of the cache when its reference count goes to 0.
 
   // We always have to grab the lock, since we will definitely need to be
-  // holding it if we happen to drop the reference count to 0. Having to grab
-  // the lock at every call to unref() is a big limiting factor on
-  // parallelization.
-  LightReMutexHolder holder(*_attribs_lock);
+  // holding it if we happen to drop the reference count to 0.  Only the
+  // shard that this attrib hashes to needs to be locked, though.
+  LightReMutexHolder holder((*_attribs)[Attribs::get_shard_index(get_hash())]._lock);
 
   if (ReferenceCount::unref()) {
     // The reference count is still nonzero.
@@ -153,8 +149,8 @@ write(ostream &out, int indent_level) const {
  */
 int RenderAttrib::
 get_num_attribs() {
-  LightReMutexHolder holder(*_attribs_lock);
-  return _attribs.get_num_entries();
+  Attribs::Holder holder(*_attribs);
+  return _attribs->get_num_entries();
 }
 
 /**
@@ -164,13 +160,16 @@ get_num_attribs() {
  */
 void RenderAttrib::
 list_attribs(ostream &out) {
-  LightReMutexHolder holder(*_attribs_lock);
+  Attribs::Holder holder(*_attribs);
 
-  size_t size = _attribs.get_num_entries();
-  out << size << " attribs:\n";
-  for (size_t si = 0; si < size; ++si) {
-    const RenderAttrib *attrib = _attribs.get_key(si);
-    attrib->write(out, 2);
+  out << _attribs->get_num_entries() << " attribs:\n";
+  for (size_t n = 0; n < Attribs::num_shards; ++n) {
+    const AttribTable &attribs = (*_attribs)[n]._table;
+    size_t size = attribs.get_num_entries();
+    for (size_t si = 0; si < size; ++si) {
+      const RenderAttrib *attrib = attribs.get_key(si);
+      attrib->write(out, 2);
+    }
   }
 }
 
@@ -183,67 +182,72 @@ garbage_collect() {
   if (!garbage_collect_states) {
     return 0;
   }
-  LightReMutexHolder holder(*_attribs_lock);
-
   PStatTimer timer(_garbage_collect_pcollector);
-  size_t orig_size = _attribs.get_num_entries();
+
+  // Each shard is collected in turn; there is no need to hold the others.
+  int num_freed = 0;
+  for (size_t n = 0; n < Attribs::num_shards; ++n) {
+    Attribs::Shard &shard = (*_attribs)[n];
+    LightReMutexHolder holder(shard._lock);
+    AttribTable &attribs = shard._table;
+    size_t orig_size = attribs.get_num_entries();
 
 #ifdef _DEBUG
-  nassertr(_attribs.validate(), 0);
+    nassertr(attribs.validate(), 0);
 #endif
 
-  // How many elements to process this pass?
-  size_t size = orig_size;
-  size_t num_this_pass = std::max(0, int(size * garbage_collect_states_rate));
-  if (num_this_pass <= 0) {
-    return 0;
-  }
+    // How many elements to process this pass?
+    size_t size = orig_size;
+    size_t num_this_pass = std::max(0, int(size * garbage_collect_states_rate));
+    if (num_this_pass <= 0) {
+      continue;
+    }
 
-  size_t si = _garbage_index;
-  if (si >= size) {
-    si = 0;
-  }
+    size_t si = shard._garbage_index;
+    num_this_pass = std::min(num_this_pass, size);
 
-  num_this_pass = std::min(num_this_pass, size);
-  size_t stop_at_element = (si + num_this_pass) % size;
-
-  do {
-    RenderAttrib *attrib = (RenderAttrib *)_attribs.get_key(si);
-    if (!attrib->unref_if_one()) {
-      // This attrib has recently been unreffed to 1 (the one we added when
-      // we stored it in the cache).  Now it's time to delete it.  This is
-      // safe, because we're holding the _attribs_lock, so it's not possible
-      // for some other thread to find the attrib in the cache and ref it
-      // while we're doing this.  Also, we've just made sure to unref it to 0,
-      // to ensure that another thread can't get it via a weak pointer.
-      attrib->release_new();
-      delete attrib;
-
-      // When we removed it from the hash map, it swapped the last element
-      // with the one we just removed.  So the current index contains one we
-      // still need to visit.
-      --size;
-      --si;
-      if (stop_at_element > 0) {
-        --stop_at_element;
+    while (num_this_pass > 0 && size > 0) {
+      --num_this_pass;
+      if (si >= size) {
+        si = 0;
       }
-    }
 
-    si = (si + 1) % size;
-  } while (si != stop_at_element);
-  _garbage_index = si;
+      RenderAttrib *attrib = (RenderAttrib *)attribs.get_key(si);
+      if (!attrib->unref_if_one()) {
+        // This attrib has recently been unreffed to 1 (the one we added when
+        // we stored it in the cache).  Now it's time to delete it.  This is
+        // safe, because we're holding the lock of its shard, so it's not
+        // possible for some other thread to find the attrib in the cache and
+        // ref it while we're doing this.  Also, we've just made sure to unref
+        // it to 0, to ensure that another thread can't get it via a weak
+        // pointer.
+        attrib->release_new();
+        delete attrib;
+
+        // When we removed it from the hash map, it swapped the last element
+        // with the one we just removed.  So the current index contains one
+        // we still need to visit.
+        --size;
+      } else {
+        ++si;
+      }
+    }
+    shard._garbage_index = si;
 
-  nassertr(_attribs.get_num_entries() == size, 0);
+    nassertr(attribs.get_num_entries() == size, 0);
 
 #ifdef _DEBUG
-  nassertr(_attribs.validate(), 0);
+    nassertr(attribs.validate(), 0);
 #endif
 
-  // If we just cleaned up a lot of attribs, see if we can reduce the table in
-  // size.  This will help reduce iteration overhead in the future.
-  _attribs.consider_shrink_table();
+    // If we just cleaned up a lot of attribs, see if we can reduce the table
+    // in size.  This will help reduce iteration overhead in the future.
+    attribs.consider_shrink_table();
+
+    num_freed += (int)orig_size - (int)size;
+  }
 
-  return (int)orig_size - (int)size;
+  return num_freed;
 }
 
 /**
@@ -253,52 +257,56 @@ garbage_collect() {
  */
 bool RenderAttrib::
 validate_attribs() {
-  LightReMutexHolder holder(*_attribs_lock);
-  if (_attribs.is_empty()) {
-    return true;
-  }
-
-  if (!_attribs.validate()) {
-    pgraph_cat.error()
-      << "RenderAttrib::_attribs cache is invalid!\n";
+  Attribs::Holder holder(*_attribs);
 
-    size_t size = _attribs.get_num_entries();
-    for (size_t si = 0; si < size; ++si) {
-      const RenderAttrib *attrib = _attribs.get_key(si);
-      //cerr << si << ": " << attrib << "\n";
-      attrib->write(std::cerr, 2);
+  for (size_t n = 0; n < Attribs::num_shards; ++n) {
+    const AttribTable &attribs = (*_attribs)[n]._table;
+    if (attribs.is_empty()) {
+      continue;
     }
 
-    return false;
-  }
-
-  size_t size = _attribs.get_num_entries();
-  size_t si = 0;
-  nassertr(si < size, false);
-  nassertr(_attribs.get_key(si)->get_ref_count() >= 0, false);
-  size_t snext = si;
-  ++snext;
-  while (snext < size) {
-    nassertr(_attribs.get_key(snext)->get_ref_count() >= 0, false);
-    const RenderAttrib *ssi = _attribs.get_key(si);
-    const RenderAttrib *ssnext = _attribs.get_key(snext);
-    int c = ssi->compare_to(*ssnext);
-    int ci = ssnext->compare_to(*ssi);
-    if ((ci < 0) != (c > 0) ||
-        (ci > 0) != (c < 0) ||
-        (ci == 0) != (c == 0)) {
+    if (!attribs.validate()) {
       pgraph_cat.error()
-        << "RenderAttrib::compare_to() not defined properly!\n";
-      pgraph_cat.error(false)
-        << "(a, b): " << c << "\n";
-      pgraph_cat.error(false)
-        << "(b, a): " << ci << "\n";
-      ssi->write(pgraph_cat.error(false), 2);
-      ssnext->write(pgraph_cat.error(false), 2);
+        << "RenderAttrib::_attribs cache is invalid!\n";
+
+      size_t size = attribs.get_num_entries();
+      for (size_t si = 0; si < size; ++si) {
+        const RenderAttrib *attrib = attribs.get_key(si);
+        //cerr << si << ": " << attrib << "\n";
+        attrib->write(std::cerr, 2);
+      }
+
       return false;
     }
-    si = snext;
+
+    size_t size = attribs.get_num_entries();
+    size_t si = 0;
+    nassertr(si < size, false);
+    nassertr(attribs.get_key(si)->get_ref_count() >= 0, false);
+    size_t snext = si;
     ++snext;
+    while (snext < size) {
+      nassertr(attribs.get_key(snext)->get_ref_count() >= 0, false);
+      const RenderAttrib *ssi = attribs.get_key(si);
+      const RenderAttrib *ssnext = attribs.get_key(snext);
+      int c = ssi->compare_to(*ssnext);
+      int ci = ssnext->compare_to(*ssi);
+      if ((ci < 0) != (c > 0) ||
+          (ci > 0) != (c < 0) ||
+          (ci == 0) != (c == 0)) {
+        pgraph_cat.error()
+          << "RenderAttrib::compare_to() not defined properly!\n";
+        pgraph_cat.error(false)
+          << "(a, b): " << c << "\n";
+        pgraph_cat.error(false)
+          << "(b, a): " << ci << "\n";
+        ssi->write(pgraph_cat.error(false), 2);
+        ssnext->write(pgraph_cat.error(false), 2);
+        return false;
+      }
+      si = snext;
+      ++snext;
+    }
   }
 
   return true;
@@ -348,36 +356,45 @@ return_unique(RenderAttrib *attrib) {
   }
 #endif
 
-  LightReMutexHolder holder(*_attribs_lock);
+  CPT(RenderAttrib) result;
+  {
+    // Only the shard that this attrib hashes to needs to be locked.
+    Attribs::Shard &shard = (*_attribs)[Attribs::get_shard_index(attrib->get_hash())];
+    LightReMutexHolder holder(shard._lock);
 
-  if (attrib->_saved_entry != -1) {
-    // This attrib is already in the cache.  nassertr(_attribs.find(attrib)
-    // == attrib->_saved_entry, attrib);
-    return attrib;
-  }
+    if (attrib->_saved_entry != -1) {
+      // This attrib is already in the cache.  nassertr(_attribs.find(attrib)
+      // == attrib->_saved_entry, attrib);
+      return attrib;
+    }
+
+    int si = shard._table.find(attrib);
+    if (si == -1) {
+      // Not already in the set; add it.
+      if (garbage_collect_states) {
+        // If we'll be garbage collecting attribs explicitly, we'll increment
+        // the reference count when we store it in the cache, so that it
+        // won't be deleted while it's in it.
+        attrib->ref();
+      }
+      si = shard._table.store(attrib, nullptr);
 
-  int si = _attribs.find(attrib);
-  if (si != -1) {
-    // There's an equivalent attrib already in the set.  Return it.  If this
-    // is a newly created RenderAttrib, though, be sure to delete it.
-    if (attrib->get_ref_count() == 0) {
-      delete attrib;
+      // Save the index and return the input attrib.
+      attrib->_saved_entry = si;
+      return attrib;
     }
-    return _attribs.get_key(si);
-  }
 
-  // Not already in the set; add it.
-  if (garbage_collect_states) {
-    // If we'll be garbage collecting attribs explicitly, we'll increment the
-    // reference count when we store it in the cache, so that it won't be
-    // deleted while it's in it.
-    attrib->ref();
+    // There's an equivalent attrib already in the set.  Return it.
+    result = shard._table.get_key(si);
   }
-  si = _attribs.store(attrib, nullptr);
 
-  // Save the index and return the input attrib.
-  attrib->_saved_entry = si;
-  return attrib;
+  // If this is a newly created RenderAttrib, though, be sure to delete it.
+  // This is done after the lock is released, since its destructor may
+  // release other objects.
+  if (attrib->get_ref_count() == 0) {
+    delete attrib;
+  }
+  return result;
 }
 
 /**
@@ -482,15 +499,17 @@ output_comparefunc(ostream &out, PandaCompareFunc fn) const {
  * This inverse of return_new, this releases this object from the global
  * RenderAttrib table.
  *
- * You must already be holding _attribs_lock before you call this method.
+ * You must already be holding the lock of the shard it is stored in before
+ * you call this method.
  */
 void RenderAttrib::
 release_new() {
-  nassertv(_attribs_lock->debug_is_locked());
+  Attribs::Shard &shard = (*_attribs)[Attribs::get_shard_index(get_hash())];
+  nassertv(shard._lock.debug_is_locked());
 
   if (_saved_entry != -1) {
     _saved_entry = -1;
-    nassertv_always(_attribs.remove(this));
+    nassertv_always(shard._table.remove(this));
   }
 }
 
@@ -504,10 +523,14 @@ release_new() {
 void RenderAttrib::
 init_attribs() {
   // TODO: we should have a global Panda mutex to allow us to safely create
-  // _attribs_lock without a startup race condition.  For the meantime, this
-  // is OK because we guarantee that this method is called at static init
-  // time, presumably when there is still only one thread in the world.
-  _attribs_lock = new LightReMutex("RenderAttrib::_attribs_lock");
+  // _attribs without a startup race condition.  For the meantime, this is OK
+  // because we guarantee that this method is called at static init time,
+  // presumably when there is still only one thread in the world.  This is
+  // called again from init_libpgraph(), after the default attribs have been
+  // stored, so we must not replace the table then.
+  if (_attribs == nullptr) {
+    _attribs = new Attribs;
+  }
   nassertv(Thread::get_current_thread() == Thread::get_main_thread());
 }
 
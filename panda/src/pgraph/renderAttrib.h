@@ -22,6 +22,7 @@
 #include "simpleHashMap.h"
 #include "lightReMutex.h"
 #include "pStatCollector.h"
+#include "stateShards.h"
 
 class AttribSlots;
 class GraphicsStateGuardianBase;
@@ -183,18 +184,15 @@ public:
   static void init_attribs();
 
 private:
-  // This mutex protects _attribs.
-  static LightReMutex *_attribs_lock;
-  typedef SimpleHashMap<const RenderAttrib *, std::nullptr_t, indirect_compare_to_hash<const RenderAttrib *> > Attribs;
-  static Attribs _attribs;
+  // The unique attribs are stored in _attribs, which is split into shards by
+  // hash.  The lock of each shard protects its table.
+  typedef SimpleHashMap<const RenderAttrib *, std::nullptr_t, indirect_compare_to_hash<const RenderAttrib *> > AttribTable;
+  typedef StateShards<AttribTable> Attribs;
+  static Attribs *_attribs;
 
   int _saved_entry;
   size_t _hash;
 
-  // This keeps track of our current position through the garbage collection
-  // cycle.
-  static size_t _garbage_index;
-
   static PStatCollector _garbage_collect_pcollector;
 
   friend class RenderAttribRegistry;
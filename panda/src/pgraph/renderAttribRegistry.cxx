@@ -90,10 +90,12 @@ register_slot(TypeHandle type_handle, int sort, RenderAttrib *default_attrib) {
     default_attrib->calc_hash();
 
     if (default_attrib->_saved_entry == -1) {
+      RenderAttrib::AttribTable &attribs =
+        (*RenderAttrib::_attribs)[RenderAttrib::Attribs::get_shard_index(default_attrib->get_hash())]._table;
+
       // If this attribute was already registered, something odd is going on.
-      nassertr(RenderAttrib::_attribs.find(default_attrib) == -1, 0);
-      default_attrib->_saved_entry =
-        RenderAttrib::_attribs.store(default_attrib, nullptr);
+      nassertr(attribs.find(default_attrib) == -1, 0);
+      default_attrib->_saved_entry = attribs.store(default_attrib, nullptr);
     }
 
     // It effectively lives forever.  Might as well make it official.
@@ -39,10 +39,9 @@
 using std::ostream;
 
 LightReMutex *RenderState::_states_lock = nullptr;
-RenderState::States RenderState::_states;
+RenderState::States *RenderState::_states = nullptr;
 const RenderState *RenderState::_empty_state = nullptr;
 UpdateSeq RenderState::_last_cycle_detect;
-size_t RenderState::_garbage_index = 0;
 
 PStatCollector RenderState::_cache_update_pcollector("*:State Cache:Update");
 PStatCollector RenderState::_garbage_collect_pcollector("*:State Cache:Garbage Collect");
@@ -117,8 +116,6 @@ RenderState::
   nassertv(!is_destructing());
   set_destructing();
 
-  LightReMutexHolder holder(*_states_lock);
-
   // unref() should have cleared these.
   nassertv(_saved_entry == -1);
   nassertv(_composition_cache.is_empty() && _invert_composition_cache.is_empty());
@@ -358,9 +355,32 @@ compose(const RenderState *other) const {
     return do_compose(other);
   }
 
-  LightReMutexHolder holder(*_states_lock);
+  {
+    LightReMutexHolder holder(get_cache_lock());
+
+    // Is this composition already cached?
+    int index = _composition_cache.find(other);
+    if (index != -1) {
+      const Composition &comp = _composition_cache.get_data(index);
+      if (comp._result != nullptr) {
+        // Here's the cache!
+        _cache_stats.inc_hits();
+        return comp._result;
+      }
+    }
+  }
+
+  // Not in the cache.  Compute a new result without holding the lock, since
+  // this may need to create new RenderStates and RenderAttribs.
+  CPT(RenderState) result = do_compose(other);
+
+  // Now we need the locks of both states, since we add an entry to each.
+  // They must be acquired in order.
+  size_t this_shard = States::get_shard_index(get_hash());
+  size_t other_shard = States::get_shard_index(other->get_hash());
+  LightReMutexHolder holder1((*_states)[std::min(this_shard, other_shard)]._lock);
+  LightReMutexHolder holder2((*_states)[std::max(this_shard, other_shard)]._lock);
 
-  // Is this composition already cached?
   int index = _composition_cache.find(other);
   if (index != -1) {
     Composition &comp = ((RenderState *)this)->_composition_cache.modify_data(index);
@@ -368,7 +388,6 @@ compose(const RenderState *other) const {
       // Well, it wasn't cached already, but we already had an entry (probably
       // created for the reverse direction), so use the same entry to store
       // the new result.
-      CPT(RenderState) result = do_compose(other);
       comp._result = result;
 
       if (result != (const RenderState *)this) {
@@ -377,7 +396,8 @@ compose(const RenderState *other) const {
         result->cache_ref();
       }
     }
-    // Here's the cache!
+    // Here's the cache!  If another thread computed the result in the
+    // meantime, we return that one instead of ours.
     _cache_stats.inc_hits();
     return comp._result;
   }
@@ -389,7 +409,6 @@ compose(const RenderState *other) const {
 
   // The cache entry in this object is the only one that indicates the result;
   // the other will be NULL for now.
-  CPT(RenderState) result = do_compose(other);
 
   _cache_stats.add_total_size(1);
   _cache_stats.inc_adds(_composition_cache.is_empty());
@@ -447,9 +466,32 @@ invert_compose(const RenderState *other) const {
     return do_invert_compose(other);
   }
 
-  LightReMutexHolder holder(*_states_lock);
+  {
+    LightReMutexHolder holder(get_cache_lock());
+
+    // Is this composition already cached?
+    int index = _invert_composition_cache.find(other);
+    if (index != -1) {
+      const Composition &comp = _invert_composition_cache.get_data(index);
+      if (comp._result != nullptr) {
+        // Here's the cache!
+        _cache_stats.inc_hits();
+        return comp._result;
+      }
+    }
+  }
+
+  // Not in the cache.  Compute a new result without holding the lock, since
+  // this may need to create new RenderStates and RenderAttribs.
+  CPT(RenderState) result = do_invert_compose(other);
+
+  // Now we need the locks of both states, since we add an entry to each.
+  // They must be acquired in order.
+  size_t this_shard = States::get_shard_index(get_hash());
+  size_t other_shard = States::get_shard_index(other->get_hash());
+  LightReMutexHolder holder1((*_states)[std::min(this_shard, other_shard)]._lock);
+  LightReMutexHolder holder2((*_states)[std::max(this_shard, other_shard)]._lock);
 
-  // Is this composition already cached?
   int index = _invert_composition_cache.find(other);
   if (index != -1) {
     Composition &comp = ((RenderState *)this)->_invert_composition_cache.modify_data(index);
@@ -457,7 +499,6 @@ invert_compose(const RenderState *other) const {
       // Well, it wasn't cached already, but we already had an entry (probably
       // created for the reverse direction), so use the same entry to store
       // the new result.
-      CPT(RenderState) result = do_invert_compose(other);
       comp._result = result;
 
       if (result != (const RenderState *)this) {
@@ -466,7 +507,8 @@ invert_compose(const RenderState *other) const {
         result->cache_ref();
       }
     }
-    // Here's the cache!
+    // Here's the cache!  If another thread computed the result in the
+    // meantime, we return that one instead of ours.
     _cache_stats.inc_hits();
     return comp._result;
   }
@@ -478,7 +520,6 @@ invert_compose(const RenderState *other) const {
 
   // The cache entry in this object is the only one that indicates the result;
   // the other will be NULL for now.
-  CPT(RenderState) result = do_invert_compose(other);
 
   _cache_stats.add_total_size(1);
   _cache_stats.inc_adds(_invert_composition_cache.is_empty());
@@ -619,11 +660,23 @@ unref() const {
   // garbage collection in effect.  In this case we will pull the object out
   // of the cache when its reference count goes to 0.
 
-  // We always have to grab the lock, since we will definitely need to be
-  // holding it if we happen to drop the reference count to 0. Having to grab
-  // the lock at every call to unref() is a big limiting factor on
-  // parallelization.
+  // As long as this doesn't leave only references in the cache, no other
+  // state is affected, and we only need the lock of our own shard, which
+  // keeps out anyone removing cache entries.  The reference count is read
+  // before the cache reference count, which cache_ref() increments first, so
+  // this can't be fooled by a concurrent compose().
+  {
+    LightReMutexHolder holder(get_cache_lock());
+    int ref_count = get_ref_count();
+    if (ref_count > get_cache_ref_count() + 1) {
+      return ReferenceCount::unref();
+    }
+  }
+
+  // Otherwise, we have to grab all of the locks, since we will definitely
+  // need to be holding them if we happen to drop the reference count to 0.
   LightReMutexHolder holder(*_states_lock);
+  States::Holder shards_holder(*_states);
 
   if (auto_break_cycles && uniquify_states) {
     if (get_cache_ref_count() > 0 &&
@@ -716,8 +769,8 @@ get_max_priority() {
  */
 int RenderState::
 get_num_states() {
-  LightReMutexHolder holder(*_states_lock);
-  return _states.get_num_entries();
+  States::Holder shards_holder(*_states);
+  return _states->get_num_entries();
 }
 
 /**
@@ -736,39 +789,43 @@ get_num_states() {
 int RenderState::
 get_num_unused_states() {
   LightReMutexHolder holder(*_states_lock);
+  States::Holder shards_holder(*_states);
 
   // First, we need to count the number of times each RenderState object is
   // recorded in the cache.
   typedef pmap<const RenderState *, int> StateCount;
   StateCount state_count;
 
-  size_t size = _states.get_num_entries();
-  for (size_t si = 0; si < size; ++si) {
-    const RenderState *state = _states.get_key(si);
-
-    size_t i;
-    size_t cache_size = state->_composition_cache.get_num_entries();
-    for (i = 0; i < cache_size; ++i) {
-      const RenderState *result = state->_composition_cache.get_data(i)._result;
-      if (result != nullptr && result != state) {
-        // Here's a RenderState that's recorded in the cache.  Count it.
-        std::pair<StateCount::iterator, bool> ir =
-          state_count.insert(StateCount::value_type(result, 1));
-        if (!ir.second) {
-          // If the above insert operation fails, then it's already in the
-          // cache; increment its value.
-          (*(ir.first)).second++;
+  for (size_t n = 0; n < States::num_shards; ++n) {
+    const StateTable &states = (*_states)[n]._table;
+    size_t size = states.get_num_entries();
+    for (size_t si = 0; si < size; ++si) {
+      const RenderState *state = states.get_key(si);
+
+      size_t i;
+      size_t cache_size = state->_composition_cache.get_num_entries();
+      for (i = 0; i < cache_size; ++i) {
+        const RenderState *result = state->_composition_cache.get_data(i)._result;
+        if (result != nullptr && result != state) {
+          // Here's a RenderState that's recorded in the cache.  Count it.
+          std::pair<StateCount::iterator, bool> ir =
+            state_count.insert(StateCount::value_type(result, 1));
+          if (!ir.second) {
+            // If the above insert operation fails, then it's already in the
+            // cache; increment its value.
+            (*(ir.first)).second++;
+          }
         }
       }
-    }
-    cache_size = state->_invert_composition_cache.get_num_entries();
-    for (i = 0; i < cache_size; ++i) {
-      const RenderState *result = state->_invert_composition_cache.get_data(i)._result;
-      if (result != nullptr && result != state) {
-        std::pair<StateCount::iterator, bool> ir =
-          state_count.insert(StateCount::value_type(result, 1));
-        if (!ir.second) {
-          (*(ir.first)).second++;
+      cache_size = state->_invert_composition_cache.get_num_entries();
+      for (i = 0; i < cache_size; ++i) {
+        const RenderState *result = state->_invert_composition_cache.get_data(i)._result;
+        if (result != nullptr && result != state) {
+          std::pair<StateCount::iterator, bool> ir =
+            state_count.insert(StateCount::value_type(result, 1));
+          if (!ir.second) {
+            (*(ir.first)).second++;
+          }
         }
       }
     }
@@ -816,9 +873,10 @@ get_num_unused_states() {
 int RenderState::
 clear_cache() {
   LightReMutexHolder holder(*_states_lock);
+  States::Holder shards_holder(*_states);
 
   PStatTimer timer(_cache_update_pcollector);
-  int orig_size = _states.get_num_entries();
+  int orig_size = _states->get_num_entries();
 
   // First, we need to copy the entire set of states to a temporary vector,
   // reference-counting each object.  That way we can walk through the copy,
@@ -829,10 +887,13 @@ clear_cache() {
     TempStates temp_states;
     temp_states.reserve(orig_size);
 
-    size_t size = _states.get_num_entries();
-    for (size_t si = 0; si < size; ++si) {
-      const RenderState *state = _states.get_key(si);
-      temp_states.push_back(state);
+    for (size_t n = 0; n < States::num_shards; ++n) {
+      const StateTable &states = (*_states)[n]._table;
+      size_t size = states.get_num_entries();
+      for (size_t si = 0; si < size; ++si) {
+        const RenderState *state = states.get_key(si);
+        temp_states.push_back(state);
+      }
     }
 
     // Now it's safe to walk through the list, destroying the cache within
@@ -870,7 +931,7 @@ clear_cache() {
     // the various objects' caches will go away.
   }
 
-  int new_size = _states.get_num_entries();
+  int new_size = _states->get_num_entries();
   return orig_size - new_size;
 }
 
@@ -891,78 +952,84 @@ garbage_collect() {
   }
 
   LightReMutexHolder holder(*_states_lock);
+  States::Holder shards_holder(*_states);
 
   PStatTimer timer(_garbage_collect_pcollector);
-  size_t orig_size = _states.get_num_entries();
-
-  // How many elements to process this pass?
-  size_t size = orig_size;
-  size_t num_this_pass = std::max(0, int(size * garbage_collect_states_rate));
-  if (num_this_pass <= 0) {
-    return num_attribs;
-  }
 
   bool break_and_uniquify = (auto_break_cycles && uniquify_transforms);
 
-  size_t si = _garbage_index;
-  if (si >= size) {
-    si = 0;
-  }
+  int num_freed = 0;
+  for (size_t n = 0; n < States::num_shards; ++n) {
+    States::Shard &shard = (*_states)[n];
+    StateTable &states = shard._table;
+    size_t orig_size = states.get_num_entries();
+
+    // How many elements to process this pass?
+    size_t size = orig_size;
+    size_t num_this_pass = std::max(0, int(size * garbage_collect_states_rate));
+    if (num_this_pass <= 0) {
+      continue;
+    }
 
-  num_this_pass = std::min(num_this_pass, size);
-  size_t stop_at_element = (si + num_this_pass) % size;
+    size_t si = shard._garbage_index;
+    num_this_pass = std::min(num_this_pass, size);
 
-  do {
-    RenderState *state = (RenderState *)_states.get_key(si);
-    if (break_and_uniquify) {
-      if (state->get_cache_ref_count() > 0 &&
-          state->get_ref_count() == state->get_cache_ref_count()) {
-        // If we have removed all the references to this state not in the
-        // cache, leaving only references in the cache, then we need to
-        // check for a cycle involving this RenderState and break it if it
-        // exists.
-        state->detect_and_break_cycles();
+    while (num_this_pass > 0 && size > 0) {
+      --num_this_pass;
+      if (si >= size) {
+        si = 0;
       }
-    }
 
-    if (!state->unref_if_one()) {
-      // This state has recently been unreffed to 1 (the one we added when
-      // we stored it in the cache).  Now it's time to delete it.  This is
-      // safe, because we're holding the _states_lock, so it's not possible
-      // for some other thread to find the state in the cache and ref it
-      // while we're doing this.  Also, we've just made sure to unref it to 0,
-      // to ensure that another thread can't get it via a weak pointer.
-
-      state->release_new();
-      state->remove_cache_pointers();
-      state->cache_unref_only();
-      delete state;
-
-      // When we removed it from the hash map, it swapped the last element
-      // with the one we just removed.  So the current index contains one we
-      // still need to visit.
-      --size;
-      --si;
-      if (stop_at_element > 0) {
-        --stop_at_element;
+      RenderState *state = (RenderState *)states.get_key(si);
+      if (break_and_uniquify) {
+        if (state->get_cache_ref_count() > 0 &&
+            state->get_ref_count() == state->get_cache_ref_count()) {
+          // If we have removed all the references to this state not in the
+          // cache, leaving only references in the cache, then we need to
+          // check for a cycle involving this RenderState and break it if it
+          // exists.
+          state->detect_and_break_cycles();
+        }
       }
-    }
 
-    si = (si + 1) % size;
-  } while (si != stop_at_element);
-  _garbage_index = si;
+      if (!state->unref_if_one()) {
+        // This state has recently been unreffed to 1 (the one we added when
+        // we stored it in the cache).  Now it's time to delete it.  This is
+        // safe, because we're holding all of the shard locks, so it's not
+        // possible for some other thread to find the state in the cache and
+        // ref it while we're doing this.  Also, we've just made sure to unref
+        // it to 0, to ensure that another thread can't get it via a weak
+        // pointer.
+
+        state->release_new();
+        state->remove_cache_pointers();
+        state->cache_unref_only();
+        delete state;
+
+        // When we removed it from the hash map, it swapped the last element
+        // with the one we just removed.  So the current index contains one
+        // we still need to visit.
+        --size;
+      } else {
+        ++si;
+      }
+    }
+    shard._garbage_index = si;
 
-  nassertr(_states.get_num_entries() == size, 0);
+    nassertr(states.get_num_entries() == size, 0);
 
 #ifdef _DEBUG
-  nassertr(_states.validate(), 0);
+    nassertr(states.validate(), 0);
 #endif
 
-  // If we just cleaned up a lot of states, see if we can reduce the table in
-  // size.  This will help reduce iteration overhead in the future.
-  _states.consider_shrink_table();
+    // If we just cleaned up a lot of states, see if we can reduce the table
+    // in size.  This will help reduce iteration overhead in the future.
+    states.consider_shrink_table();
+
+    num_freed += (int)orig_size - (int)size;
+  }
 
-  return (int)orig_size - (int)size + num_attribs;
+  return num_freed + num_attribs;
 }
 
 /**
@@ -972,13 +1039,17 @@ garbage_collect() {
 void RenderState::
 clear_munger_cache() {
   LightReMutexHolder holder(*_states_lock);
+  States::Holder shards_holder(*_states);
 
-  size_t size = _states.get_num_entries();
-  for (size_t si = 0; si < size; ++si) {
-    RenderState *state = (RenderState *)(_states.get_key(si));
-    state->_mungers.clear();
-    state->_munged_states.clear();
-    state->_last_mi = -1;
+  for (size_t n = 0; n < States::num_shards; ++n) {
+    const StateTable &states = (*_states)[n]._table;
+    size_t size = states.get_num_entries();
+    for (size_t si = 0; si < size; ++si) {
+      RenderState *state = (RenderState *)(states.get_key(si));
+      state->_mungers.clear();
+      state->_munged_states.clear();
+      state->_last_mi = -1;
+    }
   }
 }
 
@@ -998,65 +1069,69 @@ clear_munger_cache() {
 void RenderState::
 list_cycles(ostream &out) {
   LightReMutexHolder holder(*_states_lock);
+  States::Holder shards_holder(*_states);
 
   typedef pset<const RenderState *> VisitedStates;
   VisitedStates visited;
   CompositionCycleDesc cycle_desc;
 
-  size_t size = _states.get_num_entries();
-  for (size_t si = 0; si < size; ++si) {
-    const RenderState *state = _states.get_key(si);
-
-    bool inserted = visited.insert(state).second;
-    if (inserted) {
-      ++_last_cycle_detect;
-      if (r_detect_cycles(state, state, 1, _last_cycle_detect, &cycle_desc)) {
-        // This state begins a cycle.
-        CompositionCycleDesc::reverse_iterator csi;
-
-        out << "\nCycle detected of length " << cycle_desc.size() + 1 << ":\n"
-            << "state " << (void *)state << ":" << state->get_ref_count()
-            << " =\n";
-        state->write(out, 2);
-        for (csi = cycle_desc.rbegin(); csi != cycle_desc.rend(); ++csi) {
-          const CompositionCycleDescEntry &entry = (*csi);
-          if (entry._inverted) {
-            out << "invert composed with ";
-          } else {
-            out << "composed with ";
-          }
-          out << (const void *)entry._obj << ":" << entry._obj->get_ref_count()
-              << " " << *entry._obj << "\n"
-              << "produces " << (const void *)entry._result << ":"
-              << entry._result->get_ref_count() << " =\n";
-          entry._result->write(out, 2);
-          visited.insert(entry._result);
-        }
+  for (size_t n = 0; n < States::num_shards; ++n) {
+    const StateTable &states = (*_states)[n]._table;
+    size_t size = states.get_num_entries();
+    for (size_t si = 0; si < size; ++si) {
+      const RenderState *state = states.get_key(si);
 
-        cycle_desc.clear();
-      } else {
+      bool inserted = visited.insert(state).second;
+      if (inserted) {
         ++_last_cycle_detect;
-        if (r_detect_reverse_cycles(state, state, 1, _last_cycle_detect, &cycle_desc)) {
+        if (r_detect_cycles(state, state, 1, _last_cycle_detect, &cycle_desc)) {
           // This state begins a cycle.
-          CompositionCycleDesc::iterator csi;
+          CompositionCycleDesc::reverse_iterator csi;
 
-          out << "\nReverse cycle detected of length " << cycle_desc.size() + 1 << ":\n"
-              << "state ";
-          for (csi = cycle_desc.begin(); csi != cycle_desc.end(); ++csi) {
+          out << "\nCycle detected of length " << cycle_desc.size() + 1 << ":\n"
+              << "state " << (void *)state << ":" << state->get_ref_count()
+              << " =\n";
+          state->write(out, 2);
+          for (csi = cycle_desc.rbegin(); csi != cycle_desc.rend(); ++csi) {
             const CompositionCycleDescEntry &entry = (*csi);
-            out << (const void *)entry._result << ":"
+            if (entry._inverted) {
+              out << "invert composed with ";
+            } else {
+              out << "composed with ";
+            }
+            out << (const void *)entry._obj << ":" << entry._obj->get_ref_count()
+                << " " << *entry._obj << "\n"
+                << "produces " << (const void *)entry._result << ":"
                 << entry._result->get_ref_count() << " =\n";
             entry._result->write(out, 2);
-            out << (const void *)entry._obj << ":"
-                << entry._obj->get_ref_count() << " =\n";
-            entry._obj->write(out, 2);
             visited.insert(entry._result);
           }
-          out << (void *)state << ":"
-              << state->get_ref_count() << " =\n";
-          state->write(out, 2);
 
           cycle_desc.clear();
+        } else {
+          ++_last_cycle_detect;
+          if (r_detect_reverse_cycles(state, state, 1, _last_cycle_detect, &cycle_desc)) {
+            // This state begins a cycle.
+            CompositionCycleDesc::iterator csi;
+
+            out << "\nReverse cycle detected of length " << cycle_desc.size() + 1 << ":\n"
+                << "state ";
+            for (csi = cycle_desc.begin(); csi != cycle_desc.end(); ++csi) {
+              const CompositionCycleDescEntry &entry = (*csi);
+              out << (const void *)entry._result << ":"
+                  << entry._result->get_ref_count() << " =\n";
+              entry._result->write(out, 2);
+              out << (const void *)entry._obj << ":"
+                  << entry._obj->get_ref_count() << " =\n";
+              entry._obj->write(out, 2);
+              visited.insert(entry._result);
+            }
+            out << (void *)state << ":"
+                << state->get_ref_count() << " =\n";
+            state->write(out, 2);
+
+            cycle_desc.clear();
+          }
         }
       }
     }
@@ -1072,12 +1147,16 @@ list_cycles(ostream &out) {
 void RenderState::
 list_states(ostream &out) {
   LightReMutexHolder holder(*_states_lock);
+  States::Holder shards_holder(*_states);
 
-  size_t size = _states.get_num_entries();
-  out << size << " states:\n";
-  for (size_t si = 0; si < size; ++si) {
-    const RenderState *state = _states.get_key(si);
-    state->write(out, 2);
+  out << _states->get_num_entries() << " states:\n";
+  for (size_t n = 0; n < States::num_shards; ++n) {
+    const StateTable &states = (*_states)[n]._table;
+    size_t size = states.get_num_entries();
+    for (size_t si = 0; si < size; ++si) {
+      const RenderState *state = states.get_key(si);
+      state->write(out, 2);
+    }
   }
 }
 
@@ -1092,43 +1171,48 @@ validate_states() {
   PStatTimer timer(_state_validate_pcollector);
 
   LightReMutexHolder holder(*_states_lock);
-  if (_states.is_empty()) {
-    return true;
-  }
+  States::Holder shards_holder(*_states);
 
-  if (!_states.validate()) {
-    pgraph_cat.error()
-      << "RenderState::_states cache is invalid!\n";
-    return false;
-  }
-
-  size_t size = _states.get_num_entries();
-  size_t si = 0;
-  nassertr(si < size, false);
-  nassertr(_states.get_key(si)->get_ref_count() >= 0, false);
-  size_t snext = si;
-  ++snext;
-  while (snext < size) {
-    nassertr(_states.get_key(snext)->get_ref_count() >= 0, false);
-    const RenderState *ssi = _states.get_key(si);
-    const RenderState *ssnext = _states.get_key(snext);
-    int c = ssi->compare_to(*ssnext);
-    int ci = ssnext->compare_to(*ssi);
-    if ((ci < 0) != (c > 0) ||
-        (ci > 0) != (c < 0) ||
-        (ci == 0) != (c == 0)) {
+  for (size_t n = 0; n < States::num_shards; ++n) {
+    const StateTable &states = (*_states)[n]._table;
+    if (states.is_empty()) {
+      continue;
+    }
+
+    if (!states.validate()) {
       pgraph_cat.error()
-        << "RenderState::compare_to() not defined properly!\n";
-      pgraph_cat.error(false)
-        << "(a, b): " << c << "\n";
-      pgraph_cat.error(false)
-        << "(b, a): " << ci << "\n";
-      ssi->write(pgraph_cat.error(false), 2);
-      ssnext->write(pgraph_cat.error(false), 2);
+        << "RenderState::_states cache is invalid!\n";
       return false;
     }
-    si = snext;
+
+    size_t size = states.get_num_entries();
+    size_t si = 0;
+    nassertr(si < size, false);
+    nassertr(states.get_key(si)->get_ref_count() >= 0, false);
+    size_t snext = si;
     ++snext;
+    while (snext < size) {
+      nassertr(states.get_key(snext)->get_ref_count() >= 0, false);
+      const RenderState *ssi = states.get_key(si);
+      const RenderState *ssnext = states.get_key(snext);
+      int c = ssi->compare_to(*ssnext);
+      int ci = ssnext->compare_to(*ssi);
+      if ((ci < 0) != (c > 0) ||
+          (ci > 0) != (c < 0) ||
+          (ci == 0) != (c == 0)) {
+        pgraph_cat.error()
+          << "RenderState::compare_to() not defined properly!\n";
+        pgraph_cat.error(false)
+          << "(a, b): " << c << "\n";
+        pgraph_cat.error(false)
+          << "(b, a): " << ci << "\n";
+        ssi->write(pgraph_cat.error(false), 2);
+        ssnext->write(pgraph_cat.error(false), 2);
+        return false;
+      }
+      si = snext;
+      ++snext;
+    }
   }
 
   return true;
@@ -1278,17 +1362,11 @@ return_unique(RenderState *state) {
   }
 #endif
 
-  LightReMutexHolder holder(*_states_lock);
-
-  if (state->_saved_entry != -1) {
-    // This state is already in the cache.  nassertr(_states.find(state) ==
-    // state->_saved_entry, pt_state);
-    return state;
-  }
-
   // Ensure each of the individual attrib pointers has been uniquified before
-  // we add the state to the cache.
-  if (!uniquify_attribs && !state->is_empty()) {
+  // we add the state to the cache.  This is done before we take the lock,
+  // since get_unique() needs the RenderAttrib locks.  If the state is already
+  // in the cache, its attribs are already unique, so this changes nothing.
+  if (!uniquify_attribs && !state->is_empty() && state->_saved_entry == -1) {
     SlotMask mask = state->_filled_slots;
     int slot = mask.get_lowest_on_bit();
     while (slot >= 0) {
@@ -1300,29 +1378,46 @@ return_unique(RenderState *state) {
     }
   }
 
-  int si = _states.find(state);
-  if (si != -1) {
-    // There's an equivalent state already in the set.  Return it.  The state
-    // that was passed may be newly created and therefore may not be
-    // automatically deleted.  Do that if necessary.
-    if (state->get_ref_count() == 0) {
-      delete state;
+  CPT(RenderState) result;
+  {
+    // Only the shard that this state hashes to needs to be locked.
+    States::Shard &shard = (*_states)[States::get_shard_index(state->get_hash())];
+    LightReMutexHolder holder(shard._lock);
+
+    if (state->_saved_entry != -1) {
+      // This state is already in the cache.  nassertr(_states.find(state) ==
+      // state->_saved_entry, pt_state);
+      return state;
+    }
+
+    int si = shard._table.find(state);
+    if (si == -1) {
+      // Not already in the set; add it.
+      if (garbage_collect_states) {
+        // If we'll be garbage collecting states explicitly, we'll increment
+        // the reference count when we store it in the cache, so that it
+        // won't be deleted while it's in it.
+        state->cache_ref();
+      }
+      si = shard._table.store(state, nullptr);
+
+      // Save the index and return the input state.
+      state->_saved_entry = si;
+      return state;
     }
-    return _states.get_key(si);
-  }
 
-  // Not already in the set; add it.
-  if (garbage_collect_states) {
-    // If we'll be garbage collecting states explicitly, we'll increment the
-    // reference count when we store it in the cache, so that it won't be
-    // deleted while it's in it.
-    state->cache_ref();
+    // There's an equivalent state already in the set.  Return it.
+    result = shard._table.get_key(si);
   }
-  si = _states.store(state, nullptr);
 
-  // Save the index and return the input state.
-  state->_saved_entry = si;
-  return state;
+  // The state that was passed may be newly created and therefore may not be
+  // automatically deleted.  Do that if necessary.  This is done after the
+  // lock is released, since the destructor releases the attribs, which takes
+  // the RenderAttrib locks.
+  if (state->get_ref_count() == 0) {
+    delete state;
+  }
+  return result;
 }
 
 /**
@@ -1586,15 +1681,16 @@ r_detect_reverse_cycles(const RenderState *start_state,
  * This inverse of return_new, this releases this object from the global
  * RenderState table.
  *
- * You must already be holding _states_lock before you call this method.
+ * You must already be holding the lock of the shard it is stored in before
+ * you call this method.
  */
 void RenderState::
 release_new() {
-  nassertv(_states_lock->debug_is_locked());
+  nassertv(get_cache_lock().debug_is_locked());
 
   if (_saved_entry != -1) {
     _saved_entry = -1;
-    nassertv_always(_states.remove(this));
+    nassertv_always((*_states)[States::get_shard_index(get_hash())]._table.remove(this));
   }
 }
 
@@ -1603,7 +1699,8 @@ release_new() {
  * RenderState.  The pointers to this object may be scattered around in the
  * various CompositionCaches from other RenderState objects.
  *
- * You must already be holding _states_lock before you call this method.
+ * You must already be holding _states_lock and all of the shard locks before
+ * you call this method.
  */
 void RenderState::
 remove_cache_pointers() {
@@ -1836,6 +1933,9 @@ init_states() {
   // OK because we guarantee that this method is called at static init time,
   // presumably when there is still only one thread in the world.
   _states_lock = new LightReMutex("RenderState::_states_lock");
+  if (_states == nullptr) {
+    _states = new States;
+  }
   _cache_stats.init();
   nassertv(Thread::get_current_thread() == Thread::get_main_thread());
 
@@ -1843,7 +1943,8 @@ init_states() {
   // is declared globally, and lives forever.
   RenderState *state = new RenderState;
   state->local_object();
-  state->_saved_entry = _states.store(state, nullptr);
+  States::Shard &shard = (*_states)[States::get_shard_index(state->get_hash())];
+  state->_saved_entry = shard._table.store(state, nullptr);
   _empty_state = state;
 }
 
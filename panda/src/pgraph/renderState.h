@@ -31,6 +31,7 @@
 #include "deletedChain.h"
 #include "simpleHashMap.h"
 #include "cacheStats.h"
+#include "stateShards.h"
 #include "renderAttribRegistry.h"
 
 class FactoryParams;
@@ -211,6 +212,8 @@ private:
   void release_new();
   void remove_cache_pointers();
 
+  INLINE LightReMutex &get_cache_lock() const;
+
   void determine_bin_index();
   void determine_cull_callback();
   void fill_default();
@@ -232,12 +235,19 @@ public:
   mutable UpdateSeq _generated_shader_seq;
 
 private:
-  // This mutex protects _states.  It also protects any modification to the
-  // cache, which is encoded in _composition_cache and
-  // _invert_composition_cache.
+  // The unique states are stored in _states, which is split into shards by
+  // hash.  The lock of each shard protects its table, and also the
+  // _composition_cache and _invert_composition_cache of the states that hash
+  // to it.  Adding a composition to the cache locks the shards of both
+  // states involved.
+  typedef SimpleHashMap<const RenderState *, std::nullptr_t, indirect_compare_to_hash<const RenderState *> > StateTable;
+  typedef StateShards<StateTable> States;
+  static States *_states;
+
+  // This mutex is held, along with all of the shard locks, by operations
+  // that may remove states or cache entries, or that walk through all of the
+  // states, such as garbage_collect().
   static LightReMutex *_states_lock;
-  typedef SimpleHashMap<const RenderState *, std::nullptr_t, indirect_compare_to_hash<const RenderState *> > States;
-  static States _states;
   static const RenderState *_empty_state;
 
   // This iterator records the entry corresponding to this RenderState object
@@ -286,10 +296,6 @@ private:
   UpdateSeq _cycle_detect;
   static UpdateSeq _last_cycle_detect;
 
-  // This keeps track of our current position through the garbage collection
-  // cycle.
-  static size_t _garbage_index;
-
   static PStatCollector _cache_update_pcollector;
   static PStatCollector _garbage_collect_pcollector;
   static PStatCollector _state_compose_pcollector;
@@ -29,7 +29,7 @@
 PyObject *Extension<RenderState>::
 get_composition_cache() const {
   extern struct Dtool_PyTypedObject Dtool_RenderState;
-  LightReMutexHolder holder(*RenderState::_states_lock);
+  LightReMutexHolder holder(_this->get_cache_lock());
   size_t cache_size = _this->_composition_cache.get_num_entries();
   PyObject *list = PyList_New(cache_size);
 
@@ -77,7 +77,7 @@ get_composition_cache() const {
 PyObject *Extension<RenderState>::
 get_invert_composition_cache() const {
   extern struct Dtool_PyTypedObject Dtool_RenderState;
-  LightReMutexHolder holder(*RenderState::_states_lock);
+  LightReMutexHolder holder(_this->get_cache_lock());
   size_t cache_size = _this->_invert_composition_cache.get_num_entries();
   PyObject *list = PyList_New(cache_size);
 
@@ -119,21 +119,25 @@ PyObject *Extension<RenderState>::
 get_states() {
   extern struct Dtool_PyTypedObject Dtool_RenderState;
   LightReMutexHolder holder(*RenderState::_states_lock);
+  RenderState::States::Holder shards_holder(*RenderState::_states);
 
-  size_t num_states = RenderState::_states.get_num_entries();
+  size_t num_states = RenderState::_states->get_num_entries();
   PyObject *list = PyList_New(num_states);
   size_t i = 0;
 
-  size_t size = RenderState::_states.get_num_entries();
-  for (size_t si = 0; si < size; ++si) {
-    const RenderState *state = RenderState::_states.get_key(si);
-    state->ref();
-    PyObject *a =
-      DTool_CreatePyInstanceTyped((void *)state, Dtool_RenderState,
-                                  true, true, state->get_type_index());
-    nassertr(i < num_states, list);
-    PyList_SET_ITEM(list, i, a);
-    ++i;
+  for (size_t n = 0; n < RenderState::States::num_shards; ++n) {
+    const RenderState::StateTable &states = (*RenderState::_states)[n]._table;
+    size_t size = states.get_num_entries();
+    for (size_t si = 0; si < size; ++si) {
+      const RenderState *state = states.get_key(si);
+      state->ref();
+      PyObject *a =
+        DTool_CreatePyInstanceTyped((void *)state, Dtool_RenderState,
+                                    true, true, state->get_type_index());
+      nassertr(i < num_states, list);
+      PyList_SET_ITEM(list, i, a);
+      ++i;
+    }
   }
   nassertr(i == num_states, list);
   return list;
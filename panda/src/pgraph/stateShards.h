@@ -0,0 +1,78 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file stateShards.h
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#ifndef STATESHARDS_H
+#define STATESHARDS_H
+
+#include "pandabase.h"
+#include "lightReMutex.h"
+
+/**
+ * This is the global table of unique objects kept by TransformState,
+ * RenderState and RenderAttrib, split by hash into a number of shards, each
+ * with its own lock.  Threads that create unrelated states therefore rarely
+ * contend for the same lock.  The Table is a SimpleHashMap keyed by a pointer
+ * to the object, hashed on its get_hash().
+ *
+ * Operations that must see the whole table at once hold all of the locks;
+ * these must always be acquired in index order, as Holder does.  Code that
+ * holds one shard lock must not wait for any other lock, except another shard
+ * lock with a higher index.
+ */
+template<class Table>
+class StateShards {
+public:
+  enum { shard_bits = 6, num_shards = 1 << shard_bits };
+
+  class Shard {
+  public:
+    INLINE Shard();
+
+    LightReMutex _lock;
+    Table _table;
+
+    // This keeps track of our current position through the garbage
+    // collection cycle.
+    size_t _garbage_index;
+  };
+
+  INLINE static size_t get_shard_index(size_t hash);
+  INLINE Shard &operator [] (size_t n);
+  INLINE const Shard &operator [] (size_t n) const;
+
+  INLINE size_t get_num_entries() const;
+
+  INLINE void acquire_all() const;
+  INLINE void release_all() const;
+
+  /**
+   * Holds all of the shard locks for its lifetime.
+   */
+  class Holder {
+  public:
+    INLINE explicit Holder(const StateShards &shards);
+    INLINE ~Holder();
+    Holder(const Holder &copy) = delete;
+    Holder &operator = (const Holder &copy) = delete;
+
+  private:
+    const StateShards &_shards;
+  };
+
+private:
+  Shard _shards[num_shards];
+};
+
+#include "stateShards.I"
+
+#endif
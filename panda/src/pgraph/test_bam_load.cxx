@@ -0,0 +1,168 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_bam_load.cxx
+ * @author agent
+ * @date 2026-10-16
+ */
+
+/**
+ * A benchmark of loading a large bam file, with and without
+ * bam-parallel-decode.  It writes a synthetic scene of many GeomNodes with
+ * large vertex and index arrays, and a few textures with raw image data, then
+ * reads it back several times with each setting.
+ *
+ * Usage: test_bam_load [megabytes [filename [repeats]]]
+ */
+
+#include "pandabase.h"
+#include "bamFile.h"
+#include "geomNode.h"
+#include "geom.h"
+#include "geomTriangles.h"
+#include "geomVertexWriter.h"
+#include "texture.h"
+#include "textureAttrib.h"
+#include "renderState.h"
+#include "trueClock.h"
+#include "config_putil.h"
+#include "virtualFileSystem.h"
+
+using std::cerr;
+
+/**
+ * Returns a GeomNode with a single Geom of the indicated number of vertices.
+ */
+static PT(GeomNode)
+make_geom_node(int index, int num_rows) {
+  PT(GeomVertexData) data = new GeomVertexData
+    ("synthetic", GeomVertexFormat::get_v3n3t2(), Geom::UH_static);
+  data->unclean_set_num_rows(num_rows);
+  {
+    GeomVertexWriter vertex(data, "vertex");
+    GeomVertexWriter normal(data, "normal");
+    GeomVertexWriter texcoord(data, "texcoord");
+    for (int i = 0; i < num_rows; ++i) {
+      vertex.set_data3f(i, index, i * 0.5f);
+      normal.set_data3f(0, 0, 1);
+      texcoord.set_data2f(i * 0.01f, index * 0.01f);
+    }
+  }
+
+  PT(GeomTriangles) tris = new GeomTriangles(Geom::UH_static);
+  tris->set_index_type(Geom::NT_uint32);
+  // Wind the triangles backwards, so that they are stored as indexed.
+  for (int i = 0; i + 2 < num_rows; i += 3) {
+    tris->add_vertices(i, i + 2, i + 1);
+  }
+
+  PT(Geom) geom = new Geom(data);
+  geom->add_primitive(tris);
+
+  std::ostringstream strm;
+  strm << "node" << index;
+  PT(GeomNode) node = new GeomNode(strm.str());
+  node->add_geom(geom);
+  return node;
+}
+
+/**
+ * Returns a texture with a raw image of the indicated size, which will be
+ * written into the bam file.
+ */
+static PT(Texture)
+make_texture(int index, int size) {
+  std::ostringstream strm;
+  strm << "tex" << index;
+  PT(Texture) tex = new Texture(strm.str());
+  tex->setup_2d_texture(size, size, Texture::T_unsigned_byte, Texture::F_rgba8);
+  PTA_uchar image = tex->modify_ram_image();
+  for (size_t i = 0; i < image.size(); ++i) {
+    image[i] = (unsigned char)(i * 7 + index);
+  }
+  return tex;
+}
+
+/**
+ * Loads the indicated bam file, and returns the number of seconds it took.
+ */
+static double
+load_bam(const Filename &filename) {
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+
+  BamFile bam;
+  if (!bam.open_read(filename)) {
+    cerr << "ERROR: couldn't open " << filename << "\n";
+    exit(1);
+  }
+  PT(PandaNode) root = bam.read_node();
+  if (root == nullptr || !bam.resolve()) {
+    cerr << "ERROR: couldn't read " << filename << "\n";
+    exit(1);
+  }
+  bam.close();
+
+  return clock->get_short_time() - start;
+}
+
+int
+main(int argc, char *argv[]) {
+  int megabytes = (argc > 1) ? atoi(argv[1]) : 300;
+  Filename filename = (argc > 2) ? Filename::from_os_specific(argv[2])
+                                 : Filename::temporary("", "bam_load_", ".bam");
+  int repeats = (argc > 3) ? atoi(argv[3]) : 3;
+
+  // Each node holds 64K vertices of 32 bytes each, plus 256 KB of indices.
+  static const int num_rows = 65536;
+  int num_nodes = std::max(megabytes * 1024 / 2304, 1);
+  int num_textures = std::max(num_nodes / 16, 1);
+
+  cerr << "Writing " << num_nodes << " nodes and " << num_textures
+       << " textures to " << filename << "\n";
+  {
+    PT(PandaNode) root = new PandaNode("root");
+    for (int ti = 0; ti < num_textures; ++ti) {
+      CPT(RenderState) state =
+        RenderState::make(TextureAttrib::make(make_texture(ti, 512)));
+      for (int ni = ti; ni < num_nodes; ni += num_textures) {
+        PT(GeomNode) node = make_geom_node(ni, num_rows);
+        node->set_state(state);
+        root->add_child(node);
+      }
+    }
+
+    BamFile bam;
+    if (!bam.open_write(filename)) {
+      cerr << "ERROR: couldn't write " << filename << "\n";
+      return 1;
+    }
+    bam.get_writer()->set_file_texture_mode(BamWriter::BTM_rawdata);
+    bam.write_object(root);
+    bam.close();
+  }
+
+  // Load it once to warm up the disk cache.
+  load_bam(filename);
+
+  cerr << "parallel decode   load time (s)\n";
+  for (int parallel = 0; parallel <= 1; ++parallel) {
+    bam_parallel_decode.set_value(parallel != 0);
+    double best = 0.0;
+    for (int i = 0; i < repeats; ++i) {
+      double elapsed = load_bam(filename);
+      best = (i == 0) ? elapsed : std::min(best, elapsed);
+    }
+    fprintf(stderr, "%15s %15.3f\n", parallel ? "on" : "off", best);
+  }
+
+  if (argc <= 2) {
+    VirtualFileSystem::get_global_ptr()->delete_file(filename);
+  }
+  return 0;
+}
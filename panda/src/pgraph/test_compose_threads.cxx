@@ -0,0 +1,172 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_compose_threads.cxx
+ * @author agent
+ * @date 2026-10-17
+ */
+
+/**
+ * A stress test of the TransformState and RenderState caches from several
+ * threads at once.  Each thread composes random pairs from a shared pool of
+ * states, which mostly hits the composition caches, and now and then creates
+ * a new state, which goes through the interning tables.  The first thread
+ * also runs a garbage collection pass now and then, as the GraphicsEngine
+ * does once per frame.  The same work is run with 1, 2, 4, ... threads, and
+ * the total throughput is reported for each.
+ *
+ * Usage: test_compose_threads [max_threads [iterations]]
+ *
+ * The iteration count is per thread.
+ */
+
+#include "pandabase.h"
+
+#include "transformState.h"
+#include "renderState.h"
+#include "colorAttrib.h"
+#include "colorScaleAttrib.h"
+#include "transparencyAttrib.h"
+#include "depthOffsetAttrib.h"
+#include "thread.h"
+#include "trueClock.h"
+
+#include "pvector.h"
+
+typedef pvector< CPT(TransformState) > Transforms;
+typedef pvector< CPT(RenderState) > States;
+
+static const int pool_size = 64;
+
+// One in this many iterations creates a new state.
+static const int new_state_interval = 16;
+
+// The first thread garbage collects the states once in this many iterations.
+static const int garbage_collect_interval = 10000;
+
+static Transforms transform_pool;
+static States state_pool;
+
+/**
+ * A trivial random number generator, so that the threads don't share any
+ * state.
+ */
+static inline uint32_t
+next_random(uint32_t &seed) {
+  seed = seed * 1664525u + 1013904223u;
+  return seed >> 8;
+}
+
+/**
+ * Composes states from the pool for the indicated number of iterations.
+ */
+class ComposeThread : public Thread {
+public:
+  ComposeThread(int index, int iterations) :
+    Thread("compose", "compose"),
+    _index(index),
+    _seed((uint32_t)index * 7919u + 1u),
+    _iterations(iterations) {}
+
+  virtual void thread_main() {
+    for (int i = 0; i < _iterations; ++i) {
+      const TransformState *ta = transform_pool[next_random(_seed) % pool_size];
+      const TransformState *tb = transform_pool[next_random(_seed) % pool_size];
+      const RenderState *sa = state_pool[next_random(_seed) % pool_size];
+      const RenderState *sb = state_pool[next_random(_seed) % pool_size];
+
+      CPT(TransformState) transform = ta->compose(tb);
+      transform = transform->invert_compose(ta);
+      CPT(RenderState) state = sa->compose(sb);
+
+      if ((i % new_state_interval) == 0) {
+        PN_stdfloat x = (PN_stdfloat)(next_random(_seed) % 1000);
+        transform = transform->compose(TransformState::make_pos(LVecBase3(x, 0.0f, 0.0f)));
+
+        PN_stdfloat s = (PN_stdfloat)(next_random(_seed) % 1000) / 1000.0f;
+        state = state->compose(RenderState::make(ColorScaleAttrib::make(LVecBase4(s, s, s, 1.0f))));
+      }
+
+      if (_index == 0 && (i % garbage_collect_interval) == 0) {
+        TransformState::garbage_collect();
+        RenderState::garbage_collect();
+      }
+    }
+  }
+
+private:
+  int _index;
+  uint32_t _seed;
+  int _iterations;
+};
+
+/**
+ * Runs the indicated number of threads to completion, and returns the number
+ * of seconds it took.
+ */
+static double
+run_threads(int num_threads, int iterations) {
+  pvector< PT(ComposeThread) > threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.push_back(new ComposeThread(i, iterations));
+  }
+
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+  for (int i = 0; i < num_threads; ++i) {
+    threads[i]->start(TP_normal, true);
+  }
+  for (int i = 0; i < num_threads; ++i) {
+    threads[i]->join();
+  }
+  return clock->get_short_time() - start;
+}
+
+int
+main(int argc, char *argv[]) {
+  int max_threads = (argc > 1) ? atoi(argv[1]) : 8;
+  int iterations = (argc > 2) ? atoi(argv[2]) : 200000;
+
+  uint32_t seed = 1;
+  for (int i = 0; i < pool_size; ++i) {
+    PN_stdfloat a = (PN_stdfloat)(next_random(seed) % 360);
+    PN_stdfloat x = (PN_stdfloat)(next_random(seed) % 100);
+    transform_pool.push_back(TransformState::make_pos_hpr(LVecBase3(x, -x, 1.0f), LVecBase3(a, 0.0f, 0.0f)));
+
+    PN_stdfloat c = (PN_stdfloat)(i % 8) / 8.0f;
+    CPT(RenderState) state = RenderState::make(ColorAttrib::make_flat(LColor(c, 1.0f - c, 0.5f, 1.0f)));
+    if (i & 8) {
+      state = state->add_attrib(TransparencyAttrib::make(TransparencyAttrib::M_alpha));
+    }
+    if (i & 16) {
+      state = state->add_attrib(DepthOffsetAttrib::make(i / 16));
+    }
+    state_pool.push_back(state);
+  }
+
+  // Warm up the caches once from the main thread.
+  run_threads(1, iterations);
+
+  double base_rate = 0.0;
+  for (int num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+    double elapsed = run_threads(num_threads, iterations);
+    double rate = (double)num_threads * iterations / elapsed;
+    if (num_threads == 1) {
+      base_rate = rate;
+    }
+    nout << num_threads << " threads: " << elapsed * 1000.0 << " ms, "
+         << rate / 1000.0 << " iterations per ms, "
+         << rate / base_rate << "x\n";
+  }
+
+  nout << TransformState::get_num_states() << " transforms, "
+       << RenderState::get_num_states() << " states, "
+       << RenderAttrib::get_num_attribs() << " attribs in the cache.\n";
+
+  return 0;
+}
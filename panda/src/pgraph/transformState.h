@@ -31,6 +31,7 @@
 #include "deletedChain.h"
 #include "simpleHashMap.h"
 #include "cacheStats.h"
+#include "stateShards.h"
 #include "extension.h"
 
 class GraphicsStateGuardianBase;
@@ -252,13 +253,22 @@ private:
   void release_new();
   void remove_cache_pointers();
 
+  INLINE LightReMutex &get_cache_lock() const;
+
 private:
-  // This mutex protects _states.  It also protects any modification to the
-  // cache, which is encoded in _composition_cache and
-  // _invert_composition_cache.
+  // The unique states are stored in _states, which is split into shards by
+  // hash.  The lock of each shard protects its table, and also the
+  // _composition_cache and _invert_composition_cache of the states that hash
+  // to it.  Adding a composition to the cache locks the shards of both
+  // states involved.
+  typedef SimpleHashMap<const TransformState *, std::nullptr_t, indirect_equals_hash<const TransformState *> > StateTable;
+  typedef StateShards<StateTable> States;
+  static States *_states;
+
+  // This mutex is held, along with all of the shard locks, by operations
+  // that may remove states or cache entries, or that walk through all of the
+  // states, such as garbage_collect().
   static LightReMutex *_states_lock;
-  typedef SimpleHashMap<const TransformState *, std::nullptr_t, indirect_equals_hash<const TransformState *> > States;
-  static States _states;
   static CPT(TransformState) _identity_state;
   static CPT(TransformState) _invalid_state;
 
@@ -295,10 +305,6 @@ private:
   UpdateSeq _cycle_detect;
   static UpdateSeq _last_cycle_detect;
 
-  // This keeps track of our current position through the garbage collection
-  // cycle.
-  static size_t _garbage_index;
-
   static bool _uniquify_matrix;
 
   static PStatCollector _cache_update_pcollector;
@@ -29,7 +29,7 @@
 PyObject *Extension<TransformState>::
 get_composition_cache() const {
   extern struct Dtool_PyTypedObject Dtool_TransformState;
-  LightReMutexHolder holder(*_this->_states_lock);
+  LightReMutexHolder holder(_this->get_cache_lock());
 
   size_t num_states = _this->_composition_cache.get_num_entries();
   PyObject *list = PyList_New(num_states);
@@ -84,7 +84,7 @@ get_composition_cache() const {
 PyObject *Extension<TransformState>::
 get_invert_composition_cache() const {
   extern struct Dtool_PyTypedObject Dtool_TransformState;
-  LightReMutexHolder holder(*_this->_states_lock);
+  LightReMutexHolder holder(_this->get_cache_lock());
 
   size_t num_states = _this->_invert_composition_cache.get_num_entries();
   PyObject *list = PyList_New(num_states);
@@ -133,21 +133,25 @@ PyObject *Extension<TransformState>::
 get_states() {
   extern struct Dtool_PyTypedObject Dtool_TransformState;
   LightReMutexHolder holder(*TransformState::_states_lock);
+  TransformState::States::Holder shards_holder(*TransformState::_states);
 
-  size_t num_states = TransformState::_states.get_num_entries();
+  size_t num_states = TransformState::_states->get_num_entries();
   PyObject *list = PyList_New(num_states);
   size_t i = 0;
 
-  size_t size = TransformState::_states.get_num_entries();
-  for (size_t si = 0; si < size; ++si) {
-    const TransformState *state = TransformState::_states.get_key(si);
-    state->ref();
-    PyObject *a =
-      DTool_CreatePyInstanceTyped((void *)state, Dtool_TransformState,
-                                  true, true, state->get_type_index());
-    nassertr(i < num_states, list);
-    PyList_SET_ITEM(list, i, a);
-    ++i;
+  for (size_t n = 0; n < TransformState::States::num_shards; ++n) {
+    const TransformState::StateTable &states = (*TransformState::_states)[n]._table;
+    size_t size = states.get_num_entries();
+    for (size_t si = 0; si < size; ++si) {
+      const TransformState *state = states.get_key(si);
+      state->ref();
+      PyObject *a =
+        DTool_CreatePyInstanceTyped((void *)state, Dtool_TransformState,
+                                    true, true, state->get_type_index());
+      nassertr(i < num_states, list);
+      PyList_SET_ITEM(list, i, a);
+      ++i;
+    }
   }
   nassertr(i == num_states, list);
   return list;
@@ -161,18 +165,22 @@ PyObject *Extension<TransformState>::
 get_unused_states() {
   extern struct Dtool_PyTypedObject Dtool_TransformState;
   LightReMutexHolder holder(*TransformState::_states_lock);
+  TransformState::States::Holder shards_holder(*TransformState::_states);
 
   PyObject *list = PyList_New(0);
-  size_t size = TransformState::_states.get_num_entries();
-  for (size_t si = 0; si < size; ++si) {
-    const TransformState *state = TransformState::_states.get_key(si);
-    if (state->get_cache_ref_count() == state->get_ref_count()) {
-      state->ref();
-      PyObject *a =
-        DTool_CreatePyInstanceTyped((void *)state, Dtool_TransformState,
-                                    true, true, state->get_type_index());
-      PyList_Append(list, a);
-      Py_DECREF(a);
+  for (size_t n = 0; n < TransformState::States::num_shards; ++n) {
+    const TransformState::StateTable &states = (*TransformState::_states)[n]._table;
+    size_t size = states.get_num_entries();
+    for (size_t si = 0; si < size; ++si) {
+      const TransformState *state = states.get_key(si);
+      if (state->get_cache_ref_count() == state->get_ref_count()) {
+        state->ref();
+        PyObject *a =
+          DTool_CreatePyInstanceTyped((void *)state, Dtool_TransformState,
+                                      true, true, state->get_type_index());
+        PyList_Append(list, a);
+        Py_DECREF(a);
+      }
     }
   }
   return list;
@@ -59,6 +59,14 @@ child_integrate(Physical *physical,
   // Get the greater of the local or global viscosity:
   PN_stdfloat viscosityDamper=1.0f-physical->get_viscosity();
 
+  // A physical that keeps its objects in arrays is integrated a force at a
+  // time instead.
+  PhysicsObjectArrays *arrays = physical->get_object_arrays();
+  if (arrays != nullptr) {
+    integrate_arrays(*arrays, physical, forces, matrices, viscosityDamper, dt);
+    return;
+  }
+
   // Loop through each object in the set.  This processing occurs in O(pf)
   // time, where p is the number of physical objects and f is the number of
   // forces.  Unfortunately, no precomputation of forces can occur, as each
@@ -185,6 +193,79 @@ child_integrate(Physical *physical,
   }
 }
 
+/**
+ * Does the work of child_integrate() for the physical's object arrays.  This
+ * makes the same computation, but one force at a time over all of the
+ * objects rather than one object at a time over all of the forces, so that
+ * the loops run over contiguous arrays and can be vectorized by the
+ * compiler.
+ *
+ * Inactive slots are carried along with the rest, but their active value of
+ * 0 keeps them from moving.
+ */
+void LinearEulerIntegrator::
+integrate_arrays(PhysicsObjectArrays &arrays, Physical *physical,
+                 LinearForceVector &forces, const MatrixVector &matrices,
+                 PN_stdfloat viscosity_damper, PN_stdfloat dt) {
+  size_t size = arrays.get_size();
+  if (size == 0) {
+    return;
+  }
+
+  PN_stdfloat *md_accum[3];
+  PN_stdfloat *non_md_accum[3];
+  for (int c = 0; c < 3; ++c) {
+    _md_accum[c].assign(size, 0.0f);
+    _non_md_accum[c].assign(size, 0.0f);
+    md_accum[c] = _md_accum[c].data();
+    non_md_accum[c] = _non_md_accum[c].data();
+  }
+
+  // Tally the forces in the same order as child_integrate(), so that they
+  // line up with the precomputed matrices: first global, then local.
+  int index = 0;
+  LinearForceVector::const_iterator f_cur;
+  for (f_cur = forces.begin(); f_cur != forces.end(); ++f_cur) {
+    LinearForce *cur_force = *f_cur;
+    if (cur_force->get_active() == false) {
+      continue;
+    }
+    cur_force->add_vectors(arrays, matrices[index++],
+                           cur_force->get_mass_dependent() ? md_accum : non_md_accum);
+  }
+
+  const LinearForceVector &local_forces = physical->get_linear_forces();
+  for (f_cur = local_forces.begin(); f_cur != local_forces.end(); ++f_cur) {
+    LinearForce *cur_force = *f_cur;
+    if (cur_force->get_active() == false) {
+      continue;
+    }
+    cur_force->add_vectors(arrays, matrices[index++],
+                           cur_force->get_mass_dependent() ? md_accum : non_md_accum);
+  }
+
+  // Now step the positions and velocities, exactly as child_integrate() does
+  // for a single object.  The damper is folded into the activity, so that an
+  // inactive slot gets neither velocity nor acceleration.
+  const PN_stdfloat *mass = arrays._mass.data();
+  const PN_stdfloat *active = arrays._active.data();
+  PN_stdfloat half_dt2 = 0.5f * dt * dt;
+  for (int c = 0; c < 3; ++c) {
+    PN_stdfloat *pos = arrays._position[c].data();
+    PN_stdfloat *vel = arrays._velocity[c].data();
+    const PN_stdfloat *md = md_accum[c];
+    const PN_stdfloat *non_md = non_md_accum[c];
+    for (size_t i = 0; i < size; ++i) {
+      PN_stdfloat accel = (md[i] / mass[i] + non_md[i]) * (viscosity_damper * active[i]);
+
+      // x = x + v * t + 0.5 * a * t * t
+      pos[i] += vel[i] * dt * active[i] + accel * half_dt2;
+      // v = v + a * t
+      vel[i] += accel * dt;
+    }
+  }
+}
+
 /**
  * Write a string representation of this instance to <out>.
  */
@@ -32,6 +32,16 @@ private:
   virtual void child_integrate(Physical *physical,
                                LinearForceVector& forces,
                                PN_stdfloat dt);
+
+  void integrate_arrays(PhysicsObjectArrays &arrays, Physical *physical,
+                        LinearForceVector &forces,
+                        const MatrixVector &matrices,
+                        PN_stdfloat viscosity_damper, PN_stdfloat dt);
+
+  // Scratch space for integrate_arrays(), kept to save reallocating it on
+  // every step.
+  PhysicsObjectArrays::Array _md_accum[3];
+  PhysicsObjectArrays::Array _non_md_accum[3];
 };
 
 #endif // EULERINTEGRATOR_H
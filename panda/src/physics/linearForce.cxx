@@ -70,6 +70,53 @@ get_vector(const PhysicsObject *po) {
   return child_vector;
 }
 
+/**
+ * Adds the force on each of the active objects in the arrays, converted to
+ * the objects' coordinate space by xform, into the corresponding elements of
+ * the result arrays.  This is how the integrator applies forces to a
+ * Physical's object arrays.
+ *
+ * The default implementation calls get_vector() for each object in turn, on
+ * a scratch PhysicsObject.  Forces that are commonly applied to large
+ * numbers of particles override this to process the whole arrays at once.
+ */
+void LinearForce::
+add_vectors(const PhysicsObjectArrays &objects, const LMatrix4 &xform,
+            PN_stdfloat *const result[3]) {
+  PhysicsObject object;
+  size_t size = objects.get_size();
+  for (size_t i = 0; i < size; ++i) {
+    if (!objects.get_active(i)) {
+      continue;
+    }
+
+    object.set_position(objects.get_position(i));
+    object.set_last_position(objects.get_last_position(i));
+    object.set_velocity(objects.get_velocity(i));
+    object.set_mass(objects._mass[i]);
+
+    LVector3 f = get_vector(&object) * xform;
+    result[0][i] += f[0];
+    result[1][i] += f[1];
+    result[2][i] += f[2];
+  }
+}
+
+/**
+ * Returns a matrix that takes the value of get_child_vector() straight to
+ * the objects' coordinate space, given the xform from the force's space.
+ * This folds in the amplitude and the vector masks, the way get_vector()
+ * applies them, so that add_vectors() can apply it with one multiply.
+ */
+LMatrix3 LinearForce::
+get_vector_xform(const LMatrix4 &xform) const {
+  LMatrix3 mat = xform.get_upper_3();
+  mat.set_row(0, _x_mask ? mat.get_row(0) * _amplitude : LVecBase3::zero());
+  mat.set_row(1, _y_mask ? mat.get_row(1) * _amplitude : LVecBase3::zero());
+  mat.set_row(2, _z_mask ? mat.get_row(2) * _amplitude : LVecBase3::zero());
+  return mat;
+}
+
 /**
 
  */
@@ -15,6 +15,7 @@
 #define LINEARFORCE_H
 
 #include "baseForce.h"
+#include "physicsObjectArrays.h"
 
 /**
  * A force that acts on a PhysicsObject by way of an Integrator.  This is a
@@ -42,10 +43,16 @@ PUBLISHED:
   virtual void output(std::ostream &out) const;
   virtual void write(std::ostream &out, int indent=0) const;
 
+public:
+  virtual void add_vectors(const PhysicsObjectArrays &objects,
+                           const LMatrix4 &xform, PN_stdfloat *const result[3]);
+
 protected:
   LinearForce(PN_stdfloat a, bool mass);
   LinearForce(const LinearForce& copy);
 
+  LMatrix3 get_vector_xform(const LMatrix4 &xform) const;
+
 private:
   PN_stdfloat _amplitude;
   bool _mass_dependent;
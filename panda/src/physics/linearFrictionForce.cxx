@@ -68,6 +68,32 @@ get_child_vector(const PhysicsObject* po) {
   return friction;
 }
 
+/**
+ * Adds the friction on each of the objects in the arrays into the result
+ * arrays.  The friction is linear in the velocity, so for each object it is
+ * just the velocity times one matrix.
+ */
+void LinearFrictionForce::
+add_vectors(const PhysicsObjectArrays &objects, const LMatrix4 &xform,
+            PN_stdfloat *const result[3]) {
+  nassertv(_coef >= 0.0f && _coef <= 1.0f);
+  LMatrix3 mat = get_vector_xform(xform) * -_coef;
+
+  const PN_stdfloat *vx = objects._velocity[0].data();
+  const PN_stdfloat *vy = objects._velocity[1].data();
+  const PN_stdfloat *vz = objects._velocity[2].data();
+  size_t size = objects.get_size();
+  for (int c = 0; c < 3; ++c) {
+    PN_stdfloat m0 = mat(0, c);
+    PN_stdfloat m1 = mat(1, c);
+    PN_stdfloat m2 = mat(2, c);
+    PN_stdfloat *r = result[c];
+    for (size_t i = 0; i < size; ++i) {
+      r[i] += vx[i] * m0 + vy[i] * m1 + vz[i] * m2;
+    }
+  }
+}
+
 /**
  * Write a string representation of this instance to <out>.
  */
@@ -31,6 +31,10 @@ PUBLISHED:
   virtual void output(std::ostream &out) const;
   virtual void write(std::ostream &out, int indent=0) const;
 
+public:
+  virtual void add_vectors(const PhysicsObjectArrays &objects,
+                           const LMatrix4 &xform, PN_stdfloat *const result[3]);
+
 private:
   PN_stdfloat _coef;
 
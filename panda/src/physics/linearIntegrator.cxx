@@ -46,6 +46,16 @@ integrate(Physical *physical, LinearForceVector &forces,
     dt = _max_linear_dt;
 */
 
+  PhysicsObjectArrays *arrays = physical->get_object_arrays();
+  if (arrays != nullptr) {
+    // The arrays take the place of the PhysicsObjects.
+    for (int c = 0; c < 3; ++c) {
+      arrays->_last_position[c] = arrays->_position[c];
+    }
+    child_integrate(physical, forces, dt);
+    return;
+  }
+
   PhysicsObject::Vector::const_iterator current_object_iter;
   current_object_iter = physical->get_object_vector().begin();
   for (; current_object_iter != physical->get_object_vector().end();
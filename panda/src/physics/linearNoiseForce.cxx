@@ -86,8 +86,40 @@ make_copy() {
  */
 LVector3 LinearNoiseForce::
 get_child_vector(const PhysicsObject *po) {
-  LPoint3 p = po->get_position();
+  return get_noise(po->get_position());
+}
+
+/**
+ * Adds the noise force at each of the active objects' positions into the
+ * result arrays.  The lattice lookups don't vectorize, but this saves the
+ * virtual calls and a matrix multiply for each object.
+ */
+void LinearNoiseForce::
+add_vectors(const PhysicsObjectArrays &objects, const LMatrix4 &xform,
+            PN_stdfloat *const result[3]) {
+  LMatrix3 mat = get_vector_xform(xform);
+
+  const PN_stdfloat *px = objects._position[0].data();
+  const PN_stdfloat *py = objects._position[1].data();
+  const PN_stdfloat *pz = objects._position[2].data();
+  const PN_stdfloat *active = objects._active.data();
+  size_t size = objects.get_size();
+  for (size_t i = 0; i < size; ++i) {
+    if (active[i] == 0.0f) {
+      continue;
+    }
+    LVector3 f = get_noise(LPoint3(px[i], py[i], pz[i])) * mat;
+    result[0][i] += f[0];
+    result[1][i] += f[1];
+    result[2][i] += f[2];
+  }
+}
 
+/**
+ * Returns the noise vector at the indicated point.
+ */
+LVector3 LinearNoiseForce::
+get_noise(const LPoint3 &p) {
   // get all of the components
   PN_stdfloat int_x, int_y, int_z;
   PN_stdfloat frac_x, frac_y, frac_z;
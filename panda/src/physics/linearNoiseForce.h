@@ -34,6 +34,9 @@ public:
   static ConfigVariableInt _random_seed;
   static void init_noise_tables();
 
+  virtual void add_vectors(const PhysicsObjectArrays &objects,
+                           const LMatrix4 &xform, PN_stdfloat *const result[3]);
+
 private:
   static unsigned char _prn_table[256];
   static LVector3 _gradient_table[256];
@@ -50,6 +53,8 @@ private:
 
   INLINE unsigned char prn_lookup(int index) const;
 
+  LVector3 get_noise(const LPoint3 &p);
+
   virtual LVector3 get_child_vector(const PhysicsObject *po);
   virtual LinearForce *make_copy();
 
@@ -70,6 +70,25 @@ get_child_vector(const PhysicsObject *) {
   return _fvec;
 }
 
+/**
+ * Adds the force on each of the objects in the arrays into the result
+ * arrays.  The force is the same for every object, so this only has to be
+ * transformed once.
+ */
+void LinearVectorForce::
+add_vectors(const PhysicsObjectArrays &objects, const LMatrix4 &xform,
+            PN_stdfloat *const result[3]) {
+  LVector3 f = _fvec * get_vector_xform(xform);
+  size_t size = objects.get_size();
+  for (int c = 0; c < 3; ++c) {
+    PN_stdfloat fc = f[c];
+    PN_stdfloat *r = result[c];
+    for (size_t i = 0; i < size; ++i) {
+      r[i] += fc;
+    }
+  }
+}
+
 /**
  * Write a string representation of this instance to <out>.
  */
@@ -39,6 +39,9 @@ PUBLISHED:
 public:
   INLINE LinearVectorForce& operator += (const LinearVectorForce &other);
 
+  virtual void add_vectors(const PhysicsObjectArrays &objects,
+                           const LMatrix4 &xform, PN_stdfloat *const result[3]);
+
 private:
   LVector3 _fvec;
 
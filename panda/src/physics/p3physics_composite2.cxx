@@ -12,4 +12,5 @@
 #include "physicsCollisionHandler.cxx"
 #include "physicsManager.cxx"
 #include "physicsObject.cxx"
+#include "physicsObjectArrays.cxx"
 #include "physicsObjectCollection.cxx"
@@ -34,6 +34,7 @@ TypeHandle Physical::_type_handle;
 Physical::
 Physical(int total_objects, bool pre_alloc) :
   _viscosity(0.0),
+  _object_arrays(nullptr),
   _physics_manager(nullptr),
   _physical_node(nullptr) {
 
@@ -58,6 +59,7 @@ Physical(int total_objects, bool pre_alloc) :
  */
 Physical::
 Physical(const Physical& copy) :
+  _object_arrays(nullptr),
   _physics_manager(nullptr),
   _physical_node(nullptr) {
 
@@ -23,6 +23,7 @@
 
 #include "physicsObject.h"
 #include "physicsObjectCollection.h"
+#include "physicsObjectArrays.h"
 #include "linearForce.h"
 #include "angularForce.h"
 #include "nodePath.h"
@@ -86,6 +87,7 @@ public:
   INLINE const PhysicsObject::Vector &get_object_vector() const;
   INLINE const LinearForceVector &get_linear_forces() const;
   INLINE const AngularForceVector &get_angular_forces() const;
+  INLINE PhysicsObjectArrays *get_object_arrays() const;
 
   friend class PhysicsManager;
   friend class PhysicalNode;
@@ -104,6 +106,10 @@ protected:
   // way there.
   PhysicsObject *_phys_body;
 
+  // If this is set, the linear integrator moves the objects stored in these
+  // arrays instead of the PhysicsObjects.
+  PhysicsObjectArrays *_object_arrays;
+
 private:
   PhysicsManager *_physics_manager;
   PhysicalNode *_physical_node;
@@ -0,0 +1,39 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file physicsObjectArrays.cxx
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#include "physicsObjectArrays.h"
+
+/**
+ *
+ */
+PhysicsObjectArrays::
+PhysicsObjectArrays() :
+  _size(0)
+{
+}
+
+/**
+ * Changes the number of slots.  New slots are inactive, at rest at the
+ * origin, with a mass of 1.
+ */
+void PhysicsObjectArrays::
+resize(size_t size) {
+  for (int c = 0; c < 3; ++c) {
+    _position[c].resize(size, 0.0f);
+    _last_position[c].resize(size, 0.0f);
+    _velocity[c].resize(size, 0.0f);
+  }
+  _mass.resize(size, 1.0f);
+  _active.resize(size, 0.0f);
+  _size = size;
+}
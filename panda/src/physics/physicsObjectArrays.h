@@ -0,0 +1,64 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file physicsObjectArrays.h
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#ifndef PHYSICSOBJECTARRAYS_H
+#define PHYSICSOBJECTARRAYS_H
+
+#include "pandabase.h"
+#include "luse.h"
+#include "pvector.h"
+
+/**
+ * The linear state of a set of point masses, such as the particles of a
+ * ParticleSystem, stored as one array per component rather than as one
+ * PhysicsObject per body.  A Physical that has one of these is integrated
+ * straight from the arrays, a whole array at a time, and the linear
+ * integrator leaves its PhysicsObjects alone.
+ *
+ * Slots that are not in use have an active value of 0.  The integrator runs
+ * over them along with the others, but does not move them, so they must
+ * still hold finite values and a nonzero mass.
+ */
+class EXPCL_PANDA_PHYSICS PhysicsObjectArrays {
+public:
+  typedef pvector<PN_stdfloat> Array;
+
+  PhysicsObjectArrays();
+
+  void resize(size_t size);
+  INLINE size_t get_size() const;
+
+  INLINE bool get_active(size_t n) const;
+  INLINE LPoint3 get_position(size_t n) const;
+  INLINE LPoint3 get_last_position(size_t n) const;
+  INLINE LVector3 get_velocity(size_t n) const;
+
+  INLINE void reset_position(size_t n, const LPoint3 &pos);
+  INLINE void set_velocity(size_t n, const LVector3 &vel);
+
+  Array _position[3];
+  Array _last_position[3];
+  Array _velocity[3];
+  Array _mass;
+
+  // 1 for a slot in use, 0 for a free one.  This is a float so that it can
+  // be multiplied in.
+  Array _active;
+
+private:
+  size_t _size;
+};
+
+#include "physicsObjectArrays.I"
+
+#endif  // PHYSICSOBJECTARRAYS_H
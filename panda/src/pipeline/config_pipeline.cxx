@@ -57,6 +57,24 @@ ConfigVariableInt thread_stack_size
           "created for each newly-created thread.  Not all thread "
           "implementations respect this value."));
 
+ConfigVariableInt pipeline_cycle_block_size
+("pipeline-cycle-block-size", 64,
+ PRC_DESC("The number of dirty PipelineCyclers that Pipeline::cycle() "
+          "cycles at a time before it takes the Pipeline's lock to put them "
+          "back on the clean or dirty list.  Larger blocks mean fewer trips "
+          "through the lock, but other threads that want to write to one of "
+          "the cyclers in the block may have to wait a little longer.  This "
+          "is only meaningful if threaded pipelining is compiled into "
+          "Panda."));
+
+ConfigVariableInt pipeline_cycle_job_size
+("pipeline-cycle-job-size", 8192,
+ PRC_DESC("When there are at least twice this many dirty PipelineCyclers, "
+          "Pipeline::cycle() splits them into jobs of about this many "
+          "cyclers each, and runs the jobs on the engine's job pool.  Set "
+          "this to 0 to always cycle in the calling thread.  This is only "
+          "meaningful if threaded pipelining is compiled into Panda."));
+
 /**
  * Initializes the library.  This must be called at least once before any of
  * the functions or classes in this library can be used.  Normally it will be
@@ -18,6 +18,19 @@
 
 Pipeline *Pipeline::_render_pipeline = nullptr;
 
+#ifdef THREADED_PIPELINE
+/**
+ * The parameters shared by the jobs of a split cycle().
+ */
+class Pipeline::CycleJobs {
+public:
+  Pipeline *_pipeline;
+  PipelineCyclerLinks *_lists;
+  CycleDatas *_saved_cdatas;
+  unsigned int _next_seq;
+};
+#endif  // THREADED_PIPELINE
+
 /**
  *
  */
@@ -28,7 +41,8 @@ Pipeline(const std::string &name, int num_stages) :
   _num_stages(num_stages),
   _cycle_lock("Pipeline cycle"),
   _lock("Pipeline"),
-  _next_cycle_seq(1)
+  _next_cycle_seq(1),
+  _run_jobs_func(nullptr)
 #else
   _num_stages(1)
 #endif
@@ -91,11 +105,14 @@ cycle() {
       << "Beginning the pipeline cycle\n";
   }
 
-  pvector< PT(CycleData) > saved_cdatas;
+  CycleDatas saved_cdatas;
+  CycleDatas job_cdatas[max_cycle_jobs];
   {
     ReMutexHolder cycle_holder(_cycle_lock);
-    unsigned int prev_seq, next_seq;
+    unsigned int next_seq;
     PipelineCyclerLinks prev_dirty;
+    int num_dirty;
+    RunJobsFunc *run_jobs_func;
     {
       // We can't hold the lock protecting the linked lists during the cycling
       // itself, since it could cause a deadlock.
@@ -111,7 +128,7 @@ cycle() {
 
       // Increment the cycle sequence number, which is used by this method to
       // communicate with remove_cycler() about the status of dirty cyclers.
-      prev_seq = next_seq = _next_cycle_seq;
+      next_seq = _next_cycle_seq;
       if (++next_seq == 0) {
         // Skip 0, which is a reserved number used to indicate a clean cycler.
         ++next_seq;
@@ -122,141 +139,59 @@ cycle() {
       prev_dirty.make_head();
       prev_dirty.take_list(_dirty);
 
-      saved_cdatas.reserve(_num_dirty_cyclers);
+      num_dirty = _num_dirty_cyclers;
+      run_jobs_func = _run_jobs_func;
       _num_dirty_cyclers = 0;
     }
 
-    // This is duplicated for different number of stages, as an optimization.
-    switch (_num_stages) {
-    case 2:
-      while (prev_dirty._next != &prev_dirty) {
-        PipelineCyclerLinks *link = prev_dirty._next;
-        while (link != &prev_dirty) {
-          PipelineCyclerTrueImpl *cycler = (PipelineCyclerTrueImpl *)link;
-
-          if (!cycler->_lock.try_lock()) {
-            // No big deal, just move on to the next one for now, and we'll
-            // come back around to it.  It's important not to block here in
-            // order to prevent one cycler from deadlocking another.
-            if (link->_prev != &prev_dirty || link->_next != &prev_dirty) {
-              link = cycler->_next;
-              continue;
-            } else {
-              // Well, we are the last cycler left, so we might as well wait.
-              // This is necessary to trigger the deadlock detection code.
-              cycler->_lock.lock();
-            }
-          }
-
-          MutexHolder holder(_lock);
-          cycler->remove_from_list();
-
-          // We save the result of cycle(), so that we can defer the side-
-          // effects that might occur when CycleDatas destruct, at least until
-          // the end of this loop.
-          saved_cdatas.push_back(cycler->cycle_2());
-
-          // cycle_2() won't leave a cycler dirty.  Add it to the clean list.
-          nassertd(!cycler->_dirty) break;
-          cycler->insert_before(&_clean);
-#ifdef DEBUG_THREADS
-          inc_cycler_type(_dirty_cycler_types, cycler->get_parent_type(), -1);
-#endif
-          cycler->_lock.unlock();
-          break;
-        }
+    size_t num_jobs = 0;
+    int job_size = pipeline_cycle_job_size;
+    if (run_jobs_func != nullptr && job_size > 0 && num_dirty >= job_size * 2) {
+      num_jobs = std::min((size_t)(num_dirty / job_size), max_cycle_jobs);
+    }
+
+    if (num_jobs > 1) {
+      // Deal the dirty cyclers out into one list per job.  No other thread
+      // touches a cycler while it is owned by this cycle, so this doesn't need
+      // the lock.
+      PipelineCyclerLinks lists[max_cycle_jobs];
+      size_t j;
+      for (j = 0; j < num_jobs; ++j) {
+        lists[j].make_head();
       }
-      break;
 
-    case 3:
+      size_t i = 0;
       while (prev_dirty._next != &prev_dirty) {
         PipelineCyclerLinks *link = prev_dirty._next;
-        while (link != &prev_dirty) {
-          PipelineCyclerTrueImpl *cycler = (PipelineCyclerTrueImpl *)link;
-
-          if (!cycler->_lock.try_lock()) {
-            // No big deal, just move on to the next one for now, and we'll
-            // come back around to it.  It's important not to block here in
-            // order to prevent one cycler from deadlocking another.
-            if (link->_prev != &prev_dirty || link->_next != &prev_dirty) {
-              link = cycler->_next;
-              continue;
-            } else {
-              // Well, we are the last cycler left, so we might as well wait.
-              // This is necessary to trigger the deadlock detection code.
-              cycler->_lock.lock();
-            }
-          }
-
-          MutexHolder holder(_lock);
-          cycler->remove_from_list();
-
-          saved_cdatas.push_back(cycler->cycle_3());
-
-          if (cycler->_dirty) {
-            // The cycler is still dirty.  Add it back to the dirty list.
-            nassertd(cycler->_dirty == prev_seq) break;
-            cycler->insert_before(&_dirty);
-            cycler->_dirty = next_seq;
-            ++_num_dirty_cyclers;
-          } else {
-            // The cycler is now clean.  Add it back to the clean list.
-            cycler->insert_before(&_clean);
-#ifdef DEBUG_THREADS
-            inc_cycler_type(_dirty_cycler_types, cycler->get_parent_type(), -1);
-#endif
-          }
-          cycler->_lock.unlock();
-          break;
-        }
+        link->remove_from_list();
+        j = std::min((i * num_jobs) / (size_t)num_dirty, num_jobs - 1);
+        link->insert_before(&lists[j]);
+        ++i;
       }
-      break;
 
-    default:
-      while (prev_dirty._next != &prev_dirty) {
-        PipelineCyclerLinks *link = prev_dirty._next;
-        while (link != &prev_dirty) {
-          PipelineCyclerTrueImpl *cycler = (PipelineCyclerTrueImpl *)link;
-
-          if (!cycler->_lock.try_lock()) {
-            // No big deal, just move on to the next one for now, and we'll
-            // come back around to it.  It's important not to block here in
-            // order to prevent one cycler from deadlocking another.
-            if (link->_prev != &prev_dirty || link->_next != &prev_dirty) {
-              link = cycler->_next;
-              continue;
-            } else {
-              // Well, we are the last cycler left, so we might as well wait.
-              // This is necessary to trigger the deadlock detection code.
-              cycler->_lock.lock();
-            }
-          }
-
-          MutexHolder holder(_lock);
-          cycler->remove_from_list();
-
-          saved_cdatas.push_back(cycler->cycle());
-
-          if (cycler->_dirty) {
-            // The cycler is still dirty.  Add it back to the dirty list.
-            nassertd(cycler->_dirty == prev_seq) break;
-            cycler->insert_before(&_dirty);
-            cycler->_dirty = next_seq;
-            ++_num_dirty_cyclers;
-          } else {
-            // The cycler is now clean.  Add it back to the clean list.
-            cycler->insert_before(&_clean);
-#ifdef DEBUG_THREADS
-            inc_cycler_type(_dirty_cycler_types, cycler->get_parent_type(), -1);
-#endif
-          }
-          cycler->_lock.unlock();
-          break;
+      CycleJobs jobs;
+      jobs._pipeline = this;
+      jobs._lists = lists;
+      jobs._saved_cdatas = job_cdatas;
+      jobs._next_seq = next_seq;
+      run_jobs_func(num_jobs, &cycle_job, &jobs);
+
+      // The jobs don't wait for cyclers that are locked by another thread;
+      // they leave them behind on their lists, and we pick them up here.
+      for (j = 0; j < num_jobs; ++j) {
+        while (lists[j]._next != &lists[j]) {
+          PipelineCyclerLinks *link = lists[j]._next;
+          link->remove_from_list();
+          link->insert_before(&prev_dirty);
         }
+        lists[j].clear_head();
       }
-      break;
+    } else {
+      saved_cdatas.reserve(num_dirty);
     }
 
+    cycle_list(prev_dirty, saved_cdatas, next_seq, true);
+
     // Now we're ready for the next frame.
     prev_dirty.clear_head();
     _cycling = false;
@@ -267,6 +202,9 @@ cycle() {
   // PipelineCyclers to remove themselves from (or add themselves to) the
   // _dirty list.
   saved_cdatas.clear();
+  for (size_t j = 0; j < max_cycle_jobs; ++j) {
+    job_cdatas[j].clear();
+  }
 
   if (pipeline_cat.is_debug()) {
     pipeline_cat.debug()
@@ -485,6 +423,128 @@ iterate_dirty_cycler_types(CallbackFunc *func, void *data) const {
 }
 #endif  // THREADED_PIPELINE && DEBUG_THREADS
 
+#ifdef THREADED_PIPELINE
+/**
+ * Cycles the dirty cyclers on the indicated list, which must have been taken
+ * from the dirty list by the current cycle().  The cyclers are locked and
+ * cycled a block at a time, and then the whole block is moved back to the
+ * clean or dirty list with a single trip through the lock.
+ *
+ * If may_block is false, this never waits for a cycler that is locked by
+ * another thread.  If it can't lock any of the remaining cyclers, it returns
+ * with those cyclers still on the list.
+ */
+void Pipeline::
+cycle_list(PipelineCyclerLinks &list, CycleDatas &saved_cdatas,
+           unsigned int next_seq, bool may_block) {
+  size_t block_size = (size_t)std::max((int)pipeline_cycle_block_size, 1);
+  pvector<PipelineCyclerTrueImpl *> block;
+  block.reserve(block_size);
+
+  while (list._next != &list) {
+    PipelineCyclerLinks *link = list._next;
+    while (link != &list && block.size() < block_size) {
+      PipelineCyclerTrueImpl *cycler = (PipelineCyclerTrueImpl *)link;
+      link = cycler->_next;
+
+      if (!cycler->_lock.try_lock()) {
+        // No big deal, just move on to the next one for now, and we'll come
+        // back around to it.  It's important not to block here in order to
+        // prevent one cycler from deadlocking another.
+        if (!may_block || !block.empty() ||
+            cycler->_prev != &list || cycler->_next != &list) {
+          continue;
+        }
+
+        // Well, we are the last cycler left, so we might as well wait.  This
+        // is necessary to trigger the deadlock detection code.
+        cycler->_lock.lock();
+      }
+
+      // The list belongs to this cycle, so we don't need the lock to take the
+      // cycler off it.
+      cycler->remove_from_list();
+
+      // We save the result of cycle(), so that we can defer the side-effects
+      // that might occur when CycleDatas destruct, at least until the end of
+      // the cycle.
+      switch (_num_stages) {
+      case 2:
+        saved_cdatas.push_back(cycler->cycle_2());
+        break;
+
+      case 3:
+        saved_cdatas.push_back(cycler->cycle_3());
+        break;
+
+      default:
+        saved_cdatas.push_back(cycler->cycle());
+        break;
+      }
+
+      block.push_back(cycler);
+    }
+
+    if (block.empty()) {
+      if (!may_block) {
+        // Every cycler left is locked by another thread.  Leave them for the
+        // thread that called cycle().
+        return;
+      }
+      continue;
+    }
+
+    finish_block(&block[0], block.size(), next_seq);
+    block.clear();
+  }
+}
+#endif  // THREADED_PIPELINE
+
+#ifdef THREADED_PIPELINE
+/**
+ * Moves a block of just-cycled cyclers, which are all still locked, back onto
+ * the clean or dirty list, and then unlocks them.
+ */
+void Pipeline::
+finish_block(PipelineCyclerTrueImpl **block, size_t count,
+             unsigned int next_seq) {
+  {
+    MutexHolder holder(_lock);
+    for (size_t i = 0; i < count; ++i) {
+      PipelineCyclerTrueImpl *cycler = block[i];
+      if (cycler->_dirty) {
+        // The cycler is still dirty.  Add it back to the dirty list.
+        cycler->insert_before(&_dirty);
+        cycler->_dirty = next_seq;
+        ++_num_dirty_cyclers;
+      } else {
+        // The cycler is now clean.  Add it back to the clean list.
+        cycler->insert_before(&_clean);
+#ifdef DEBUG_THREADS
+        inc_cycler_type(_dirty_cycler_types, cycler->get_parent_type(), -1);
+#endif
+      }
+    }
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    block[i]->_lock.unlock();
+  }
+}
+#endif  // THREADED_PIPELINE
+
+#ifdef THREADED_PIPELINE
+/**
+ * Runs one job of a split cycle().  This is passed to the RunJobsFunc.
+ */
+void Pipeline::
+cycle_job(size_t index, void *data) {
+  CycleJobs *jobs = (CycleJobs *)data;
+  jobs->_pipeline->cycle_list(jobs->_lists[index], jobs->_saved_cdatas[index],
+                              jobs->_next_seq, false);
+}
+#endif  // THREADED_PIPELINE
+
 /**
  *
  */
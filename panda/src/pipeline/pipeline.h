@@ -22,9 +22,12 @@
 #include "mutexHolder.h"
 #include "reMutex.h"
 #include "reMutexHolder.h"
+#include "pointerTo.h"
+#include "pvector.h"
 #include "selectThreadImpl.h"  // for THREADED_PIPELINE definition
 
 struct PipelineCyclerTrueImpl;
+class CycleData;
 
 /**
  * This class manages a staged pipeline of data, for instance the render
@@ -56,6 +59,14 @@ public:
   INLINE int get_num_cyclers() const;
   INLINE int get_num_dirty_cyclers() const;
 
+  // A higher-level job system may supply a function to run the jobs of a
+  // large cycle() on several threads.  It should call function(i, data) once
+  // for each i in [0, num_jobs), in any order and on any thread, and return
+  // when they have all finished.
+  typedef void JobFunc(size_t index, void *data);
+  typedef void RunJobsFunc(size_t num_jobs, JobFunc *function, void *data);
+  INLINE void set_run_jobs_func(RunJobsFunc *run_jobs_func);
+
 #ifdef DEBUG_THREADS
   typedef void CallbackFunc(TypeHandle type, int count, void *data);
   void iterate_all_cycler_types(CallbackFunc *func, void *data) const;
@@ -71,6 +82,19 @@ private:
   static Pipeline *_render_pipeline;
 
 #ifdef THREADED_PIPELINE
+  typedef pvector< PT(CycleData) > CycleDatas;
+
+  class CycleJobs;
+
+  void cycle_list(PipelineCyclerLinks &list, CycleDatas &saved_cdatas,
+                  unsigned int next_seq, bool may_block);
+  void finish_block(PipelineCyclerTrueImpl **block, size_t count,
+                    unsigned int next_seq);
+  static void cycle_job(size_t index, void *data);
+
+  // The most jobs a single cycle() will be split into.
+  static const size_t max_cycle_jobs = 32;
+
   PipelineCyclerLinks _clean;
   PipelineCyclerLinks _dirty;
 
@@ -97,6 +121,8 @@ private:
 
   // This lock protects the data stored on this Pipeline.
   Mutex _lock;
+
+  RunJobsFunc *_run_jobs_func;
 #endif  // THREADED_PIPELINE
 };
 
@@ -19,12 +19,24 @@
 #include "datagramIterator.h"
 #include "config_putil.h"
 #include "pipelineCyclerBase.h"
+#include "virtualFileSystem.h"
+#include "virtualFileSimple.h"
 
 using std::string;
 
 TypeHandle BamReaderAuxData::_type_handle;
 
 WritableFactory *BamReader::_factory = nullptr;
+BamReader::DecodeRunner *BamReader::_decode_runner = nullptr;
+
+// extract_bytes() copies fewer bytes than this immediately, since it isn't
+// worth the overhead of deferring them.
+static const size_t min_deferred_decode_size = 16384;
+
+// defer_decode() runs the pending jobs once they add up to this many bytes,
+// which limits the amount of memory held by datagrams that are waiting on
+// them.
+static const size_t max_deferred_decode_size = 64 * 1024 * 1024;
 BamReader *const BamReader::Null = nullptr;
 WritableFactory *const BamReader::NullFactory = nullptr;
 
@@ -49,6 +61,10 @@ BamReader(DatagramGenerator *source)
   _pta_id = -1;
   _long_object_id = false;
   _long_pta_id = false;
+  _tried_mapping = false;
+  _mapping_start = 0;
+  _file_data_stream = nullptr;
+  _decode_jobs_size = 0;
 }
 
 
@@ -57,8 +73,10 @@ BamReader(DatagramGenerator *source)
  */
 BamReader::
 ~BamReader() {
+  flush_decode_jobs();
   nassertv(_num_extra_objects == 0);
   nassertv(_nesting_level == 0);
+  close_file_data();
 }
 
 /**
@@ -67,6 +85,7 @@ BamReader::
  */
 void BamReader::
 set_source(DatagramGenerator *source) {
+  close_file_data();
   _source = source;
   if (_needs_init && _source != nullptr) {
     bool success = init();
@@ -269,6 +288,10 @@ read_object(TypedWritable *&ptr, ReferenceCount *&ref_ptr) {
     p_read_object();
   }
 
+  // Finish any bulk decoding that the objects have deferred, so that they are
+  // complete when we return them.
+  flush_decode_jobs();
+
   // Now look up the pointer of the object we read first.  It should be
   // available now.
   if (object_id == 0) {
@@ -323,6 +346,8 @@ read_object(TypedWritable *&ptr, ReferenceCount *&ref_ptr) {
  */
 bool BamReader::
 resolve() {
+  flush_decode_jobs();
+
   bool all_completed;
   bool any_completed_this_pass;
 
@@ -685,6 +710,199 @@ read_file_data(SubfileInfo &info) {
   _file_data_records.pop_front();
 }
 
+/**
+ * Returns a pointer to the block of file data described by the indicated
+ * SubfileInfo, as filled in by read_file_data(), within a read-only memory
+ * mapping of the bam file.  The mapping is stored in the indicated pointer;
+ * the caller should hold on to it for as long as the data is in use.
+ *
+ * This only works if bam-memory-map is true and the bam file is being read
+ * from a plain file on disk that is neither compressed nor encrypted;
+ * otherwise, this returns NULL, and the data should be read with
+ * load_file_data() instead.
+ */
+const unsigned char *BamReader::
+map_file_data(const SubfileInfo &info, PT(MemoryMappedFile) &mapping) {
+  if (!bam_memory_map || _source == nullptr || info.is_empty() ||
+      info.get_file() != _source->get_file()) {
+    return nullptr;
+  }
+
+  if (!_tried_mapping) {
+    // Map the file into memory the first time we need it.  We can only do
+    // this if the file is stored on disk byte-for-byte as we are reading it.
+    _tried_mapping = true;
+
+    VirtualFile *vfile = _source->get_vfile();
+    SubfileInfo system_info;
+    if (vfile != nullptr && vfile->get_system_info(system_info)) {
+      std::string extension = vfile->get_filename().get_extension();
+      bool compressed = (extension == "pz" || extension == "gz");
+      if (vfile->is_of_type(VirtualFileSimple::get_class_type()) &&
+          ((VirtualFileSimple *)vfile)->is_implicit_pz_file()) {
+        compressed = true;
+      }
+
+      if (!compressed) {
+        PT(MemoryMappedFile) new_mapping = new MemoryMappedFile;
+        if (new_mapping->open(system_info.get_filename())) {
+          _mapping = std::move(new_mapping);
+          _mapping_start = (size_t)system_info.get_start();
+
+          if (bam_cat.is_debug()) {
+            bam_cat.debug()
+              << "Mapped " << system_info.get_filename() << " into memory.\n";
+          }
+        }
+      }
+    }
+  }
+
+  if (_mapping == nullptr) {
+    return nullptr;
+  }
+
+  size_t start = _mapping_start + (size_t)info.get_start();
+  size_t size = (size_t)info.get_size();
+  if (start > _mapping->get_size() || size > _mapping->get_size() - start) {
+    bam_cat.error()
+      << "File data at " << info.get_start() << " extends past the end of "
+      << _mapping->get_filename() << "\n";
+    return nullptr;
+  }
+
+  mapping = _mapping;
+  return _mapping->get_data() + start;
+}
+
+/**
+ * Reads the block of file data described by the indicated SubfileInfo, as
+ * filled in by read_file_data(), into the indicated buffer, which must be at
+ * least info.get_size() bytes.  Returns true on success, false on failure.
+ */
+bool BamReader::
+load_file_data(const SubfileInfo &info, unsigned char *dest) {
+  if (info.is_empty()) {
+    return (info.get_size() == 0);
+  }
+
+  if (_file_data_stream == nullptr || _file_data_file != info.get_file()) {
+    close_file_data();
+
+    Filename filename = info.get_filename();
+    filename.set_binary();
+    VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+    _file_data_stream = vfs->open_read_file(filename, true);
+    if (_file_data_stream == nullptr) {
+      bam_cat.error()
+        << "Unable to open " << filename << " to read file data.\n";
+      return false;
+    }
+    _file_data_file = info.get_file();
+  }
+
+  // The blocks are usually requested in increasing order, so we skip forward
+  // to the next one rather than seeking; this works even if the stream is
+  // compressed.
+  std::istream *in = _file_data_stream;
+  in->clear();
+  std::streampos pos = in->tellg();
+  if (pos >= 0 && pos <= info.get_start()) {
+    in->ignore(info.get_start() - pos);
+  } else {
+    in->seekg(info.get_start());
+  }
+
+  in->read((char *)dest, info.get_size());
+  if (in->fail() || in->gcount() != info.get_size()) {
+    bam_cat.error()
+      << "Unable to read file data from " << info.get_filename() << "\n";
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Copies the indicated number of bytes from the current position of the
+ * DatagramIterator into dest, and advances the iterator past them, like
+ * DatagramIterator::extract_bytes().  However, a large copy may be deferred
+ * with defer_decode(), to be done in parallel with other such work; the bytes
+ * are only guaranteed to be in dest by the time read_object() or resolve()
+ * returns.  The caller must not touch dest before then.
+ */
+void BamReader::
+extract_bytes(DatagramIterator &scan, unsigned char *dest, size_t size) {
+  nassertv(size <= scan.get_remaining_size());
+
+  if (size < min_deferred_decode_size || _decode_runner == nullptr ||
+      !bam_parallel_decode) {
+    scan.extract_bytes(dest, size);
+  } else {
+    defer_decode(new ExtractBytesJob(scan, dest, size), size);
+    scan.skip_bytes(size);
+  }
+}
+
+/**
+ * May be called by an object's fillin() method to hand off some bulk decoding
+ * work, which will be done before the current call to read_object() or
+ * resolve() returns.  The jobs deferred in this way may be run in any order,
+ * on several threads at once, so each must touch only its own data.  size is
+ * the approximate number of bytes the job will decode.
+ *
+ * If parallel decoding is not available, the job is simply run immediately.
+ */
+void BamReader::
+defer_decode(DecodeJob *job, size_t size) {
+  PT(DecodeJob) job_ref = job;
+  if (_decode_runner == nullptr || !bam_parallel_decode) {
+    job->do_decode();
+    return;
+  }
+
+  _decode_jobs.push_back(std::move(job_ref));
+  _decode_jobs_size += size;
+  if (_decode_jobs_size >= max_deferred_decode_size) {
+    flush_decode_jobs();
+  }
+}
+
+/**
+ * Runs all of the jobs that have been deferred with defer_decode(), and
+ * returns when they have all finished.  This is called automatically by
+ * read_object() and resolve().
+ */
+void BamReader::
+flush_decode_jobs() {
+  if (_decode_jobs.empty()) {
+    return;
+  }
+
+  DecodeJobs jobs;
+  jobs.swap(_decode_jobs);
+  _decode_jobs_size = 0;
+
+  if (jobs.size() == 1 || _decode_runner == nullptr) {
+    for (DecodeJob *job : jobs) {
+      job->do_decode();
+    }
+  } else {
+    (*_decode_runner)(jobs.size(), &st_run_decode_job, &jobs);
+  }
+}
+
+/**
+ * Specifies the function that flush_decode_jobs() uses to run a batch of
+ * deferred decoding jobs in parallel.  It must call the indicated function
+ * once for each index in [0, num_jobs), and return when all of the calls have
+ * returned.  This is installed by a higher-level library that provides a
+ * thread pool; until then, objects decode their data immediately.
+ */
+void BamReader::
+set_decode_runner(DecodeRunner *runner) {
+  _decode_runner = runner;
+}
+
 /**
  * Reads in the indicated CycleData object.  This should be used by classes
  * that store some or all of their data within a CycleData subclass, in
@@ -1546,3 +1764,38 @@ finalize() {
     }
   }
 }
+
+/**
+ * Releases the memory mapping and the stream that may have been opened by
+ * map_file_data() and load_file_data().
+ */
+void BamReader::
+close_file_data() {
+  _tried_mapping = false;
+  _mapping.clear();
+  _mapping_start = 0;
+
+  if (_file_data_stream != nullptr) {
+    VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+    vfs->close_read_file(_file_data_stream);
+    _file_data_stream = nullptr;
+  }
+  _file_data_file.clear();
+}
+
+/**
+ * Called by the decode runner to run the indicated job of a batch.
+ */
+void BamReader::
+st_run_decode_job(size_t index, void *data) {
+  DecodeJobs &jobs = *(DecodeJobs *)data;
+  jobs[index]->do_decode();
+}
+
+/**
+ *
+ */
+void BamReader::ExtractBytesJob::
+do_decode() {
+  memcpy(_dest, _source.p() + _start, _size);
+}
@@ -25,12 +25,15 @@
 #include "bamReaderParam.h"
 #include "bamEnums.h"
 #include "subfileInfo.h"
+#include "memoryMappedFile.h"
+#include "fileReference.h"
 #include "loaderOptions.h"
 #include "factory.h"
 #include "vector_int.h"
 #include "pset.h"
 #include "pmap.h"
 #include "pdeque.h"
+#include "pvector.h"
 #include "dcast.h"
 #include "pipelineCyclerBase.h"
 #include "referenceCount.h"
@@ -167,6 +170,18 @@ public:
   void skip_pointer(DatagramIterator &scan);
 
   void read_file_data(SubfileInfo &info);
+  const unsigned char *map_file_data(const SubfileInfo &info,
+                                     PT(MemoryMappedFile) &mapping);
+  bool load_file_data(const SubfileInfo &info, unsigned char *dest);
+
+  class DecodeJob;
+  void extract_bytes(DatagramIterator &scan, unsigned char *dest, size_t size);
+  void defer_decode(DecodeJob *job, size_t size);
+  void flush_decode_jobs();
+
+  typedef void DecodeIndexFunc(size_t index, void *data);
+  typedef void DecodeRunner(size_t num_jobs, DecodeIndexFunc *function, void *data);
+  static void set_decode_runner(DecodeRunner *runner);
 
   void read_cdata(DatagramIterator &scan, PipelineCyclerBase &cycler);
   void read_cdata(DatagramIterator &scan, PipelineCyclerBase &cycler,
@@ -218,6 +233,7 @@ private:
   bool resolve_cycler_pointers(PipelineCyclerBase *cycler, const vector_int &pointer_ids,
                                bool require_fully_complete);
   void finalize();
+  void close_file_data();
 
   INLINE bool get_datagram(Datagram &datagram);
 
@@ -231,6 +247,32 @@ public:
     virtual ~AuxData() = default;
   };
 
+  // Inherit from this class to describe some bulk decoding work, such as
+  // copying or byte-swapping a large array, that an object's fillin() method
+  // hands to defer_decode() to be done later, possibly in parallel with the
+  // work deferred by other objects.
+  class DecodeJob : public ReferenceCount {
+  public:
+    virtual ~DecodeJob() = default;
+    virtual void do_decode() = 0;
+  };
+
+private:
+  // The job used by extract_bytes() to copy bytes out of a datagram.
+  class ExtractBytesJob : public DecodeJob {
+  public:
+    INLINE ExtractBytesJob(const DatagramIterator &scan, unsigned char *dest,
+                           size_t size);
+    virtual void do_decode();
+
+    CPTA_uchar _source;
+    size_t _start;
+    unsigned char *_dest;
+    size_t _size;
+  };
+
+  static void st_run_decode_job(size_t index, void *data);
+
 private:
   static WritableFactory *_factory;
 
@@ -321,6 +363,22 @@ private:
   typedef pdeque<SubfileInfo> FileDataRecords;
   FileDataRecords _file_data_records;
 
+  // These are used by map_file_data() to map the source file into memory the
+  // first time it is needed, and by load_file_data() to keep a stream open
+  // on the file that contains the file data.
+  bool _tried_mapping;
+  PT(MemoryMappedFile) _mapping;
+  size_t _mapping_start;
+  CPT(FileReference) _file_data_file;
+  std::istream *_file_data_stream;
+
+  // The jobs handed to defer_decode() that haven't been run yet, and the total
+  // number of bytes they will decode.
+  typedef pvector<PT(DecodeJob)> DecodeJobs;
+  DecodeJobs _decode_jobs;
+  size_t _decode_jobs_size;
+  static DecodeRunner *_decode_runner;
+
   // This is used internally to record all of the new types created on-the-fly
   // to satisfy bam requirements.  We keep track of this just so we can
   // suppress warning messages from attempts to create objects of these types.
@@ -100,6 +100,7 @@ BamWriter(DatagramSink *target) :
   _file_endian = bam_endian;
   _file_stdfloat_double = bam_stdfloat_double;
   _file_texture_mode = bam_texture_mode;
+  _file_data_alignment = (size_t)std::max(bam_file_data_alignment.get_value(), 0);
 }
 
 /**
@@ -415,6 +416,60 @@ write_file_data(SubfileInfo &result, const SubfileInfo &source) {
   // order and queued up in the BamReader.
 }
 
+/**
+ * Returns true if a block of file data of the indicated size should be
+ * written with write_aligned_file_data(), or false if it should be stored
+ * inline with the object instead.  This is true only if a file data alignment
+ * has been specified, the block is at least that large, the bam version is
+ * new enough to support it, and the target is able to report its position
+ * within the file.
+ */
+bool BamWriter::
+can_align_file_data(size_t size) {
+  return _file_data_alignment != 0 && size >= _file_data_alignment &&
+         _file_minor >= 46 && _target != nullptr &&
+         _target->get_file_pos() > 0;
+}
+
+/**
+ * Writes a block of auxiliary file data from the indicated memory buffer,
+ * such that the first byte of the data is aligned to the boundary specified
+ * by set_file_data_alignment() within the file.  This must be balanced by a
+ * matching call to read_file_data() on restore, after which the data may be
+ * retrieved with BamReader::map_file_data() or BamReader::load_file_data().
+ */
+void BamWriter::
+write_aligned_file_data(const unsigned char *data, size_t size) {
+  // As in write_file_data(), we precede the data with a datagram containing
+  // the BOC_file_data token.  The reader ignores anything that follows the
+  // token, so we pad out this datagram with enough zero bytes that the data
+  // of the following datagram begins on an aligned boundary.
+  Datagram dg;
+  dg.add_uint8(BOC_file_data);
+
+  if (_file_data_alignment > 1) {
+    // Each datagram is preceded by a 4-byte length, and the data datagram
+    // also by an 8-byte length if it is 4 GB or larger.
+    size_t header_size = (size >= 0xffffffff) ? 4 + 4 + 8 : 4 + 4;
+    size_t data_pos = (size_t)_target->get_file_pos() + header_size + 1;
+    size_t padding = (_file_data_alignment - data_pos % _file_data_alignment) % _file_data_alignment;
+    dg.pad_bytes(padding);
+  }
+
+  if (!_target->put_datagram(dg)) {
+    util_cat.error()
+      << "Unable to write data to output.\n";
+    return;
+  }
+
+  Datagram data_dg(data, size);
+  if (!_target->put_datagram(data_dg)) {
+    util_cat.error()
+      << "Unable to write file data to output.\n";
+    return;
+  }
+}
+
 /**
  * Writes out the indicated CycleData object.  This should be used by classes
  * that store some or all of their data within a CycleData subclass, in
@@ -89,6 +89,34 @@ ConfigVariableEnum<BamEnums::BamTextureMode> bam_texture_mode
  PRC_DESC("Set this to specify how textures should be written into Bam files."
           "See the panda source or documentation for available options."));
 
+ConfigVariableInt bam_file_data_alignment
+("bam-file-data-alignment", 0,
+ PRC_DESC("Set this to a nonzero number of bytes to store large vertex and "
+          "index arrays outside of their object records when writing bam "
+          "files of version 6.46 or later, aligned to a multiple of this "
+          "many bytes within the file.  Arrays smaller than this are still "
+          "stored inline.  Such arrays may be used directly from a memory "
+          "mapping of the file when it is loaded; see bam-memory-map.  A "
+          "value of 4096 matches the page size on most platforms."));
+
+ConfigVariableBool bam_memory_map
+("bam-memory-map", false,
+ PRC_DESC("Set this true to map bam files into memory when they are loaded "
+          "from a plain, uncompressed file on disk, so that vertex and index "
+          "arrays written with bam-file-data-alignment are referenced "
+          "directly from the mapped pages rather than copied.  Each such "
+          "array is copied into ordinary memory only when it is modified.  "
+          "The file must not be modified while it is mapped."));
+
+ConfigVariableBool bam_parallel_decode
+("bam-parallel-decode", true,
+ PRC_DESC("Set this true to allow the bulk data of large objects read from "
+          "bam files, such as vertex arrays and texture images, to be "
+          "copied and byte-swapped on several threads, in parallel with "
+          "each other.  The threads are the job pool controlled by "
+          "job-pool-threads.  The result is the same either way; set this "
+          "false to do all of the work in the loading thread."));
+
 ConfigureFn(config_putil) {
   init_libputil();
 }
@@ -240,9 +240,16 @@ save_datagram(SubfileInfo &info) {
   // If this stream is file-based, we can just point the SubfileInfo directly
   // into this file.
   if (_file != nullptr) {
-    info = SubfileInfo(_file, _in->tellg(), num_bytes);
+    std::streampos pos = _in->tellg();
+    info = SubfileInfo(_file, pos, num_bytes);
     _in->seekg(num_bytes, std::ios::cur);
-    return true;
+    if (_in->fail()) {
+      // A compressed stream can't seek; we have to read past the data.
+      _in->clear();
+      _in->seekg(pos);
+      _in->ignore(num_bytes);
+    }
+    return !_in->fail();
   }
 
   // Otherwise, we have to dump the data into a temporary file.
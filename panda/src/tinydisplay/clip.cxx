@@ -1,4 +1,5 @@
 #include "zgl.h"
+#include "zbin.h"
 #include <limits.h>
 
 /* fill triangle profile */
@@ -406,7 +407,11 @@ void gl_draw_triangle_fill(GLContext *c,
   }
 #endif
 
-  (*c->zb_fill_tri)(c->zb,&p0->zp,&p1->zp,&p2->zp);
+  if (c->zb_bins != nullptr) {
+    ZB_binTriangle(c->zb_bins,c->zb_fill_tri,&p0->zp,&p1->zp,&p2->zp);
+  } else {
+    (*c->zb_fill_tri)(c->zb,&p0->zp,&p1->zp,&p2->zp);
+  }
 }
 
 /* Render a clipped triangle in line mode */  
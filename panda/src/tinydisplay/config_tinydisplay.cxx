@@ -55,6 +55,27 @@ ConfigVariableBool td_perspective_textures
             "textures on the tinydisplay software renderer, for a small "
             "performance gain."));
 
+ConfigVariableInt td_raster_threads
+  ("td-raster-threads", 0,
+   PRC_DESC("Specifies the number of threads that may share the work of "
+            "filling triangles on the tinydisplay software renderer.  The "
+            "frame buffer is divided into horizontal bands, and the "
+            "triangles of each draw call are filled into the bands in "
+            "parallel, using the engine's job pool, which is sized by "
+            "job-pool-threads.  The default of 0 uses all of the threads "
+            "of the pool.  Set this to 1 to fill each triangle as soon as "
+            "it is drawn.  The rendered image is the same either way."));
+
+ConfigVariableBool td_sort_opaque_front_to_back
+  ("td-sort-opaque-front-to-back", false,
+   PRC_DESC("Configure this true to change the \"opaque\" cull bin to sort "
+            "its geometry front-to-back when a tinydisplay GSG is created.  "
+            "The software renderer skips rows of pixels that are known to be "
+            "hidden behind geometry that has already been drawn, so drawing "
+            "the nearest geometry first can save much of the work of "
+            "overdraw, at the cost of more state changes.  Note that this "
+            "changes the bin for all windows."));
+
 /**
  * Initializes the library.  This must be called at least once before any of
  * the functions or classes in this library can be used.  Normally it will be
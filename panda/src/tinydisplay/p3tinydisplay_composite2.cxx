@@ -8,6 +8,7 @@
 #include "tinyXGraphicsPipe.cxx"
 #include "tinyXGraphicsWindow.cxx"
 #include "vertex.cxx"
+#include "zbin.cxx"
 #include "zbuffer.cxx"
 #include "zdither.cxx"
 #include "zline.cxx"
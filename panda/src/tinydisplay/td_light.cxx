@@ -133,3 +133,189 @@ void gl_shade_vertex(GLContext *c,GLVertex *v)
   v->color.v[3]=clampf(A*v->color.v[3],0,1);
 }
 
+
+#ifdef TGL_FEATURE_SSE2
+/* Returns true if the lighting can be computed by gl_shade_vertices_sse2(),
+   which handles only directional lights with the infinite viewer model. */
+static int gl_can_shade_sse2(GLContext *c)
+{
+  GLLight *l;
+
+  if (c->local_light_model) return 0;
+  for(l=c->first_light;l!=nullptr;l=l->next) {
+    if (l->position.v[3] != 0 || l->spot_cutoff != 180) return 0;
+  }
+  return 1;
+}
+
+/* Returns min(max(a, 0), 1) in each lane, with the same result as clampf()
+   for -0 and NaN. */
+static inline __m128 clamp01_ps(__m128 a)
+{
+  return _mm_min_ps(_mm_set1_ps(1.0f), _mm_max_ps(_mm_setzero_ps(), a));
+}
+
+/* Returns a where mask is set, and b elsewhere. */
+static inline __m128 select_ps(__m128 mask, __m128 a, __m128 b)
+{
+  return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+/* Shades four vertices at once; see gl_shade_vertices().  The operations are
+   done in the same order as in gl_shade_vertex(). */
+static void gl_shade_vertices_sse2(GLContext *c,GLVertex *v,
+                                   int ambient_from_color,
+                                   int diffuse_from_color)
+{
+  GLMaterial *m;
+  GLLight *l;
+  __m128 nx,ny,nz,nw,cr,cg,cb,ca;
+  __m128 ma[3],md[4];
+  __m128 R,G,B,A;
+  __m128 zero = _mm_setzero_ps();
+  __m128 sign = _mm_set1_ps(-0.0f);
+  int twoside = c->light_model_two_side;
+  int i;
+
+  m=&c->materials[0];
+
+  nx=_mm_loadu_ps(v[0].normal.v);
+  ny=_mm_loadu_ps(v[1].normal.v);
+  nz=_mm_loadu_ps(v[2].normal.v);
+  nw=_mm_loadu_ps(v[3].normal.v);
+  _MM_TRANSPOSE4_PS(nx,ny,nz,nw);
+
+  cr=_mm_loadu_ps(v[0].color.v);
+  cg=_mm_loadu_ps(v[1].color.v);
+  cb=_mm_loadu_ps(v[2].color.v);
+  ca=_mm_loadu_ps(v[3].color.v);
+  _MM_TRANSPOSE4_PS(cr,cg,cb,ca);
+
+  /* With color material, each vertex has its own ambient and diffuse. */
+  if (ambient_from_color) {
+    ma[0]=cr; ma[1]=cg; ma[2]=cb;
+  } else {
+    for (i=0;i<3;i++) ma[i]=_mm_set1_ps(m->ambient.v[i]);
+  }
+  if (diffuse_from_color) {
+    md[0]=cr; md[1]=cg; md[2]=cb; md[3]=ca;
+  } else {
+    for (i=0;i<4;i++) md[i]=_mm_set1_ps(m->diffuse.v[i]);
+  }
+
+  R=_mm_add_ps(_mm_set1_ps(m->emission.v[0]),
+               _mm_mul_ps(ma[0],_mm_set1_ps(c->ambient_light_model.v[0])));
+  G=_mm_add_ps(_mm_set1_ps(m->emission.v[1]),
+               _mm_mul_ps(ma[1],_mm_set1_ps(c->ambient_light_model.v[1])));
+  B=_mm_add_ps(_mm_set1_ps(m->emission.v[2]),
+               _mm_mul_ps(ma[2],_mm_set1_ps(c->ambient_light_model.v[2])));
+  A=clamp01_ps(md[3]);
+
+  for(l=c->first_light;l!=nullptr;l=l->next) {
+    __m128 lR,lG,lB,dot,lit;
+    V3 d;
+
+    /* ambient */
+    lR=_mm_mul_ps(_mm_set1_ps(l->ambient.v[0]),ma[0]);
+    lG=_mm_mul_ps(_mm_set1_ps(l->ambient.v[1]),ma[1]);
+    lB=_mm_mul_ps(_mm_set1_ps(l->ambient.v[2]),ma[2]);
+
+    /* light at infinity */
+    d.v[0]=l->position.v[0];
+    d.v[1]=l->position.v[1];
+    d.v[2]=l->position.v[2];
+
+    dot=_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(d.v[0]),nx),
+                              _mm_mul_ps(_mm_set1_ps(d.v[1]),ny)),
+                   _mm_mul_ps(_mm_set1_ps(d.v[2]),nz));
+    if (twoside) dot=_mm_andnot_ps(sign,dot);
+    lit=_mm_cmpgt_ps(dot,zero);
+    if (_mm_movemask_ps(lit) != 0) {
+      /* diffuse light */
+      lR=select_ps(lit,_mm_add_ps(lR,_mm_mul_ps(_mm_mul_ps(dot,_mm_set1_ps(l->diffuse.v[0])),md[0])),lR);
+      lG=select_ps(lit,_mm_add_ps(lG,_mm_mul_ps(_mm_mul_ps(dot,_mm_set1_ps(l->diffuse.v[1])),md[1])),lG);
+      lB=select_ps(lit,_mm_add_ps(lB,_mm_mul_ps(_mm_mul_ps(dot,_mm_set1_ps(l->diffuse.v[2])),md[2])),lB);
+
+      /* specular light, for the infinite viewer */
+      V3 s;
+      __m128 dot_spec,spec;
+      PN_stdfloat tmp;
+      s.v[0]=d.v[0];
+      s.v[1]=d.v[1];
+      s.v[2]=d.v[2]+1.0f;
+      dot_spec=_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx,_mm_set1_ps(s.v[0])),
+                                     _mm_mul_ps(ny,_mm_set1_ps(s.v[1]))),
+                          _mm_mul_ps(nz,_mm_set1_ps(s.v[2])));
+      if (twoside) dot_spec=_mm_andnot_ps(sign,dot_spec);
+      spec=_mm_and_ps(lit,_mm_cmpgt_ps(dot_spec,zero));
+      int spec_mask=_mm_movemask_ps(spec);
+      if (spec_mask != 0) {
+        GLSpecBuf *specbuf;
+        PN_stdfloat dots[4];
+        tmp=sqrt(s.v[0]*s.v[0]+s.v[1]*s.v[1]+s.v[2]*s.v[2]);
+        if (tmp > 1E-3) {
+          dot_spec=_mm_div_ps(dot_spec,_mm_set1_ps(tmp));
+        }
+
+        /* The table lookup is done one vertex at a time. */
+        specbuf = specbuf_get_buffer(c, m->shininess_i, m->shininess);
+        _mm_storeu_ps(dots,dot_spec);
+        for (i=0;i<4;i++) {
+          if (spec_mask & (1<<i)) {
+            int idx = (int)(dots[i]*SPECULAR_BUFFER_SIZE);
+            if (idx > SPECULAR_BUFFER_SIZE) idx = SPECULAR_BUFFER_SIZE;
+            dots[i] = specbuf->buf[idx];
+          }
+        }
+        dot_spec=_mm_loadu_ps(dots);
+        lR=select_ps(spec,_mm_add_ps(lR,_mm_mul_ps(_mm_mul_ps(dot_spec,_mm_set1_ps(l->specular.v[0])),_mm_set1_ps(m->specular.v[0]))),lR);
+        lG=select_ps(spec,_mm_add_ps(lG,_mm_mul_ps(_mm_mul_ps(dot_spec,_mm_set1_ps(l->specular.v[1])),_mm_set1_ps(m->specular.v[1]))),lG);
+        lB=select_ps(spec,_mm_add_ps(lB,_mm_mul_ps(_mm_mul_ps(dot_spec,_mm_set1_ps(l->specular.v[2])),_mm_set1_ps(m->specular.v[2]))),lB);
+      }
+    }
+
+    /* the attenuation is 1 */
+    R=_mm_add_ps(R,lR);
+    G=_mm_add_ps(G,lG);
+    B=_mm_add_ps(B,lB);
+  }
+
+  cr=clamp01_ps(_mm_mul_ps(R,cr));
+  cg=clamp01_ps(_mm_mul_ps(G,cg));
+  cb=clamp01_ps(_mm_mul_ps(B,cb));
+  ca=clamp01_ps(_mm_mul_ps(A,ca));
+  _MM_TRANSPOSE4_PS(cr,cg,cb,ca);
+  _mm_storeu_ps(v[0].color.v,cr);
+  _mm_storeu_ps(v[1].color.v,cg);
+  _mm_storeu_ps(v[2].color.v,cb);
+  _mm_storeu_ps(v[3].color.v,ca);
+}
+#endif  /* TGL_FEATURE_SSE2 */
+
+/* Shades an array of vertices, as gl_shade_vertex() does for one.  If
+   ambient_from_color or diffuse_from_color is set, the material's ambient or
+   diffuse color is taken from each vertex's unlit color, as with
+   glColorMaterial.  Where possible, four vertices are shaded at a time. */
+void gl_shade_vertices(GLContext *c,GLVertex *v,int num_vertices,
+                       int ambient_from_color,int diffuse_from_color)
+{
+  int i = 0;
+
+#ifdef TGL_FEATURE_SSE2
+  if (gl_can_shade_sse2(c)) {
+    for (; i + 4 <= num_vertices; i += 4) {
+      gl_shade_vertices_sse2(c, v + i, ambient_from_color, diffuse_from_color);
+    }
+  }
+#endif
+
+  for (; i < num_vertices; ++i) {
+    if (ambient_from_color) {
+      c->materials[0].ambient = v[i].color;
+    }
+    if (diffuse_from_color) {
+      c->materials[0].diffuse = v[i].color;
+    }
+    gl_shade_vertex(c, &v[i]);
+  }
+}
@@ -0,0 +1,185 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_tiny_raster.cxx
+ * @author agent
+ * @date 2026-10-17
+ */
+
+/**
+ * A benchmark of the tinydisplay rasterizer, with and without
+ * td-raster-threads.  It renders a scene of many overlapping textured,
+ * smooth-shaded triangles, some of them alpha-blended, into an offscreen
+ * buffer of the TinyOffscreenGraphicsPipe, and checks that the threaded
+ * rendering produces exactly the same image.
+ *
+ * Usage: test_tiny_raster [triangles [size [frames]]]
+ */
+
+#include "pandabase.h"
+#include "tinyOffscreenGraphicsPipe.h"
+#include "graphicsEngine.h"
+#include "graphicsOutput.h"
+#include "displayRegion.h"
+#include "frameBufferProperties.h"
+#include "windowProperties.h"
+#include "camera.h"
+#include "perspectiveLens.h"
+#include "nodePath.h"
+#include "geomNode.h"
+#include "geom.h"
+#include "geomTriangles.h"
+#include "geomVertexWriter.h"
+#include "texture.h"
+#include "textureAttrib.h"
+#include "transparencyAttrib.h"
+#include "randomizer.h"
+#include "trueClock.h"
+#include "configVariableInt.h"
+
+using std::cerr;
+
+/**
+ * Returns a GeomNode with the indicated number of randomly placed triangles.
+ */
+static PT(GeomNode)
+make_triangles(Randomizer &random, int num_triangles) {
+  PT(GeomVertexData) data = new GeomVertexData
+    ("triangles", GeomVertexFormat::get_v3c4t2(), Geom::UH_static);
+  data->unclean_set_num_rows(num_triangles * 3);
+  GeomVertexWriter vertex(data, "vertex");
+  GeomVertexWriter color(data, "color");
+  GeomVertexWriter texcoord(data, "texcoord");
+
+  PT(GeomTriangles) tris = new GeomTriangles(Geom::UH_static);
+  for (int i = 0; i < num_triangles; ++i) {
+    LPoint3 center(random.random_real(40) - 20, random.random_real(40) + 20,
+                   random.random_real(30) - 15);
+    for (int j = 0; j < 3; ++j) {
+      vertex.add_data3(center + LVector3(random.random_real(12) - 6,
+                                         random.random_real(12) - 6,
+                                         random.random_real(12) - 6));
+      color.add_data4(random.random_real(1), random.random_real(1),
+                      random.random_real(1), random.random_real(1));
+      texcoord.add_data2(random.random_real(4), random.random_real(4));
+    }
+    tris->add_vertices(i * 3, i * 3 + 1, i * 3 + 2);
+  }
+
+  PT(Geom) geom = new Geom(data);
+  geom->add_primitive(tris);
+  PT(GeomNode) node = new GeomNode("triangles");
+  node->add_geom(geom);
+  return node;
+}
+
+/**
+ * Returns a small checkerboard texture.
+ */
+static PT(Texture)
+make_texture() {
+  PT(Texture) tex = new Texture("checker");
+  tex->setup_2d_texture(64, 64, Texture::T_unsigned_byte, Texture::F_rgba8);
+  PTA_uchar image = tex->modify_ram_image();
+  for (int y = 0; y < 64; ++y) {
+    for (int x = 0; x < 64; ++x) {
+      unsigned char value = (((x >> 3) ^ (y >> 3)) & 1) ? 255 : 128;
+      unsigned char *p = &image[(y * 64 + x) * 4];
+      p[0] = value;
+      p[1] = (unsigned char)(x * 4);
+      p[2] = (unsigned char)(y * 4);
+      p[3] = 255;
+    }
+  }
+  return tex;
+}
+
+/**
+ * Returns true if the two images have the same contents.
+ */
+static bool
+same_image(Texture *a, Texture *b) {
+  CPTA_uchar a_image = a->get_ram_image();
+  CPTA_uchar b_image = b->get_ram_image();
+  return a_image.size() == b_image.size() &&
+    memcmp(a_image.p(), b_image.p(), a_image.size()) == 0;
+}
+
+/**
+ * Renders the indicated number of frames, and returns the average number of
+ * seconds per frame.
+ */
+static double
+render_frames(GraphicsEngine *engine, int num_frames) {
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+  for (int i = 0; i < num_frames; ++i) {
+    engine->render_frame();
+  }
+  engine->sync_frame();
+  return (clock->get_short_time() - start) / num_frames;
+}
+
+int
+main(int argc, char *argv[]) {
+  int num_triangles = (argc > 1) ? atoi(argv[1]) : 20000;
+  int size = (argc > 2) ? atoi(argv[2]) : 1024;
+  int num_frames = (argc > 3) ? atoi(argv[3]) : 10;
+
+  PT(GraphicsPipe) pipe = new TinyOffscreenGraphicsPipe;
+  PT(GraphicsEngine) engine = new GraphicsEngine;
+
+  FrameBufferProperties fb_prop;
+  fb_prop.set_rgb_color(true);
+  fb_prop.set_depth_bits(1);
+  GraphicsOutput *buffer = engine->make_output
+    (pipe, "raster", 0, fb_prop, WindowProperties::size(size, size),
+     GraphicsPipe::BF_refuse_window);
+  if (buffer == nullptr) {
+    cerr << "ERROR: couldn't open an offscreen buffer\n";
+    return 1;
+  }
+
+  // Half of the triangles are opaque, and the other half are blended over
+  // them, in the order they are drawn.
+  NodePath render("render");
+  Randomizer random(1);
+  NodePath opaque = render.attach_new_node(make_triangles(random, num_triangles / 2));
+  NodePath blended = render.attach_new_node(make_triangles(random, num_triangles / 2));
+  blended.set_transparency(TransparencyAttrib::M_alpha);
+  blended.set_bin("fixed", 0);
+  render.set_texture(make_texture());
+
+  PT(Camera) camera = new Camera("camera", new PerspectiveLens);
+  NodePath camera_np = render.attach_new_node(camera);
+  buffer->make_display_region()->set_camera(camera_np);
+  buffer->set_clear_color_active(true);
+  buffer->set_clear_depth_active(true);
+
+  // Render one frame serially first, as the reference.
+  ConfigVariableInt raster_threads("td-raster-threads");
+  raster_threads.set_value(1);
+  render_frames(engine, 1);
+  PT(Texture) reference = buffer->get_screenshot();
+
+  cerr << "threads   ms per frame   identical\n";
+  for (int threads = 1; threads >= 0; --threads) {
+    raster_threads.set_value(threads);
+    double elapsed = render_frames(engine, num_frames);
+    PT(Texture) image = buffer->get_screenshot();
+    bool identical = same_image(image, reference);
+    fprintf(stderr, "%7s %14.2f %11s\n", threads ? "1" : "all",
+            elapsed * 1000.0, identical ? "yes" : "NO");
+    if (!identical) {
+      return 1;
+    }
+  }
+
+  engine->remove_all_windows();
+  return 0;
+}
@@ -35,10 +35,12 @@
 #include "bitMask.h"
 #include "samplerState.h"
 #include "zgl.h"
+#include "jobGroup.h"
 #include "zmath.h"
 #include "ztriangle_table.h"
 #include "store_pixel_table.h"
 #include "graphicsEngine.h"
+#include "cullBinManager.h"
 
 using std::max;
 using std::min;
@@ -135,6 +137,16 @@ reset() {
   _filled_flat = false;
   _auto_rescale_normal = false;
 
+  if (td_sort_opaque_front_to_back) {
+    // Drawing the nearest opaque geometry first lets the hierarchical z
+    // buffer reject more of the hidden spans.
+    CullBinManager *bin_manager = CullBinManager::get_global_ptr();
+    int bin_index = bin_manager->find_bin("opaque");
+    if (bin_index != -1) {
+      bin_manager->set_bin_type(bin_index, CullBinManager::BT_front_to_back);
+    }
+  }
+
   // Now that the GSG has been initialized, make it available for
   // optimizations.
   add_gsg(this);
@@ -687,61 +699,73 @@ begin_draw_primitives(const GeomPipelineReader *geom_reader,
 
   bool lighting_enabled = (needs_normal && _c->lighting_enabled);
 
-  for (i = 0; i < num_used_vertices; ++i) {
-    GLVertex *v = &_vertices[i];
-    const LVecBase4 &d = rvertex.get_data4();
-
-    v->coord.v[0] = d[0];
-    v->coord.v[1] = d[1];
-    v->coord.v[2] = d[2];
-    v->coord.v[3] = d[3];
-
-    // Texture coordinates.
-    for (int si = 0; si < max_stage_index; ++si) {
-      (*texgen_func[si])(v->tex_coord[si], tcdata[si]);
-    }
+  // The vertices are processed in batches that stay in the cache, between
+  // reading them and transforming them.
+  static const int vertex_batch_size = 64;
+  int cmf = needs_color ? _color_material_flags : 0;
+  for (int first = 0; first < num_used_vertices; first += vertex_batch_size) {
+    int end = min(first + vertex_batch_size, num_used_vertices);
+    for (i = first; i < end; ++i) {
+      GLVertex *v = &_vertices[i];
+      const LVecBase4 &d = rvertex.get_data4();
+
+      v->coord.v[0] = d[0];
+      v->coord.v[1] = d[1];
+      v->coord.v[2] = d[2];
+      v->coord.v[3] = d[3];
+
+      // Texture coordinates.
+      for (int si = 0; si < max_stage_index; ++si) {
+        (*texgen_func[si])(v->tex_coord[si], tcdata[si]);
+      }
 
-    if (needs_color) {
-      const LColor &d = rcolor.get_data4();
-      const LColor &s = _current_color_scale;
-      _c->current_color.v[0] = max(d[0] * s[0], (PN_stdfloat)0);
-      _c->current_color.v[1] = max(d[1] * s[1], (PN_stdfloat)0);
-      _c->current_color.v[2] = max(d[2] * s[2], (PN_stdfloat)0);
-      _c->current_color.v[3] = max(d[3] * s[3], (PN_stdfloat)0);
-
-      if (_color_material_flags) {
-        if (_color_material_flags & CMF_ambient) {
-          _c->materials[0].ambient = _c->current_color;
-          _c->materials[1].ambient = _c->current_color;
-        }
-        if (_color_material_flags & CMF_diffuse) {
-          _c->materials[0].diffuse = _c->current_color;
-          _c->materials[1].diffuse = _c->current_color;
+      if (needs_color) {
+        const LColor &d = rcolor.get_data4();
+        const LColor &s = _current_color_scale;
+        _c->current_color.v[0] = max(d[0] * s[0], (PN_stdfloat)0);
+        _c->current_color.v[1] = max(d[1] * s[1], (PN_stdfloat)0);
+        _c->current_color.v[2] = max(d[2] * s[2], (PN_stdfloat)0);
+        _c->current_color.v[3] = max(d[3] * s[3], (PN_stdfloat)0);
+
+        if (_color_material_flags) {
+          if (_color_material_flags & CMF_ambient) {
+            _c->materials[0].ambient = _c->current_color;
+            _c->materials[1].ambient = _c->current_color;
+          }
+          if (_color_material_flags & CMF_diffuse) {
+            _c->materials[0].diffuse = _c->current_color;
+            _c->materials[1].diffuse = _c->current_color;
+          }
         }
       }
-    }
-
-    v->color = _c->current_color;
 
-    if (lighting_enabled) {
-      const LVecBase3 &d = rnormal.get_data3();
-      _c->current_normal.v[0] = d[0];
-      _c->current_normal.v[1] = d[1];
-      _c->current_normal.v[2] = d[2];
-      _c->current_normal.v[3] = 0.0f;
+      v->color = _c->current_color;
 
-      gl_vertex_transform(_c, v);
-      gl_shade_vertex(_c, v);
+      if (lighting_enabled) {
+        // The untransformed normal is stored in the vertex for now.
+        const LVecBase3 &d = rnormal.get_data3();
+        v->normal.v[0] = d[0];
+        v->normal.v[1] = d[1];
+        v->normal.v[2] = d[2];
+      }
 
-    } else {
-      gl_vertex_transform(_c, v);
+      v->edge_flag = 1;
     }
 
-    if (v->clip_code == 0) {
-      gl_transform_to_viewport(_c, v);
+    // Now transform, light and clip this batch of vertices, several at a
+    // time.
+    gl_transform_vertices(_c, _vertices + first, end - first, lighting_enabled);
+    if (lighting_enabled) {
+      gl_shade_vertices(_c, _vertices + first, end - first,
+                        (cmf & CMF_ambient) != 0, (cmf & CMF_diffuse) != 0);
     }
 
-    v->edge_flag = 1;
+    for (i = first; i < end; ++i) {
+      GLVertex *v = &_vertices[i];
+      if (v->clip_code == 0) {
+        gl_transform_to_viewport(_c, v);
+      }
+    }
   }
 
   // Set up the appropriate function callback for filling triangles, according
@@ -937,6 +961,21 @@ begin_draw_primitives(const GeomPipelineReader *geom_reader,
   pixel_count_smooth_multitex3 = 0;
 #endif  // DO_PSTATS
 
+  // If we have threads to spare, collect the filled triangles into bands of
+  // the frame buffer, to be rasterized in parallel by end_draw_primitives().
+  int num_threads = td_raster_threads;
+  if (num_threads <= 0) {
+    num_threads = JobGroup::get_num_threads() + 1;
+  } else {
+    num_threads = min(num_threads, JobGroup::get_num_threads() + 1);
+  }
+  if (num_threads > 1) {
+    ZB_initBins(&_bins, _c->zb, num_threads);
+    _c->zb_bins = &_bins;
+  } else {
+    _c->zb_bins = nullptr;
+  }
+
   return true;
 }
 
@@ -1319,6 +1358,10 @@ draw_points(const GeomPrimitivePipelineReader *reader, bool force) {
  */
 void TinyGraphicsStateGuardian::
 end_draw_primitives() {
+  if (_c->zb_bins != nullptr) {
+    ZB_flushBins(_c->zb_bins);
+    _c->zb_bins = nullptr;
+  }
 
 #ifdef DO_PSTATS
   _pixel_count_white_untextured_pcollector.add_level(pixel_count_white_untextured);
@@ -22,6 +22,7 @@
 #include "zmath.h"
 #include "zbuffer.h"
 #include "zgl.h"
+#include "zbin.h"
 #include "geomVertexReader.h"
 
 class TinyTextureContext;
@@ -153,6 +154,7 @@ private:
   ZBuffer *_aux_frame_buffer;
 
   GLContext *_c;
+  ZBins _bins;
 
   enum ColorMaterialFlags {
     CMF_ambient   = 0x001,
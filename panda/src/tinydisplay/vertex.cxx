@@ -82,3 +82,186 @@ gl_vertex_transform(GLContext * c, GLVertex * v) {
 
   v->clip_code = gl_clipcode(v->pc.v[0], v->pc.v[1], v->pc.v[2], v->pc.v[3]);
 }
+
+#ifdef TGL_FEATURE_SSE2
+/* Loads the same four-component vector from four vertices, transposed so
+   that each register holds one component of all four. */
+static inline void
+load_transposed(const PN_stdfloat *a, const PN_stdfloat *b,
+                const PN_stdfloat *c, const PN_stdfloat *d,
+                __m128 &x, __m128 &y, __m128 &z, __m128 &w) {
+  x = _mm_loadu_ps(a);
+  y = _mm_loadu_ps(b);
+  z = _mm_loadu_ps(c);
+  w = _mm_loadu_ps(d);
+  _MM_TRANSPOSE4_PS(x, y, z, w);
+}
+
+/* The reverse of load_transposed(). */
+static inline void
+store_transposed(PN_stdfloat *a, PN_stdfloat *b, PN_stdfloat *c, PN_stdfloat *d,
+                 __m128 x, __m128 y, __m128 z, __m128 w) {
+  _MM_TRANSPOSE4_PS(x, y, z, w);
+  _mm_storeu_ps(a, x);
+  _mm_storeu_ps(b, y);
+  _mm_storeu_ps(c, z);
+  _mm_storeu_ps(d, w);
+}
+
+/* Returns one row of a matrix times four points, with W = 1.  The terms are
+   added in the same order as in gl_vertex_transform(). */
+static inline __m128
+transform_point_row(const PN_stdfloat *m, __m128 x, __m128 y, __m128 z) {
+  __m128 r = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(m[0])),
+                        _mm_mul_ps(y, _mm_set1_ps(m[1])));
+  r = _mm_add_ps(r, _mm_mul_ps(z, _mm_set1_ps(m[2])));
+  return _mm_add_ps(r, _mm_set1_ps(m[3]));
+}
+
+static inline __m128
+transform_vec4_row(const PN_stdfloat *m, __m128 x, __m128 y, __m128 z, __m128 w) {
+  __m128 r = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(m[0])),
+                        _mm_mul_ps(y, _mm_set1_ps(m[1])));
+  r = _mm_add_ps(r, _mm_mul_ps(z, _mm_set1_ps(m[2])));
+  return _mm_add_ps(r, _mm_mul_ps(w, _mm_set1_ps(m[3])));
+}
+
+static inline __m128
+transform_vec3_row(const PN_stdfloat *m, __m128 x, __m128 y, __m128 z) {
+  __m128 r = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(m[0])),
+                        _mm_mul_ps(y, _mm_set1_ps(m[1])));
+  return _mm_add_ps(r, _mm_mul_ps(z, _mm_set1_ps(m[2])));
+}
+
+/* Returns the indicated clip code bit in each lane for which mask is set. */
+static inline __m128i
+clip_bit(__m128 mask, int bit) {
+  return _mm_and_si128(_mm_castps_si128(mask), _mm_set1_epi32(bit));
+}
+
+/* Transforms four vertices at once; see gl_transform_vertices(). */
+static void
+gl_transform_vertices_sse2(GLContext *c, GLVertex *v, int with_normals) {
+  const PN_stdfloat *m;
+  __m128 x, y, z, w;
+  __m128 px, py, pz, pw;
+
+  load_transposed(v[0].coord.v, v[1].coord.v, v[2].coord.v, v[3].coord.v,
+                  x, y, z, w);
+
+  if (c->lighting_enabled) {
+    __m128 ex, ey, ez, ew;
+
+    m = &c->matrix_model_view.m[0][0];
+    ex = transform_point_row(m, x, y, z);
+    ey = transform_point_row(m + 4, x, y, z);
+    ez = transform_point_row(m + 8, x, y, z);
+    ew = transform_point_row(m + 12, x, y, z);
+    store_transposed(v[0].ec.v, v[1].ec.v, v[2].ec.v, v[3].ec.v,
+                     ex, ey, ez, ew);
+
+    m = &c->matrix_projection.m[0][0];
+    px = transform_vec4_row(m, ex, ey, ez, ew);
+    py = transform_vec4_row(m + 4, ex, ey, ez, ew);
+    pz = transform_vec4_row(m + 8, ex, ey, ez, ew);
+    pw = transform_vec4_row(m + 12, ex, ey, ez, ew);
+
+    if (with_normals) {
+      __m128 nx, ny, nz, nw;
+      __m128 scale = _mm_set1_ps(c->normal_scale);
+
+      /* The normal is followed by the coord in GLVertex, so it is safe to
+         load four components of it. */
+      load_transposed(v[0].normal.v, v[1].normal.v, v[2].normal.v,
+                      v[3].normal.v, nx, ny, nz, nw);
+      m = &c->matrix_model_view_inv.m[0][0];
+      __m128 tx = _mm_mul_ps(transform_vec3_row(m, nx, ny, nz), scale);
+      __m128 ty = _mm_mul_ps(transform_vec3_row(m + 4, nx, ny, nz), scale);
+      __m128 tz = _mm_mul_ps(transform_vec3_row(m + 8, nx, ny, nz), scale);
+
+      if (c->normalize_enabled) {
+        /* As in gl_V3_Norm(), a normal of zero length is left alone. */
+        __m128 len = _mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, tx), _mm_mul_ps(ty, ty)),
+                                _mm_mul_ps(tz, tz));
+        len = _mm_sqrt_ps(len);
+        __m128 nonzero = _mm_cmpneq_ps(len, _mm_setzero_ps());
+        tx = _mm_or_ps(_mm_and_ps(nonzero, _mm_div_ps(tx, len)),
+                       _mm_andnot_ps(nonzero, tx));
+        ty = _mm_or_ps(_mm_and_ps(nonzero, _mm_div_ps(ty, len)),
+                       _mm_andnot_ps(nonzero, ty));
+        tz = _mm_or_ps(_mm_and_ps(nonzero, _mm_div_ps(tz, len)),
+                       _mm_andnot_ps(nonzero, tz));
+      }
+
+      /* Only three components may be stored, or we would overwrite the
+         coord. */
+      PN_stdfloat normals[4][4];
+      store_transposed(normals[0], normals[1], normals[2], normals[3],
+                       tx, ty, tz, nw);
+      for (int i = 0; i < 4; ++i) {
+        v[i].normal.v[0] = normals[i][0];
+        v[i].normal.v[1] = normals[i][1];
+        v[i].normal.v[2] = normals[i][2];
+      }
+    }
+  } else {
+    /* NOTE: W = 1 is assumed */
+    m = &c->matrix_model_projection.m[0][0];
+    px = transform_point_row(m, x, y, z);
+    py = transform_point_row(m + 4, x, y, z);
+    pz = transform_point_row(m + 8, x, y, z);
+    if (c->matrix_model_projection_no_w_transform) {
+      pw = _mm_set1_ps(m[15]);
+    } else {
+      pw = transform_point_row(m + 12, x, y, z);
+    }
+  }
+
+  /* The clip codes, as computed by gl_clipcode(). */
+  __m128 cw = _mm_mul_ps(pw, _mm_set1_ps(1.0f + CLIP_EPSILON));
+  __m128 ncw = _mm_xor_ps(cw, _mm_set1_ps(-0.0f));
+  __m128i code = clip_bit(_mm_cmplt_ps(px, ncw), 1);
+  code = _mm_or_si128(code, clip_bit(_mm_cmpgt_ps(px, cw), 2));
+  code = _mm_or_si128(code, clip_bit(_mm_cmplt_ps(py, ncw), 4));
+  code = _mm_or_si128(code, clip_bit(_mm_cmpgt_ps(py, cw), 8));
+  code = _mm_or_si128(code, clip_bit(_mm_cmplt_ps(pz, ncw), 16));
+  code = _mm_or_si128(code, clip_bit(_mm_cmpgt_ps(pz, cw), 32));
+
+  store_transposed(v[0].pc.v, v[1].pc.v, v[2].pc.v, v[3].pc.v, px, py, pz, pw);
+
+  int codes[4];
+  _mm_storeu_si128((__m128i *)codes, code);
+  v[0].clip_code = codes[0];
+  v[1].clip_code = codes[1];
+  v[2].clip_code = codes[2];
+  v[3].clip_code = codes[3];
+}
+#endif  /* TGL_FEATURE_SSE2 */
+
+/*
+ * Transforms an array of vertices, as gl_vertex_transform() does for one.  If
+ * with_normals is set, each vertex's normal holds the untransformed normal on
+ * entry, rather than c->current_normal.  Vertices are processed four at a
+ * time where SSE2 is available.
+ */
+void
+gl_transform_vertices(GLContext *c, GLVertex *v, int num_vertices,
+                      int with_normals) {
+  int i = 0;
+
+#ifdef TGL_FEATURE_SSE2
+  for (; i + 4 <= num_vertices; i += 4) {
+    gl_transform_vertices_sse2(c, v + i, with_normals);
+  }
+#endif
+
+  for (; i < num_vertices; ++i) {
+    if (with_normals) {
+      c->current_normal.v[0] = v[i].normal.v[0];
+      c->current_normal.v[1] = v[i].normal.v[1];
+      c->current_normal.v[2] = v[i].normal.v[2];
+      c->current_normal.v[3] = 0.0f;
+    }
+    gl_vertex_transform(c, &v[i]);
+  }
+}
@@ -0,0 +1,136 @@
+/*
+ * Binned triangle rasterization: see zbin.h.
+ */
+#include "zbin.h"
+#include "jobGroup.h"
+#include "pnotify.h"
+
+using std::max;
+using std::min;
+
+/* Each thread gets several bands, so that the work still balances when the
+   geometry is concentrated in part of the frame. */
+static const int bands_per_thread = 4;
+static const int min_band_height = 16;
+
+/* The triangles are filled once this many are pending, to bound the memory
+   used by the bins. */
+static const size_t max_binned_triangles = 4096;
+
+/* If the pending triangles cover fewer rows than this, it is not worth
+   waking up the other threads. */
+static const int min_parallel_rows = 512;
+
+static void ZB_fillBand(size_t band, void *data);
+
+/*
+ * Prepares the bins to collect triangles for the indicated frame buffer,
+ * to be filled with the indicated number of threads.  There must not be any
+ * triangles pending.
+ */
+void
+ZB_initBins(ZBins *bins, ZBuffer *zb, int num_threads) {
+  nassertv(bins->triangles.empty());
+
+  int num_bands = max(min(num_threads * bands_per_thread,
+                          zb->ysize / min_band_height), 1);
+
+  bins->zb = zb;
+  bins->num_bands = num_bands;
+  /* The bands are aligned to the tiles of the hierarchical z buffer, so
+     that each tile is only touched by one thread. */
+  bins->band_height = (zb->ysize + num_bands - 1) / num_bands;
+  bins->band_height = (bins->band_height + ZB_HIZ_TILE_SIZE - 1) & ~(ZB_HIZ_TILE_SIZE - 1);
+  bins->num_rows = 0;
+  if ((int)bins->bands.size() < num_bands) {
+    bins->bands.resize(num_bands);
+  }
+}
+
+/*
+ * Records a triangle, along with the function that will fill it, in each of
+ * the bands it touches.  The points are copied, since the fill functions
+ * modify them.
+ */
+void
+ZB_binTriangle(ZBins *bins, ZB_fillTriangleFunc fill_tri,
+               ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint *p2) {
+  int ymin = min(p0->y, min(p1->y, p2->y));
+  int ymax = max(p0->y, max(p1->y, p2->y));
+  ymin = max(ymin, 0);
+  ymax = min(ymax, bins->zb->ysize - 1);
+  if (ymin > ymax) {
+    return;
+  }
+
+  int index = (int)bins->triangles.size();
+  bins->triangles.push_back(ZBinTriangle());
+  ZBinTriangle &tri = bins->triangles.back();
+  tri.fill_tri = fill_tri;
+  tri.p0 = *p0;
+  tri.p1 = *p1;
+  tri.p2 = *p2;
+
+  int first = ymin / bins->band_height;
+  int last = ymax / bins->band_height;
+  for (int b = first; b <= last; ++b) {
+    bins->bands[b].push_back(index);
+  }
+  bins->num_rows += ymax - ymin + 1;
+
+  if (bins->triangles.size() >= max_binned_triangles) {
+    ZB_flushBins(bins);
+  }
+}
+
+/*
+ * Fills all of the pending triangles into the frame buffer, and empties the
+ * bins.
+ */
+void
+ZB_flushBins(ZBins *bins) {
+  if (bins->triangles.empty()) {
+    return;
+  }
+
+  if (bins->num_rows < min_parallel_rows) {
+    // Just fill them in this thread, in order.
+    pvector<ZBinTriangle>::iterator ti;
+    for (ti = bins->triangles.begin(); ti != bins->triangles.end(); ++ti) {
+      (*(*ti).fill_tri)(bins->zb, &(*ti).p0, &(*ti).p1, &(*ti).p2);
+    }
+  } else {
+    JobGroup group(bins->num_bands, &ZB_fillBand, bins);
+    group.wait();
+  }
+
+  bins->triangles.clear();
+  for (int b = 0; b < bins->num_bands; ++b) {
+    bins->bands[b].clear();
+  }
+  bins->num_rows = 0;
+}
+
+/*
+ * The JobGroup function that fills the triangles binned to the indicated
+ * band, restricting the fill functions to the rows of that band.
+ */
+static void
+ZB_fillBand(size_t band, void *data) {
+  const ZBins *bins = (const ZBins *)data;
+  const pvector<int> &indices = bins->bands[band];
+  if (indices.empty()) {
+    return;
+  }
+
+  ZBuffer zb = *bins->zb;
+  zb.ymin = (int)band * bins->band_height;
+  zb.ymax = min(zb.ymin + bins->band_height, zb.ysize);
+
+  pvector<int>::const_iterator ii;
+  for (ii = indices.begin(); ii != indices.end(); ++ii) {
+    // Each band works on its own copy of the points.
+    ZBinTriangle tri = bins->triangles[*ii];
+    (*tri.fill_tri)(&zb, &tri.p0, &tri.p1, &tri.p2);
+  }
+}
@@ -0,0 +1,41 @@
+#ifndef _tgl_zbin_h_
+#define _tgl_zbin_h_
+
+/*
+ * Binned triangle rasterization.  Filled triangles are collected into
+ * horizontal bands of the frame buffer as they are drawn, and the bands are
+ * later filled in parallel, each by one thread.  Since the bands do not
+ * overlap and each band fills its triangles in the order they were drawn,
+ * the result is the same as filling them one at a time.
+ *
+ * The fill state in the ZBuffer (textures, blending, alpha reference) must
+ * not change while triangles are pending; call ZB_flushBins() first.
+ */
+
+#include "zbuffer.h"
+#include "pvector.h"
+
+typedef struct ZBinTriangle {
+  ZB_fillTriangleFunc fill_tri;
+  ZBufferPoint p0, p1, p2;
+} ZBinTriangle;
+
+typedef struct ZBins {
+  ZBuffer *zb;
+  int num_bands;
+  int band_height;
+
+  /* the total number of rows covered by the pending triangles */
+  int num_rows;
+
+  pvector<ZBinTriangle> triangles;
+  /* for each band, the indices of the triangles that touch it */
+  pvector<pvector<int> > bands;
+} ZBins;
+
+void ZB_initBins(ZBins *bins, ZBuffer *zb, int num_threads);
+void ZB_binTriangle(ZBins *bins, ZB_fillTriangleFunc fill_tri,
+                    ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint *p2);
+void ZB_flushBins(ZBins *bins);
+
+#endif /* _tgl_zbin_h_ */
@@ -11,22 +11,57 @@
 #include "pnotify.h"
 
 #ifdef DO_PSTATS
-int pixel_count_white_untextured;
-int pixel_count_flat_untextured;
-int pixel_count_smooth_untextured;
-int pixel_count_white_textured;
-int pixel_count_flat_textured;
-int pixel_count_smooth_textured;
-int pixel_count_white_perspective;
-int pixel_count_flat_perspective;
-int pixel_count_smooth_perspective;
-int pixel_count_smooth_multitex2;
-int pixel_count_smooth_multitex3;
+AtomicAdjust::Integer pixel_count_white_untextured;
+AtomicAdjust::Integer pixel_count_flat_untextured;
+AtomicAdjust::Integer pixel_count_smooth_untextured;
+AtomicAdjust::Integer pixel_count_white_textured;
+AtomicAdjust::Integer pixel_count_flat_textured;
+AtomicAdjust::Integer pixel_count_smooth_textured;
+AtomicAdjust::Integer pixel_count_white_perspective;
+AtomicAdjust::Integer pixel_count_flat_perspective;
+AtomicAdjust::Integer pixel_count_smooth_perspective;
+AtomicAdjust::Integer pixel_count_smooth_multitex2;
+AtomicAdjust::Integer pixel_count_smooth_multitex3;
 #endif  // DO_PSTATS
 
 using std::max;
 using std::min;
 
+/*
+ * Allocates the hierarchical z buffer to match the size of the zbuffer.
+ * Its contents are not yet known, so every bound is 0.  Returns 0 on
+ * failure.
+ */
+static int
+ZB_hizAlloc(ZBuffer *zb) {
+  int num_tiles;
+
+  zb->hiz_xsize = (zb->xsize + ZB_HIZ_TILE_SIZE - 1) >> ZB_HIZ_TILE_BITS;
+  zb->hiz_ysize = (zb->ysize + ZB_HIZ_TILE_SIZE - 1) >> ZB_HIZ_TILE_BITS;
+  num_tiles = zb->hiz_xsize * zb->hiz_ysize;
+
+  zb->hiz_min = (ZPOINT *)gl_malloc(num_tiles * sizeof(ZPOINT));
+  zb->hiz_dirty = (unsigned char *)gl_malloc(num_tiles);
+  if (zb->hiz_min == nullptr || zb->hiz_dirty == nullptr) {
+    gl_free(zb->hiz_min);
+    gl_free(zb->hiz_dirty);
+    zb->hiz_min = nullptr;
+    zb->hiz_dirty = nullptr;
+    return 0;
+  }
+  memset(zb->hiz_min, 0, num_tiles * sizeof(ZPOINT));
+  memset(zb->hiz_dirty, 1, num_tiles);
+  return 1;
+}
+
+static void
+ZB_hizFree(ZBuffer *zb) {
+  gl_free(zb->hiz_min);
+  gl_free(zb->hiz_dirty);
+  zb->hiz_min = nullptr;
+  zb->hiz_dirty = nullptr;
+}
+
 ZBuffer *
 ZB_open(int xsize, int ysize, int mode,
         int nb_colors,
@@ -46,6 +81,8 @@ ZB_open(int xsize, int ysize, int mode,
 
   zb->xsize = xsize;
   zb->ysize = ysize;
+  zb->ymin = 0;
+  zb->ymax = ysize;
   zb->mode = mode;
   zb->linesize = (xsize * PSZB + 3) & ~3;
 
@@ -74,9 +111,15 @@ ZB_open(int xsize, int ysize, int mode,
   if (zb->zbuf == nullptr)
     goto error;
 
+  if (!ZB_hizAlloc(zb)) {
+    gl_free(zb->zbuf);
+    goto error;
+  }
+
   if (frame_buffer == nullptr) {
     zb->pbuf = (PIXEL *)gl_malloc(zb->ysize * zb->linesize);
     if (zb->pbuf == nullptr) {
+      ZB_hizFree(zb);
       gl_free(zb->zbuf);
       goto error;
     }
@@ -102,6 +145,7 @@ ZB_close(ZBuffer * zb) {
   if (zb->frame_buffer_allocated)
     gl_free(zb->pbuf);
 
+  ZB_hizFree(zb);
   gl_free(zb->zbuf);
   gl_free(zb);
 }
@@ -117,11 +161,15 @@ ZB_resize(ZBuffer * zb, void *frame_buffer, int xsize, int ysize) {
 
   zb->xsize = xsize;
   zb->ysize = ysize;
+  zb->ymin = 0;
+  zb->ymax = ysize;
   zb->linesize = (xsize * PSZB + 3) & ~3;
 
   size = zb->xsize * zb->ysize * sizeof(ZPOINT);
   gl_free(zb->zbuf);
   zb->zbuf = (ZPOINT *)gl_malloc(size);
+  ZB_hizFree(zb);
+  ZB_hizAlloc(zb);
 
   if (zb->frame_buffer_allocated)
     gl_free(zb->pbuf);
@@ -306,6 +354,11 @@ void ZB_zoomFrameBuffer(ZBuffer *dest, int dest_xmin, int dest_ymin, int dest_xs
       tz[tx] = fz[fx];
     }
   }
+
+  if (dest_xsize > 0 && dest_ysize > 0) {
+    ZB_hizReset(dest, dest_xmin, dest_ymin,
+                dest_xmin + dest_xsize - 1, dest_ymin + dest_ysize - 1);
+  }
 }
 
 
@@ -395,6 +448,10 @@ ZB_clear(ZBuffer * zb, int clear_z, ZPOINT z, int clear_color, PIXEL color) {
 
   if (clear_z) {
     memset(zb->zbuf, 0, zb->xsize * zb->ysize * sizeof(ZPOINT));
+
+    /* Every tile now holds exactly 0. */
+    memset(zb->hiz_min, 0, zb->hiz_xsize * zb->hiz_ysize * sizeof(ZPOINT));
+    memset(zb->hiz_dirty, 0, zb->hiz_xsize * zb->hiz_ysize);
   }
   if (clear_color) {
     pp = zb->pbuf;
@@ -423,6 +480,19 @@ ZB_clear_viewport(ZBuffer * zb, int clear_z, ZPOINT z, int clear_color, PIXEL co
       memset(zz, 0, xsize * sizeof(ZPOINT));
       zz += zb->xsize;
     }
+
+    /* Each tile that was even partly cleared now has a minimum of exactly
+       0. */
+    if (xsize > 0 && ysize > 0) {
+      int tx0 = xmin >> ZB_HIZ_TILE_BITS;
+      int tx1 = (xmin + xsize - 1) >> ZB_HIZ_TILE_BITS;
+      int ty1 = (ymin + ysize - 1) >> ZB_HIZ_TILE_BITS;
+      for (int ty = ymin >> ZB_HIZ_TILE_BITS; ty <= ty1; ++ty) {
+        int tile = ty * zb->hiz_xsize + tx0;
+        memset(zb->hiz_min + tile, 0, (tx1 - tx0 + 1) * sizeof(ZPOINT));
+        memset(zb->hiz_dirty + tile, 0, tx1 - tx0 + 1);
+      }
+    }
   }
   if (clear_color) {
     pp = zb->pbuf + xmin + ymin * (zb->linesize / PSZB);
@@ -433,6 +503,83 @@ ZB_clear_viewport(ZBuffer * zb, int clear_z, ZPOINT z, int clear_color, PIXEL co
   }
 }
 
+/*
+ * Forgets the bounds of the hierarchical z buffer tiles that overlap the
+ * indicated rectangle (inclusive), after depth values have been written
+ * there that might be farther than before.  Only the rows from zb->ymin to
+ * zb->ymax are affected.
+ */
+void
+ZB_hizReset(ZBuffer *zb, int xmin, int ymin, int xmax, int ymax) {
+  xmin = max(xmin, 0);
+  xmax = min(xmax, zb->xsize - 1);
+  ymin = max(ymin, zb->ymin);
+  ymax = min(ymax, zb->ymax - 1);
+  if (xmin > xmax || ymin > ymax) {
+    return;
+  }
+
+  int tx0 = xmin >> ZB_HIZ_TILE_BITS;
+  int tx1 = xmax >> ZB_HIZ_TILE_BITS;
+  int ty1 = ymax >> ZB_HIZ_TILE_BITS;
+  for (int ty = ymin >> ZB_HIZ_TILE_BITS; ty <= ty1; ++ty) {
+    int tile = ty * zb->hiz_xsize + tx0;
+    memset(zb->hiz_min + tile, 0, (tx1 - tx0 + 1) * sizeof(ZPOINT));
+    memset(zb->hiz_dirty + tile, 1, tx1 - tx0 + 1);
+  }
+}
+
+/*
+ * Marks the hierarchical z buffer tiles that overlap the indicated rectangle
+ * (inclusive) as out of date, after nearer depth values have been written
+ * there.  Their bounds remain valid, but may no longer be the tightest.
+ * Only the rows from zb->ymin to zb->ymax are affected.
+ */
+void
+ZB_hizTouch(ZBuffer *zb, int xmin, int ymin, int xmax, int ymax) {
+  xmin = max(xmin, 0);
+  xmax = min(xmax, zb->xsize - 1);
+  ymin = max(ymin, zb->ymin);
+  ymax = min(ymax, zb->ymax - 1);
+  if (xmin > xmax || ymin > ymax) {
+    return;
+  }
+
+  int tx0 = xmin >> ZB_HIZ_TILE_BITS;
+  int tx1 = xmax >> ZB_HIZ_TILE_BITS;
+  int ty1 = ymax >> ZB_HIZ_TILE_BITS;
+  for (int ty = ymin >> ZB_HIZ_TILE_BITS; ty <= ty1; ++ty) {
+    memset(zb->hiz_dirty + ty * zb->hiz_xsize + tx0, 1, tx1 - tx0 + 1);
+  }
+}
+
+/*
+ * Recomputes the bound of the indicated hierarchical z buffer tile from the
+ * depth values within it, and returns the new bound.
+ */
+ZPOINT
+ZB_hizUpdate(ZBuffer *zb, int tile) {
+  int tx = tile % zb->hiz_xsize;
+  int ty = tile / zb->hiz_xsize;
+  int x0 = tx << ZB_HIZ_TILE_BITS;
+  int y0 = ty << ZB_HIZ_TILE_BITS;
+  int x1 = min(x0 + ZB_HIZ_TILE_SIZE, zb->xsize);
+  int y1 = min(y0 + ZB_HIZ_TILE_SIZE, zb->ysize);
+
+  ZPOINT zmin = 0xffffffffU;
+  const ZPOINT *row = zb->zbuf + y0 * zb->xsize;
+  for (int y = y0; y < y1; ++y) {
+    for (int x = x0; x < x1; ++x) {
+      zmin = min(zmin, row[x]);
+    }
+    row += zb->xsize;
+  }
+
+  zb->hiz_min[tile] = zmin;
+  zb->hiz_dirty[tile] = 0;
+  return zmin;
+}
+
 #define ZB_ST_FRAC_HIGH (1 << ZB_POINT_ST_FRAC_BITS)
 #define ZB_ST_FRAC_MASK (ZB_ST_FRAC_HIGH - 1)
 
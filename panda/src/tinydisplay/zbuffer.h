@@ -8,11 +8,22 @@
 #include "zfeatures.h"
 #include "pbitops.h"
 #include "srgb_tables.h"
+#include "atomicAdjust.h"
 
 typedef unsigned int ZPOINT;
 #define ZB_Z_BITS 20
 #define ZB_POINT_Z_FRAC_BITS 10  // These must add to < 32.
 
+/* The hierarchical z buffer keeps a bound on the depth values in each square
+   tile of this many pixels on a side (as a power of 2). */
+#define ZB_HIZ_TILE_BITS 3
+#define ZB_HIZ_TILE_SIZE (1 << ZB_HIZ_TILE_BITS)
+
+/* Triangles smaller than this many pixels are not tested against the
+   hierarchical z buffer, since they would rarely skip enough to pay for
+   the test. */
+#define ZB_HIZ_MIN_AREA 128
+
 /* The number of fractional bits below the S and T texture coords.
    The more we have, the more precise the texel calculation will be
    when we zoom into small details of a texture; but the greater
@@ -174,6 +185,19 @@ struct ZBuffer {
   int reference_alpha;
   int blend_r, blend_g, blend_b, blend_a;
   ZB_storePixelFunc store_pix_func;
+
+  /* the triangle fill functions only write the rows from ymin up to (but
+     not including) ymax; normally the whole buffer.  See zbin.h. */
+  int ymin, ymax;
+
+  /* the hierarchical z buffer: for each tile, a lower bound on the depth
+     values within it, and whether the tile has been written since the bound
+     was last computed.  Since a pixel is drawn only if it is nearer (greater)
+     than the stored depth, a span that is no nearer than the bound of every
+     tile it crosses can be skipped.  See ZB_hizOccluded(). */
+  ZPOINT *hiz_min;
+  unsigned char *hiz_dirty;
+  int hiz_xsize, hiz_ysize;
 };
 
 struct ZBufferPoint {
@@ -193,20 +217,21 @@ struct ZBufferPoint {
 /* zbuffer.c */
 
 #ifdef DO_PSTATS
-extern int pixel_count_white_untextured;
-extern int pixel_count_flat_untextured;
-extern int pixel_count_smooth_untextured;
-extern int pixel_count_white_textured;
-extern int pixel_count_flat_textured;
-extern int pixel_count_smooth_textured;
-extern int pixel_count_white_perspective;
-extern int pixel_count_flat_perspective;
-extern int pixel_count_smooth_perspective;
-extern int pixel_count_smooth_multitex2;
-extern int pixel_count_smooth_multitex3;
+/* These are atomic, since the triangles may be filled by several threads. */
+extern AtomicAdjust::Integer pixel_count_white_untextured;
+extern AtomicAdjust::Integer pixel_count_flat_untextured;
+extern AtomicAdjust::Integer pixel_count_smooth_untextured;
+extern AtomicAdjust::Integer pixel_count_white_textured;
+extern AtomicAdjust::Integer pixel_count_flat_textured;
+extern AtomicAdjust::Integer pixel_count_smooth_textured;
+extern AtomicAdjust::Integer pixel_count_white_perspective;
+extern AtomicAdjust::Integer pixel_count_flat_perspective;
+extern AtomicAdjust::Integer pixel_count_smooth_perspective;
+extern AtomicAdjust::Integer pixel_count_smooth_multitex2;
+extern AtomicAdjust::Integer pixel_count_smooth_multitex3;
 
 #define COUNT_PIXELS(pixel_count, p0, p1, p2) \
-  (pixel_count) += abs((p0)->x * ((p1)->y - (p2)->y) + (p1)->x * ((p2)->y - (p0)->y) + (p2)->x * ((p0)->y - (p1)->y)) / 2
+  AtomicAdjust::add((pixel_count), abs((p0)->x * ((p1)->y - (p2)->y) + (p1)->x * ((p2)->y - (p0)->y) + (p2)->x * ((p0)->y - (p1)->y)) / 2)
 
 #else
 
@@ -228,6 +253,42 @@ void ZB_clear(ZBuffer *zb, int clear_z, ZPOINT z, int clear_color, PIXEL color);
 void ZB_clear_viewport(ZBuffer * zb, int clear_z, ZPOINT z, int clear_color, PIXEL color,
                        int xmin, int ymin, int xsize, int ysize);
 
+void ZB_hizReset(ZBuffer *zb, int xmin, int ymin, int xmax, int ymax);
+void ZB_hizTouch(ZBuffer *zb, int xmin, int ymin, int xmax, int ymax);
+ZPOINT ZB_hizUpdate(ZBuffer *zb, int tile);
+
+/*
+ * Returns true if none of the n + 1 pixels of row y, starting at column x,
+ * could pass a "less" depth test against the zbuffer, given the depth z of
+ * the first one and the increment dzdx, which are in the same fixed-point
+ * form used by the triangle fill functions.
+ */
+static inline int
+ZB_hizOccluded(ZBuffer *zb, int x, int y, int n, int z, int dzdx) {
+  if (n < 0 || x < 0 || x + n >= zb->xsize) {
+    return 0;
+  }
+
+  /* The pixels are compared as unsigned; give up if they would wrap. */
+  int64_t zlast = (int64_t)z + (int64_t)n * dzdx;
+  if (z < 0 || zlast < 0 || zlast > (int64_t)0xffffffffU) {
+    return 0;
+  }
+  ZPOINT zmax = (ZPOINT)(z > zlast ? z : zlast) >> ZB_POINT_Z_FRAC_BITS;
+
+  int tile = (y >> ZB_HIZ_TILE_BITS) * zb->hiz_xsize + (x >> ZB_HIZ_TILE_BITS);
+  int last_tile = tile + ((x + n) >> ZB_HIZ_TILE_BITS) - (x >> ZB_HIZ_TILE_BITS);
+  for (; tile <= last_tile; ++tile) {
+    if (zmax > zb->hiz_min[tile]) {
+      /* The bound may just be out of date. */
+      if (!zb->hiz_dirty[tile] || zmax > ZB_hizUpdate(zb, tile)) {
+        return 0;
+      }
+    }
+  }
+  return 1;
+}
+
 PIXEL lookup_texture_nearest(ZTextureDef *texture_def, int s, int t, unsigned int level, unsigned int level_dx);
 PIXEL lookup_texture_bilinear(ZTextureDef *texture_def, int s, int t, unsigned int level, unsigned int level_dx);
 PIXEL lookup_texture_mipmap_nearest(ZTextureDef *texture_def, int s, int t, unsigned int level, unsigned int level_dx);
@@ -36,6 +36,13 @@
 #define TGL_FEATURE_24_BITS        1
 #define TGL_FEATURE_32_BITS        1
 
+/* transform and light vertices four at a time with SSE2, where it is
+   available; the results are the same as with the scalar code */
+#if !defined(STDFLOAT_DOUBLE) && \
+    (defined(__SSE2__) || (_M_IX86_FP >= 2) || defined(_M_X64) || defined(_M_AMD64))
+#define TGL_FEATURE_SSE2           1
+#endif
+
 /* Number of simultaneous texture stages supported (multitexture). */
 #define MAX_TEXTURE_STAGES 3
 
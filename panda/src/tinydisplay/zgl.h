@@ -11,6 +11,10 @@
 #include "zmath.h"
 #include "zfeatures.h"
 
+#ifdef TGL_FEATURE_SSE2
+#include <emmintrin.h>
+#endif
+
 /* initially # of allocated GLVertexes (will grow when necessary) */
 #define POLYGON_MAX_VERTEX 16
 
@@ -180,6 +184,10 @@ typedef struct GLContext {
   gl_draw_triangle_func draw_triangle_front,draw_triangle_back;
   ZB_fillTriangleFunc zb_fill_tri;
 
+  /* if not NULL, filled triangles are collected here to be rasterized in
+     parallel, rather than filled immediately */
+  struct ZBins *zb_bins;
+
   /* current vertex state */
   V4 current_color;
   V4 current_normal;
@@ -217,10 +225,14 @@ void gl_draw_triangle_fill(GLContext *c,
 /* light.c */
 void gl_enable_disable_light(GLContext *c,int light,int v);
 void gl_shade_vertex(GLContext *c,GLVertex *v);
+void gl_shade_vertices(GLContext *c,GLVertex *v,int num_vertices,
+                       int ambient_from_color,int diffuse_from_color);
 
 /* vertex.c */
 void gl_eval_viewport(GLContext *c);
 void gl_vertex_transform(GLContext * c, GLVertex * v);
+void gl_transform_vertices(GLContext *c, GLVertex *v, int num_vertices,
+                           int with_normals);
 
 /* image_util.c */
 void gl_convertRGB_to_5R6G5B(unsigned short *pixmap,unsigned char *rgb,
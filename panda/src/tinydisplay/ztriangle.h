@@ -9,7 +9,7 @@
   PIXEL *pp1;
   int part, update_left, update_right;
 
-  int nb_lines, dx1, dy1, tmp, dx2, dy2;
+  int nb_lines, dx1, dy1, tmp, dx2, dy2, y;
 
   int error, derror;
   int x1, dxdy_min, dxdy_max;
@@ -50,11 +50,15 @@
 #if defined(INTERP_MIPMAP) && defined(INTERP_STZB)
   unsigned int mipmap_dxb = 0, mipmap_levelb = 0;
 #endif
+#ifdef DEPTH_TEST
+  int use_hiz;
+#endif
+#ifdef DEPTH_WRITE
+  int hiz_xmin, hiz_xmax;
+#endif
 
   EARLY_OUT();
 
-  COUNT_PIXELS(PIXEL_COUNT, p0, p1, p2);
-
   /* we sort the vertex with increasing y */
   if (p1->y < p0->y) {
     t = p0;
@@ -72,6 +76,14 @@
     p2 = t;
   }
 
+  /* when filling a band of the zbuffer, skip triangles outside it, and count
+     each triangle only in the band containing its top row */
+  if (p0->y >= zb->ymax || p2->y < zb->ymin)
+    return;
+  if (p0->y >= zb->ymin) {
+    COUNT_PIXELS(PIXEL_COUNT, p0, p1, p2);
+  }
+
   /* we compute dXdx and dXdy for all interpolated values */
   
   fdx1 = (PN_stdfloat) (p1->x - p0->x);
@@ -83,6 +95,10 @@
   fz = fdx1 * fdy2 - fdx2 * fdy1;
   if (fz == 0)
     return;
+#ifdef DEPTH_TEST
+  /* fz is twice the area of the triangle */
+  use_hiz = (fz > 2 * ZB_HIZ_MIN_AREA || fz < -2 * ZB_HIZ_MIN_AREA);
+#endif
   fz = 1.0f / fz;
 
   fdx1 *= fz;
@@ -213,9 +229,23 @@
 
   pp1 = (PIXEL *) ((char *) zb->pbuf + zb->linesize * p0->y);
   pz1 = zb->zbuf + p0->y * zb->xsize;
+  y = p0->y;
 
   DRAW_INIT();
 
+#ifdef DEPTH_WRITE
+  /* the columns that may be written, with a pixel to spare, for keeping the
+     hierarchical z buffer up to date */
+  hiz_xmin = (p0->x < p1->x) ? p0->x : p1->x;
+  hiz_xmin = ((p2->x < hiz_xmin) ? p2->x : hiz_xmin) - 1;
+  hiz_xmax = (p0->x > p1->x) ? p0->x : p1->x;
+  hiz_xmax = ((p2->x > hiz_xmax) ? p2->x : hiz_xmax) + 1;
+#ifndef DEPTH_TEST
+  /* without a depth test, farther depths may be written */
+  ZB_hizReset(zb, hiz_xmin, p0->y, hiz_xmax, p2->y);
+#endif
+#endif
+
   for(part=0;part<2;part++) {
     if (part == 0) {
       if (fz > 0) {
@@ -341,82 +371,98 @@
 
     while (nb_lines>0) {
       nb_lines--;
+      if (y >= zb->ymax) {
+#if defined(DEPTH_WRITE) && defined(DEPTH_TEST)
+        ZB_hizTouch(zb, hiz_xmin, p0->y, hiz_xmax, p2->y);
+#endif
+        return;
+      }
+
+      /* the edges are stepped through the rows above the band, but only
+         the rows within it are drawn; and spans that are entirely hidden
+         according to the hierarchical z buffer are skipped */
+      if (y >= zb->ymin
+#ifdef DEPTH_TEST
+          && !(use_hiz && ZB_hizOccluded(zb, x1, y, (x2 >> 16) - x1, z1, dzdx))
+#endif
+          ) {
 #ifndef DRAW_LINE
-      /* generic draw line */
-      {
-        PIXEL *pp;
-        int n;
+        /* generic draw line */
+        {
+          PIXEL *pp;
+          int n;
 #ifdef INTERP_Z
-        ZPOINT *pz;
-        unsigned int z,zz;
+          ZPOINT *pz;
+          unsigned int z,zz;
 #endif
 #ifdef INTERP_RGB
-        unsigned int or1,og1,ob1,oa1;
+          unsigned int or1,og1,ob1,oa1;
 #endif
 #ifdef INTERP_ST
-        unsigned int s,t;
+          unsigned int s,t;
 #endif
 #ifdef INTERP_STZ
-        PN_stdfloat sz,tz;
+          PN_stdfloat sz,tz;
 #endif
 #ifdef INTERP_STZA
-        PN_stdfloat sza,tza;
+          PN_stdfloat sza,tza;
 #endif
 #ifdef INTERP_STZB
-        PN_stdfloat szb,tzb;
+          PN_stdfloat szb,tzb;
 #endif
 
-        n=(x2 >> 16) - x1;
-        pp=(PIXEL *)((char *)pp1 + x1 * PSZB);
+          n=(x2 >> 16) - x1;
+          pp=(PIXEL *)((char *)pp1 + x1 * PSZB);
 #ifdef INTERP_Z
-        pz=pz1+x1;
-        z=z1;
+          pz=pz1+x1;
+          z=z1;
 #endif
 #ifdef INTERP_RGB
-        or1 = r1;
-        og1 = g1;
-        ob1 = b1;
-        oa1 = a1;
+          or1 = r1;
+          og1 = g1;
+          ob1 = b1;
+          oa1 = a1;
 #endif
 #ifdef INTERP_ST
-        s=s1;
-        t=t1;
+          s=s1;
+          t=t1;
 #endif
 #ifdef INTERP_STZ
-        sz=sz1;
-        tz=tz1;
+          sz=sz1;
+          tz=tz1;
 #endif
 #ifdef INTERP_STZA
-        sza=sza1;
-        tza=tza1;
+          sza=sza1;
+          tza=tza1;
 #endif
 #ifdef INTERP_STZB
-        szb=szb1;
-        tzb=tzb1;
-#endif
-        while (n>=3) {
-          PUT_PIXEL(0);
-          PUT_PIXEL(1);
-          PUT_PIXEL(2);
-          PUT_PIXEL(3);
+          szb=szb1;
+          tzb=tzb1;
+#endif
+          while (n>=3) {
+            PUT_PIXEL(0);
+            PUT_PIXEL(1);
+            PUT_PIXEL(2);
+            PUT_PIXEL(3);
 #ifdef INTERP_Z
-          pz+=4;
+            pz+=4;
 #endif
-          pp=(PIXEL *)((char *)pp + 4 * PSZB);
-          n-=4;
-        }
-        while (n>=0) {
-          PUT_PIXEL(0);
+            pp=(PIXEL *)((char *)pp + 4 * PSZB);
+            n-=4;
+          }
+          while (n>=0) {
+            PUT_PIXEL(0);
 #ifdef INTERP_Z
-          pz+=1;
+            pz+=1;
 #endif
-          pp=(PIXEL *)((char *)pp + PSZB);
-          n-=1;
+            pp=(PIXEL *)((char *)pp + PSZB);
+            n-=1;
+          }
         }
-      }
 #else
-      DRAW_LINE();
+        DRAW_LINE();
 #endif
+      }
       
       /* left edge */
       error+=derror;
@@ -483,8 +529,13 @@
       /* screen coordinates */
       pp1=(PIXEL *)((char *)pp1 + zb->linesize);
       pz1+=zb->xsize;
+      y++;
     }
   }
+
+#if defined(DEPTH_WRITE) && defined(DEPTH_TEST)
+  ZB_hizTouch(zb, hiz_xmin, p0->y, hiz_xmax, p2->y);
+#endif
 }
 
 #undef INTERP_Z
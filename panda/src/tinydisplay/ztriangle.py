@@ -56,7 +56,7 @@ FullOptions = Options + ExtraOptions
 
 CodeTable = {
     # depth write
-    'zon' : '#define STORE_Z(zpix, z) (zpix) = (z)',
+    'zon' : '#define STORE_Z(zpix, z) (zpix) = (z)\n#define DEPTH_WRITE',
     'zoff' : '#define STORE_Z(zpix, z)',
 
     # color write
@@ -76,7 +76,7 @@ CodeTable = {
 
     # depth test
     'znone' : '#define ZCMP(zpix, z) 1',
-    'zless' : '#define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))',
+    'zless' : '#define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))\n#define DEPTH_TEST',
 
     # texture filters
     'tnearest' : '#define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)\n#define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)',
@@ -1,6 +1,7 @@
 /* This file is generated code--do not edit.  See ztriangle.py. */
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a)
 #define ACMP(zb, a) 1
 #define ZCMP(zpix, z) 1
@@ -10,6 +11,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a)
 #define ACMP(zb, a) 1
 #define ZCMP(zpix, z) 1
@@ -20,6 +22,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a)
 #define ACMP(zb, a) 1
 #define ZCMP(zpix, z) 1
@@ -30,18 +33,22 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a)
 #define ACMP(zb, a) 1
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
 #define FNAME(name) FB_triangle_zon_coff_anone_zless_tnearest_ ## name
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a)
 #define ACMP(zb, a) 1
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
@@ -49,9 +56,11 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a)
 #define ACMP(zb, a) 1
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
@@ -59,6 +68,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -68,6 +78,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -78,6 +89,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -88,18 +100,22 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
 #define FNAME(name) FB_triangle_zon_coff_aless_zless_tnearest_ ## name
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
@@ -107,9 +123,11 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
@@ -117,6 +135,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -126,6 +145,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -136,6 +156,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -146,18 +167,22 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
 #define FNAME(name) FB_triangle_zon_coff_amore_zless_tnearest_ ## name
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
@@ -165,9 +190,11 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
@@ -175,6 +202,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = SRGBA_TO_PIXEL(r, g, b, a)
 #define ACMP(zb, a) 1
 #define ZCMP(zpix, z) 1
@@ -184,6 +212,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = SRGBA_TO_PIXEL(r, g, b, a)
 #define ACMP(zb, a) 1
 #define ZCMP(zpix, z) 1
@@ -194,6 +223,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = SRGBA_TO_PIXEL(r, g, b, a)
 #define ACMP(zb, a) 1
 #define ZCMP(zpix, z) 1
@@ -204,18 +234,22 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = SRGBA_TO_PIXEL(r, g, b, a)
 #define ACMP(zb, a) 1
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
 #define FNAME(name) FB_triangle_zon_csstore_anone_zless_tnearest_ ## name
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = SRGBA_TO_PIXEL(r, g, b, a)
 #define ACMP(zb, a) 1
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
@@ -223,9 +257,11 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = SRGBA_TO_PIXEL(r, g, b, a)
 #define ACMP(zb, a) 1
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
@@ -233,6 +269,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = SRGBA_TO_PIXEL(r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -242,6 +279,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = SRGBA_TO_PIXEL(r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -252,6 +290,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = SRGBA_TO_PIXEL(r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -262,18 +301,22 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = SRGBA_TO_PIXEL(r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
 #define FNAME(name) FB_triangle_zon_csstore_aless_zless_tnearest_ ## name
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = SRGBA_TO_PIXEL(r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
@@ -281,9 +324,11 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = SRGBA_TO_PIXEL(r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
@@ -291,6 +336,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = SRGBA_TO_PIXEL(r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -300,6 +346,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = SRGBA_TO_PIXEL(r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -310,6 +357,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = SRGBA_TO_PIXEL(r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -320,18 +368,22 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = SRGBA_TO_PIXEL(r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
 #define FNAME(name) FB_triangle_zon_csstore_amore_zless_tnearest_ ## name
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = SRGBA_TO_PIXEL(r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
@@ -339,9 +391,11 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = SRGBA_TO_PIXEL(r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
@@ -349,6 +403,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_SRGB(pix, r, g, b, a)
 #define ACMP(zb, a) 1
 #define ZCMP(zpix, z) 1
@@ -358,6 +413,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_SRGB(pix, r, g, b, a)
 #define ACMP(zb, a) 1
 #define ZCMP(zpix, z) 1
@@ -368,6 +424,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_SRGB(pix, r, g, b, a)
 #define ACMP(zb, a) 1
 #define ZCMP(zpix, z) 1
@@ -378,18 +435,22 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_SRGB(pix, r, g, b, a)
 #define ACMP(zb, a) 1
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
 #define FNAME(name) FB_triangle_zon_csblend_anone_zless_tnearest_ ## name
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_SRGB(pix, r, g, b, a)
 #define ACMP(zb, a) 1
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
@@ -397,9 +458,11 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_SRGB(pix, r, g, b, a)
 #define ACMP(zb, a) 1
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
@@ -407,6 +470,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_SRGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -416,6 +480,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_SRGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -426,6 +491,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_SRGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -436,18 +502,22 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_SRGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
 #define FNAME(name) FB_triangle_zon_csblend_aless_zless_tnearest_ ## name
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_SRGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
@@ -455,9 +525,11 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_SRGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
@@ -465,6 +537,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_SRGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -474,6 +547,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_SRGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -484,6 +558,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_SRGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -494,18 +569,22 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_SRGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
 #define FNAME(name) FB_triangle_zon_csblend_amore_zless_tnearest_ ## name
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_SRGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
@@ -513,9 +592,11 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_SRGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
@@ -33,6 +33,7 @@
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = (rgb)
 #define ACMP(zb, a) 1
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
 #define FNAME(name) FB_triangle_zoff_cstore_anone_zless_tnearest_ ## name
@@ -42,6 +43,7 @@
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = (rgb)
 #define ACMP(zb, a) 1
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
@@ -52,6 +54,7 @@
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = (rgb)
 #define ACMP(zb, a) 1
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
@@ -91,6 +94,7 @@
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = (rgb)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
 #define FNAME(name) FB_triangle_zoff_cstore_aless_zless_tnearest_ ## name
@@ -100,6 +104,7 @@
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = (rgb)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
@@ -110,6 +115,7 @@
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = (rgb)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
@@ -149,6 +155,7 @@
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = (rgb)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
 #define FNAME(name) FB_triangle_zoff_cstore_amore_zless_tnearest_ ## name
@@ -158,6 +165,7 @@
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = (rgb)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
@@ -168,6 +176,7 @@
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = (rgb)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
@@ -207,6 +216,7 @@
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_RGB(pix, r, g, b, a)
 #define ACMP(zb, a) 1
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
 #define FNAME(name) FB_triangle_zoff_cblend_anone_zless_tnearest_ ## name
@@ -216,6 +226,7 @@
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_RGB(pix, r, g, b, a)
 #define ACMP(zb, a) 1
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
@@ -226,6 +237,7 @@
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_RGB(pix, r, g, b, a)
 #define ACMP(zb, a) 1
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
@@ -265,6 +277,7 @@
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_RGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
 #define FNAME(name) FB_triangle_zoff_cblend_aless_zless_tnearest_ ## name
@@ -274,6 +287,7 @@
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_RGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
@@ -284,6 +298,7 @@
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_RGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
@@ -323,6 +338,7 @@
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_RGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
 #define FNAME(name) FB_triangle_zoff_cblend_amore_zless_tnearest_ ## name
@@ -332,6 +348,7 @@
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_RGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
@@ -342,6 +359,7 @@
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_RGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
@@ -381,6 +399,7 @@
 #define STORE_PIX(pix, rgb, r, g, b, a) zb->store_pix_func(zb, pix, r, g, b, a)
 #define ACMP(zb, a) 1
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
 #define FNAME(name) FB_triangle_zoff_cgeneral_anone_zless_tnearest_ ## name
@@ -390,6 +409,7 @@
 #define STORE_PIX(pix, rgb, r, g, b, a) zb->store_pix_func(zb, pix, r, g, b, a)
 #define ACMP(zb, a) 1
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
@@ -400,6 +420,7 @@
 #define STORE_PIX(pix, rgb, r, g, b, a) zb->store_pix_func(zb, pix, r, g, b, a)
 #define ACMP(zb, a) 1
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
@@ -439,6 +460,7 @@
 #define STORE_PIX(pix, rgb, r, g, b, a) zb->store_pix_func(zb, pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
 #define FNAME(name) FB_triangle_zoff_cgeneral_aless_zless_tnearest_ ## name
@@ -448,6 +470,7 @@
 #define STORE_PIX(pix, rgb, r, g, b, a) zb->store_pix_func(zb, pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
@@ -458,6 +481,7 @@
 #define STORE_PIX(pix, rgb, r, g, b, a) zb->store_pix_func(zb, pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
@@ -497,6 +521,7 @@
 #define STORE_PIX(pix, rgb, r, g, b, a) zb->store_pix_func(zb, pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
 #define FNAME(name) FB_triangle_zoff_cgeneral_amore_zless_tnearest_ ## name
@@ -506,6 +531,7 @@
 #define STORE_PIX(pix, rgb, r, g, b, a) zb->store_pix_func(zb, pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
@@ -516,6 +542,7 @@
 #define STORE_PIX(pix, rgb, r, g, b, a) zb->store_pix_func(zb, pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
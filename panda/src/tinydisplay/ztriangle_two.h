@@ -1010,6 +1010,8 @@ FNAME(smooth_multitex3) (ZBuffer *zb,
 #undef ZCMP
 #undef STORE_PIX
 #undef STORE_Z
+#undef DEPTH_WRITE
+#undef DEPTH_TEST
 #undef FNAME
 #undef INTERP_MIPMAP
 #undef CALC_MIPMAP_LEVEL
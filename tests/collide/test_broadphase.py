@@ -0,0 +1,34 @@
+from panda3d.core import CollisionNode, NodePath, CollisionTraverser, CollisionHandlerQueue
+from panda3d.core import CollisionSphere, CollisionRay, Point3, Vec3
+
+
+def traverse_crowd(use_broadphase):
+    root = NodePath('root')
+    trav = CollisionTraverser()
+    trav.set_use_broadphase(use_broadphase)
+    queue = CollisionHandlerQueue()
+
+    # A grid of moving spheres, each of which is both a collider and a
+    # collidee, as with a crowd of characters using a pusher.
+    for i in range(100):
+        cnode = CollisionNode('sphere%d' % i)
+        cnode.add_solid(CollisionSphere(0, 0, 0, 0.6))
+        np = root.attach_new_node(cnode)
+        np.set_pos((i % 10) * 1.0, (i // 10) * 1.5, 0)
+        trav.add_collider(np, queue)
+
+    # A ray has an infinite bounding volume, and must never be rejected.
+    cnode = CollisionNode('ray')
+    cnode.add_solid(CollisionRay(Point3(3, 3, 10), Vec3(0, 0, -1)))
+    cnode.set_into_collide_mask(0)
+    trav.add_collider(root.attach_new_node(cnode), queue)
+
+    trav.traverse(root)
+    return [(e.get_from_node().get_name(), e.get_into_node().get_name())
+            for e in queue.get_entries()]
+
+
+def test_broadphase_same_results():
+    without = traverse_crowd(False)
+    assert len(without) > 0
+    assert traverse_crowd(True) == without
@@ -0,0 +1,95 @@
+from panda3d.core import GeomVertexFormat, GeomVertexData, GeomVertexWriter
+from panda3d.core import Geom, GeomTriangles, GeomNode, ConfigVariableBool
+from panda3d.core import CollisionNode, NodePath, CollisionTraverser, CollisionHandlerQueue
+from panda3d.core import CollisionSphere, CollisionRay, CollisionSegment, CollisionCapsule
+from panda3d.core import Point3
+
+
+def make_grid(size):
+    # Makes a flat grid of size x size quads, two triangles each, in the
+    # z = 0 plane, stretching from (0, 0) to (size, size).
+    vdata = GeomVertexData('grid', GeomVertexFormat.get_v3(), Geom.UH_static)
+    vertex = GeomVertexWriter(vdata, 'vertex')
+    for y in range(size + 1):
+        for x in range(size + 1):
+            vertex.add_data3(x, y, 0)
+
+    tris = GeomTriangles(Geom.UH_static)
+    for y in range(size):
+        for x in range(size):
+            i = y * (size + 1) + x
+            tris.add_vertices(i, i + 1, i + size + 2)
+            tris.add_vertices(i, i + size + 2, i + size + 1)
+
+    geom = Geom(vdata)
+    geom.add_primitive(tris)
+    node = GeomNode('grid')
+    node.add_geom(geom)
+    return node
+
+
+def collide_with_grid(solid):
+    root = NodePath('root')
+    root.attach_new_node(make_grid(32))
+
+    cnode = CollisionNode('from')
+    cnode.add_solid(solid)
+    cnode.set_from_collide_mask(GeomNode.get_default_collide_mask())
+    np_from = root.attach_new_node(cnode)
+
+    trav = CollisionTraverser()
+    queue = CollisionHandlerQueue()
+    trav.add_collider(np_from, queue)
+    trav.traverse(root)
+
+    return sorted((tuple(e.get_surface_point(root)), tuple(e.get_surface_normal(root)))
+                  for e in queue.get_entries())
+
+
+def compare_with_and_without_tree(solid):
+    var = ConfigVariableBool('collision-geom-tree')
+    old_value = var.get_value()
+    try:
+        var.set_value(True)
+        with_tree = collide_with_grid(solid)
+        var.set_value(False)
+        without_tree = collide_with_grid(solid)
+    finally:
+        var.set_value(old_value)
+
+    assert with_tree == without_tree
+    return with_tree
+
+
+def test_sphere_into_geom():
+    entries = compare_with_and_without_tree(CollisionSphere(10.25, 10.25, 0.5, 1))
+    assert len(entries) > 0
+    assert all(point[2] == 0 for point, normal in entries)
+
+    entries = compare_with_and_without_tree(CollisionSphere(10.25, 10.25, 5, 1))
+    assert len(entries) == 0
+
+
+def test_ray_into_geom():
+    entries = compare_with_and_without_tree(CollisionRay(Point3(5.25, 7.75, 10), (0, 0, -1)))
+    assert len(entries) == 1
+    assert entries[0][0] == (5.25, 7.75, 0)
+
+    entries = compare_with_and_without_tree(CollisionRay(Point3(50, 50, 10), (0, 0, -1)))
+    assert len(entries) == 0
+
+
+def test_segment_into_geom():
+    entries = compare_with_and_without_tree(CollisionSegment(Point3(3.5, 3.25, 1), Point3(3.5, 3.25, -1)))
+    assert len(entries) == 1
+
+    entries = compare_with_and_without_tree(CollisionSegment(Point3(3.5, 3.25, 1), Point3(3.5, 3.25, 0.5)))
+    assert len(entries) == 0
+
+
+def test_capsule_into_geom():
+    entries = compare_with_and_without_tree(CollisionCapsule(Point3(2, 2, 0.25), Point3(8, 2, 0.25), 0.5))
+    assert len(entries) > 0
+
+    entries = compare_with_and_without_tree(CollisionCapsule(Point3(2, 2, 3), Point3(8, 2, 3), 0.5))
+    assert len(entries) == 0
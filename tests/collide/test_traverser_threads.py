@@ -0,0 +1,34 @@
+from panda3d.core import CollisionNode, NodePath, CollisionTraverser, CollisionHandlerQueue
+from panda3d.core import CollisionSphere, CollisionBox, Point3
+
+
+def traverse_spheres(num_threads):
+    root = NodePath('root')
+
+    # A row of boxes to collide into.
+    for i in range(20):
+        cnode = CollisionNode('box%d' % i)
+        cnode.add_solid(CollisionBox(Point3(i * 2, 0, 0), 0.75, 0.75, 0.75))
+        root.attach_new_node(cnode)
+
+    # Enough spheres to need several passes of 32 colliders each.
+    trav = CollisionTraverser()
+    trav.set_num_threads(num_threads)
+    queue = CollisionHandlerQueue()
+    for i in range(150):
+        cnode = CollisionNode('sphere%d' % i)
+        cnode.add_solid(CollisionSphere(i * 0.25, 0, 0, 0.5))
+        cnode.set_into_collide_mask(0)
+        trav.add_collider(root.attach_new_node(cnode), queue)
+
+    trav.traverse(root)
+    return [(e.get_from_node().get_name(), e.get_into_node().get_name())
+            for e in queue.get_entries()]
+
+
+def test_traverser_threads():
+    serial = traverse_spheres(1)
+    assert len(serial) > 0
+
+    # The handler must see exactly the same entries, in the same order.
+    assert traverse_spheres(4) == serial
@@ -0,0 +1,98 @@
+from panda3d import core
+import pytest
+
+
+@pytest.fixture(scope='module')
+def sort_region(graphics_pipe):
+    """Creates and returns a DisplayRegion on an offscreen buffer."""
+
+    engine = core.GraphicsEngine()
+    engine.set_threading_model("")
+
+    fbprops = core.FrameBufferProperties()
+    fbprops.set_rgba_bits(8, 8, 8, 8)
+
+    buffer = engine.make_output(
+        graphics_pipe,
+        'buffer',
+        0,
+        fbprops,
+        core.WindowProperties.size(32, 32),
+        core.GraphicsPipe.BF_refuse_window,
+    )
+    engine.open_windows()
+
+    if buffer is None:
+        pytest.skip("GraphicsPipe cannot make offscreen buffers")
+
+    buffer.set_clear_color_active(True)
+    buffer.set_clear_color((0, 0, 0, 1))
+
+    yield buffer.make_display_region()
+
+    if buffer is not None:
+        engine.remove_window(buffer)
+
+
+def make_scene(bin_name):
+    # Makes a grid of overlapping cards with a few different colors, with the
+    # depth test disabled, so that the resulting image depends on the order in
+    # which the bin draws the cards.
+    scene = core.NodePath("root")
+    scene.set_depth_test(False)
+    scene.set_depth_write(False)
+
+    lens = core.OrthographicLens()
+    lens.set_film_size(2, 2)
+    lens.set_near_far(-100, 100)
+    camera = scene.attach_new_node(core.Camera("camera", lens))
+
+    cm = core.CardMaker("card")
+    cm.set_frame(-0.2, 0.2, -0.2, 0.2)
+    for i in range(400):
+        x = i % 20
+        y = i // 20
+        card = scene.attach_new_node(cm.generate())
+        card.set_pos(x * 0.1 - 0.95, ((i * 37) % 400) * 0.1 - 20, y * 0.1 - 0.95)
+        card.set_color((i % 3) / 2.0, (i % 5) / 4.0, (i % 7) / 6.0, 1)
+        card.set_bin(bin_name, 0)
+
+    return scene, camera
+
+
+def render_scene(region, scene, camera, key_sort):
+    sort_var = core.ConfigVariableBool('cull-bin-key-sort')
+    min_var = core.ConfigVariableInt('cull-bin-key-sort-min-objects')
+    old_sort = sort_var.get_value()
+    old_min = min_var.get_value()
+
+    region.active = True
+    region.camera = camera
+
+    texture = core.Texture("color")
+    region.window.add_render_texture(texture,
+                                     core.GraphicsOutput.RTM_copy_ram,
+                                     core.GraphicsOutput.RTP_color)
+    try:
+        sort_var.set_value(key_sort)
+        min_var.set_value(2)
+        region.window.engine.render_frame()
+    finally:
+        sort_var.set_value(old_sort)
+        min_var.set_value(old_min)
+        region.window.clear_render_textures()
+
+    return bytes(texture.get_ram_image())
+
+
+@pytest.mark.parametrize("bin_name", ["opaque", "transparent"])
+def test_cull_bin_key_sort(sort_region, bin_name):
+    # The same scene must be rendered both times, since the state-sorted bin
+    # orders objects with the same state by pointer.
+    scene, camera = make_scene(bin_name)
+
+    comparator = render_scene(sort_region, scene, camera, False)
+    assert any(comparator)
+
+    key = render_scene(sort_region, scene, camera, True)
+    assert key == comparator
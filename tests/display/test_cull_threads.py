@@ -0,0 +1,84 @@
+from panda3d import core
+import pytest
+
+
+@pytest.fixture(scope='module')
+def cull_region(graphics_pipe):
+    """Creates and returns a DisplayRegion on an offscreen buffer."""
+
+    engine = core.GraphicsEngine()
+    engine.set_threading_model("")
+
+    fbprops = core.FrameBufferProperties()
+    fbprops.set_rgba_bits(8, 8, 8, 8)
+
+    buffer = engine.make_output(
+        graphics_pipe,
+        'buffer',
+        0,
+        fbprops,
+        core.WindowProperties.size(32, 32),
+        core.GraphicsPipe.BF_refuse_window,
+    )
+    engine.open_windows()
+
+    if buffer is None:
+        pytest.skip("GraphicsPipe cannot make offscreen buffers")
+
+    buffer.set_clear_color_active(True)
+    buffer.set_clear_color((0, 0, 0, 1))
+
+    yield buffer.make_display_region()
+
+    if buffer is not None:
+        engine.remove_window(buffer)
+
+
+def make_scene():
+    # Makes a grid of overlapping cards, each with its own color, in a bin
+    # that draws them in traversal order; so the resulting image depends on
+    # the order in which the cards are found by the cull traversal.
+    scene = core.NodePath("root")
+    scene.set_depth_test(False)
+    scene.set_depth_write(False)
+
+    lens = core.OrthographicLens()
+    lens.set_film_size(2, 2)
+    lens.set_near_far(-10, 10)
+    camera = scene.attach_new_node(core.Camera("camera", lens))
+
+    cm = core.CardMaker("card")
+    cm.set_frame(-0.2, 0.2, -0.2, 0.2)
+    cards = scene.attach_new_node("cards")
+    for y in range(8):
+        for x in range(8):
+            card = cards.attach_new_node(cm.generate())
+            card.set_pos(x * 0.25 - 0.875, 0, y * 0.25 - 0.875)
+            card.set_color((x / 7.0, y / 7.0, ((x + y) % 3) / 2.0, 1))
+            card.set_bin("unsorted", 0)
+
+    return scene, camera
+
+
+def render_scene(region, num_threads):
+    scene, camera = make_scene()
+    region.active = True
+    region.camera = camera
+    region.cull_traverser.num_threads = num_threads
+
+    texture = core.Texture("color")
+    region.window.add_render_texture(texture,
+                                     core.GraphicsOutput.RTM_copy_ram,
+                                     core.GraphicsOutput.RTP_color)
+    region.window.engine.render_frame()
+    region.window.clear_render_textures()
+
+    return bytes(texture.get_ram_image())
+
+
+def test_cull_threads(cull_region):
+    single = render_scene(cull_region, 1)
+    assert any(single)
+
+    multi = render_scene(cull_region, 4)
+    assert multi == single
@@ -0,0 +1,124 @@
+from panda3d import core
+import pytest
+import time
+
+
+pytestmark = pytest.mark.skipif(not core.Thread.is_threading_supported(),
+                                reason="requires threads")
+
+
+def make_chain(name, num_threads, work_stealing):
+    task_mgr = core.AsyncTaskManager.get_global_ptr()
+    task_chain = task_mgr.make_task_chain(name)
+    task_chain.set_num_threads(num_threads)
+    task_chain.set_work_stealing(work_stealing)
+    assert task_chain.get_work_stealing() == work_stealing
+    return task_mgr, task_chain
+
+
+@pytest.mark.parametrize("work_stealing", [False, True])
+def test_task_chain_sort_barrier(work_stealing):
+    task_mgr, task_chain = make_chain("test_task_chain_sort_barrier_%d" % (work_stealing), 4, work_stealing)
+
+    log = []
+
+    def task_main(task):
+        log.append(('start', task.sort))
+        time.sleep(0.001)
+        log.append(('end', task.sort))
+        return task.done
+
+    for sort in range(3):
+        for i in range(20):
+            task = core.PythonTask(task_main, "task_%d_%d" % (sort, i))
+            task.set_sort(sort)
+            task.set_task_chain(task_chain.name)
+            task_mgr.add(task)
+
+    task_chain.start_threads()
+    task_chain.wait_for_tasks()
+    task_chain.stop_threads()
+
+    assert len(log) == 3 * 20 * 2
+
+    # Every task of one sort value must end before any task of a higher sort
+    # value starts.
+    ended = [0, 0, 0]
+    for event, sort in log:
+        if event == 'start':
+            assert sum(ended[:sort]) == 20 * sort
+        else:
+            ended[sort] += 1
+
+
+def test_task_chain_work_stealing_remove():
+    task_mgr, task_chain = make_chain("test_task_chain_work_stealing_remove", 2, True)
+
+    ran = []
+
+    def task_main(task):
+        ran.append(task.name)
+        time.sleep(0.002)
+        return task.done
+
+    tasks = []
+    for i in range(40):
+        task = core.PythonTask(task_main, "task_%d" % (i))
+        task.set_priority(-i)
+        task.set_task_chain(task_chain.name)
+        tasks.append(task)
+
+    # The first task to run removes the one that would run last, which must
+    # still be waiting on one of the threads' queues.
+    def remove_main(task):
+        tasks[-1].remove()
+        ran.append(task.name)
+        return task.done
+
+    remover = core.PythonTask(remove_main, "remover")
+    remover.set_priority(100)
+    remover.set_task_chain(task_chain.name)
+
+    task_mgr.add(remover)
+    for task in tasks:
+        task_mgr.add(task)
+
+    task_chain.start_threads()
+    task_chain.wait_for_tasks()
+    task_chain.stop_threads()
+
+    assert "remover" in ran
+    assert tasks[-1].name not in ran
+    assert tasks[-1].cancelled()
+    assert len(ran) == len(tasks)
+    assert all(task.done() for task in tasks)
+
+
+def test_task_chain_work_stealing_stop():
+    task_mgr, task_chain = make_chain("test_task_chain_work_stealing_stop", 2, True)
+
+    count = [0]
+
+    def task_main(task):
+        count[0] += 1
+        return task.cont
+
+    tasks = []
+    for i in range(10):
+        task = core.PythonTask(task_main, "task_%d" % (i))
+        task.set_task_chain(task_chain.name)
+        task_mgr.add(task)
+        tasks.append(task)
+
+    task_chain.start_threads()
+    while count[0] < 100:
+        time.sleep(0.001)
+
+    # Stopping the threads must put any queued tasks back on the chain.
+    task_chain.stop_threads()
+    assert task_chain.get_num_tasks() == len(tasks)
+    assert len(task_chain.get_active_tasks()) == len(tasks)
+
+    for task in tasks:
+        task.remove()
+    assert task_chain.get_num_tasks() == 0
@@ -1,4 +1,6 @@
 from panda3d.core import Multifile, StringStream, IStreamWrapper
+from panda3d.core import Filename, ConfigVariableBool
+import pytest
 
 
 def test_multifile_read_empty():
@@ -10,3 +12,75 @@ def test_multifile_read_empty():
     assert m.is_read_valid()
     assert m.get_num_subfiles() == 0
     m.close()
+
+
+def test_multifile_memory_map(tmp_path):
+    plain = bytes(range(256)) * 64
+    packed = b'compressible ' * 1000
+
+    fn = Filename.from_os_specific(str(tmp_path / "test.mf"))
+    m = Multifile()
+    assert m.open_write(fn)
+    m.add_subfile("plain.bin", StringStream(plain), 0)
+    m.add_subfile("packed.bin", StringStream(packed), 6)
+    m.close()
+
+    var = ConfigVariableBool("multifile-memory-map")
+    old_value = var.get_value()
+    try:
+        var.set_value(True)
+        assert m.open_read(fn)
+    finally:
+        var.set_value(old_value)
+
+    assert m.is_memory_mapped()
+    assert m.read_subfile(m.find_subfile("plain.bin")) == plain
+    assert m.read_subfile(m.find_subfile("packed.bin")) == packed
+    m.close()
+    assert not m.is_memory_mapped()
+
+
+@pytest.mark.parametrize("codec", [Multifile.CC_zlib, Multifile.CC_lz4, Multifile.CC_zstd])
+def test_multifile_compression_codec(tmp_path, codec):
+    if not Multifile.has_compression_codec(codec):
+        pytest.skip("codec not available")
+
+    packed = b'compressible ' * 1000
+
+    fn = Filename.from_os_specific(str(tmp_path / "test.mf"))
+    m = Multifile()
+    assert m.open_write(fn)
+    m.set_compression_codec(codec)
+    m.add_subfile("packed.bin", StringStream(packed), 6)
+    m.close()
+
+    assert m.open_read(fn)
+    index = m.find_subfile("packed.bin")
+    assert m.is_subfile_compressed(index)
+    assert m.get_subfile_compression_codec(index) == codec
+    assert m.get_subfile_internal_length(index) < len(packed)
+    assert m.read_subfile(index) == packed
+    m.close()
+
+
+def test_multifile_compression_threads(tmp_path):
+    contents = [(b'subfile %d ' % (i)) * (500 + i * 20) for i in range(40)]
+
+    def write(name, num_threads):
+        fn = Filename.from_os_specific(str(tmp_path / name))
+        m = Multifile()
+        assert m.open_write(fn)
+        m.set_record_timestamp(False)
+        m.set_num_compression_threads(num_threads)
+        for i, data in enumerate(contents):
+            m.add_subfile("f%d" % (i), StringStream(data), 6 if i % 4 else 0)
+        m.close()
+
+        assert m.open_read(fn)
+        for i, data in enumerate(contents):
+            assert m.read_subfile(m.find_subfile("f%d" % (i))) == data
+        m.close()
+        return (tmp_path / name).read_bytes()
+
+    # The Multifile should be the same no matter how many threads wrote it.
+    assert write("serial.mf", 1) == write("parallel.mf", 4)
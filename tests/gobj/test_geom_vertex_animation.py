@@ -0,0 +1,177 @@
+from panda3d import core
+import pytest
+
+
+def make_format():
+    array = core.GeomVertexArrayFormat()
+    array.add_column("vertex", 3, core.Geom.NT_float32, core.Geom.C_point)
+    array.add_column("normal", 3, core.Geom.NT_float32, core.Geom.C_normal)
+
+    blend_array = core.GeomVertexArrayFormat()
+    blend_array.add_column("transform_blend", 1, core.Geom.NT_uint16, core.Geom.C_index)
+
+    format = core.GeomVertexFormat()
+    format.add_array(array)
+    format.add_array(blend_array)
+
+    spec = core.GeomVertexAnimationSpec()
+    spec.set_panda()
+    format.set_animation(spec)
+    return core.GeomVertexFormat.register_format(format)
+
+
+def make_data(num_rows):
+    # Each blend has a different kind of matrix, so that the normals are
+    # transformed in each of the different ways.
+    mats = [
+        core.Mat4.ident_mat(),
+        core.Mat4.translate_mat(1, 2, 3),
+        core.Mat4.rotate_mat(30, (0, 0, 1)) * core.Mat4.translate_mat(-1, 0, 2),
+        core.Mat4.scale_mat(2) * core.Mat4.rotate_mat(45, (1, 0, 0)),
+        core.Mat4.scale_mat(1, 2, 3) * core.Mat4.translate_mat(0, 0, -4),
+    ]
+
+    table = core.TransformBlendTable()
+    for i, mat in enumerate(mats):
+        transform = core.UserVertexTransform("joint%d" % (i))
+        transform.set_matrix(mat)
+        table.add_blend(core.TransformBlend(transform, 1.0))
+    table.set_rows(core.SparseArray.range(0, num_rows))
+
+    data = core.GeomVertexData("test", make_format(), core.Geom.UH_static)
+    data.set_transform_blend_table(table)
+    data.set_num_rows(num_rows)
+
+    vertex = core.GeomVertexWriter(data, "vertex")
+    normal = core.GeomVertexWriter(data, "normal")
+    blend = core.GeomVertexWriter(data, "transform_blend")
+    for i in range(num_rows):
+        vertex.set_data3(i * 0.01, (i % 7) * 0.5, -(i % 11) * 0.25)
+        normal.set_data3(core.Vec3((i % 3) - 1, (i % 5) - 2, 1).normalized())
+        blend.set_data1i((i // 37) % len(mats))
+
+    return data, mats
+
+
+def animate(num_threads, num_rows):
+    threads_var = core.ConfigVariableInt("cpu-animation-threads")
+    min_rows_var = core.ConfigVariableInt("cpu-animation-thread-min-rows")
+    old_threads = threads_var.get_value()
+    old_min_rows = min_rows_var.get_value()
+
+    data, mats = make_data(num_rows)
+    try:
+        threads_var.set_value(num_threads)
+        min_rows_var.set_value(16)
+        animated = data.animate_vertices(True, core.Thread.get_current_thread())
+    finally:
+        threads_var.set_value(old_threads)
+        min_rows_var.set_value(old_min_rows)
+
+    vertex = core.GeomVertexReader(animated, "vertex")
+    normal = core.GeomVertexReader(animated, "normal")
+    vertices = [tuple(vertex.get_data3()) for i in range(num_rows)]
+    normals = [tuple(normal.get_data3()) for i in range(num_rows)]
+    return data, mats, vertices, normals
+
+
+def test_animate_vertices():
+    data, mats, vertices, normals = animate(1, 500)
+
+    vertex = core.GeomVertexReader(data, "vertex")
+    normal = core.GeomVertexReader(data, "normal")
+    for i in range(500):
+        mat = mats[(i // 37) % len(mats)]
+        assert vertices[i] == pytest.approx(tuple(mat.xform_point(vertex.get_data3())), abs=1e-4)
+
+        # Normals should remain unit length, and perpendicular to the surface.
+        expected = core.Mat4(mat)
+        expected.invert_in_place()
+        expected.transpose_in_place()
+        expected = expected.xform_vec(normal.get_data3()).normalized()
+        assert normals[i] == pytest.approx(tuple(expected), abs=1e-4)
+
+
+@pytest.mark.skipif(not core.Thread.is_true_threads(), reason="requires threads")
+def test_animate_vertices_threads():
+    data, mats, single_vertices, single_normals = animate(1, 2000)
+    data, mats, multi_vertices, multi_normals = animate(4, 2000)
+
+    assert multi_vertices == single_vertices
+    assert multi_normals == single_normals
+
+
+def make_morph_data(num_rows):
+    array = core.GeomVertexArrayFormat()
+    array.add_column("vertex", 3, core.Geom.NT_float32, core.Geom.C_point)
+    array.add_column("vertex.morph.smile", 3, core.Geom.NT_float32, core.Geom.C_morph_delta)
+    array.add_column("vertex.morph.blink", 3, core.Geom.NT_float32, core.Geom.C_morph_delta)
+
+    blend_array = core.GeomVertexArrayFormat()
+    blend_array.add_column("transform_blend", 1, core.Geom.NT_uint16, core.Geom.C_index)
+
+    format = core.GeomVertexFormat()
+    format.add_array(array)
+    format.add_array(blend_array)
+    spec = core.GeomVertexAnimationSpec()
+    spec.set_panda()
+    format.set_animation(spec)
+    format = core.GeomVertexFormat.register_format(format)
+
+    sliders = [core.UserVertexSlider("smile"), core.UserVertexSlider("blink")]
+    slider_table = core.SliderTable()
+    slider_table.add_slider(sliders[0], core.SparseArray.range(0, num_rows // 2))
+    slider_table.add_slider(sliders[1], core.SparseArray.range(num_rows // 3, num_rows // 2))
+
+    transforms = [core.UserVertexTransform("joint%d" % (i)) for i in range(3)]
+    blend_table = core.TransformBlendTable()
+    for transform in transforms:
+        blend_table.add_blend(core.TransformBlend(transform, 1.0))
+    blend_table.set_rows(core.SparseArray.range(0, num_rows))
+
+    data = core.GeomVertexData("test", format, core.Geom.UH_static)
+    data.set_slider_table(core.SliderTable.register_table(slider_table))
+    data.set_transform_blend_table(blend_table)
+    data.set_num_rows(num_rows)
+
+    vertex = core.GeomVertexWriter(data, "vertex")
+    smile = core.GeomVertexWriter(data, "vertex.morph.smile")
+    blink = core.GeomVertexWriter(data, "vertex.morph.blink")
+    blend = core.GeomVertexWriter(data, "transform_blend")
+    for i in range(num_rows):
+        vertex.set_data3(i * 0.01, (i % 7) * 0.5, -(i % 11) * 0.25)
+        smile.set_data3(0, 0.1, (i % 3) * 0.1)
+        blink.set_data3(0.2, 0, -0.1)
+        blend.set_data1i((i // 50) % len(transforms))
+
+    return data, sliders, transforms
+
+
+def get_animated_vertices(data):
+    animated = data.animate_vertices(True, core.Thread.get_current_thread())
+    vertex = core.GeomVertexReader(animated, "vertex")
+    return [tuple(vertex.get_data3()) for i in range(data.get_num_rows())]
+
+
+def test_animate_vertices_incremental():
+    data, sliders, transforms = make_morph_data(300)
+    get_animated_vertices(data)
+
+    # Change one slider, then one joint, then both, comparing each result to
+    # the result of animating the same values from scratch.
+    steps = [
+        (0.5, None),
+        (0.5, core.Mat4.translate_mat(0, 0, 1)),
+        (0.25, core.Mat4.rotate_mat(90, (0, 0, 1))),
+    ]
+    for smile, mat in steps:
+        sliders[0].set_slider(smile)
+        if mat is not None:
+            transforms[1].set_matrix(mat)
+        incremental = get_animated_vertices(data)
+
+        fresh_data, fresh_sliders, fresh_transforms = make_morph_data(300)
+        fresh_sliders[0].set_slider(smile)
+        if mat is not None:
+            fresh_transforms[1].set_matrix(mat)
+        assert incremental == get_animated_vertices(fresh_data)
@@ -0,0 +1,92 @@
+from panda3d import core
+import pytest
+
+
+BAM_HEADER = "pbj\0\n\r"
+
+
+def make_geom(num_rows):
+    data = core.GeomVertexData("test", core.GeomVertexFormat.get_v3(), core.Geom.UH_static)
+    data.set_num_rows(num_rows)
+    vertex = core.GeomVertexWriter(data, "vertex")
+    for i in range(num_rows):
+        vertex.set_data3(i, i * 0.5, -i)
+
+    prim = core.GeomPoints(core.Geom.UH_static)
+    prim.set_index_type(core.GeomEnums.NT_uint32)
+    for i in range(num_rows):
+        prim.add_vertex(num_rows - 1 - i)
+
+    geom = core.Geom(data)
+    geom.add_primitive(prim)
+    return geom
+
+
+def write_bam(path, obj, alignment):
+    dout = core.DatagramOutputFile()
+    assert dout.open(core.Filename.from_os_specific(str(path)))
+    assert dout.write_header(BAM_HEADER)
+
+    writer = core.BamWriter(dout)
+    writer.set_file_minor_ver(46)
+    writer.set_file_data_alignment(alignment)
+    assert writer.init()
+    assert writer.write_object(obj)
+    dout.close()
+
+
+def read_bam(path, memory_map):
+    var = core.ConfigVariableBool("bam-memory-map")
+    old_value = var.get_value()
+    var.set_value(memory_map)
+    try:
+        bam = core.BamFile()
+        assert bam.open_read(core.Filename.from_os_specific(str(path)))
+        obj = bam.read_object()
+        assert bam.resolve()
+        return obj
+    finally:
+        var.set_value(old_value)
+
+
+@pytest.mark.parametrize("memory_map", [False, True])
+@pytest.mark.parametrize("alignment", [0, 4096])
+def test_geom_bam_file_data(tmp_path, alignment, memory_map):
+    geom = make_geom(1000)
+    path = tmp_path / "geom.bam"
+    write_bam(path, geom, alignment)
+
+    contents = path.read_bytes()
+    vertex_bytes = bytes(geom.get_vertex_data().get_array(0).get_handle().get_data())
+    index_bytes = bytes(geom.get_primitive(0).get_vertices().get_handle().get_data())
+    if alignment != 0:
+        # The arrays should have been written on aligned boundaries.
+        assert contents.find(vertex_bytes) % alignment == 0
+        assert contents.find(index_bytes) % alignment == 0
+
+    geom2 = read_bam(path, memory_map)
+    array = geom2.get_vertex_data().get_array(0)
+    assert bytes(array.get_handle().get_data()) == vertex_bytes
+    assert bytes(geom2.get_primitive(0).get_vertices().get_handle().get_data()) == index_bytes
+
+    # The array may be modified after loading, without affecting the file.
+    data = geom2.modify_vertex_data()
+    vertex = core.GeomVertexWriter(data, "vertex")
+    vertex.set_data3(7, 8, 9)
+    reader = core.GeomVertexReader(data, "vertex")
+    assert reader.get_data3() == (7, 8, 9)
+    assert reader.get_data3() == (1, 0.5, -1)
+    assert path.read_bytes() == contents
+
+
+def test_geom_bam_file_data_small(tmp_path):
+    # Arrays smaller than the alignment are stored inline.
+    geom = make_geom(10)
+    path = tmp_path / "geom.bam"
+    write_bam(path, geom, 4096)
+    assert path.stat().st_size < 4096
+
+    geom2 = read_bam(path, True)
+    reader = core.GeomVertexReader(geom2.get_vertex_data(), "vertex")
+    reader.set_row(9)
+    assert reader.get_data3() == (9, 4.5, -9)
@@ -1,4 +1,4 @@
-from panda3d.core import Texture, PNMImage, LColor
+from panda3d.core import Texture, PNMImage, LColor, ConfigVariableInt
 from array import array
 import math
 
@@ -134,3 +134,29 @@ def test_texture_clear_half():
     assert col.y == -inf
     assert col.z == -inf
     assert math.isnan(col.w)
+
+
+def compress_rgtc_with_threads(format, threads):
+    var = ConfigVariableInt("texture-compression-threads")
+    old_value = var.get_value()
+    var.set_value(threads)
+    try:
+        tex = Texture("")
+        tex.setup_2d_texture(512, 256, Texture.T_unsigned_byte, format)
+        num_bytes = tex.get_expected_ram_image_size()
+        tex.set_ram_image(array('B', ((i * 7 + (i >> 9) * 3) & 0xff for i in range(num_bytes))))
+        assert tex.compress_ram_image(Texture.CM_rgtc)
+        compressed = bytes(tex.get_ram_image())
+        assert tex.uncompress_ram_image()
+        return compressed, bytes(tex.get_ram_image())
+    finally:
+        var.set_value(old_value)
+
+
+def test_texture_compress_rgtc_threads():
+    # The result must not depend on the number of threads.
+    for format in (Texture.F_red, Texture.F_rg):
+        serial = compress_rgtc_with_threads(format, 1)
+        parallel = compress_rgtc_with_threads(format, 0)
+        assert serial[0] == parallel[0]
+        assert serial[1] == parallel[1]